@@ -60,14 +60,12 @@ public:
   std::tuple <NtkDest, std::unordered_map<int, std::string>>  run()
   {
     NtkDest dest;
-    nlohmann::json json_library; //LUT -> verilog database
+    nlohmann::json const& json_library = library(); //LUT -> verilog database
     mockturtle::node_map<mockturtle::signal<NtkDest>, NtkSource> node_to_signal( ntk ); //i/o for original klut network
     int netlistcount = 0; //node count.  Used as index in cell_names
     int new_count = 0;
     std::unordered_map <int, std::string> cell_names; //which network node is which standard cell.  Returned in tuple for printing.  Doing it this way to avoid changing mockturtle    
     std::regex gate_inputs("\\.([ABCDY123]+)\\((.+?)\\)");  //regex to handle signals
-    std::ifstream library("../../NPN_complete_noZero.json"); //make this generic once it's working
-    library >> json_library; //this will be huge if we go above LUT4.  May need to memoize.
 
     /* primary inputs */
     ntk.foreach_pi( [&]( auto n ) {
@@ -310,6 +308,17 @@ public:
   }
 
 private:
+  /* The library is parsed once per process, it is large and never changes */
+  static nlohmann::json const& library(){
+    static const nlohmann::json json_library = [](){
+      nlohmann::json json_library;
+      std::ifstream library("../../NPN_complete_noZero.json"); //make this generic once it's working
+      library >> json_library; //this will be huge if we go above LUT4.
+      return json_library;
+    }();
+    return json_library;
+  }
+
   NtkSource const& ntk;
 
   kitty::dynamic_truth_table make_truth_table (NtkSource const& dest, std::vector <mockturtle::signal <NtkDest> > children, std::string func){
@@ -1,6 +1,7 @@
 #include <kitty/kitty.hpp>
 #include <mockturtle/mockturtle.hpp>
 
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -12,40 +13,26 @@ namespace oracle{
     
     class aig_script{
     public:
-        mockturtle::aig_network run(mockturtle::aig_network& aig){
+        /* number of times run() calls pass_done, if it is not stopped */
+        static constexpr int num_passes = 10;
 
-            mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn;
+        mockturtle::aig_network run(mockturtle::aig_network& aig,
+                                    std::function<bool(mockturtle::aig_network const&)> const& pass_done = {}){
+
+            oracle::profile_scope profile("aig_script");
+            auto& resyn = oracle::xag_npn_database<mockturtle::aig_network>();
             mockturtle::cut_rewriting_params ps;
             ps.cut_enumeration_ps.cut_size = 4;
 
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
-
-            mockturtle::cut_rewriting(aig, resyn, ps);
-            aig = mockturtle::cleanup_dangling(aig);
+            for(int pass = 0; pass < num_passes; pass++){
+                oracle::profile_scope stage("cut_rewriting");
+                mockturtle::cut_rewriting(aig, resyn, ps);
+                stage.next("cleanup");
+                aig = mockturtle::cleanup_dangling(aig);
+                stage.next("cutoff_check");
+                if(pass_done && !pass_done(aig))
+                    break;
+            }
 
             return aig;
         }
@@ -0,0 +1,307 @@
+#include <mockturtle/mockturtle.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace oracle{
+
+  /* Whether the AIG result is kept over the MIG result of a partition.
+     strategy: area delay product=0, area=1, delay=2, area under delay_threshold=3 */
+  inline bool prefer_aig(unsigned strategy, unsigned delay_threshold, int aig_size, int aig_depth, int mig_size, int mig_depth){
+    const int threshold = delay_threshold;
+    switch(strategy){
+      default:
+      case 0:
+        return (aig_size * aig_depth) <= (mig_size * mig_depth);
+      case 1:
+        return aig_size <= mig_size;
+      case 2:
+        return aig_depth <= mig_depth;
+      case 3:
+        if(aig_depth <= threshold && mig_depth <= threshold)
+          return aig_size < mig_size;
+        if(aig_depth <= threshold || mig_depth <= threshold)
+          return aig_depth <= threshold;
+        return aig_depth <= mig_depth;
+    }
+  }
+
+  /* Largest number of inputs any output is shown to depend on by random
+     simulation. Every dependence is witnessed by a pair of patterns, so this
+     is a lower bound on the true functional support. */
+  inline uint32_t witnessed_support(mockturtle::aig_network const& ntk, uint32_t rounds = 4u){
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> base(ntk.size()), flipped(ntk.size());
+    std::vector<std::vector<bool>> depends(ntk.num_pos(), std::vector<bool>(ntk.num_pis(), false));
+
+    const auto simulate = [&](std::vector<uint64_t>& values){
+      ntk.foreach_gate([&](auto n){
+        uint64_t v = ~uint64_t(0);
+        ntk.foreach_fanin(n, [&](auto const& f){
+          const auto x = values[ntk.node_to_index(ntk.get_node(f))];
+          v &= ntk.is_complemented(f) ? ~x : x;
+        });
+        values[ntk.node_to_index(n)] = v;
+      });
+    };
+    const auto output = [&](std::vector<uint64_t> const& values, auto const& f){
+      const auto x = values[ntk.node_to_index(ntk.get_node(f))];
+      return ntk.is_complemented(f) ? ~x : x;
+    };
+
+    for(uint32_t r = 0; r < rounds; r++){
+      ntk.foreach_pi([&](auto n){
+        base[ntk.node_to_index(n)] = rng();
+      });
+      simulate(base);
+      ntk.foreach_pi([&](auto x, auto i){
+        flipped = base;
+        flipped[ntk.node_to_index(x)] = ~base[ntk.node_to_index(x)];
+        simulate(flipped);
+        ntk.foreach_po([&](auto const& f, auto o){
+          if(output(base, f) != output(flipped, f))
+            depends[o][i] = true;
+        });
+      });
+    }
+
+    uint32_t support = 0;
+    for(auto const& d : depends)
+      support = std::max<uint32_t>(support, std::count(d.begin(), d.end(), true));
+    return support;
+  }
+
+  /* Shared state of an AIG and an MIG candidate optimized concurrently. Each
+     candidate reports at its pass boundaries; once the other candidate has
+     finished and wins even against the best result this one is expected to
+     reach, this one is told to stop.
+
+     The structural bounds from the support (s-1 two-input or (s-1)/2
+     three-input gates, depth log2(s) or log3(s)) are exact but loose, they
+     rarely decide anything.  A candidate that is started with its initial
+     size, depth and number of passes is also bounded by its own progress:
+     its gains are summed per window of three passes (one depth and two area
+     passes of mig_script), the remaining passes are assumed to gain at most
+     as much per window as the last one, and once there are two windows, to
+     keep shrinking geometrically at their rate.  This projection is lossy:
+     it can stop a candidate that would have won in its last passes, so it is
+     only used for candidates that are started. */
+  class candidate_monitor{
+  public:
+    candidate_monitor(unsigned strategy, unsigned delay_threshold, uint32_t support)
+      : strategy(strategy), delay_threshold(delay_threshold){
+      if(support > 1){
+        aig.floor_size = support - 1;
+        aig.floor_depth = std::ceil(std::log2(support) - 1e-9);
+        mig.floor_size = support / 2;
+        mig.floor_depth = std::ceil(std::log(support) / std::log(3.0) - 1e-9);
+      }
+      aig.min_size = aig.floor_size;
+      aig.min_depth = aig.floor_depth;
+      mig.min_size = mig.floor_size;
+      mig.min_depth = mig.floor_depth;
+    }
+
+    void start(bool is_aig, int size, int depth, int passes){
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& self = is_aig ? aig : mig;
+      self.size = size;
+      self.depth = depth;
+      self.passes_left = passes;
+      self.started = true;
+    }
+
+    /* at a pass boundary, with the current size and depth of the candidate */
+    bool keep_going(bool is_aig, int size, int depth){
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& self = is_aig ? aig : mig;
+        if(self.started){
+          self.size_gains.push_back(std::max(0, self.size - size));
+          self.depth_gains.push_back(std::max(0, self.depth - depth));
+          self.size = size;
+          self.depth = depth;
+          self.passes_left = std::max(0, self.passes_left - 1);
+          self.min_size = std::max(self.floor_size, size - projected_gain(self.size_gains, self.passes_left));
+          self.min_depth = std::max(self.floor_depth, depth - projected_gain(self.depth_gains, self.passes_left));
+        }
+      }
+      return keep_going(is_aig);
+    }
+
+    bool keep_going(bool is_aig){
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& self = is_aig ? aig : mig;
+      auto const& other = is_aig ? mig : aig;
+      if(!other.done || self.cancelled)
+        return !self.cancelled;
+      const bool aig_wins = is_aig ?
+        prefer_aig(strategy, delay_threshold, self.min_size, self.min_depth, other.size, other.depth) :
+        prefer_aig(strategy, delay_threshold, other.size, other.depth, self.min_size, self.min_depth);
+      self.cancelled = aig_wins != is_aig;
+      return !self.cancelled;
+    }
+
+    void finish(bool is_aig, int size, int depth){
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& self = is_aig ? aig : mig;
+      self.done = true;
+      self.size = size;
+      self.depth = depth;
+    }
+
+    bool cancelled(bool is_aig) const { return is_aig ? aig.cancelled : mig.cancelled; }
+
+  private:
+    static constexpr std::size_t window = 3u;
+
+    /* gain still expected from the remaining passes */
+    static int projected_gain(std::vector<int> const& gains, int passes_left){
+      if(passes_left == 0)
+        return 0;
+      /* gain of the window of passes ending before end, a window that is
+         not complete yet is extrapolated from its best pass */
+      const auto window_gain = [&](std::size_t end) -> double {
+        if(end < window)
+          return *std::max_element(gains.begin(), gains.begin() + end) * double(window);
+        return std::accumulate(gains.begin() + (end - window), gains.begin() + end, 0);
+      };
+      const double recent = window_gain(gains.size());
+      double gain = recent * std::ceil(passes_left / double(window));
+      if(gains.size() >= 2u * window){
+        const double before = window_gain(gains.size() - window);
+        if(recent < before){
+          const double q = recent / before;
+          gain = std::min(gain, recent * q / (1.0 - q));
+        }
+      }
+      return std::ceil(gain - 1e-9);
+    }
+
+    struct candidate{
+      int floor_size{0};
+      int floor_depth{0};
+      int min_size{0};
+      int min_depth{0};
+      int size{0};
+      int depth{0};
+      int passes_left{0};
+      std::vector<int> size_gains;
+      std::vector<int> depth_gains;
+      bool started{false};
+      bool done{false};
+      bool cancelled{false};
+    };
+
+    unsigned strategy;
+    unsigned delay_threshold;
+    std::mutex mutex;
+    candidate aig;
+    candidate mig;
+  };
+
+  struct dual_candidate_result{
+    mockturtle::aig_network aig;
+    mockturtle::mig_network mig;
+    int aig_size{0};
+    int aig_depth{0};
+    int mig_size{0};
+    int mig_depth{0};
+    bool use_aig{true};
+    bool cancelled{false};
+    /* with a reference, whether each result is equivalent to the partition,
+       whether the other result was chosen because the preferred one was
+       not, and whether neither is, in which case use_aig is meaningless */
+    bool aig_verified{true};
+    bool mig_verified{true};
+    bool retried{false};
+    bool rejected{false};
+  };
+
+  /* Runs aig_script and mig_script on the two extracted copies of a partition
+     in parallel and returns both results with the chosen one. The losing
+     candidate may be stopped early, in which case its result is partial.
+     With a reference of the partition (see partition_reference), each thread
+     checks its own result against it, and a result that fails is never
+     chosen. Only the exact support bounds
+     stop a candidate, unless project_progress also bounds it by its own
+     progress, which is faster but may discard the better result. */
+  inline dual_candidate_result optimize_dual_candidates(mockturtle::aig_network aig, mockturtle::mig_network mig,
+                                                        unsigned strategy, unsigned delay_threshold = 0u,
+                                                        std::optional<mockturtle::aig_network> const& reference = std::nullopt,
+                                                        bool project_progress = false){
+    oracle::profile_scope profile("dual_candidates");
+    oracle::profile_scope stage("support");
+    dual_candidate_result result;
+    candidate_monitor monitor(strategy, delay_threshold, witnessed_support(aig));
+    stage.end();
+
+    /* one private copy per thread, the checks mark nodes while traversing */
+    mockturtle::aig_network aig_spec, mig_spec;
+    const bool verify = reference.has_value();
+    if(verify){
+      aig_spec = mockturtle::cleanup_dangling(*reference);
+      mig_spec = mockturtle::cleanup_dangling(*reference);
+    }
+
+    const auto depth = [](auto const& ntk){
+      mockturtle::depth_view ntk_depth{ntk};
+      return static_cast<int>(ntk_depth.depth());
+    };
+    if(project_progress){
+      monitor.start(true, aig.num_gates(), depth(aig), oracle::aig_script::num_passes);
+      monitor.start(false, mig.num_gates(), depth(mig), oracle::mig_script::num_passes);
+    }
+
+    std::thread mig_thread([&, context = oracle::profiler::context()](){
+      oracle::profile_thread_scope thread_profile(context);
+      oracle::mig_script migopt;
+      result.mig = migopt.run(mig, [&](auto const& ntk){ return monitor.keep_going(false, ntk.num_gates(), depth(ntk)); });
+      mockturtle::depth_view mig_depth{result.mig};
+      result.mig_size = result.mig.num_gates();
+      result.mig_depth = mig_depth.depth();
+      monitor.finish(false, result.mig_size, result.mig_depth);
+      if(verify){
+        oracle::profile_scope verification("verification");
+        result.mig_verified = verify_partition(mig_spec, result.mig);
+      }
+    });
+
+    oracle::aig_script aigopt;
+    result.aig = aigopt.run(aig, [&](auto const& ntk){ return monitor.keep_going(true, ntk.num_gates(), depth(ntk)); });
+    mockturtle::depth_view aig_depth{result.aig};
+    result.aig_size = result.aig.num_gates();
+    result.aig_depth = aig_depth.depth();
+    monitor.finish(true, result.aig_size, result.aig_depth);
+    if(verify){
+      stage.next("verification");
+      result.aig_verified = verify_partition(aig_spec, result.aig);
+    }
+
+    stage.next("join");
+    mig_thread.join();
+    stage.end();
+
+    if(monitor.cancelled(true))
+      result.use_aig = false;
+    else if(monitor.cancelled(false))
+      result.use_aig = true;
+    else
+      result.use_aig = prefer_aig(strategy, delay_threshold, result.aig_size, result.aig_depth, result.mig_size, result.mig_depth);
+    result.cancelled = monitor.cancelled(true) || monitor.cancelled(false);
+
+    if(!(result.use_aig ? result.aig_verified : result.mig_verified)){
+      result.use_aig = !result.use_aig;
+      result.retried = true;
+      result.rejected = !(result.use_aig ? result.aig_verified : result.mig_verified);
+    }
+    return result;
+  }
+}
@@ -1,6 +1,7 @@
 #include <kitty/kitty.hpp>
 #include <mockturtle/mockturtle.hpp>
 
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -11,7 +12,13 @@
 namespace oracle{
     class mig_script{
     public:
-        mockturtle::mig_network run(mockturtle::mig_network& mig){
+        /* number of times run() calls pass_done, if it is not stopped */
+        static constexpr int num_passes = 9;
+
+        mockturtle::mig_network run(mockturtle::mig_network& mig,
+                                    std::function<bool(mockturtle::mig_network const&)> const& pass_done = {}){
+            oracle::profile_scope profile("mig_script");
+            oracle::profile_scope stage("depth_rewriting");
             mockturtle::depth_view mig_depth{mig};
 
             mockturtle::mig_algebraic_depth_rewriting_params pm;
@@ -21,73 +28,119 @@ namespace oracle{
 
             mockturtle::mig_algebraic_depth_rewriting(mig_depth, pm);
 
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "1st round area recovering " << std::endl;
 
             // AREA RECOVERING
-            mockturtle::mig_npn_resynthesis resyn;
+            auto& resyn = oracle::mig_npn_database();
             mockturtle::cut_rewriting_params ps;
 
             ps.cut_enumeration_ps.cut_size = 4;
 
+            stage.next("area_recovery");
             mockturtle::cut_rewriting(mig, resyn, ps);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "2nd round area recovering " << std::endl;
 
             // AREA RECOVERING
+            stage.next("area_recovery");
             mockturtle::cut_rewriting(mig, resyn, ps);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "2nd round depth optimization" << std::endl;
 
             //DEPTH REWRITING
+            stage.next("depth_rewriting");
             mockturtle::depth_view mig_depth1{mig};
 
             mockturtle::mig_algebraic_depth_rewriting(mig_depth1, pm);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "3rd round area recovering" << std::endl;
 
             // AREA RECOVERING
+            stage.next("area_recovery");
             mockturtle::cut_rewriting(mig, resyn, ps);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "4th round area recovering" << std::endl;
 
             // AREA RECOVERING
+            stage.next("area_recovery");
             mockturtle::cut_rewriting(mig, resyn, ps);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "3rd round depth optimization" << std::endl;
 
             //DEPTH REWRITING
+            stage.next("depth_rewriting");
             mockturtle::depth_view mig_depth2{mig};
 
             mockturtle::mig_algebraic_depth_rewriting(mig_depth2, pm);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "5th round area recovering" << std::endl;
 
             // AREA RECOVERING
+            stage.next("area_recovery");
             mockturtle::cut_rewriting(mig, resyn, ps);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "6th round area recovering" << std::endl;
 
             // AREA RECOVERING
+            stage.next("area_recovery");
             mockturtle::cut_rewriting(mig, resyn, ps);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
+            stage.next("cutoff_check");
+            if(pass_done && !pass_done(mig))
+                return mig;
 
             // std::cout << "Final depth optimization" << std::endl;
 
             //DEPTH REWRITING
+            stage.next("depth_rewriting");
             mockturtle::depth_view mig_depth3{mig};
 
             // std::cout << "Network Optimized" << std::endl;
 
             mockturtle::mig_algebraic_depth_rewriting(mig_depth3, pm);
+            stage.next("cleanup");
             mig = mockturtle::cleanup_dangling( mig );
 
             // std::cout << "Majority nodes " << mig.num_gates() << " MIG depth " << mig_depth3.depth() << std::endl;
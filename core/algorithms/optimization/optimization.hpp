@@ -31,10 +31,11 @@ namespace oracle{
                          bool high, bool aig, bool mig, bool combine,
                          std::set<int32_t> aig_always_partitions, std::set<int32_t> mig_always_partitions,
                          std::set<int32_t> depth_always_partitions, std::set<int32_t> area_always_partitions,
-                         std::set<int32_t> skip_partitions){
+                         std::set<int32_t> skip_partitions, float margin_threshold = 0.0f, bool verify = false,
+                         bool project_progress = false){
 
-    mockturtle::direct_resynthesis<mockturtle::mig_network> resyn_mig;
-    mockturtle::direct_resynthesis<mockturtle::aig_network> resyn_aig;
+    oracle::profile_scope profile("optimization");
+    oracle::profile_scope stage("aig_to_mig");
 
     std::vector<int> aig_parts;
     std::vector<int> mig_parts;
@@ -42,6 +43,40 @@ namespace oracle{
     std::vector<int> comb_aig_parts;
     std::vector<int> comb_mig_parts;
     int num_parts = partitions_aig.get_part_num();
+
+    auto ntk_mig = *aig_to_mig(ntk_aig, 1);
+    oracle::partition_manager<mig_names> partitions_mig(ntk_mig, partitions_aig.get_all_part_connections(), 
+            partitions_aig.get_all_partition_inputs(), partitions_aig.get_all_partition_outputs(),
+            partitions_aig.get_all_partition_regs(), partitions_aig.get_all_partition_regin(), partitions_aig.get_part_num());
+
+    oracle::partition_extractor<mig_names> extractor(ntk_mig);
+    oracle::partition_integrator<mig_names> integrator(ntk_mig);
+    oracle::partition_checker checker(verify);
+    /* the dual candidates check their results themselves, unless combine
+       changes the partitions afterwards */
+    const auto reference = [&](oracle::partition_view<mig_names> const& part) -> std::optional<mockturtle::aig_network> {
+      if(!verify || combine)
+        return std::nullopt;
+      return oracle::partition_reference(part);
+    };
+
+    /* partitions whose dual candidate winner is already integrated, only
+       without combine, which changes the partitions afterwards */
+    std::set<int> optimized_parts;
+    const auto integrate_winner = [&](oracle::partition_view<mig_names> const& part, int i, dual_candidate_result const& candidates){
+      if(combine)
+        return;
+      if(checker.is_enabled())
+        checker.record(!candidates.retried, !candidates.rejected);
+      if(!candidates.rejected){
+        if(candidates.use_aig)
+          integrator.add(part, candidates.aig);
+        else
+          integrator.add(part, candidates.mig);
+      }
+      optimized_parts.insert(i);
+    };
+    stage.next("selection");
     if(aig){
       for(int i = 0; i < num_parts; i++){
         aig_parts.push_back(i);
@@ -53,6 +88,7 @@ namespace oracle{
       }
     }
     else if(high){
+      int stopped_early = 0;
       for(int i = 0; i < num_parts; i++){
         if (mig_always_partitions.find(i) != mig_always_partitions.end()) {
           mig_parts.push_back(i);
@@ -66,21 +102,7 @@ namespace oracle{
           continue;
         }
 
-        oracle::partition_view<aig_names> part_aig = partitions_aig.create_part(ntk_aig, i);
-
-        auto opt_aig = mockturtle::node_resynthesis<mockturtle::aig_network>( part_aig, resyn_aig );
-        oracle::aig_script aigopt;
-        opt_aig = aigopt.run(opt_aig);
-        mockturtle::depth_view part_aig_opt_depth{opt_aig};
-        int aig_opt_size = opt_aig.num_gates();
-        int aig_opt_depth = part_aig_opt_depth.depth();
-
-        auto opt_mig = mockturtle::node_resynthesis<mockturtle::mig_network>( part_aig, resyn_mig );
-        oracle::mig_script migopt;
-        opt_mig = migopt.run(opt_mig);
-        mockturtle::depth_view part_mig_opt_depth{opt_mig};
-        int mig_opt_size = opt_mig.num_gates();
-        int mig_opt_depth = part_mig_opt_depth.depth();
+        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, i);
 
         unsigned local_strategy;
         if (depth_always_partitions.find(i) != depth_always_partitions.end()) {
@@ -90,67 +112,49 @@ namespace oracle{
         } else {
           local_strategy = strategy;
         }
-        switch(local_strategy){
-          default:
-          case 0:
-          {
-            if((aig_opt_size * aig_opt_depth) <= (mig_opt_size * mig_opt_depth)){
-              aig_parts.push_back(i);
-            }
-            else{
-              mig_parts.push_back(i);
-            }
-          }
-          break;
-          case 1:
-          {
-            if((aig_opt_size) <= (mig_opt_size)){
-              aig_parts.push_back(i);
-            }
-            else{
-              mig_parts.push_back(i);
-            }
-          }
-          break;
-          case 2:
-          {
-            if((aig_opt_depth) <= (mig_opt_depth)){
-              aig_parts.push_back(i);
-            }
-            else{
-              mig_parts.push_back(i);
-            }
-          }
-          break;
-          case 3:
-          {
-            if (aig_opt_depth <= delay_threshold && mig_opt_depth <= delay_threshold) {
-              if (aig_opt_size < mig_opt_size) {
-                aig_parts.push_back(i);
-              } else {
-                mig_parts.push_back(i);
-              }
-            } else if(aig_opt_depth <= delay_threshold && mig_opt_depth > delay_threshold) {
-              aig_parts.push_back(i);
-            } else if (aig_opt_depth > delay_threshold && mig_opt_depth <= delay_threshold) {
-              mig_parts.push_back(i);
-            } else {
-              if(aig_opt_depth <= mig_opt_depth) {
-                aig_parts.push_back(i);
-              } else{
-                mig_parts.push_back(i);
-              }
-            }
-          }
-          break;
+        auto candidates = oracle::optimize_dual_candidates(extractor.extract<mockturtle::aig_network>(part),
+                                                           extractor.extract<mockturtle::mig_network>(part),
+                                                           local_strategy, delay_threshold, reference(part), project_progress);
+        if(candidates.cancelled)
+          stopped_early++;
+        if(candidates.use_aig){
+          aig_parts.push_back(i);
+        }
+        else{
+          mig_parts.push_back(i);
         }
+        integrate_winner(part, i, candidates);
       }
+      std::cout << stopped_early << " losing candidates stopped early\n";
     }
     else{
       if(!nn_model.empty()){
         partitions_aig.run_classification(ntk_aig, nn_model);
         aig_parts = partitions_aig.get_aig_parts();
                 mig_parts = partitions_aig.get_mig_parts();
+
+        if(margin_threshold > 0){
+          auto margins = partitions_aig.get_classification_margins();
+          int num_uncertain = 0;
+          for(int i = 0; i < num_parts; i++){
+            if(margins.at(i) >= margin_threshold)
+              continue;
+            num_uncertain++;
+            oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, i);
+            auto candidates = oracle::optimize_dual_candidates(extractor.extract<mockturtle::aig_network>(part),
+                                                               extractor.extract<mockturtle::mig_network>(part),
+                                                               strategy, delay_threshold, reference(part), project_progress);
+            aig_parts.erase(std::remove(aig_parts.begin(), aig_parts.end(), i), aig_parts.end());
+            mig_parts.erase(std::remove(mig_parts.begin(), mig_parts.end(), i), mig_parts.end());
+            if(candidates.use_aig)
+              aig_parts.push_back(i);
+            else
+              mig_parts.push_back(i);
+            integrate_winner(part, i, candidates);
+          }
+          std::cout << num_parts - num_uncertain << " partitions classified by the neural network, " << num_uncertain
+                    << " with margin below " << margin_threshold << " classified by high effort optimization\n";
+        }
       }
       else{
         std::cout << "Must include Neural Network model json file\n";
@@ -160,6 +164,7 @@ namespace oracle{
 
     std::cout << aig_parts.size() << " AIGs and " << mig_parts.size() << " MIGs\n";
 
+    stage.next("combine");
     if(combine){
       std::vector<int> visited;
       std::unordered_map<int, int> comb_part;
@@ -272,54 +277,52 @@ namespace oracle{
       mig_parts = comb_mig_parts;
       std::cout << "Scheduled optimization after partition merging\n";
       std::cout << aig_parts.size() << " AIGs and " << mig_parts.size() << " MIGs\n";
-    }
 
-    auto ntk_mig = *aig_to_mig(ntk_aig, 1);
-    oracle::partition_manager<mig_names> partitions_mig(ntk_mig, partitions_aig.get_all_part_connections(), 
+      partitions_mig = oracle::partition_manager<mig_names>(ntk_mig, partitions_aig.get_all_part_connections(),
             partitions_aig.get_all_partition_inputs(), partitions_aig.get_all_partition_outputs(),
             partitions_aig.get_all_partition_regs(), partitions_aig.get_all_partition_regin(), partitions_aig.get_part_num());
+    }
 
+    stage.next("scripts");
     for(int i = 0; i < aig_parts.size(); i++){
-      
-      oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, aig_parts.at(i));
-      mockturtle::depth_view part_depth{part};
+      if(optimized_parts.count(aig_parts.at(i)))
+        continue;
 
-      auto opt_part = *part_to_mig(part, 1);
-      auto opt = *mig_to_aig(opt_part);
+      oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, aig_parts.at(i));
 
-      mockturtle::depth_view opt_part_depth{opt};
+      auto opt = extractor.extract<mockturtle::aig_network>(part);
 
       oracle::aig_script aigopt;
       opt = aigopt.run(opt);
 
-      auto opt_mig = *aig_to_mig(opt, 0);
-      mockturtle::depth_view part_opt_depth{opt_mig};
-
-      partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
+      checker.add(part, integrator, opt, [&](){
+        auto retry = extractor.extract<mockturtle::mig_network>(part);
+        oracle::mig_script migopt;
+        return migopt.run(retry);
+      });
     }
     
     for(int i = 0; i < mig_parts.size(); i++){
-      
-      oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, mig_parts.at(i));
-      mockturtle::depth_view part_depth{part};
+      if(optimized_parts.count(mig_parts.at(i)))
+        continue;
 
-      auto opt = *part_to_mig(part, 0);
+      oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, mig_parts.at(i));
 
-      mockturtle::depth_view opt_part_depth{opt};
+      auto opt = extractor.extract<mockturtle::mig_network>(part);
       
       oracle::mig_script migopt;
       opt = migopt.run(opt);
-      
-      mockturtle::depth_view part_opt_depth{opt};
 
-      partitions_mig.synchronize_part(part, opt, ntk_mig);
+      checker.add(part, integrator, opt, [&](){
+        auto retry = extractor.extract<mockturtle::aig_network>(part);
+        oracle::aig_script aigopt;
+        return aigopt.run(retry);
+      });
     }
+    checker.report();
     
-    partitions_mig.connect_outputs(ntk_mig);
-    
-    mockturtle::depth_view ntk_before_depth2{ntk_mig};
-    
-    ntk_mig = mockturtle::cleanup_dangling( ntk_mig );
+    stage.next("rebuild");
+    ntk_mig = integrator.rebuild(ntk_mig);
 
     return ntk_mig;
     
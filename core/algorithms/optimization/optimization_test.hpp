@@ -28,8 +28,11 @@ namespace oracle{
   using part_man_mig_ntk = std::shared_ptr<part_man_mig>;
     
   mig_names optimization_test(aig_names ntk_aig, part_man_aig partitions_aig, unsigned strategy,std::string nn_model, 
-    bool high, bool aig, bool mig, bool combine){
+    bool high, bool aig, bool mig, bool combine, float margin_threshold = 0.0f, bool verify = false,
+    bool project_progress = false){
 
+    oracle::profile_scope profile("optimization");
+    oracle::profile_scope stage("aig_to_mig");
     mockturtle::direct_resynthesis<mockturtle::mig_network> resyn_mig;
     mockturtle::direct_resynthesis<mockturtle::aig_network> resyn_aig;
 
@@ -43,6 +46,18 @@ namespace oracle{
     oracle::partition_manager<mig_names> partitions_mig(ntk_mig, partitions_aig.get_all_part_connections(), 
             partitions_aig.get_all_partition_inputs(), partitions_aig.get_all_partition_outputs(),
             partitions_aig.get_all_partition_regs(), partitions_aig.get_all_partition_regin(), partitions_aig.get_part_num());
+    oracle::partition_extractor<mig_names> extractor(ntk_mig);
+    oracle::partition_integrator<mig_names> integrator(ntk_mig);
+    std::set<int> optimized_parts;
+    oracle::partition_checker checker(verify);
+    /* the dual candidates check their results themselves, unless combine
+       changes the partitions afterwards */
+    const auto reference = [&](oracle::partition_view<mig_names> const& part) -> std::optional<mockturtle::aig_network> {
+      if(!verify || combine)
+        return std::nullopt;
+      return oracle::partition_reference(part);
+    };
+    stage.next("selection");
 
     if(aig){
       for(int i = 0; i < num_parts; i++){
@@ -59,88 +74,72 @@ namespace oracle{
       partitions_aig.run_classification(ntk_aig, nn_model);
       aig_parts = partitions_aig.get_aig_parts();
       mig_parts = partitions_aig.get_mig_parts();
+
+      if(margin_threshold > 0){
+        auto margins = partitions_aig.get_classification_margins();
+        int num_uncertain = 0;
+        for(int i = 0; i < num_parts; i++){
+          if(margins.at(i) >= margin_threshold)
+            continue;
+          num_uncertain++;
+          oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, i);
+          auto candidates = oracle::optimize_dual_candidates(extractor.extract<mockturtle::aig_network>(part),
+                                                             extractor.extract<mockturtle::mig_network>(part),
+                                                             strategy > 2 ? 0u : strategy, 0u, reference(part), project_progress);
+          aig_parts.erase(std::remove(aig_parts.begin(), aig_parts.end(), i), aig_parts.end());
+          mig_parts.erase(std::remove(mig_parts.begin(), mig_parts.end(), i), mig_parts.end());
+          if(candidates.use_aig)
+            aig_parts.push_back(i);
+          else
+            mig_parts.push_back(i);
+          if(!combine){
+            if(checker.is_enabled())
+              checker.record(!candidates.retried, !candidates.rejected);
+            if(!candidates.rejected){
+              if(candidates.use_aig)
+                integrator.add(part, candidates.aig);
+              else
+                integrator.add(part, candidates.mig);
+            }
+            optimized_parts.insert(i);
+          }
+        }
+        std::cout << num_parts - num_uncertain << " partitions classified by the neural network, " << num_uncertain
+                  << " with margin below " << margin_threshold << " classified by high effort optimization\n";
+      }
     }
     else{
       std::cout << "Performing High Effort Classification and Optimization\n";
+      int stopped_early = 0;
       for(int i = 0; i < num_parts; i++){
         oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, i);
 
-        auto opt_part_aig = *part_to_mig(part, 1);
-        auto opt_aig = *mig_to_aig(opt_part_aig);
-
-        oracle::aig_script aigopt;
-        opt_aig = aigopt.run(opt_aig);
-        mockturtle::depth_view part_aig_opt_depth{opt_aig};
-        int aig_opt_size = opt_aig.num_gates();
-        int aig_opt_depth = part_aig_opt_depth.depth();
-
-        auto opt_mig = *part_to_mig(part, 0);
-        oracle::mig_script migopt;
-        opt_mig = migopt.run(opt_mig);
-        mockturtle::depth_view part_mig_opt_depth{opt_mig};
-        int mig_opt_size = opt_mig.num_gates();
-        int mig_opt_depth = part_mig_opt_depth.depth();
-
-        switch(strategy){
-          default:
-          case 0:
-          {
-            if((aig_opt_size * aig_opt_depth) <= (mig_opt_size * mig_opt_depth)){
-              aig_parts.push_back(i);
-              if(!combine){
-                auto opt_aig_mig = *aig_to_mig(opt_aig, 0);
-                partitions_mig.synchronize_part(part, opt_aig_mig, ntk_mig);
-              }
-            }
-            else{
-              mig_parts.push_back(i);
-              if(!combine){
-                partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-              }
-            }
-          }
-          break;
-          case 1:
-          {
-            if((aig_opt_size) <= (mig_opt_size)){
-              aig_parts.push_back(i);
-              if(!combine){
-                auto opt_aig_mig = *aig_to_mig(opt_aig, 0);
-                partitions_mig.synchronize_part(part, opt_aig_mig, ntk_mig);
-              }
-            }
-            else{
-              mig_parts.push_back(i);
-              if(!combine){
-                partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-              }
-            }
+        auto candidates = oracle::optimize_dual_candidates(extractor.extract<mockturtle::aig_network>(part),
+                                                           extractor.extract<mockturtle::mig_network>(part),
+                                                           strategy > 2 ? 0u : strategy, 0u, reference(part), project_progress);
+        if(candidates.cancelled)
+          stopped_early++;
+        if(checker.is_enabled() && !combine)
+          checker.record(!candidates.retried, !candidates.rejected);
+        if(candidates.use_aig){
+          aig_parts.push_back(i);
+          if(!combine && !candidates.rejected){
+            integrator.add(part, candidates.aig);
           }
-          break;
-          case 2:
-          {
-            if((aig_opt_depth) <= (mig_opt_depth)){
-              aig_parts.push_back(i);
-              if(!combine){
-                auto opt_aig_mig = *aig_to_mig(opt_aig, 0);
-                partitions_mig.synchronize_part(part, opt_aig_mig, ntk_mig);
-              }
-            }
-            else{
-              mig_parts.push_back(i);
-              if(!combine){
-                partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
-              }
-            }
+        }
+        else{
+          mig_parts.push_back(i);
+          if(!combine && !candidates.rejected){
+            integrator.add(part, candidates.mig);
           }
-          break;
         }
-        
       }
+      std::cout << stopped_early << " losing candidates stopped early\n";
     }
 
     std::cout << aig_parts.size() << " AIGs and " << mig_parts.size() << " MIGs\n";
 
+    stage.next("combine");
     if(combine){
       std::vector<int> visited;
       std::unordered_map<int, int> comb_part;
@@ -255,46 +254,48 @@ namespace oracle{
       std::cout << aig_parts.size() << " AIGs and " << mig_parts.size() << " MIGs\n";
     }
 
+    stage.next("scripts");
     if(!high){
       for(int i = 0; i < aig_parts.size(); i++){
-      
-        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, aig_parts.at(i));
-        mockturtle::depth_view part_depth{part};
+        if(optimized_parts.count(aig_parts.at(i)))
+          continue;
 
-        auto opt_part = *part_to_mig(part, 1);
-        auto opt = *mig_to_aig(opt_part);
+        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, aig_parts.at(i));
 
-        mockturtle::depth_view opt_part_depth{opt};
+        auto opt = extractor.extract<mockturtle::aig_network>(part);
 
         oracle::aig_script aigopt;
         opt = aigopt.run(opt);
 
-        auto opt_mig = *aig_to_mig(opt, 0);
-
-        partitions_mig.synchronize_part(part, opt_mig, ntk_mig);
+        checker.add(part, integrator, opt, [&](){
+          auto retry = extractor.extract<mockturtle::mig_network>(part);
+          oracle::mig_script migopt;
+          return migopt.run(retry);
+        });
       }
       
       for(int i = 0; i < mig_parts.size(); i++){
-        
-        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, mig_parts.at(i));
-        mockturtle::depth_view part_depth{part};
+        if(optimized_parts.count(mig_parts.at(i)))
+          continue;
 
-        auto opt = *part_to_mig(part, 0);
+        oracle::partition_view<mig_names> part = partitions_mig.create_part(ntk_mig, mig_parts.at(i));
 
-        mockturtle::depth_view opt_part_depth{opt};
+        auto opt = extractor.extract<mockturtle::mig_network>(part);
         
         oracle::mig_script migopt;
         opt = migopt.run(opt);
-        
-        mockturtle::depth_view part_opt_depth{opt};
 
-        partitions_mig.synchronize_part(part, opt, ntk_mig);
+        checker.add(part, integrator, opt, [&](){
+          auto retry = extractor.extract<mockturtle::aig_network>(part);
+          oracle::aig_script aigopt;
+          return aigopt.run(retry);
+        });
       }
     }
+    checker.report();
     
-    partitions_mig.connect_outputs(ntk_mig);
-    
-    ntk_mig = mockturtle::cleanup_dangling( ntk_mig );
+    stage.next("rebuild");
+    ntk_mig = integrator.rebuild(ntk_mig);
 
     return ntk_mig;
   }
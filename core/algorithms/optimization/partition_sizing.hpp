@@ -0,0 +1,254 @@
+#include <mockturtle/mockturtle.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oracle{
+
+  struct partition_sizing_params{
+    /* Gate counts of the sampled windows */
+    std::vector<uint32_t> sample_sizes{64, 128, 256, 512, 1024};
+    /* Windows sampled per size */
+    uint32_t samples_per_size{2u};
+    /* Range of partition sizes considered when choosing k */
+    uint32_t min_partition_size{50u};
+    uint32_t max_partition_size{4000u};
+    /* Threads available to the run, 0 uses available_threads() */
+    uint32_t num_threads{0u};
+    /* Partitioner the run uses, sampled at several numbers of partitions */
+    std::string backend{"kahypar"};
+    partitioner_params partitioning;
+    /* Scripts a partition may be optimized with */
+    bool run_aig{true};
+    bool run_mig{true};
+    /* Whether every partition runs both of them (high effort, dual candidates)
+       or only the one it is classified for, costed as the slower one. The
+       dual candidates run the two scripts at the same time if there are at
+       least two threads, partitions are optimized one after the other. */
+    bool run_both{true};
+    /* If non-zero, reject partition sizes whose predicted gate reduction is
+       below this fraction of the best reduction seen while sampling */
+    double qor_floor{0.0};
+    bool verbose{false};
+  };
+
+  struct partition_sizing_result{
+    int num_partitions{1};
+    double partition_size{0.0};
+    double predicted_partitioning_ms{0.0};
+    double predicted_optimization_ms{0.0};
+    double predicted_total_ms() const { return predicted_partitioning_ms + predicted_optimization_ms; }
+  };
+
+  /* t(s) = a * s^b, fit by least squares in log-log space */
+  struct power_law_model{
+    double a{0.0};
+    double b{1.0};
+
+    void fit(std::vector<double> const& x, std::vector<double> const& y){
+      double sx = 0, sy = 0, sxx = 0, sxy = 0;
+      const double n = x.size();
+      for(int i = 0; i < x.size(); i++){
+        const double lx = std::log(x[i]);
+        const double ly = std::log(std::max(y[i], 1e-3));
+        sx += lx; sy += ly; sxx += lx * lx; sxy += lx * ly;
+      }
+      const double den = n * sxx - sx * sx;
+      b = den != 0 ? (n * sxy - sx * sy) / den : 1.0;
+      a = std::exp((sy - b * sx) / n);
+    }
+
+    double operator()(double s) const { return a * std::pow(s, b); }
+  };
+
+  /* Copies the gates with index in [begin, end) into a standalone network.
+     Fanins from outside the window become inputs, and gates that are used
+     outside the window (or not used at all inside it) become outputs. */
+  template<class NtkDest, class Ntk>
+  NtkDest sample_window(Ntk const& ntk, uint64_t begin, uint64_t end){
+    NtkDest dest;
+    std::vector<typename NtkDest::signal> old_to_new(end - begin);
+    std::vector<bool> mapped(end - begin, false);
+    std::vector<uint32_t> inner_fanout(end - begin, 0u);
+    std::unordered_map<uint64_t, typename NtkDest::signal> inputs;
+
+    const auto get = [&](auto const& f){
+      const auto n = ntk.get_node(f);
+      typename NtkDest::signal s;
+      if(ntk.is_constant(n)){
+        s = dest.get_constant(false);
+      }
+      else if(n >= begin && n < end && mapped[n - begin]){
+        s = old_to_new[n - begin];
+        inner_fanout[n - begin]++;
+      }
+      else{
+        auto it = inputs.find(n);
+        if(it == inputs.end())
+          it = inputs.emplace(n, dest.create_pi()).first;
+        s = it->second;
+      }
+      return ntk.is_complemented(f) ? dest.create_not(s) : s;
+    };
+
+    for(auto n = begin; n < end; n++){
+      if(ntk.is_constant(n) || ntk.is_ci(n))
+        continue;
+      std::vector<typename NtkDest::signal> children;
+      ntk.foreach_fanin(n, [&](auto const& f){
+        children.push_back(get(f));
+      });
+      if(children.size() == 3)
+        old_to_new[n - begin] = dest.create_maj(children[0], children[1], children[2]);
+      else
+        old_to_new[n - begin] = dest.create_and(children[0], children[1]);
+      mapped[n - begin] = true;
+    }
+
+    for(auto n = begin; n < end; n++){
+      if(mapped[n - begin] && (inner_fanout[n - begin] == 0 || inner_fanout[n - begin] < ntk.fanout_size(n)))
+        dest.create_po(old_to_new[n - begin]);
+    }
+    return dest;
+  }
+
+  /* Measures aig_script, mig_script and the partitioner on windows of the
+     network and picks the number of partitions that minimizes the predicted
+     wall-clock time of partitioning plus optimization. */
+  template<class Ntk>
+  partition_sizing_result estimate_partition_count(Ntk const& ntk, partition_sizing_params const& ps = {}){
+    using clock = std::chrono::high_resolution_clock;
+    const auto elapsed_ms = [](auto start){
+      return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    partition_sizing_result result;
+    const uint64_t first_gate = ntk.num_pis() + 1;
+    const uint64_t num_gates = ntk.size() - first_gate;
+    if(num_gates <= ps.min_partition_size){
+      result.partition_size = num_gates;
+      return result;
+    }
+
+    /* sample both optimization scripts */
+    std::vector<double> sizes, aig_ms, mig_ms, sizes_qor, qor;
+    for(auto size : ps.sample_sizes){
+      if(size > num_gates)
+        break;
+      for(uint32_t r = 0; r < ps.samples_per_size; r++){
+        const uint64_t begin = first_gate + (num_gates - size) * (r + 1) / (ps.samples_per_size + 1);
+        auto sample_aig = sample_window<mockturtle::aig_network>(ntk, begin, begin + size);
+        auto sample_mig = sample_window<mockturtle::mig_network>(ntk, begin, begin + size);
+        const double orig_gates = sample_aig.num_gates();
+        if(orig_gates == 0)
+          continue;
+
+        auto start = clock::now();
+        oracle::aig_script aigopt;
+        sample_aig = aigopt.run(sample_aig);
+        aig_ms.push_back(elapsed_ms(start));
+
+        start = clock::now();
+        oracle::mig_script migopt;
+        sample_mig = migopt.run(sample_mig);
+        mig_ms.push_back(elapsed_ms(start));
+
+        sizes.push_back(orig_gates);
+        qor.push_back(1.0 - std::min(sample_aig.num_gates(), sample_mig.num_gates()) / orig_gates);
+
+        if(ps.verbose)
+          std::cout << "Sample of " << orig_gates << " gates: aig_script " << aig_ms.back() << "ms, mig_script "
+                    << mig_ms.back() << "ms, gate reduction " << qor.back() << "\n";
+      }
+    }
+    if(sizes.size() < 2){
+      result.partition_size = num_gates;
+      return result;
+    }
+
+    power_law_model aig_model, mig_model;
+    aig_model.fit(sizes, aig_ms);
+    mig_model.fit(sizes, mig_ms);
+
+    const uint32_t threads = ps.num_threads ? ps.num_threads : available_threads();
+
+    /* sample the partitioner on a larger window at several values of k, and
+       model its time as linear in the network size and a power of k; a
+       partition file costs nothing */
+    const uint64_t kp_size = std::min<uint64_t>(num_gates, 4 * ps.sample_sizes.back());
+    const uint64_t kp_begin = first_gate + (num_gates - kp_size) / 2;
+    mockturtle::names_view<mockturtle::aig_network> kp_sample{sample_window<mockturtle::aig_network>(ntk, kp_begin, kp_begin + kp_size)};
+    std::vector<double> kp_k, kp_ms;
+    auto kp_ps = ps.partitioning;
+    kp_ps.num_threads = threads;
+    for(int k = 2; k <= 32 && kp_size / k >= ps.min_partition_size && ps.backend != "file"; k *= 4){
+      kp_ps.num_partitions = k;
+      auto start = clock::now();
+      if(!run_partitioner(ps.backend, kp_sample, kp_ps).valid())
+        break;
+      kp_ms.push_back(elapsed_ms(start));
+      kp_k.push_back(k);
+    }
+    power_law_model kp_model;
+    if(kp_k.size() >= 2)
+      kp_model.fit(kp_k, kp_ms);
+    else if(!kp_k.empty())
+      kp_model.a = kp_ms[0] / kp_k[0];
+    const double kp_scale = static_cast<double>(ntk.size()) / kp_sample.size();
+    const auto kahypar_ms = [&](int k){
+      return k <= 1 ? 0.0 : kp_scale * kp_model(k);
+    };
+
+    const double best_qor = *std::max_element(qor.begin(), qor.end());
+    const auto predicted_qor = [&](double s){
+      /* piecewise linear interpolation over log size */
+      std::vector<int> order(sizes.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](int x, int y){ return sizes[x] < sizes[y]; });
+      if(s <= sizes[order.front()])
+        return qor[order.front()];
+      for(int i = 1; i < order.size(); i++){
+        const double s0 = sizes[order[i - 1]], s1 = sizes[order[i]];
+        if(s <= s1){
+          const double t = s1 > s0 ? (std::log(s) - std::log(s0)) / (std::log(s1) - std::log(s0)) : 1.0;
+          return qor[order[i - 1]] + t * (qor[order[i]] - qor[order[i - 1]]);
+        }
+      }
+      return qor[order.back()];
+    };
+
+    bool found = false;
+    for(double s = ps.min_partition_size; s <= std::min<double>(ps.max_partition_size, num_gates) * 1.0001; s *= 1.1){
+      const int k = std::max(1, static_cast<int>(std::ceil(num_gates / s)));
+      const double part_size = static_cast<double>(num_gates) / k;
+      if(ps.qor_floor > 0 && predicted_qor(part_size) < ps.qor_floor * best_qor)
+        continue;
+
+      const double aig_ms = ps.run_aig ? aig_model(part_size) : 0.0;
+      const double mig_ms = ps.run_mig ? mig_model(part_size) : 0.0;
+      const double per_part = ps.run_both && threads < 2 ? aig_ms + mig_ms : std::max(aig_ms, mig_ms);
+      const double opt_ms = k * per_part;
+      const double part_ms = kahypar_ms(k);
+      if(!found || part_ms + opt_ms < result.predicted_total_ms()){
+        found = true;
+        result.num_partitions = k;
+        result.partition_size = part_size;
+        result.predicted_partitioning_ms = part_ms;
+        result.predicted_optimization_ms = opt_ms;
+      }
+    }
+
+    if(ps.verbose){
+      std::cout << "aig_script model: " << aig_model.a << " * s^" << aig_model.b << " ms\n";
+      std::cout << "mig_script model: " << mig_model.a << " * s^" << mig_model.b << " ms\n";
+      std::cout << ps.backend << " model: " << kp_scale << " * " << kp_model.a << " * k^" << kp_model.b << " ms\n";
+    }
+    return result;
+  }
+}
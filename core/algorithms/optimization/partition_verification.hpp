@@ -0,0 +1,139 @@
+#include <mockturtle/mockturtle.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+
+namespace oracle{
+
+  /* Checks an optimized partition against the logic it replaces. Partitions
+     with up to exhaustive_limit inputs are simulated exhaustively, larger
+     ones are proved by SAT sweeping. */
+  template<class NtkSpec, class NtkImpl>
+  bool verify_partition(NtkSpec const& spec, NtkImpl const& impl, uint32_t exhaustive_limit = 16u){
+    if(spec.num_pis() != impl.num_pis() || spec.num_pos() != impl.num_pos())
+      return false;
+
+    if(spec.num_pis() <= exhaustive_limit){
+      mockturtle::bit_parallel_simulation_params ps;
+      ps.block_size = std::min<uint32_t>(1u << spec.num_pis(), 4096u);
+      mockturtle::bit_parallel_simulator<NtkSpec> sim_spec(spec, ps);
+      mockturtle::bit_parallel_simulator<NtkImpl> sim_impl(impl, ps);
+      for(uint64_t b = 0; b < sim_spec.num_exhaustive_blocks(); b++){
+        sim_spec.fill_exhaustive(b);
+        sim_impl.fill_exhaustive(b);
+        sim_spec.simulate();
+        sim_impl.simulate();
+        for(uint32_t o = 0; o < spec.num_pos(); o++){
+          if(!std::equal(sim_spec.output(o), sim_spec.output(o) + sim_spec.words(), sim_impl.output(o)))
+            return false;
+        }
+      }
+      return true;
+    }
+
+    const auto result = mockturtle::sweeping_equivalence_checking(spec, impl);
+    return result && *result;
+  }
+
+  /* AIG of the logic a partition view covers, built from the view's own
+     inputs, nodes and roots rather than by partition_extractor, so that the
+     checks against it also catch extraction errors (input or output order,
+     dropped logic). The nodes of a view are in topological order. */
+  template<class Part>
+  mockturtle::aig_network partition_reference(Part const& part){
+    using aig_signal = mockturtle::aig_network::signal;
+    mockturtle::aig_network ref;
+    std::unordered_map<typename Part::node, aig_signal> node_to_ref;
+    const auto fanin = [&](auto const& f){
+      const auto s = node_to_ref.at(part.get_node(f));
+      return part.is_complemented(f) ? ref.create_not(s) : s;
+    };
+
+    part.foreach_pi([&](auto n){
+      node_to_ref[n] = ref.create_pi();
+    });
+    part.foreach_node([&](auto n){
+      if(part.is_constant(n)){
+        node_to_ref[n] = ref.get_constant(part.constant_value(n));
+        return;
+      }
+      if(node_to_ref.count(n))
+        return;
+      std::vector<aig_signal> fanins;
+      part.foreach_fanin(n, [&](auto const& f){
+        fanins.push_back(fanin(f));
+      });
+      if(fanins.size() == 3u)
+        node_to_ref[n] = ref.create_maj(fanins[0], fanins[1], fanins[2]);
+      else if(part.is_xor(n))
+        node_to_ref[n] = ref.create_xor(fanins[0], fanins[1]);
+      else
+        node_to_ref[n] = ref.create_and(fanins[0], fanins[1]);
+    });
+    part.foreach_po([&](auto const& f){
+      ref.create_po(fanin(f));
+    });
+    return ref;
+  }
+
+  /* Verify mode of the partition optimization flows: every optimized
+     partition is checked against its original logic before it is handed to
+     the integrator. */
+  class partition_checker{
+  public:
+    explicit partition_checker(bool enabled) : enabled(enabled){}
+
+    bool is_enabled() const { return enabled; }
+
+    /* Integrates opt if it is equivalent to the partition, otherwise the
+       result of retry() if that one is, and keeps the original logic of the
+       partition if neither is. */
+    template<class Part, class Integrator, class NtkOpt, class Retry>
+    void add(Part const& part, Integrator& integrator, NtkOpt const& opt, Retry&& retry){
+      oracle::profile_scope stage("integration");
+      if(!enabled){
+        integrator.add(part, opt);
+        return;
+      }
+      stage.next("verification");
+      const auto reference = partition_reference(part);
+      if(verify_partition(reference, opt)){
+        record(true, true);
+        stage.next("integration");
+        integrator.add(part, opt);
+        return;
+      }
+      stage.next("retry");
+      const auto other = retry();
+      stage.next("verification");
+      const bool accepted = verify_partition(reference, other);
+      record(false, accepted);
+      stage.next("integration");
+      if(accepted)
+        integrator.add(part, other);
+    }
+
+    void record(bool passed, bool accepted){
+      checked++;
+      failed += passed ? 0 : 1;
+      rejected += accepted ? 0 : 1;
+    }
+
+    void report() const{
+      if(!enabled)
+        return;
+      std::cout << checked << " partitions verified, " << failed << " failed";
+      if(failed > 0)
+        std::cout << " (" << failed - rejected << " recovered by the other script, " << rejected << " kept as original logic)";
+      std::cout << "\n";
+    }
+
+  private:
+    bool enabled;
+    int checked{0};
+    int failed{0};
+    int rejected{0};
+  };
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace oracle{
+
+  /* Single-file dataset of k-map images.
+
+     The file is a 64 byte header followed by fixed-size records, all little
+     endian.  The number of records is not stored, it is
+     (file size - header_size) / record_size, so the file can be appended to
+     by later runs and read while it is still being written.
+
+     header:  char     magic[8]      "LSOKMAP\0"
+              uint32_t version       1
+              uint32_t header_size   64
+              uint32_t record_size   32 + image_rows * image_cols
+              uint32_t image_rows    256
+              uint32_t image_cols    256
+              (zero padding)
+
+     record:  int32_t  label         -1 unlabelled, 0 AIG, 1 MIG
+              uint32_t partition
+              uint32_t output        node index of the cone output
+              uint32_t num_inputs
+              uint32_t level         depth of the cone in its partition
+              (12 bytes zero padding)
+              uint8_t  image[image_rows][image_cols]
+
+     Image pixels are 0 for the off-set, 2 for the on-set and 1 for the
+     padding around maps of fewer than 16 inputs.  Compressed datasets are a
+     sequence of zstd frames that decompress to exactly this layout. */
+
+  constexpr char kmap_dataset_magic[8] = {'L', 'S', 'O', 'K', 'M', 'A', 'P', '\0'};
+  constexpr uint32_t kmap_dataset_version = 1u;
+  constexpr uint32_t kmap_image_rows = 256u;
+  constexpr uint32_t kmap_image_cols = 256u;
+  constexpr uint32_t kmap_image_size = kmap_image_rows * kmap_image_cols;
+
+  struct kmap_dataset_header{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    uint32_t image_rows;
+    uint32_t image_cols;
+    uint8_t reserved[36];
+  };
+  static_assert(sizeof(kmap_dataset_header) == 64, "k-map dataset header must be 64 bytes");
+
+  struct kmap_record{
+    int32_t label{-1};
+    uint32_t partition{0u};
+    uint32_t output{0u};
+    uint32_t num_inputs{0u};
+    uint32_t level{0u};
+    uint8_t reserved[12]{};
+  };
+  static_assert(sizeof(kmap_record) == 32, "k-map record metadata must be 32 bytes");
+
+  constexpr uint32_t kmap_record_size = sizeof(kmap_record) + kmap_image_size;
+
+  struct kmap_dataset_params{
+    /* Write zstd frames, needs a build with ENABLE_ZSTD */
+    bool compress{false};
+    int compression_level{3};
+    /* Records buffered before they are written */
+    uint32_t buffered_records{16u};
+  };
+
+  inline bool zstd_available(){
+#if defined ENABLE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /* Appends records to a k-map dataset, creating it with its header if the
+     file does not exist yet.  A partial record at the end of an existing
+     uncompressed dataset, left by a run that was killed, is cut off.  Errors
+     are reported on std::cerr and make good() return false. */
+  class kmap_dataset_writer{
+  public:
+    explicit kmap_dataset_writer(std::string const& filename, kmap_dataset_params const& ps = {})
+        : _ps(ps){
+      if(_ps.compress && !zstd_available()){
+        std::cerr << "[e] lsoracle was built without zstd, cannot compress " << filename << "\n";
+        return;
+      }
+      if(!open_existing(filename))
+        return;
+
+      _os.open(filename, std::ios::out | std::ios::binary | std::ios::app);
+      if(!_os){
+        std::cerr << "[e] could not open " << filename << "\n";
+        return;
+      }
+#if defined ENABLE_ZSTD
+      if(_ps.compress){
+        _cctx = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(_cctx, ZSTD_c_compressionLevel, _ps.compression_level);
+        ZSTD_CCtx_setParameter(_cctx, ZSTD_c_checksumFlag, 1);
+        _compressed.resize(ZSTD_CStreamOutSize());
+      }
+#endif
+      _good = true;
+      _buffer.reserve(static_cast<std::size_t>(_ps.buffered_records) * kmap_record_size + sizeof(kmap_dataset_header));
+      if(_write_header){
+        kmap_dataset_header header{};
+        std::memcpy(header.magic, kmap_dataset_magic, sizeof(header.magic));
+        header.version = kmap_dataset_version;
+        header.header_size = sizeof(kmap_dataset_header);
+        header.record_size = kmap_record_size;
+        header.image_rows = kmap_image_rows;
+        header.image_cols = kmap_image_cols;
+        append(&header, sizeof(header));
+      }
+    }
+
+    kmap_dataset_writer(kmap_dataset_writer const&) = delete;
+    kmap_dataset_writer& operator=(kmap_dataset_writer const&) = delete;
+
+    ~kmap_dataset_writer(){
+      close();
+    }
+
+    bool good() const { return _good; }
+
+    /* Records in the file, including those of earlier runs (unknown for an
+       existing compressed dataset, only the new ones are counted) */
+    uint64_t num_records() const { return _num_records; }
+
+    /* `image` holds kmap_image_size pixels, row by row */
+    void write(kmap_record const& record, uint8_t const* image){
+      if(!_good)
+        return;
+      append(&record, sizeof(record));
+      append(image, kmap_image_size);
+      ++_num_records;
+      if(_buffer.size() >= static_cast<std::size_t>(_ps.buffered_records) * kmap_record_size)
+        write_buffer(false);
+    }
+
+    /* Makes all records written so far durable in the file; a compressed
+       dataset ends its current zstd frame */
+    void flush(){
+      if(!_good)
+        return;
+      write_buffer(true);
+      _os.flush();
+      if(!_os)
+        _good = false;
+    }
+
+    void close(){
+      if(!_os.is_open())
+        return;
+      flush();
+      _os.close();
+#if defined ENABLE_ZSTD
+      ZSTD_freeCCtx(_cctx);
+      _cctx = nullptr;
+#endif
+    }
+
+  private:
+    bool open_existing(std::string const& filename){
+      std::error_code ec;
+      const auto size = std::filesystem::file_size(filename, ec);
+      if(ec || size == 0u){
+        _write_header = true;
+        return true;
+      }
+
+      char magic[8]{};
+      std::ifstream is(filename, std::ios::in | std::ios::binary);
+      is.read(magic, sizeof(magic));
+      const bool is_zstd = is.gcount() >= 4 && static_cast<uint8_t>(magic[0]) == 0x28u && static_cast<uint8_t>(magic[1]) == 0xb5u &&
+                           static_cast<uint8_t>(magic[2]) == 0x2fu && static_cast<uint8_t>(magic[3]) == 0xfdu;
+      if(_ps.compress){
+        if(!is_zstd){
+          std::cerr << "[e] " << filename << " is not a compressed k-map dataset\n";
+          return false;
+        }
+        /* new records go into new frames, the header is already there */
+        return true;
+      }
+
+      kmap_dataset_header header{};
+      is.seekg(0);
+      is.read(reinterpret_cast<char*>(&header), sizeof(header));
+      if(is.gcount() != sizeof(header) || std::memcmp(header.magic, kmap_dataset_magic, sizeof(header.magic)) != 0){
+        std::cerr << "[e] " << filename << (is_zstd ? " is a compressed k-map dataset\n" : " is not a k-map dataset\n");
+        return false;
+      }
+      if(header.version != kmap_dataset_version || header.record_size != kmap_record_size ||
+         header.image_rows != kmap_image_rows || header.image_cols != kmap_image_cols){
+        std::cerr << "[e] " << filename << " has an incompatible k-map dataset layout\n";
+        return false;
+      }
+      is.close();
+
+      _num_records = (size - header.header_size) / header.record_size;
+      const auto complete = header.header_size + _num_records * header.record_size;
+      if(complete != size){
+        std::cerr << "[w] dropping a partial record at the end of " << filename << "\n";
+        std::filesystem::resize_file(filename, complete, ec);
+        if(ec){
+          std::cerr << "[e] could not truncate " << filename << ": " << ec.message() << "\n";
+          return false;
+        }
+      }
+      return true;
+    }
+
+    void append(void const* data, std::size_t size){
+      auto const* bytes = static_cast<char const*>(data);
+      _buffer.insert(_buffer.end(), bytes, bytes + size);
+    }
+
+    void write_buffer(bool end_frame){
+      if(!_ps.compress){
+        _os.write(_buffer.data(), _buffer.size());
+        _buffer.clear();
+        if(!_os)
+          _good = false;
+        return;
+      }
+#if defined ENABLE_ZSTD
+      if(_buffer.empty() && !_frame_open)
+        return;
+      ZSTD_inBuffer in{_buffer.data(), _buffer.size(), 0};
+      const auto mode = end_frame ? ZSTD_e_end : ZSTD_e_continue;
+      for(;;){
+        ZSTD_outBuffer out{_compressed.data(), _compressed.size(), 0};
+        const auto remaining = ZSTD_compressStream2(_cctx, &out, &in, mode);
+        if(ZSTD_isError(remaining)){
+          std::cerr << "[e] zstd: " << ZSTD_getErrorName(remaining) << "\n";
+          _good = false;
+          return;
+        }
+        _os.write(_compressed.data(), out.pos);
+        if(mode == ZSTD_e_end ? remaining == 0u : in.pos == in.size)
+          break;
+      }
+      _frame_open = !end_frame;
+      _buffer.clear();
+      if(!_os)
+        _good = false;
+#endif
+    }
+
+  private:
+    kmap_dataset_params _ps;
+    std::ofstream _os;
+    std::vector<char> _buffer;
+    uint64_t _num_records{0u};
+    bool _write_header{false};
+    bool _good{false};
+#if defined ENABLE_ZSTD
+    ZSTD_CCtx* _cctx{nullptr};
+    std::vector<char> _compressed;
+    bool _frame_open{false};
+#endif
+  };
+
+} // namespace oracle
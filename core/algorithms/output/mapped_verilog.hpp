@@ -42,11 +42,13 @@ endmodule
 #include <stdlib.h>
 #include <fstream>
 #include <iostream>
+#include <regex>
 #include <string>
+#include <unordered_map>
 #include <algorithm>
 
-#include <fmt/format.h>
 #include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/utils/output_buffer.hpp>
 #include <mockturtle/utils/string_utils.hpp>
 #include <kitty/operations.hpp>
 #include <kitty/print.hpp>
@@ -56,139 +58,149 @@ endmodule
 namespace oracle
 {
 
+/* Pin names of a cell, the AOI/OAI cells of the library name their pins
+   after the digits in the cell name */
+inline std::vector<std::string> cell_port_names(std::string const& cell_name)
+{
+    std::vector<std::string> port_names;
+    if(regex_match(cell_name, std::regex("[AOIx123]{6}.+"))){
+        std::string working_name = cell_name;
+        working_name.erase(std::remove_if(working_name.begin(), working_name.end(), [](char c) { return !std::isdigit(c);}), working_name.end());
+        if (working_name.at(0) == '2'){
+            port_names.push_back("A1");
+            port_names.push_back("A2");
+        } else if (working_name.at(0) == '3'){
+            port_names.push_back("A1");
+            port_names.push_back("A2");
+            port_names.push_back("A3");
+        }
+        if (working_name.at(1)  == '1'){
+            port_names.push_back("B");
+        } else if (working_name.at(1) == '2'){
+            port_names.push_back("B1");
+            port_names.push_back("B2");
+        } else if (working_name.at(1)  == '3'){
+            port_names.push_back("B1");
+            port_names.push_back("B2");
+            port_names.push_back("B3");
+        }
+        if (working_name.at(2)  == '1'){
+            port_names.push_back("C");
+        }
+    } else {
+        port_names.push_back("A");
+        port_names.push_back("B");
+        port_names.push_back("C");
+        port_names.push_back("D");
+    }
+    return port_names;
+}
 
 template<class Ntk>
-void write_techmapped_verilog( Ntk const& ntk, std::ostream& os, std::unordered_map<int, std::string> cell_names, std::string top_name )
+void write_techmapped_verilog( Ntk const& ntk, mockturtle::output_buffer& out, std::unordered_map<int, std::string> const& cell_names, std::string const& top_name )
 {
-    int netlistcount;
-    std::string input_list;
-    std::string output_list;
-    std::string wire_list;
-    std::string po_assignments;
-    auto first = true; 
-    ntk.foreach_pi( [&]( auto const& n ) {
+    const auto put_list = [&](auto&& foreach, auto&& put){
+        auto first = true;
+        foreach([&](auto const& x){
             if (first)
                 first = false;
             else
-                input_list += ", ";
-            input_list += fmt::format("n{}", ntk.node_to_index( n ) );
+                out << ", ";
+            put(x);
+        });
+    };
+    const auto put_inputs = [&](){
+        put_list([&](auto&& fn){ ntk.foreach_pi([&](auto const& n){ fn(n); }); },
+                 [&](auto const& n){ out << 'n'; out.append_uint(ntk.node_to_index(n)); });
+    };
+    const auto put_outputs = [&](){
+        put_list([&](auto&& fn){ ntk.foreach_po([&](auto const&, auto i){ fn(i); }); },
+                 [&](auto i){ out << "po"; out.append_uint(i); });
+    };
+
+    out << "module " << top_name << '(';
+    put_inputs();
+    out << ", ";
+    put_outputs();
+    out << ");\n\tinput ";
+    put_inputs();
+    out << ";\n\toutput ";
+    put_outputs();
+    out << ";\n\twire ";
+    put_list([&](auto&& fn){
+        ntk.foreach_node([&](auto const& n){
+            if (!ntk.is_pi(n) && !ntk.is_constant(n) && cell_names.find(n) != cell_names.end())
+                fn(n);
+        });
+    }, [&](auto const& n){ out << 'n'; out.append_uint(n); });
+    out << ";\n\n";
+//body
 
-    });
+    /* the pin names only depend on the cell */
+    std::unordered_map<std::string, std::vector<std::string>> ports;
+    ntk.foreach_node( [&]( auto const& n ) {
+        const auto cell = cell_names.find(n);
+        if (cell == cell_names.end())
+            return;
 
-    first = true;
-    ntk.foreach_po( [&]( auto const& n, auto i ) {
-            if (first)
-                first = false;
-            else
-                output_list += ", ";
-            output_list += fmt::format("po{}", i);
-            if ( ntk.is_constant( ntk.get_node( n ) ) ){
-                po_assignments += fmt::format( "\tassign po{} = {};\n", i, ntk.is_complemented( n ) ? "1'b1" : "1'b0" );
+        auto port_names = ports.find(cell->second);
+        if (port_names == ports.end())
+            port_names = ports.emplace(cell->second, cell_port_names(cell->second)).first;
+
+        out << '\t' << cell->second << ' ';
+        ntk.foreach_fanin( n, [&]( auto fanin, auto i ) {
+            if (i == 0){
+                out << 'g';
+                out.append_uint(n) << "(.";
+            } else if (i < 6){
+                out << ", .";
             } else {
-                po_assignments += fmt::format("\tassign po{} = n{};\n", i, n);
+                return;
             }
-    });
-    
-    first = true;
-    ntk.foreach_node ( [&](auto const& n){
-        if (ntk.is_pi(n) || ntk.is_constant( n)){
-            return;
-        }
-        if(cell_names.find(n) != cell_names.end()){
-            if (first)
-                first = false;
-            else
-                wire_list += ", ";
-            wire_list += fmt::format("n{}", n);
-        }
-    });
-
-    os << "module " << top_name <<"("<<input_list <<", " << output_list<< ");\n";
-    os << "\tinput " << input_list<< ";\n";
-    os << "\toutput " << output_list << ";\n";
-    os << "\twire "<< wire_list << ";\n\n";
-//body
-
-    ntk.foreach_node( [&]( auto const& n ) {
-                int flag = 0;
-
-        if (cell_names.find(n) != cell_names.end()){
-            std::vector <std::string> children;
-            std::vector <std::string> port_names;
-            if(regex_match(cell_names.at(n), std::regex("[AOIx123]{6}.+"))){
-                std::string working_name = cell_names.at(n);
-                working_name.erase(std::remove_if(working_name.begin(), working_name.end(), [](char c) { return !std::isdigit(c);}), working_name.end());
-                if (working_name.at(0) == '2'){
-                    port_names.push_back("A1");
-                    port_names.push_back("A2");
-                } else if (working_name.at(0) == '3'){
-                    port_names.push_back("A1");
-                    port_names.push_back("A2");
-                    port_names.push_back("A3");
-                }
-                if (working_name.at(1)  == '1'){
-                    port_names.push_back("B");
-                } else if (working_name.at(1) == '2'){
-                    port_names.push_back("B1");
-                    port_names.push_back("B2");
-                } else if (working_name.at(1)  == '3'){
-                    port_names.push_back("B1");
-                    port_names.push_back("B2");
-                    port_names.push_back("B3");
-                }
-                if (working_name.at(2)  == '1'){
-                    port_names.push_back("C");
-                }
+            out << port_names->second.at(i) << '(';
+            //handle constants in fanin
+            if (fanin == 0){
+                out << "1'b0";
+            } else if (fanin == 1){
+                out << "1'b1";
             } else {
-                port_names.push_back("A");
-                port_names.push_back("B");
-                port_names.push_back("C");
-                port_names.push_back("D");
+                out << 'n';
+                out.append_uint(fanin);
             }
-            // populate children, which will be function inputs
-            ntk.foreach_fanin( n, [&]( auto fanin ) {
-                //handle constants in fanin
-                if (fanin == 0){
-                    children.push_back("1'b0");
-                } else if (fanin == 1){
-                    children.push_back("1'b1");
-                } else {
-                    children.push_back(fmt::format( "n{}",fanin ));
-                }
-            } );
-            os << "\t" << cell_names.at(n) << " "; 
-                if(children.size() > 0){       
-                    os << fmt::format("g{}", n) << "(." << port_names.at(0) << "(" << children.at(0) << ")";
-                }
-                if (children.size() > 1){
-                    os << ", ." <<port_names.at(1)<<"(" << children.at(1) << ")";
-                }
-                if (children.size() > 2){
-                    os << ", ."<<port_names.at(2)<<"(" << children.at(2) << ")";
-                }
-                if (children.size() > 3){
-                    os << ", ."<<port_names.at(3)<<"(" << children.at(3) << ")";
-                }
-                if (children.size() > 4){
-                    os << ", ."<<port_names.at(4)<<"(" << children.at(4) << ")";
-                }
-                if (children.size() > 5){
-                    os << ", ."<<port_names.at(5)<<"(" << children.at(5) << ")";
-                }
-                os << ", .Y(" << fmt::format("n{}",n) << ") );\n";
-     }
+            out << ')';
+        } );
+        out << ", .Y(n";
+        out.append_uint(n) << ") );\n";
     } );
-    os << po_assignments;
-    os << "endmodule\n";
+
+    ntk.foreach_po( [&]( auto const& n, auto i ) {
+        out << "\tassign po";
+        out.append_uint(i) << " = ";
+        if ( ntk.is_constant( ntk.get_node( n ) ) ){
+            out << ( ntk.is_complemented( n ) ? "1'b1" : "1'b0" );
+        } else {
+            out << 'n';
+            out.append_uint(n);
+        }
+        out << ";\n";
+    });
+    out << "endmodule\n";
+    out.flush();
+}
+
+template<class Ntk>
+void write_techmapped_verilog( Ntk const& ntk, std::ostream& os, std::unordered_map<int, std::string> const& cell_names, std::string const& top_name )
+{
+    mockturtle::output_buffer out( os );
+    write_techmapped_verilog( ntk, out, cell_names, top_name );
 }
 
 //file version
 template<class Ntk>
-void write_techmapped_verilog( Ntk const& ntk, std::string const& filename, std::unordered_map<int, std::string> cell_names, std::string top_name )
+void write_techmapped_verilog( Ntk const& ntk, std::string const& filename, std::unordered_map<int, std::string> const& cell_names, std::string const& top_name )
 {
-      std::ofstream os( filename.c_str(), std::ofstream::out );
-      write_techmapped_verilog( ntk, os, cell_names, top_name );
-      os.close();
+    mockturtle::output_buffer out( filename );
+    write_techmapped_verilog( ntk, out, cell_names, top_name );
 }
 
-}
\ No newline at end of file
+}
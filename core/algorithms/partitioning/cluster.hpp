@@ -61,6 +61,9 @@ namespace oracle
 
     cluster( Ntk const& ntk ) : Ntk( ntk ){}
 
+    /* Shares the fanouts of `fanout` instead of computing them for each query */
+    cluster( Ntk const& ntk, mockturtle::fanout_view<Ntk> const& fanout ) : Ntk( ntk ), _fanout( &fanout ){}
+
     int size(){
       return nodes.size();
     }
@@ -102,8 +105,7 @@ namespace oracle
         if(inputs.find(node2add) != inputs.end()){
           inputs.erase(node2add);
         }
-        mockturtle::fanout_view fanout{ntk};
-        fanout.foreach_fanout(node2add, [&](const auto& p){
+        foreach_fanout(ntk, node2add, [&](const auto& p){
           if(nodes.find(p) == nodes.end() && outputs.find(p) == outputs.end()){
             outputs.insert(p);
           }
@@ -123,8 +125,7 @@ namespace oracle
 
     int num_intersec( Ntk const& ntk, node node2add ){
       int num_intersec_nets = 0;
-      mockturtle::fanout_view fanout{ntk};
-      fanout.foreach_fanout(node2add, [&](const auto& p){
+      foreach_fanout(ntk, node2add, [&](const auto& p){
         if(nodes.find(p) != nodes.end()){
           num_intersec_nets++;
         }
@@ -141,8 +142,7 @@ namespace oracle
 
     int num_intersec( Ntk const& ntk, node output, std::vector<node> inputs ){
       int num_intersec_nets = 0;
-      mockturtle::fanout_view fanout{ntk};
-      fanout.foreach_fanout(output, [&](const auto& p){
+      foreach_fanout(ntk, output, [&](const auto& p){
         if(nodes.find(p) != nodes.end()){
           num_intersec_nets++;
         }
@@ -160,9 +160,8 @@ namespace oracle
       return num_intersec_nets;
     }
 
-    std::set<node> get_conn_nodes( Ntk const& ntk, std::set<node> nodes2part ){
+    std::set<node> get_conn_nodes( Ntk const& ntk, std::set<node> const& nodes2part ){
       std::set<node> connected_nodes;
-      mockturtle::fanout_view fanout{ntk};
       for( node curr_output : outputs ){
         // std::cout << "fanout = " << curr_output << "\n";
         if(nodes.find(curr_output) == nodes.end() && nodes2part.find(curr_output) != nodes2part.end()){
@@ -186,7 +185,18 @@ namespace oracle
     }
     
   private:
-    
+
+    template<typename Fn>
+    void foreach_fanout( Ntk const& ntk, node n, Fn&& fn ){
+      if(_fanout){
+        _fanout->foreach_fanout(n, fn);
+        return;
+      }
+      mockturtle::fanout_view fanout{ntk};
+      fanout.foreach_fanout(n, fn);
+    }
+
+    mockturtle::fanout_view<Ntk> const* _fanout{nullptr};
     std::set<node> nodes{};
     std::set<node> inputs{};
     std::set<node> outputs{};
@@ -104,7 +104,6 @@ namespace oracle
       *************/
       ntk.foreach_node([&](auto node){
         int curr_slack = slack(node);
-        std::cout << "Node = " << node << " with slack = " << curr_slack << "\n";
         if(curr_slack > max_slack)
           max_slack = curr_slack;
         if(!ntk.is_constant(node) && !ntk.is_pi(node))
@@ -120,18 +119,11 @@ namespace oracle
         if(nodes2part.size() == 0)
           break; 
 
-        cluster<Ntk> curr_cluster(ntk);
-
-        auto start = std::chrono::high_resolution_clock::now();
+        cluster<Ntk> curr_cluster(ntk, fanout);
 
         node seed = find_seed(ntk);
-
-        auto stop = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-
-        std::cout << "Finding seed: " << duration.count() << "us\n";
         // std::cout << "first seed = " << seed << "\n";
-        curr_cluster.add_to_cluster(ntk, seed);
+        curr_cluster.add_to_cluster(ntk, {seed});
         // std::cout << "erasing " << seed << "\n";
         nodes2part.erase(seed);
         while(true){
@@ -139,11 +131,7 @@ namespace oracle
           if((curr_cluster.num_pis() >= pi_const && curr_cluster.size() >= node_count_const) || nodes2part.size() == 0)
             break;
           
-          start = std::chrono::high_resolution_clock::now();
           std::set<node> connected_nodes = curr_cluster.get_conn_nodes(ntk, nodes2part);
-          stop = std::chrono::high_resolution_clock::now();
-          duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-          std::cout << "Finding all connected nodes: " << duration.count() << "us\n";
 
           // std::cout << "cluster size = " << curr_cluster.size() << "\n";
           // std::cout << "number of cluster internal nodes = " << curr_cluster.num_int_nodes() << "\n";
@@ -154,12 +142,8 @@ namespace oracle
             break;
           node best_node;
           double best_attr = -1.0;
-          auto start1 = std::chrono::high_resolution_clock::now();
           for( node curr_node : connected_nodes ){
-            start = std::chrono::high_resolution_clock::now();
             double curr_attr = attraction(ntk, curr_node, curr_cluster);
-            stop = std::chrono::high_resolution_clock::now();
-            duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
             // std::cout << "Determining attraction: " << duration.count() << "us\n";
             // std::cout << "curr_node = " << curr_node << " with attraction = " << curr_attr << "\n";
             if( curr_attr > best_attr ){
@@ -169,23 +153,17 @@ namespace oracle
             
           }
           // mapped_part[best_node] = num_partitions;
-          curr_cluster.add_to_cluster(ntk, best_node);
+          curr_cluster.add_to_cluster(ntk, {best_node});
           // std::cout << "erasing " << best_node << "\n";
           nodes2part.erase(best_node);
-          auto stop1 = std::chrono::high_resolution_clock::now();
-          auto duration1 = std::chrono::duration_cast<std::chrono::microseconds>(stop1 - start1);
-          std::cout << "Finding best node to add: " << duration1.count() << "us\n";
           // std::cout << "done connected nodes\n";
         }
         std::set<node> curr_cluster_nodes = curr_cluster.get_cluster();
         // std::set<node> curr_cluster_outputs = curr_cluster.get_outputs();
         std::set<node> curr_cluster_inputs = curr_cluster.get_inputs();
-        std::cout << "Partition " << num_partitions << " = {";
         for(node curr_node : curr_cluster_nodes ){
-          std::cout << curr_node << " ";
           mapped_part[curr_node] = num_partitions;
         }
-        std::cout << "}\n";
         // std::cout << "Inputs = {";
         for(node curr_input : curr_cluster_inputs){
           // std::cout << curr_input << " ";
@@ -201,7 +179,6 @@ namespace oracle
         // std::cout << "}\n";
         num_partitions++;
       }
-      std::cout << "Number of partitions = " << num_partitions << "\n";
 
     }
 
@@ -230,11 +207,13 @@ namespace oracle
     }
 
     double connection_crit( node curr_node ){
+      if(max_slack == 0)
+        return 1.0;
       int curr_slack = slack(curr_node);
       return 1.0 - (double(curr_slack) / double(max_slack));
     }
 
-    double attraction( Ntk const& ntk, node curr_node, cluster<Ntk> curr_cluster ){
+    double attraction( Ntk const& ntk, node curr_node, cluster<Ntk>& curr_cluster ){
 
       int net_intersec = curr_cluster.num_intersec(ntk, curr_node);
 
@@ -242,12 +221,11 @@ namespace oracle
     }
 
     node find_seed(Ntk const& ntk){
-      double max_crit = 0.0;
-      node seed;
+      double max_crit = -1.0;
+      node seed = *nodes2part.begin();
       ntk.foreach_gate([&]( auto curr_node ){
         if(nodes2part.find(curr_node) != nodes2part.end()){
           double conn_crit = connection_crit(curr_node);
-          std::cout << "Node = " << curr_node << " with conn crit = " << conn_crit << "\n";
           if(conn_crit > max_crit){
             max_crit = conn_crit;
             seed = curr_node;
@@ -257,11 +235,19 @@ namespace oracle
       return seed;
     }
 
-    partition_manager<Ntk> create_part_man(Ntk const& ntk){
+    partition_manager<Ntk> create_part_man(Ntk& ntk){
       partition_manager<Ntk> part_man(ntk, mapped_part, num_partitions);
       return part_man;
     }
 
+    int get_num_partitions() const {
+      return num_partitions;
+    }
+
+    std::map<node, int> const& get_mapped_part() const {
+      return mapped_part;
+    }
+
   private:
 
     int num_partitions = 0;
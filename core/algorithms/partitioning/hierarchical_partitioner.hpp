@@ -0,0 +1,399 @@
+/*!
+  \file hierarchical_partitioner.hpp
+  \brief Two-level partitioning of large networks: output cone super-blocks,
+         partitioned independently and refined along their boundaries
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mockturtle/views/fanout_view.hpp>
+
+namespace oracle
+{
+
+  struct hierarchical_params{
+    int num_partitions{2};
+    /* Super-blocks of the first level, 0 uses the square root of num_partitions */
+    int super_blocks{0};
+    std::string config_file{};
+    double imbalance{0.5};
+    uint32_t num_threads{1u};
+    bool refine_boundaries{true};
+  };
+
+  struct hierarchical_stats{
+    int super_blocks{0};
+    /* Pairs of super-blocks sharing a hyperedge, and the rounds in which the
+       pairs were refined, each round on disjoint pairs */
+    uint64_t adjacent_pairs{0};
+    uint64_t refinement_rounds{0};
+    uint64_t boundary_moves{0};
+  };
+
+  namespace detail
+  {
+    /* The hypergraph of hypergraph<Ntk> (a node with its fanouts, or a PO
+       with its fanins) in CSR form, with the incident hyperedges of every
+       node */
+    struct csr_hypergraph{
+      std::vector<unsigned long> offsets{0};
+      std::vector<uint32_t> pins;
+      std::vector<unsigned long> node_offsets;
+      std::vector<uint32_t> node_edges;
+    };
+
+    template<class Ntk>
+    csr_hypergraph build_csr_hypergraph(Ntk const& ntk){
+      csr_hypergraph h;
+      mockturtle::fanout_view fanout{ntk};
+      std::vector<uint32_t> connections;
+      ntk.foreach_node([&](auto n){
+        connections.clear();
+        if(!ntk.is_po(n)){
+          fanout.foreach_fanout(n, [&](auto const& p){
+            connections.push_back(ntk.node_to_index(p));
+          });
+        }
+        else if(!ntk.is_ro(n)){
+          ntk.foreach_fanin(n, [&](auto const& f){
+            connections.push_back(ntk.node_to_index(ntk.get_node(f)));
+          });
+        }
+        if(connections.empty())
+          return;
+        std::sort(connections.begin(), connections.end());
+        connections.erase(std::unique(connections.begin(), connections.end()), connections.end());
+        const uint32_t root = ntk.node_to_index(n);
+        h.pins.push_back(root);
+        for(auto c : connections)
+          if(c != root)
+            h.pins.push_back(c);
+        h.offsets.push_back(h.pins.size());
+      });
+
+      /* transpose */
+      h.node_offsets.assign(ntk.size() + 1, 0);
+      for(auto v : h.pins)
+        ++h.node_offsets[v + 1];
+      for(auto i = 0u; i < ntk.size(); ++i)
+        h.node_offsets[i + 1] += h.node_offsets[i];
+      h.node_edges.resize(h.pins.size());
+      auto next = h.node_offsets;
+      for(auto e = 0u; e + 1 < h.offsets.size(); ++e)
+        for(auto j = h.offsets[e]; j < h.offsets[e + 1]; ++j)
+          h.node_edges[next[h.pins[j]]++] = e;
+      return h;
+    }
+
+    /* Claims the transitive fanin of the outputs, one output after the
+       other, and starts a new super-block once the current one has
+       num_nodes / super_blocks nodes */
+    template<class Ntk>
+    int output_cone_blocks(Ntk const& ntk, int super_blocks, std::vector<int>& block){
+      const auto target = (ntk.size() + super_blocks - 1) / super_blocks;
+      block.assign(ntk.size(), -1);
+      int current = 0;
+      uint64_t current_size = 0;
+      std::vector<uint32_t> stack;
+      ntk.foreach_po([&](auto const& f){
+        stack.push_back(ntk.node_to_index(ntk.get_node(f)));
+        while(!stack.empty()){
+          const auto index = stack.back();
+          stack.pop_back();
+          if(block[index] != -1)
+            continue;
+          block[index] = current;
+          ++current_size;
+          ntk.foreach_fanin(ntk.index_to_node(index), [&](auto const& g){
+            const auto fanin = ntk.node_to_index(ntk.get_node(g));
+            if(block[fanin] == -1)
+              stack.push_back(fanin);
+          });
+        }
+        if(current_size >= target && current + 1 < super_blocks){
+          ++current;
+          current_size = 0;
+        }
+      });
+      if(current_size == 0 && current > 0)
+        --current;
+      /* constants and logic that reaches no output */
+      for(auto& b : block)
+        if(b == -1)
+          b = current;
+      return current + 1;
+    }
+
+    /* Splits num_partitions over the blocks in proportion to their sizes,
+       at least one and at most size partitions per block */
+    inline std::vector<int> leaves_per_block(std::vector<uint64_t> const& sizes, int num_partitions){
+      const auto total = std::accumulate(sizes.begin(), sizes.end(), uint64_t{0});
+      std::vector<double> ideal(sizes.size());
+      std::vector<int> leaves(sizes.size());
+      int sum = 0;
+      for(auto b = 0u; b < sizes.size(); ++b){
+        ideal[b] = double(num_partitions) * sizes[b] / total;
+        leaves[b] = std::clamp<int>(std::floor(ideal[b]), 1, std::max<uint64_t>(1, sizes[b]));
+        sum += leaves[b];
+      }
+      while(sum != num_partitions){
+        int best = -1;
+        for(auto b = 0u; b < sizes.size(); ++b){
+          const bool can = sum < num_partitions ? leaves[b] < static_cast<int>(sizes[b]) : leaves[b] > 1;
+          if(!can)
+            continue;
+          const double slack = sum < num_partitions ? ideal[b] - leaves[b] : leaves[b] - ideal[b];
+          if(best == -1 || slack > (sum < num_partitions ? ideal[best] - leaves[best] : leaves[best] - ideal[best]))
+            best = b;
+        }
+        if(best == -1)
+          break;
+        leaves[best] += sum < num_partitions ? 1 : -1;
+        sum += sum < num_partitions ? 1 : -1;
+      }
+      return leaves;
+    }
+
+    template<class Fn>
+    void parallel_for(uint64_t count, uint32_t num_threads, Fn&& fn){
+      std::atomic<uint64_t> next{0};
+      auto worker = [&](){
+        for(auto i = next++; i < count; i = next++)
+          fn(i);
+      };
+      std::vector<std::thread> threads;
+      for(auto t = 1u; t < std::min<uint64_t>(num_threads, count); ++t)
+        threads.emplace_back([&, scope = oracle::allocation_scope::current()](){
+          oracle::allocation_thread_scope allocations(scope);
+          worker();
+        });
+      worker();
+      for(auto& t : threads)
+        t.join();
+    }
+  } // namespace detail
+
+  /*! \brief Partitions a network in two levels
+   *
+   * The network is split into super-blocks of consecutive output cones.  Each
+   * super-block is partitioned with KaHyPar on its own, in parallel, into its
+   * share of num_partitions partitions.  Boundary refinement then moves nodes
+   * across the boundaries of adjacent super-blocks when that lowers the (k-1)
+   * connectivity; pairs of super-blocks are refined in rounds of disjoint
+   * pairs, in parallel.  Every node is moved at most once, so the result does
+   * not depend on the number of threads.
+   *
+   * Returns the partition of every node, indexed by node index.
+   */
+  template<class Ntk>
+  std::vector<int> hierarchical_partition(Ntk const& ntk, hierarchical_params const& ps, hierarchical_stats* pst = nullptr){
+    hierarchical_stats st;
+    const int num_partitions = std::max(1, std::min<int>(ps.num_partitions, ntk.size()));
+    const int wanted_blocks = ps.super_blocks > 0 ? ps.super_blocks : std::ceil(std::sqrt(double(num_partitions)));
+    const uint32_t num_threads = std::max(1u, ps.num_threads);
+
+    oracle::profile_scope stage("hypergraph");
+    const auto h = detail::build_csr_hypergraph(ntk);
+    const auto num_edges = h.offsets.size() - 1;
+
+    stage.next("super_blocks");
+    std::vector<int> block;
+    st.super_blocks = detail::output_cone_blocks(ntk, std::clamp(wanted_blocks, 1, num_partitions), block);
+    std::vector<std::vector<uint32_t>> block_nodes(st.super_blocks);
+    for(auto i = 0u; i < ntk.size(); ++i)
+      block_nodes[block[i]].push_back(i);
+    std::vector<uint64_t> sizes(st.super_blocks);
+    for(auto b = 0; b < st.super_blocks; ++b)
+      sizes[b] = block_nodes[b].size();
+    const auto leaves = detail::leaves_per_block(sizes, num_partitions);
+    std::vector<int> first_leaf(st.super_blocks + 1, 0);
+    for(auto b = 0; b < st.super_blocks; ++b)
+      first_leaf[b + 1] = first_leaf[b] + leaves[b];
+
+    /* partition every super-block on the hyperedges restricted to it */
+    stage.next("block_partitioning");
+    std::vector<int> partition(ntk.size(), 0);
+    std::vector<uint32_t> local(ntk.size());
+    for(auto const& nodes : block_nodes)
+      for(auto i = 0u; i < nodes.size(); ++i)
+        local[nodes[i]] = i;
+    detail::parallel_for(st.super_blocks, num_threads, [&](uint64_t b){
+      auto const& nodes = block_nodes[b];
+      std::vector<int> parts(nodes.size(), 0);
+      if(leaves[b] > 1){
+        std::vector<uint32_t> edges;
+        for(auto v : nodes)
+          edges.insert(edges.end(), h.node_edges.begin() + h.node_offsets[v], h.node_edges.begin() + h.node_offsets[v + 1]);
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        std::vector<unsigned long> offsets{0};
+        std::vector<uint32_t> pins;
+        for(auto e : edges){
+          const auto start = pins.size();
+          for(auto j = h.offsets[e]; j < h.offsets[e + 1]; ++j)
+            if(block[h.pins[j]] == static_cast<int>(b))
+              pins.push_back(local[h.pins[j]]);
+          if(pins.size() - start < 2)
+            pins.resize(start);
+          else
+            offsets.push_back(pins.size());
+        }
+
+        if(offsets.size() > 1){
+          /* the imbalance is relative to the average partition of the whole
+             network, rounded so that few contexts are configured */
+          const double average = double(ntk.size()) / num_partitions;
+          const double block_average = double(nodes.size()) / leaves[b];
+          const double imbalance = std::max(0.01, std::floor(((1.0 + ps.imbalance) * average / block_average - 1.0) * 100.0) / 100.0);
+          parts = kahypar_partition_csr(nodes.size(), offsets, pins, leaves[b], ps.config_file, imbalance, true);
+        }
+        else{
+          for(auto i = 0u; i < nodes.size(); ++i)
+            parts[i] = uint64_t(i) * leaves[b] / nodes.size();
+        }
+      }
+      for(auto i = 0u; i < nodes.size(); ++i)
+        partition[nodes[i]] = first_leaf[b] + parts[i];
+    });
+
+    if(!ps.refine_boundaries || st.super_blocks == 1){
+      if(pst)
+        *pst = st;
+      return partition;
+    }
+
+    /* nodes on the boundary of every pair of adjacent super-blocks */
+    stage.next("boundary_refinement");
+    std::map<std::pair<int, int>, std::vector<uint32_t>> boundaries;
+    std::vector<int> spanned;
+    for(auto e = 0u; e < num_edges; ++e){
+      spanned.clear();
+      for(auto j = h.offsets[e]; j < h.offsets[e + 1]; ++j)
+        spanned.push_back(block[h.pins[j]]);
+      std::sort(spanned.begin(), spanned.end());
+      spanned.erase(std::unique(spanned.begin(), spanned.end()), spanned.end());
+      if(spanned.size() < 2)
+        continue;
+      for(auto j = h.offsets[e]; j < h.offsets[e + 1]; ++j){
+        const auto v = h.pins[j];
+        for(auto other : spanned)
+          if(other != block[v])
+            boundaries[std::minmax(block[v], other)].push_back(v);
+      }
+    }
+    std::vector<std::pair<std::pair<int, int>, std::vector<uint32_t>>> pairs(boundaries.begin(), boundaries.end());
+    boundaries.clear();
+    for(auto& [blocks, nodes] : pairs){
+      std::sort(nodes.begin(), nodes.end());
+      nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    }
+    st.adjacent_pairs = pairs.size();
+
+    /* Concurrent pairs only write nodes of their own super-blocks, and only
+       move them into partitions of their own super-blocks, so a pair reads
+       either a stable partition or one that is none of its own */
+    std::vector<std::atomic<int>> part(ntk.size());
+    for(auto i = 0u; i < ntk.size(); ++i)
+      part[i].store(partition[i], std::memory_order_relaxed);
+    std::vector<int64_t> part_size(num_partitions, 0);
+    for(auto p : partition)
+      ++part_size[p];
+    const int64_t max_size = std::ceil((1.0 + ps.imbalance) * ntk.size() / num_partitions);
+    std::vector<uint8_t> moved(ntk.size(), 0u);
+    std::atomic<uint64_t> num_moves{0};
+
+    const auto refine_pair = [&](int a, int b, std::vector<uint32_t> const& nodes){
+      const auto own = [&](int p, int blk){ return p >= first_leaf[blk] && p < first_leaf[blk + 1]; };
+      std::vector<int> candidates;
+      for(auto v : nodes){
+        if(moved[v])
+          continue;
+        const int from = part[v].load(std::memory_order_relaxed);
+        const int partner = block[v] == a ? b : a;
+        if(!own(from, block[v]) || part_size[from] <= 1)
+          continue;
+
+        candidates.clear();
+        for(auto k = h.node_offsets[v]; k < h.node_offsets[v + 1]; ++k){
+          const auto e = h.node_edges[k];
+          for(auto j = h.offsets[e]; j < h.offsets[e + 1]; ++j){
+            const int p = part[h.pins[j]].load(std::memory_order_relaxed);
+            if(own(p, partner))
+              candidates.push_back(p);
+          }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        int best = -1, best_gain = 0;
+        for(auto to : candidates){
+          if(part_size[to] >= max_size)
+            continue;
+          int gain = 0;
+          for(auto k = h.node_offsets[v]; k < h.node_offsets[v + 1]; ++k){
+            const auto e = h.node_edges[k];
+            uint32_t in_from = 0, in_to = 0;
+            for(auto j = h.offsets[e]; j < h.offsets[e + 1]; ++j){
+              const int p = part[h.pins[j]].load(std::memory_order_relaxed);
+              in_from += p == from;
+              in_to += p == to;
+            }
+            gain += (in_from == 1) - (in_to == 0);
+          }
+          if(gain > best_gain){
+            best = to;
+            best_gain = gain;
+          }
+        }
+        if(best != -1){
+          part[v].store(best, std::memory_order_relaxed);
+          --part_size[from];
+          ++part_size[best];
+          moved[v] = 1u;
+          ++num_moves;
+        }
+      }
+    };
+
+    /* rounds of disjoint pairs */
+    std::vector<bool> done(pairs.size(), false);
+    std::vector<size_t> round;
+    std::vector<int> busy(st.super_blocks, -1);
+    for(auto remaining = pairs.size(); remaining > 0; ++st.refinement_rounds){
+      round.clear();
+      for(auto i = 0u; i < pairs.size(); ++i){
+        auto [a, b] = pairs[i].first;
+        if(done[i] || busy[a] == static_cast<int>(st.refinement_rounds) || busy[b] == static_cast<int>(st.refinement_rounds))
+          continue;
+        busy[a] = busy[b] = st.refinement_rounds;
+        done[i] = true;
+        round.push_back(i);
+      }
+      remaining -= round.size();
+      detail::parallel_for(round.size(), num_threads, [&](uint64_t r){
+        auto const& [blocks, nodes] = pairs[round[r]];
+        refine_pair(blocks.first, blocks.second, nodes);
+      });
+    }
+    st.boundary_moves = num_moves;
+
+    for(auto i = 0u; i < ntk.size(); ++i)
+      partition[i] = part[i].load(std::memory_order_relaxed);
+    if(pst)
+      *pst = st;
+    return partition;
+  }
+
+} // namespace oracle
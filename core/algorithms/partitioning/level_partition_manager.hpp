@@ -58,7 +58,7 @@ namespace oracle
 
     level_partition_manager(){}
 
-    level_partition_manager( Ntk const& ntk ) : Ntk( ntk )
+    level_partition_manager( Ntk const& ntk, std::string const& config_direc = "" ) : Ntk( ntk )
     {
 
       static_assert( mockturtle::is_network_type_v<Ntk>, "Ntk is not a network type" );
@@ -69,62 +69,54 @@ namespace oracle
       static_assert( mockturtle::has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
       static_assert( mockturtle::has_make_signal_v<Ntk>, "Ntk does not implement the make_signal method" );
 
-      oracle::partition_manager<Ntk> partitions(ntk, 2);
+      Ntk copy = ntk;
+      oracle::partition_manager<Ntk> partitions(copy, 2, config_direc);
       std::set<node> shared_io = partitions.get_shared_io(0, 1);
-      
+
       levels.clear();
       level_idx = 1;
       std::unordered_map<node, bool> visited;
       ntk.foreach_node([&](auto node){
         visited[node] = false;
       });
-      std::cout << "Cutset Variables = {";
-      typename std::set<node>::iterator it;
-      for(it = shared_io.begin(); it != shared_io.end(); ++it){
-        std::cout << *it << " ";
-        visited[*it] = true;
+      for(auto const& n : shared_io){
+        visited[n] = true;
       }
-      std::cout << "}\n";
       levels[0] = shared_io;
       compute_level_nodes(ntk, shared_io, visited);
-      std::cout << "Number of levels = " << levels.size() << "\n";
-      for(auto level_it = levels.rbegin(); level_it != levels.rend(); ++level_it){
-        std::set<node> curr_level = level_it->second;
-        std::cout << "\nLevel " << level_it->first << " = {";
-        for(it = curr_level.begin(); it != curr_level.end(); ++it){
-          std::cout << *it << " ";
-        }
-        std::cout << "}\n";
-      }
     }
 
-    oracle::partition_manager<Ntk> generate_partitions(Ntk const& ntk, int coarse){
+    /* Groups `coarse` consecutive levels, starting from the last one, into
+       one partition */
+    std::map<node, int> get_mapped_part(int coarse) const {
       int idx = 0;
       int part_idx = 0;
       std::map<node, int> new_partitions;
       for(auto level_it = levels.rbegin(); level_it != levels.rend(); ++level_it){
-        std::set<node> curr_level = level_it->second;
+        for(auto const& n : level_it->second){
+          new_partitions[n] = part_idx;
+        }
         if(idx != coarse - 1){
-          for(auto it = curr_level.begin(); it != curr_level.end(); ++it){
-            new_partitions[*it] = part_idx;
-          }
           idx++;
         }
         else{
-          for(auto it = curr_level.begin(); it != curr_level.end(); ++it){
-            new_partitions[*it] = part_idx;
-          }
           idx = 0;
           part_idx++;
         }
       }
+      return new_partitions;
+    }
 
+    int get_num_partitions(int coarse) const {
       int num_partitions = levels.size() / coarse;
       if(levels.size() % coarse != 0){
         num_partitions++;
       }
+      return num_partitions;
+    }
 
-      oracle::partition_manager<Ntk> partitions(ntk, new_partitions, num_partitions);
+    oracle::partition_manager<Ntk> generate_partitions(Ntk& ntk, int coarse){
+      oracle::partition_manager<Ntk> partitions(ntk, get_mapped_part(coarse), get_num_partitions(coarse));
       return partitions;
     }
 
@@ -139,38 +131,36 @@ namespace oracle
   private:
     std::map<int, std::set<node>> levels;
     int level_idx = 1;
-    
-    void compute_level_nodes(Ntk const& ntk, std::set<node> prev_level, std::unordered_map<node, bool> visited){
+
+    /* Levels grow outwards from the cutset, each level holds the unvisited
+       fanins and fanouts of the previous one */
+    void compute_level_nodes(Ntk const& ntk, std::set<node> prev_level, std::unordered_map<node, bool>& visited){
       mockturtle::fanout_view<Ntk> fanout_ntk{ntk};
-      std::set<node> curr_level;
-      
-      typename std::set<node>::iterator it;
-      for(it = prev_level.begin(); it != prev_level.end(); ++it){
-        // std::cout << "Current node = " << *it << "\n";
-        fanout_ntk.foreach_fanout(*it, [&](const auto& p){
-          if(curr_level.find(p) == curr_level.end() && prev_level.find(p) == prev_level.end() && !visited[p]){
-            // std::cout << "Adding fanout " << p << " to current level set\n";
-            curr_level.insert(p);
-            visited[p] = true;
-          }
-        });
-
-        ntk.foreach_fanin(*it, [&](const auto& fanin){
-          auto node = ntk.get_node(fanin);
-          if(curr_level.find(node) == curr_level.end() && prev_level.find(node) == prev_level.end() && !visited[node]){
-            // std::cout << "Adding fanin " << node << " to current level set\n";
-            curr_level.insert(node);
-            visited[node] = true;
-          }
-        });
-      }
+      while(!prev_level.empty()){
+        std::set<node> curr_level;
+        for(auto const& n : prev_level){
+          fanout_ntk.foreach_fanout(n, [&](const auto& p){
+            if(!visited[p]){
+              curr_level.insert(p);
+              visited[p] = true;
+            }
+          });
+
+          ntk.foreach_fanin(n, [&](const auto& fanin){
+            auto node = ntk.get_node(fanin);
+            if(!visited[node]){
+              curr_level.insert(node);
+              visited[node] = true;
+            }
+          });
+        }
 
-      if (!curr_level.empty()){
-        levels[level_idx] = curr_level;
-        level_idx++;
-        compute_level_nodes(ntk, curr_level, visited);
+        if(!curr_level.empty()){
+          levels[level_idx] = curr_level;
+          level_idx++;
+        }
+        prev_level = std::move(curr_level);
       }
-        
     }
 
   };
@@ -0,0 +1,143 @@
+/*!
+  \file partition_extract.hpp
+  \brief Copies partitions into standalone networks and back into their host
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <mockturtle/traits.hpp>
+#include "partition_view.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Extracts partition views into optimizable networks and reinserts the results.
+   *
+   * `extract` builds an `aig_network`, `mig_network` or `xag_network` straight
+   * from a `partition_view`, so that no intermediate MIG copy is needed before
+   * running an optimization script.  Host nodes are mapped through a dense
+   * vector indexed by host node index which is allocated once and reused for
+   * every partition of the same host network.
+   *
+   * `reinsert` writes an optimized network of any of these types back into the
+   * host network and returns the host signals of its outputs, in the order of
+   * the partition roots.
+   */
+  template<typename Ntk>
+  class partition_extractor
+  {
+  public:
+    using node = typename Ntk::node;
+    using signal = typename Ntk::signal;
+
+  public:
+    explicit partition_extractor( Ntk const& ntk )
+      : _old_to_new( ntk.size() )
+    {
+    }
+
+    template<class NtkDest>
+    NtkDest extract( partition_view<Ntk> const& part )
+    {
+      static_assert( mockturtle::is_network_type_v<NtkDest>, "NtkDest is not a network type" );
+      using dest_signal = typename NtkDest::signal;
+
+      if ( _old_to_new.size() < part._storage->nodes.size() )
+        _old_to_new.resize( part._storage->nodes.size() );
+
+      NtkDest dest;
+      dest._storage->nodes.reserve( part.size() + 1u );
+      dest._storage->hash.reserve( part.size() );
+
+      const auto num_inputs = part._num_constants + part._num_regs + part._num_leaves;
+
+      for ( auto i = 0u; i < part._num_constants; ++i )
+        _old_to_new[part._nodes[i]] = dest.get_constant( part.constant_value( part._nodes[i] ) ).data;
+
+      for ( auto i = part._num_constants; i < num_inputs; ++i )
+        _old_to_new[part._nodes[i]] = dest.create_pi().data;
+
+      for ( auto i = num_inputs; i < part._nodes.size(); ++i )
+      {
+        const auto n = part._nodes[i];
+        assert( !part.Ntk::is_ci( n ) );
+
+        std::array<dest_signal, 3u> fanin;
+        auto k = 0u;
+        part.foreach_fanin( n, [&]( auto const& f ) {
+          const dest_signal s( _old_to_new[part.get_node( f )] );
+          fanin[k++] = part.is_complemented( f ) ? dest.create_not( s ) : s;
+        } );
+
+        dest_signal s;
+        if ( k == 3u )
+          s = dest.create_maj( fanin[0], fanin[1], fanin[2] );
+        else if ( part.is_xor( n ) )
+          s = dest.create_xor( fanin[0], fanin[1] );
+        else
+          s = dest.create_and( fanin[0], fanin[1] );
+        _old_to_new[n] = s.data;
+      }
+
+      part.foreach_po( [&]( auto const& f ) {
+        const dest_signal s( _old_to_new[part.get_node( f )] );
+        dest.create_po( part.is_complemented( f ) ? dest.create_not( s ) : s );
+      } );
+
+      return dest;
+    }
+
+    template<class NtkOpt>
+    static std::vector<signal> reinsert( partition_view<Ntk> const& part, NtkOpt const& opt, Ntk& ntk )
+    {
+      static_assert( mockturtle::is_network_type_v<NtkOpt>, "NtkOpt is not a network type" );
+      assert( opt.num_pis() == part.num_pis() + part.num_latches() );
+
+      std::vector<signal> old_to_new( opt.size() );
+      old_to_new[0] = ntk.get_constant( false );
+
+      std::vector<signal> pis;
+      part.foreach_pi( [&]( auto n ) {
+        pis.push_back( part.make_signal( n ) );
+      } );
+      opt.foreach_pi( [&]( auto n, auto i ) {
+        old_to_new[opt.node_to_index( n )] = pis[i];
+      } );
+
+      /* optimized networks are cleaned up, so index order is topological */
+      opt.foreach_gate( [&]( auto n ) {
+        std::array<signal, 3u> fanin;
+        auto k = 0u;
+        opt.foreach_fanin( n, [&]( auto const& f ) {
+          const auto s = old_to_new[opt.node_to_index( opt.get_node( f ) )];
+          fanin[k++] = opt.is_complemented( f ) ? ntk.create_not( s ) : s;
+        } );
+
+        signal s;
+        if ( k == 3u )
+          s = ntk.create_maj( fanin[0], fanin[1], fanin[2] );
+        else if ( opt.is_xor( n ) )
+          s = ntk.create_xor( fanin[0], fanin[1] );
+        else
+          s = ntk.create_and( fanin[0], fanin[1] );
+        old_to_new[opt.node_to_index( n )] = s;
+      } );
+
+      std::vector<signal> outputs;
+      opt.foreach_po( [&]( auto const& f ) {
+        const auto s = old_to_new[opt.node_to_index( opt.get_node( f ) )];
+        outputs.push_back( opt.is_complemented( f ) ? ntk.create_not( s ) : s );
+      } );
+      return outputs;
+    }
+
+  private:
+    std::vector<uint64_t> _old_to_new;
+  };
+
+} /* namespace oracle */
@@ -0,0 +1,365 @@
+/*!
+  \file partition_integrator.hpp
+  \brief Rebuilds a network from its optimized partitions in a single pass
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <mockturtle/traits.hpp>
+#include "partition_view.hpp"
+
+namespace oracle
+{
+
+  /*! \brief Batched reintegration of optimized partitions.
+   *
+   * Optimized partitions are collected with `add` and stored in a compact,
+   * network type independent form.  `rebuild` then creates the final network
+   * in one depth-first pass from the outputs of the original network: every
+   * partition root is resolved through the optimized logic of its partition,
+   * every other node is copied from the original network, and structural
+   * hashing happens while the new network is built.  Only logic reachable from
+   * the outputs is created, so no cleanup pass is needed afterwards.
+   */
+  template<typename Ntk>
+  class partition_integrator
+  {
+  public:
+    using node = typename Ntk::node;
+    using signal = typename Ntk::signal;
+
+  private:
+    enum gate_kind : uint8_t { kind_and, kind_xor, kind_maj };
+
+    struct flat_gate
+    {
+      std::array<uint64_t, 3u> fanin;
+      gate_kind kind;
+    };
+
+    /* literals are ( index << 1 ) | complement, where index 0 is the constant,
+     * indexes 1 to leaves.size() are the partition inputs, and the remaining
+     * indexes are gates */
+    struct flat_part
+    {
+      std::vector<node> leaves;
+      std::vector<flat_gate> gates;
+      std::vector<uint64_t> outputs;
+      bool enabled{true};
+    };
+
+    struct root_ref
+    {
+      uint32_t part;
+      uint32_t output;
+    };
+
+    struct item
+    {
+      uint32_t part;
+      uint64_t index;
+    };
+
+    static constexpr uint32_t host = std::numeric_limits<uint32_t>::max();
+
+  public:
+    explicit partition_integrator( Ntk const& ntk )
+      : _roots( ntk.size(), root_ref{host, 0u} )
+    {
+    }
+
+    template<class NtkOpt>
+    void add( partition_view<Ntk> const& part, NtkOpt const& opt )
+    {
+      static_assert( mockturtle::is_network_type_v<NtkOpt>, "NtkOpt is not a network type" );
+
+      const auto part_index = static_cast<uint32_t>( _parts.size() );
+      auto& p = _parts.emplace_back();
+
+      part.foreach_pi( [&]( auto n ) {
+        p.leaves.push_back( n );
+      } );
+
+      std::vector<uint64_t> opt_to_flat( opt.size() );
+      opt.foreach_pi( [&]( auto n, auto i ) {
+        opt_to_flat[opt.node_to_index( n )] = i + 1u;
+      } );
+
+      const auto literal = [&]( auto const& f ) {
+        return ( opt_to_flat[opt.node_to_index( opt.get_node( f ) )] << 1u ) | ( opt.is_complemented( f ) ? 1u : 0u );
+      };
+
+      p.gates.reserve( opt.num_gates() );
+      opt.foreach_gate( [&]( auto n ) {
+        flat_gate g{};
+        auto k = 0u;
+        opt.foreach_fanin( n, [&]( auto const& f ) {
+          g.fanin[k++] = literal( f );
+        } );
+        g.kind = k == 3u ? kind_maj : ( opt.is_xor( n ) ? kind_xor : kind_and );
+        opt_to_flat[opt.node_to_index( n )] = p.leaves.size() + 1u + p.gates.size();
+        p.gates.push_back( g );
+      } );
+
+      opt.foreach_po( [&]( auto const& f, auto i ) {
+        p.outputs.push_back( literal( f ) );
+        const auto root = part.get_node( part._roots.at( i ) );
+        if ( root >= _roots.size() )
+          _roots.resize( root + 1u, root_ref{host, 0u} );
+        _roots[root] = root_ref{part_index, static_cast<uint32_t>( i )};
+      } );
+    }
+
+    auto num_parts() const { return _parts.size(); }
+
+    /*! \brief Builds the final network from the original one and all added partitions. */
+    Ntk rebuild( Ntk const& ntk )
+    {
+      while ( true )
+      {
+        Ntk dest;
+        const auto cyclic = try_rebuild( ntk, dest );
+        if ( cyclic == host )
+          return dest;
+
+        /* a cross-partition cycle through optimized logic cannot be resolved in
+         * topological order, keep that partition as in the original network */
+        std::cout << "Partition result " << cyclic << " depends on itself through other partitions, keeping original logic\n";
+        _parts[cyclic].enabled = false;
+      }
+    }
+
+  private:
+    uint32_t try_rebuild( Ntk const& ntk, Ntk& dest )
+    {
+      _host_state.assign( ntk.size(), 0u );
+      _host_sig.assign( ntk.size(), dest.get_constant( false ) );
+      _part_state.resize( _parts.size() );
+      _part_sig.resize( _parts.size() );
+      for ( auto i = 0u; i < _parts.size(); ++i )
+      {
+        _part_state[i].assign( _parts[i].gates.size(), 0u );
+        _part_sig[i].resize( _parts[i].gates.size() );
+      }
+
+      _host_state[0] = 2u;
+      if ( ntk.get_node( ntk.get_constant( true ) ) != ntk.get_node( ntk.get_constant( false ) ) )
+      {
+        _host_sig[ntk.get_node( ntk.get_constant( true ) )] = dest.get_constant( true );
+        _host_state[ntk.get_node( ntk.get_constant( true ) )] = 2u;
+      }
+
+      const auto num_inputs = ntk.num_pis() - ntk.num_latches();
+      ntk.foreach_pi( [&]( auto n, auto i ) {
+        _host_sig[n] = i < num_inputs ? dest.create_pi() : dest.create_ro();
+        _host_state[n] = 2u;
+
+        if constexpr ( mockturtle::has_has_name_v<Ntk> && mockturtle::has_get_name_v<Ntk> && mockturtle::has_set_name_v<Ntk> )
+        {
+          if ( ntk.has_name( ntk.make_signal( n ) ) )
+            dest.set_name( _host_sig[n], ntk.get_name( ntk.make_signal( n ) ) );
+        }
+      } );
+
+      std::vector<signal> outputs;
+      uint32_t cyclic = host;
+      ntk.foreach_po( [&]( auto const& f ) {
+        if ( cyclic == host )
+          cyclic = resolve( ntk, dest, item{host, ntk.get_node( f )} );
+        if ( cyclic != host )
+          return false;
+        const auto s = _host_sig[ntk.get_node( f )];
+        outputs.push_back( ntk.is_complemented( f ) ? dest.create_not( s ) : s );
+        return true;
+      } );
+      if ( cyclic != host )
+        return cyclic;
+
+      const auto num_outputs = ntk.num_pos() - ntk.num_latches();
+      for ( auto i = 0u; i < outputs.size(); ++i )
+      {
+        if ( i < num_outputs )
+          dest.create_po( outputs[i] );
+        else
+          dest.create_ri( outputs[i], ntk.latch_reset( i - num_outputs ) );
+
+        if constexpr ( mockturtle::has_has_output_name_v<Ntk> && mockturtle::has_get_output_name_v<Ntk> && mockturtle::has_set_output_name_v<Ntk> )
+        {
+          if ( ntk.has_output_name( i ) )
+            dest.set_output_name( i, ntk.get_output_name( i ) );
+        }
+      }
+      return host;
+    }
+
+    /* maps a partition literal to the item computing it */
+    item flat_item( uint32_t part, uint64_t literal ) const
+    {
+      const auto index = literal >> 1u;
+      if ( index == 0u )
+        return item{host, 0u};
+      if ( index <= _parts[part].leaves.size() )
+        return item{host, _parts[part].leaves[index - 1u]};
+      return item{part, index - _parts[part].leaves.size() - 1u};
+    }
+
+    /* returns the literal a host node is replaced by, if it is an enabled partition root */
+    bool root_literal( Ntk const& ntk, node n, uint32_t& part, uint64_t& literal ) const
+    {
+      if ( n >= _roots.size() || _roots[n].part == host || !_parts[_roots[n].part].enabled )
+        return false;
+      part = _roots[n].part;
+      literal = _parts[part].outputs[_roots[n].output];
+      const auto target = flat_item( part, literal );
+      return !( target.part == host && target.index == n && !ntk.is_constant( n ) );
+    }
+
+    template<typename Fn>
+    void foreach_dependency( Ntk const& ntk, item const& it, Fn&& fn ) const
+    {
+      if ( it.part != host )
+      {
+        const auto& g = _parts[it.part].gates[it.index];
+        const auto k = g.kind == kind_maj ? 3u : 2u;
+        for ( auto i = 0u; i < k; ++i )
+          fn( flat_item( it.part, g.fanin[i] ) );
+        return;
+      }
+
+      uint32_t part;
+      uint64_t literal;
+      if ( root_literal( ntk, it.index, part, literal ) )
+      {
+        fn( flat_item( part, literal ) );
+        return;
+      }
+      ntk.foreach_fanin( it.index, [&]( auto const& f ) {
+        fn( item{host, ntk.get_node( f )} );
+      } );
+    }
+
+    uint8_t& state( item const& it )
+    {
+      return it.part == host ? _host_state[it.index] : _part_state[it.part][it.index];
+    }
+
+    signal literal_signal( Ntk& dest, uint32_t part, uint64_t literal ) const
+    {
+      const auto it = flat_item( part, literal );
+      const auto s = it.part == host ? _host_sig[it.index] : _part_sig[it.part][it.index];
+      return ( literal & 1u ) ? dest.create_not( s ) : s;
+    }
+
+    void compute( Ntk const& ntk, Ntk& dest, item const& it )
+    {
+      if ( it.part != host )
+      {
+        const auto& g = _parts[it.part].gates[it.index];
+        const auto a = literal_signal( dest, it.part, g.fanin[0] );
+        const auto b = literal_signal( dest, it.part, g.fanin[1] );
+        auto& s = _part_sig[it.part][it.index];
+        if ( g.kind == kind_maj )
+          s = dest.create_maj( a, b, literal_signal( dest, it.part, g.fanin[2] ) );
+        else if ( g.kind == kind_xor )
+          s = dest.create_xor( a, b );
+        else
+          s = dest.create_and( a, b );
+        return;
+      }
+
+      uint32_t part;
+      uint64_t literal;
+      if ( root_literal( ntk, it.index, part, literal ) )
+      {
+        _host_sig[it.index] = literal_signal( dest, part, literal );
+        return;
+      }
+
+      std::array<signal, 3u> fanin;
+      auto k = 0u;
+      ntk.foreach_fanin( it.index, [&]( auto const& f ) {
+        const auto s = _host_sig[ntk.get_node( f )];
+        fanin[k++] = ntk.is_complemented( f ) ? dest.create_not( s ) : s;
+      } );
+      if ( k == 3u )
+        _host_sig[it.index] = dest.create_maj( fanin[0], fanin[1], fanin[2] );
+      else if ( ntk.is_xor( it.index ) )
+        _host_sig[it.index] = dest.create_xor( fanin[0], fanin[1] );
+      else
+        _host_sig[it.index] = dest.create_and( fanin[0], fanin[1] );
+    }
+
+    /* iterative post-order traversal; returns the partition closing a cycle, if any */
+    uint32_t resolve( Ntk const& ntk, Ntk& dest, item const& start )
+    {
+      if ( state( start ) == 2u )
+        return host;
+
+      std::vector<item> stack{start};
+      while ( !stack.empty() )
+      {
+        const auto it = stack.back();
+        auto& st = state( it );
+        if ( st == 2u )
+        {
+          stack.pop_back();
+          continue;
+        }
+
+        auto ready = true;
+        auto cyclic = false;
+        foreach_dependency( ntk, it, [&]( item const& dep ) {
+          const auto dep_state = state( dep );
+          if ( dep_state == 2u )
+            return;
+          cyclic = cyclic || dep_state == 1u;
+          ready = false;
+          if ( st == 0u )
+            stack.push_back( dep );
+        } );
+
+        if ( cyclic )
+        {
+          /* the expanded items on the stack form the path closing the cycle,
+           * which must pass through at least one optimized partition */
+          if ( it.part != host )
+            return it.part;
+          for ( auto i = stack.size(); i-- > 0u; )
+          {
+            if ( stack[i].part != host && state( stack[i] ) == 1u )
+              return stack[i].part;
+          }
+          return host;
+        }
+
+        if ( ready )
+        {
+          compute( ntk, dest, it );
+          st = 2u;
+          stack.pop_back();
+        }
+        else
+        {
+          st = 1u;
+        }
+      }
+      return host;
+    }
+
+  private:
+    std::vector<flat_part> _parts;
+    std::vector<root_ref> _roots;
+
+    std::vector<uint8_t> _host_state;
+    std::vector<signal> _host_sig;
+    std::vector<std::vector<uint8_t>> _part_state;
+    std::vector<std::vector<signal>> _part_sig;
+  };
+
+} /* namespace oracle */
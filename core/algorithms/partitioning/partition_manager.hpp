@@ -38,18 +38,86 @@
 #include <set>
 #include <cassert>
 #include <queue>
+#include <mutex>
 
 #include <mockturtle/traits.hpp>
 #include "partition_view.hpp"
+#include "partition_extract.hpp"
+#include "partition_integrator.hpp"
 #include "hyperg.hpp"
 #include <mockturtle/networks/detail/foreach.hpp>
 #include <mockturtle/views/fanout_view.hpp>
 #include <libkahypar.h>
 #include "kahypar_config.hpp"
+#include "../output/kmap_dataset.hpp"
 
 namespace oracle
 {
 
+  /*! \brief Partitions a hypergraph given in CSR form with KaHyPar
+   *
+   * Hyperedge i holds the vertices pins[offsets[i]] to pins[offsets[i+1]] - 1.
+   * Returns the partition of every vertex.  An empty config_direc uses the
+   * built-in default configuration; quiet turns off KaHyPar's reports.
+   */
+  inline std::vector<int> kahypar_partition_csr( uint32_t num_vertices, std::vector<unsigned long> const& offsets,
+                                                 std::vector<uint32_t> const& pins, int part_num,
+                                                 std::string const& config_direc, double imbalance = 0.5, bool quiet = false )
+  {
+    if(!quiet){
+      if(config_direc.empty())
+        std::cout << "Using the default KaHyPar configuration" << std::endl;
+      else
+        std::cout << "Using config file " << config_direc << std::endl;
+    }
+    kahypar_context_t* context = kahypar_cached_context(config_direc);
+    kahypar_set_quiet_mode(context, quiet);
+
+    const kahypar_hyperedge_id_t num_hyperedges = offsets.empty() ? 0 : offsets.size() - 1;
+
+    //set all edges to have the same weight
+    std::vector<kahypar_hyperedge_weight_t> hyperedge_weights(num_hyperedges, 2);
+    //vector with indeces where each set starts
+    std::vector<size_t> hyperedge_indices(offsets.begin(), offsets.end());
+
+    kahypar_hyperedge_weight_t objective = 0;
+    std::vector<int> partition(num_vertices, -1);
+
+    kahypar_partition(num_vertices, num_hyperedges,
+                      imbalance, part_num, nullptr, hyperedge_weights.data(),
+                      hyperedge_indices.data(), pins.data(),
+                      &objective, context, partition.data());
+
+    kahypar_context_free(context);
+    return partition;
+  }
+
+  /*! \brief Partitions the hypergraph of a network with KaHyPar
+   *
+   * Returns the partition of every node, indexed by node index.  An empty
+   * config_direc uses the built-in default configuration.
+   */
+  template<typename Ntk>
+  std::vector<int> kahypar_partition_network( Ntk const& ntk, int part_num, std::string const& config_direc, double imbalance = 0.5 )
+  {
+    /******************
+    Generate HyperGraph
+    ******************/
+    oracle::profile_scope stage("hypergraph");
+    std::vector<uint32_t> kahypar_connections;
+    std::vector<unsigned long> kahyp_set_indeces;
+    hypergraph<Ntk> t(ntk);
+    t.get_hypergraph(ntk);
+    t.return_hyperedges(kahypar_connections);
+    t.get_indeces(kahyp_set_indeces);
+
+    /******************
+    Partition with kahypar
+    ******************/
+    stage.next("kahypar");
+    return kahypar_partition_csr(t.get_num_vertices(), kahyp_set_indeces, kahypar_connections, part_num, config_direc, imbalance);
+  }
+
   /*! \brief Partitions circuit using multi-level hypergraph partitioner
    *
    */
@@ -134,153 +202,107 @@ namespace oracle
       static_assert( mockturtle::has_make_signal_v<Ntk>, "Ntk does not implement the make_signal method" );
 
       num_partitions = part_num;
+      oracle::profile_scope profile("partitioning");
 
       for(int i = 0; i<part_num; ++i)
         _part_scope.push_back(std::set<node>());
 
-      if(part_num == 1){
-        ntk.foreach_pi( [&](auto pi){
-          _part_scope[0].insert(ntk.index_to_node(pi));
-          _part_pis.insert(std::pair<int, node>(0, ntk.index_to_node(pi)));
-        });
-        ntk.foreach_po( [&](auto po){
-          _part_scope[0].insert(ntk.index_to_node(po.index));
-          _part_pos.insert(std::pair<int, node>(0, ntk.index_to_node(po.index)));
-
-        });
-        ntk.foreach_gate( [&](auto curr_node){
-          _part_scope[0].insert(curr_node);
-          _part_nodes[curr_node] = 0;
-        });
-
-        for(int i = 0; i < part_num; i++){
-          partitionInputs[i] = create_part_inputs(i);
-          partitionOutputs[i] = create_part_outputs(i);
-          partitionReg[i] = create_part_latches(i);
-          partitionRegIn[i] = create_part_latches_in(i);
-        }
-      }
+      if(part_num == 1)
+        single_partition(ntk);
+      else
+        assign_partitions(ntk, kahypar_partition_network(ntk, part_num, config_direc), part_num);
+    }
 
-      else{
-        uint32_t kahyp_num_hyperedges = 0;
-        uint32_t kahyp_num_vertices = 0;
-        uint32_t kahyp_num_indeces_hyper = 0;
-        unsigned long kahyp_num_sets = 0;
-        std::vector<uint32_t> kahypar_connections;
-        std::vector<unsigned long> kahyp_set_indeces;
-
-        /******************
-        Generate HyperGraph
-        ******************/
-
-        hypergraph<Ntk> t(ntk);
-        t.get_hypergraph(ntk);
-        t.return_hyperedges(kahypar_connections);
-        kahyp_num_hyperedges = t.get_num_edges();
-        kahyp_num_vertices = t.get_num_vertices();
-        kahyp_num_indeces_hyper = t.get_num_indeces();
-        kahyp_num_sets = t.get_num_sets();
-        t.get_indeces(kahyp_set_indeces);
-        // t.dump();
-
-        /******************
-        Partition with kahypar
-        ******************/
-        //configures kahypar
-        kahypar_context_t* context = kahypar_context_new();
+    /* Partitions given as the partition of every node, indexed by node index */
+    partition_manager( Ntk& ntk, std::vector<int> const& partition, int part_num ) : Ntk( ntk )
+    {
+      num_partitions = part_num;
+      oracle::profile_scope profile("partitioning");
 
-        std::cout << "Using config file " << config_direc << std::endl;
-        kahypar_configure_context_from_file(context, config_direc.c_str());
+      for(int i = 0; i<part_num; ++i)
+        _part_scope.push_back(std::set<node>());
 
-        //set number of hyperedges and vertices. These variables are defined by the hyperG command
-        const kahypar_hyperedge_id_t num_hyperedges = kahyp_num_hyperedges;
-        const kahypar_hypernode_id_t num_vertices = kahyp_num_vertices;
+      if(part_num == 1)
+        single_partition(ntk);
+      else
+        assign_partitions(ntk, partition, part_num);
+    }
 
-        //set all edges to have the same weight
-        std::unique_ptr<kahypar_hyperedge_weight_t[]> hyperedge_weights = std::make_unique<kahypar_hyperedge_weight_t[]>(kahyp_num_vertices);
+  private:
+    void single_partition(Ntk& ntk){
+      ntk.foreach_pi( [&](auto pi){
+        _part_scope[0].insert(ntk.index_to_node(pi));
+        _part_pis.insert(std::pair<int, node>(0, ntk.index_to_node(pi)));
+      });
+      ntk.foreach_po( [&](auto po){
+        _part_scope[0].insert(ntk.index_to_node(po.index));
+        _part_pos.insert(std::pair<int, node>(0, ntk.index_to_node(po.index)));
 
-        for( int i = 0; i < kahyp_num_vertices; i++ )
-          hyperedge_weights[i] = 2;
+      });
+      ntk.foreach_gate( [&](auto curr_node){
+        _part_scope[0].insert(curr_node);
+        _part_nodes[curr_node] = 0;
+      });
 
-        //vector with indeces where each set starts
-        std::unique_ptr<size_t[]> hyperedge_indices = std::make_unique<size_t[]>(kahyp_num_sets+1);
+      for(int i = 0; i < num_partitions; i++){
+        partitionInputs[i] = create_part_inputs(i);
+        partitionOutputs[i] = create_part_outputs(i);
+        partitionReg[i] = create_part_latches(i);
+        partitionRegIn[i] = create_part_latches_in(i);
+      }
+    }
 
-        for ( int j = 0; j < kahyp_num_sets+1; j++){
-          hyperedge_indices[j] = kahyp_set_indeces[j];
+    void assign_partitions(Ntk& ntk, std::vector<int> const& partition, int part_num){
+      oracle::profile_scope stage("partition_io");
+      for(auto i=1; i <= ntk.num_pis(); i++){
+        if(i<=ntk.num_pis()-ntk.num_latches()){
+          _part_pis.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
         }
-
-        std::unique_ptr<kahypar_hyperedge_id_t[]> hyperedges = std::make_unique<kahypar_hyperedge_id_t[]>(kahyp_num_indeces_hyper);
-
-        for ( int i = 0; i < kahyp_num_indeces_hyper; i++){
-          hyperedges[i] = kahypar_connections[i];
+        else {
+          _part_pis.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
+          _part_ros.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
         }
+      }
 
-        const double imbalance = 0.5;
-        const kahypar_partition_id_t k = part_num;
-
-        kahypar_hyperedge_weight_t objective = 0;
-
-        std::vector<kahypar_partition_id_t> partition(num_vertices, -1);
-
-        kahypar_partition(num_vertices, num_hyperedges,
-                          imbalance, k, nullptr, hyperedge_weights.get(),
-                          hyperedge_indices.get(), hyperedges.get(),
-                          &objective, context, partition.data());
-
-        for(auto i=1; i <= ntk.num_pis(); i++){
-          if(i<=ntk.num_pis()-ntk.num_latches()){
-            _part_pis.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
-          }
-          else {
-            _part_pis.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
-            _part_ros.insert(std::pair<int, node>(partition[i], ntk.index_to_node(i)));
-          }
+      ntk.foreach_node( [&](auto curr_node){
+        if (!ntk.is_constant(curr_node)) {
+          _part_scope[partition[ntk.node_to_index(curr_node)]].insert(curr_node);
         }
 
-        ntk.foreach_node( [&](auto curr_node){
-          if (!ntk.is_constant(curr_node)) {
-            _part_scope[partition[ntk.node_to_index(curr_node)]].insert(curr_node);
-          }
-
-          //look to partition inputs (those that are not circuit PIs)
-          if (!ntk.is_pi(curr_node) && !ntk.is_ro(curr_node)){
-            ntk.foreach_fanin(curr_node, [&](auto const &conn, auto j) {
-              if (partition[conn.index] != partition[ntk.node_to_index(curr_node)] && !ntk.is_constant(ntk.index_to_node(conn.index))) {
-                _part_scope[partition[ntk.node_to_index(curr_node)]].insert(curr_node);
-                _part_pis.insert(std::pair<int, node>(partition[ntk.node_to_index(curr_node)], ntk.index_to_node(conn.index)));
-                _part_pos.insert(std::pair<int, node>(partition[conn.index],ntk.index_to_node(conn.index)));
-
-              }
-            });
-          }
-        });
+        //look to partition inputs (those that are not circuit PIs)
+        if (!ntk.is_pi(curr_node) && !ntk.is_ro(curr_node)){
+          ntk.foreach_fanin(curr_node, [&](auto const &conn, auto j) {
+            if (partition[conn.index] != partition[ntk.node_to_index(curr_node)] && !ntk.is_constant(ntk.index_to_node(conn.index))) {
+              _part_scope[partition[ntk.node_to_index(curr_node)]].insert(curr_node);
+              _part_pis.insert(std::pair<int, node>(partition[ntk.node_to_index(curr_node)], ntk.index_to_node(conn.index)));
+              _part_pos.insert(std::pair<int, node>(partition[conn.index],ntk.index_to_node(conn.index)));
 
-        for(auto i=0; i < ntk.num_pos(); i++){
-          if(i<ntk.num_pos()-ntk.num_latches() && !ntk.is_constant(ntk.index_to_node(ntk._storage->outputs[i].index))){
-            _part_pos.insert(std::pair<int, node>(partition[ntk._storage->outputs[i].index], ntk.index_to_node(ntk._storage->outputs[i].index)));
-          }
-          else {
-      			if(!ntk.is_constant(ntk.index_to_node(ntk._storage->outputs[i].index))){
-              _part_ris.insert(std::pair<int, node>(partition[ntk._storage->outputs[i].index], ntk.index_to_node(ntk._storage->outputs[i].index)));
             }
-    		  }
+          });
         }
+      });
 
-        for(int i = 0; i < part_num; i++){
-          partitionInputs[i] = create_part_inputs(i);
-          partitionReg[i] = create_part_latches(i);
-          typename std::set<node>::iterator it;
-          partitionRegIn[i] = create_part_latches_in(i);
-          partitionOutputs[i] = create_part_outputs(i);
-          update_io(i);
+      for(auto i=0; i < ntk.num_pos(); i++){
+        if(i<ntk.num_pos()-ntk.num_latches() && !ntk.is_constant(ntk.index_to_node(ntk._storage->outputs[i].index))){
+          _part_pos.insert(std::pair<int, node>(partition[ntk._storage->outputs[i].index], ntk.index_to_node(ntk._storage->outputs[i].index)));
         }
-        kahypar_context_free(context);
+        else {
+    			if(!ntk.is_constant(ntk.index_to_node(ntk._storage->outputs[i].index))){
+            _part_ris.insert(std::pair<int, node>(partition[ntk._storage->outputs[i].index], ntk.index_to_node(ntk._storage->outputs[i].index)));
+          }
+  		  }
       }
 
+      for(int i = 0; i < part_num; i++){
+        partitionInputs[i] = create_part_inputs(i);
+        partitionReg[i] = create_part_latches(i);
+        typename std::set<node>::iterator it;
+        partitionRegIn[i] = create_part_latches_in(i);
+        partitionOutputs[i] = create_part_outputs(i);
+        update_io(i);
+      }
     }
 
-  private:
-
     //Simple BFS Traversal to optain the depth of an output's logic cone before the truth table is built
     void BFS_traversal(Ntk& ntk, node output, int partition){
       std::queue<int> net_queue;
@@ -456,7 +478,22 @@ namespace oracle
       }
     }
 
+    /* Same as synchronize_part, but accepts an optimized AIG, MIG or XAG directly
+     * instead of requiring it to be converted to the host network type first */
+    template<class NtkOpt>
+    void reinsert_part(partition_view<Ntk> const& part, NtkOpt const& opt, Ntk &ntk){
+      auto outputs = partition_extractor<Ntk>::reinsert(part, opt, ntk);
+
+      opt.foreach_po( [&]( auto const& f, auto i ) {
+        auto opt_node = opt.get_node(f);
+        if(!opt.is_constant(opt_node) && !opt.is_pi(opt_node)){
+          output_substitutions[ntk.get_node(part._roots.at(i))] = outputs.at(i);
+        }
+      });
+    }
+
     void generate_truth_tables(Ntk& ntk){
+      oracle::profile_scope profile("truth_tables");
 
       for(int i = 0; i < num_partitions; i++){
         typename std::set<node>::iterator it;
@@ -492,114 +529,58 @@ namespace oracle
       }
     }
 
-    std::vector<float> get_km_image( Ntk& ntk, int partition, node output ){
+    /* Draws the k-map of `output` into `image` (kmap_image_size pixels,
+       see kmap_dataset.hpp).  Returns false for cones with fewer than 2 or
+       more than 16 inputs, which have no image. */
+    bool km_image( Ntk& ntk, int partition, node output, uint8_t* image ){
 
-      std::vector<float> default_image;
       BFS_traversal(ntk, output, partition);
       int num_inputs = logic_cone_inputs[output].size();
       ntk.foreach_node( [&]( auto node ) {
         int index = ntk.node_to_index(node);
         ntk._storage->nodes[index].data[1].h1 = 0;
       });
+      if(num_inputs > 16 || num_inputs < 2)
+        return false;
 
-      std::string tt = kitty::to_binary(output_tt[output]);
-      char* tt_binary = (char*)malloc(sizeof(char) * (tt.length() + 1));
-      strcpy(tt_binary, tt.c_str());
-
-      std::vector<std::string> onset_indeces;
-      int indx = 0;
-      for(int k = tt.length() - 1; k >= 0; k--){
-        int bit = (int)tt_binary[k] - 48;
-        if(bit == 1){
-          onset_indeces.push_back(oracle::to_binary(indx));
-        }
-        indx++;
-      }
-      for(int k = 0; k < onset_indeces.size(); k++){
-        while(onset_indeces.at(k).length() != logic_cone_inputs[output].size()){
-          onset_indeces.at(k).insert(0, "0");
-        }
-        std::reverse(onset_indeces.at(k).begin(), onset_indeces.at(k).end());
-      }
+      /* the first `rows` inputs select the row and the others the column,
+         both in Gray code with the lowest input as the most significant bit */
       int columns = num_inputs / 2;
-      int rows;
-      if(num_inputs <= 16 && num_inputs >= 2){
-        if(num_inputs % 2 != 0){
-          rows = columns + 1;
+      int rows = num_inputs - columns;
+      int row_num = 1 << rows;
+      int col_num = 1 << columns;
+      int row_offset = (oracle::kmap_image_cols - row_num) / 2;
+      int col_offset = (oracle::kmap_image_rows - col_num) / 2;
+
+      std::fill(image, image + oracle::kmap_image_size, 1);
+      for(int y = 0; y < col_num; y++)
+        std::fill_n(image + (y + col_offset) * oracle::kmap_image_cols + row_offset, row_num, 0);
+
+      auto const& tt = output_tt[output];
+      for(uint64_t bit = 0; bit < tt.num_bits(); bit++){
+        if(!kitty::get_bit(tt, bit))
+          continue;
+        int row_index = 0, col_index = 0, b = 0;
+        for(int k = 0; k < rows; k++){
+          b ^= (bit >> k) & 1;
+          row_index = (row_index << 1) | b;
         }
-        else{
-          rows = columns;
+        b = 0;
+        for(int k = rows; k < num_inputs; k++){
+          b ^= (bit >> k) & 1;
+          col_index = (col_index << 1) | b;
         }
+        image[(col_index + col_offset) * oracle::kmap_image_cols + row_index + row_offset] = 2;
+      }
+      return true;
+    }
 
-        int row_num = pow(2, rows);
-        int col_num = pow(2, columns);
-        char **k_map = (char**)malloc(sizeof(char *) * col_num);
-        for(int y = 0; y < col_num; y++)
-          k_map[y] = (char*)malloc(sizeof(char) * row_num);
-
-        for(int y = 0; y < col_num; y++){
-          for(int x = 0; x < row_num; x++){
-            k_map[y][x] = 0;
-          }
-        }
-        for(int k = 0; k < onset_indeces.size(); k++){
-
-          std::string row_index_gray = onset_indeces.at(k).substr(0, rows);
-          std::string col_index_gray = onset_indeces.at(k).substr(rows, onset_indeces.at(k).size() - 1);
-          std::string row_index_bin = graytoBinary(row_index_gray);
-          std::string col_index_bin = graytoBinary(col_index_gray);
-          int row_index = std::stoi(row_index_bin,nullptr,2);
-          int col_index = std::stoi(col_index_bin,nullptr,2);
-          k_map[col_index][row_index] = 2;
-
-        }
-        if(num_inputs < 16){
-          int padded_row = 256;
-          int padded_col = 256;
-          char **k_map_pad = (char**)malloc(sizeof(char *) * padded_col);
-          for(int k = 0; k < padded_col; k++){
-            k_map_pad[k] = (char*)malloc(sizeof(char) * padded_row);
-          }
+    std::vector<float> get_km_image( Ntk& ntk, int partition, node output ){
 
-          for(int y = 0; y < padded_col; y++){
-            for(int x = 0; x < padded_row; x++){
-              k_map_pad[y][x] = 1;
-            }
-          }
-          int row_offset = (padded_row - row_num);
-          if(row_offset % 2 != 0){
-            row_offset++;
-          }
-          int col_offset = (padded_col - col_num);
-          if(col_offset % 2 != 0){
-            col_offset++;
-          }
-          row_offset /= 2;
-          col_offset /= 2;
-          for(int y = 0; y < col_num; y++){
-            for(int x = 0; x < row_num; x++){
-              k_map_pad[y + col_offset][x + row_offset] = k_map[y][x];
-            }
-          }
-          std::vector<float> data_1d(padded_row * padded_col);
-          for(int y = 0; y < padded_col; y++){
-            for(int x = 0; x < padded_row; x++){
-              data_1d[x + y*padded_col] = (float)k_map_pad[y][x];
-            }
-          }
-          return data_1d;
-        }
-        else{
-          std::vector<float> data_1d(row_num * col_num);
-          for(int y = 0; y < col_num; y++){
-            for(int x = 0; x < row_num; x++){
-              data_1d[x + y*col_num] = (float)k_map[y][x];
-            }
-          }
-          return data_1d;
-        }
-      }
-      return default_image;
+      std::vector<uint8_t> image(oracle::kmap_image_size);
+      if(!km_image(ntk, partition, output, image.data()))
+        return std::vector<float>();
+      return std::vector<float>(image.begin(), image.end());
     }
 
     void run_classification( Ntk& ntk, std::string model_file ){
@@ -608,15 +589,22 @@ namespace oracle
       int col_num = 256;
       int chann_num = 1;
       std::vector<std::string> labels = {"AIG", "MIG"};
-      const auto model = fdeep::load_model(model_file);
+      oracle::profile_scope profile("classification");
+      oracle::profile_scope stage("load_model");
+      const auto& model = oracle::cached_model(model_file);
 
+      stage.end();
       if(output_tt.empty()){
         generate_truth_tables(ntk);
       }
 
+      stage.next("inference");
+
+      classification_margins.assign(num_partitions, 0.0f);
       for(int i = 0; i < num_partitions; i++){
         int aig_score = 0;
         int mig_score = 0;
+        float margin_sum = 0.0f;
 
         int partition = i;
         auto total_outputs = 0;
@@ -648,7 +636,11 @@ namespace oracle
           if(image.size() > 0){
             const fdeep::shared_float_vec sv(fplus::make_shared_ref<fdeep::float_vec>(std::move(image)));
             fdeep::tensor5 input(fdeep::shape5(1, 1, row_num, col_num, chann_num), sv);
-            const auto result = model.predict_class({input});
+            const auto prediction = model.predict({input}).front();
+            const auto p_aig = prediction.get(0, 0, 0, 0, 0);
+            const auto p_mig = prediction.get(0, 0, 0, 0, 1);
+            const auto result = p_aig >= p_mig ? 0 : 1;
+            margin_sum += std::abs(p_aig - p_mig);
 
             weight = 1;
             weight_nodes = 1;
@@ -702,6 +694,9 @@ namespace oracle
               aig_score += ( (weight_nodes*_num_nodes_cone)+(3*big_depth));
           }
         }
+        /* outputs too large for the classifier count as uncertain */
+        if(!partitionOutputs[i].empty())
+          classification_margins[i] = margin_sum / partitionOutputs[i].size();
         if(aig_score > mig_score){
           aig_parts.push_back(partition);
         }
@@ -718,130 +713,54 @@ namespace oracle
       }
 
       mkdir(directory.c_str(), 0777);
+      std::vector<uint8_t> image(oracle::kmap_image_size);
       for(int i = 0; i < num_partitions; i++){
         int partition = i;
         typename std::set<node>::iterator it;
         for(it = partitionOutputs[i].begin(); it != partitionOutputs[i].end(); ++it){
           auto output = *it;
-          BFS_traversal(ntk, output, partition);
+          if(!km_image(ntk, partition, output, image.data()))
+            continue;
           int num_inputs = logic_cone_inputs[output].size();
-          ntk.foreach_node( [&]( auto node ) {
-            int index = ntk.node_to_index(node);
-            ntk._storage->nodes[index].data[1].h1 = 0;
-          });
           int logic_depth = computeLevel(ntk, output, partitionInputs[partition]);
 
           std::string file_out = "top_kar_part_" + std::to_string(partition) + "_out_" +
                                  std::to_string(output) + "_in_" + std::to_string(num_inputs) + "_lev_" + std::to_string(logic_depth) + ".txt";
+          std::ofstream output_file(directory + file_out, std::ios::out | std::ios::binary | std::ios::trunc);
+          output_file.write(reinterpret_cast<char const*>(image.data()), image.size());
+        }
+      }
+    }
 
+    /* Appends one record per partition output with an image to `dataset`,
+       returns the number of records written.  `labels` holds the label of
+       every partition, partitions with a negative label are skipped; without
+       labels all records are unlabelled. */
+    uint64_t write_karnaugh_dataset( Ntk& ntk, oracle::kmap_dataset_writer& dataset, std::vector<int32_t> const& labels = {} ){
 
-          std::string tt = kitty::to_binary(output_tt[output]);
-          char* tt_binary = (char*)malloc(sizeof(char) * (tt.length() + 1));
-          strcpy(tt_binary, tt.c_str());
-
-          std::vector<std::string> onset_indeces;
-
-          int indx = 0;
-          for(int k = tt.length() - 1; k >= 0; k--){
-            int bit = (int)tt_binary[k] - 48;
-            if(bit == 1){
-              onset_indeces.push_back(oracle::to_binary(indx));
-            }
-            indx++;
-          }
-          for(int k = 0; k < onset_indeces.size(); k++){
-            while(onset_indeces.at(k).length() != logic_cone_inputs[output].size()){
-              onset_indeces.at(k).insert(0, "0");
-            }
-            std::reverse(onset_indeces.at(k).begin(), onset_indeces.at(k).end());
-          }
-
-          int columns = num_inputs / 2;
-          int rows;
-          if(num_inputs <= 16 && num_inputs >= 2){
-            std::ofstream output_file(directory + file_out, std::ios::out | std::ios::binary | std::ios::trunc);
-            if(num_inputs % 2 != 0){
-              rows = columns + 1;
-            }
-            else{
-              rows = columns;
-            }
-
-            int row_num = pow(2, rows);
-            int col_num = pow(2, columns);
-            char **k_map = (char**)malloc(sizeof(char *) * col_num);
-            for(int y = 0; y < col_num; y++)
-              k_map[y] = (char*)malloc(sizeof(char) * row_num);
-
-            for(int y = 0; y < col_num; y++){
-              for(int x = 0; x < row_num; x++){
-                k_map[y][x] = 0;
-              }
-            }
-
-            for(int k = 0; k < onset_indeces.size(); k++){
-
-              std::string row_index_gray = onset_indeces.at(k).substr(0, rows);
-              std::string col_index_gray = onset_indeces.at(k).substr(rows, onset_indeces.at(k).size() - 1);
-              std::string row_index_bin = graytoBinary(row_index_gray);
-              std::string col_index_bin = graytoBinary(col_index_gray);
-              int row_index = std::stoi(row_index_bin,nullptr,2);
-              int col_index = std::stoi(col_index_bin,nullptr,2);
-              k_map[col_index][row_index] = 2;
-
-            }
-
-            if(num_inputs < 16){
-              int padded_row = 256;
-              int padded_col = 256;
-              char **k_map_pad = (char**)malloc(sizeof(char *) * padded_col);
-              for(int k = 0; k < padded_col; k++){
-                k_map_pad[k] = (char*)malloc(sizeof(char) * padded_row);
-              }
-
-              for(int y = 0; y < padded_col; y++){
-                for(int x = 0; x < padded_row; x++){
-                  k_map_pad[y][x] = 1;
-                }
-              }
-              int row_offset = (padded_row - row_num);
-              if(row_offset % 2 != 0){
-                row_offset++;
-              }
-              int col_offset = (padded_col - col_num);
-              if(col_offset % 2 != 0){
-                col_offset++;
-              }
-              row_offset /= 2;
-              col_offset /= 2;
-              for(int y = 0; y < col_num; y++){
-                for(int x = 0; x < row_num; x++){
-                  k_map_pad[y + col_offset][x + row_offset] = k_map[y][x];
-                }
-              }
-              std::vector<char> data_1d(padded_row * padded_col);
-              for(int y = 0; y < padded_col; y++){
-                for(int x = 0; x < padded_row; x++){
-                  data_1d[x + y*padded_col] = k_map_pad[y][x];
-                }
-              }
-
-              output_file.write(data_1d.data(), data_1d.size()*sizeof(char));
-            }
-            else{
-              std::vector<char> data_1d(row_num * col_num);
-              for(int y = 0; y < col_num; y++){
-                for(int x = 0; x < row_num; x++){
-                  data_1d[x + y*col_num] = k_map[y][x];
-                }
-              }
-              output_file.write(data_1d.data(), data_1d.size()*sizeof(char));
-            }
-            output_file.close();
-          }
+      if(output_tt.empty()){
+        generate_truth_tables(ntk);
+      }
 
+      uint64_t num_records = 0;
+      std::vector<uint8_t> image(oracle::kmap_image_size);
+      for(int i = 0; i < num_partitions; i++){
+        if(!labels.empty() && labels.at(i) < 0)
+          continue;
+        for(auto output : partitionOutputs[i]){
+          if(!km_image(ntk, i, output, image.data()))
+            continue;
+          oracle::kmap_record record;
+          record.label = labels.empty() ? -1 : labels.at(i);
+          record.partition = i;
+          record.output = ntk.node_to_index(output);
+          record.num_inputs = logic_cone_inputs[output].size();
+          record.level = computeLevel(ntk, output, partitionInputs[i]);
+          dataset.write(record, image.data());
+          num_records++;
         }
       }
+      return num_records;
     }
 
     void connect_outputs(Ntk ntk){
@@ -1042,6 +961,11 @@ namespace oracle
     std::vector<int> get_mig_parts(){
       return mig_parts;
     }
+    /* mean softmax margin of the classifier over the outputs of each partition,
+       set by run_classification */
+    std::vector<float> get_classification_margins(){
+      return classification_margins;
+    }
 
     std::set<int> get_connected_parts( Ntk& ntk, int partition_num ){
       std::set<int> conn_parts;
@@ -1086,6 +1010,7 @@ namespace oracle
 
     std::vector<int> aig_parts;
     std::vector<int> mig_parts;
+    std::vector<float> classification_margins;
 
     std::unordered_map<int, std::set<int>> conn_parts;
     std::unordered_map<node, std::vector<int>> input_partition;
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+#ifdef ENABLE_GALOIS
+#include <utah/BiPart.h>
+#endif
+
+namespace oracle{
+
+  /* Threads this process can actually run in parallel: the CPUs in its
+     affinity mask, further limited by a cgroup CPU quota (containers, batch
+     schedulers), never less than one */
+  inline uint32_t available_threads(){
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+#ifdef __linux__
+    cpu_set_t set;
+    if(sched_getaffinity(0, sizeof(set), &set) == 0)
+      threads = std::min<uint32_t>(threads, std::max(1, CPU_COUNT(&set)));
+#endif
+
+    double quota = -1.0, period = 0.0;
+    /* cgroup v2 "max 100000" or "<quota> <period>", cgroup v1 in two files */
+    std::ifstream v2("/sys/fs/cgroup/cpu.max");
+    std::string max;
+    if(v2 >> max >> period){
+      if(max != "max")
+        quota = std::stod(max);
+    }
+    else{
+      std::ifstream v1_quota("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+      std::ifstream v1_period("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+      if(!(v1_quota >> quota) || !(v1_period >> period))
+        quota = -1.0;
+    }
+    if(quota > 0.0 && period > 0.0)
+      threads = std::min<uint32_t>(threads, std::max(1.0, std::ceil(quota / period)));
+    return threads;
+  }
+
+  struct partitioner_params{
+    /* Wanted number of partitions; backends that grow partitions up to a
+       size use it to derive that size */
+    int num_partitions{2};
+
+    /* kahypar, and level which cuts the network in two with KaHyPar first;
+       empty for the built-in configuration */
+    std::string config_file{};
+    double imbalance{0.5};
+
+    /* bipart and hierarchical, 0 uses available_threads(); a deterministic
+       bipart run gives the same partition for any number of threads */
+    uint32_t num_threads{0u};
+    bool deterministic{true};
+
+    /* seed and fpga_seed close a partition once it has this many inputs and
+       nodes; 0 nodes is the number of gates divided by num_partitions */
+    int seed_inputs{1};
+    int seed_nodes{0};
+
+    /* fpga_seed weighs connection criticality against shared nets */
+    double net_delay{0.5};
+    double max_net{10.0};
+
+    /* hierarchical, super-blocks of the first level; 0 is the square root
+       of num_partitions */
+    int super_blocks{0};
+
+    /* file, one partition per line for the nodes from index 1 on */
+    std::string partition_file{};
+  };
+
+  struct partitioner_stats{
+    /* Hyperedges (a node and its fanouts) spanning more than one partition */
+    uint64_t cut_size{0};
+    /* Sum over the hyperedges of the partitions they span minus one */
+    uint64_t connectivity{0};
+    /* Size of the largest partition over the average partition size, minus one */
+    double imbalance{0.0};
+    double runtime_ms{0.0};
+    /* Bytes allocated by the backend, on the calling thread and the worker
+       threads of hierarchical; the Galois threads of bipart are not counted */
+    uint64_t allocated_bytes{0};
+  };
+
+  /* Partition of every node, indexed by node index */
+  struct partition_assignment{
+    std::vector<int> partition;
+    int num_partitions{0};
+    partitioner_stats stats;
+
+    bool valid() const {
+      return num_partitions > 0;
+    }
+  };
+
+  template<class Ntk>
+  class partitioner{
+  public:
+    virtual ~partitioner() = default;
+
+    /* Returns an invalid assignment, after printing why, on failure */
+    virtual partition_assignment run(Ntk const& ntk, partitioner_params const& ps) = 0;
+  };
+
+  template<class Ntk>
+  using partitioner_factory = std::function<std::unique_ptr<partitioner<Ntk>>()>;
+
+  template<class Ntk>
+  int seed_partition_size(Ntk const& ntk, partitioner_params const& ps){
+    if(ps.seed_nodes > 0)
+      return ps.seed_nodes;
+    return std::max<int>(1, std::ceil(double(ntk.num_gates()) / std::max(1, ps.num_partitions)));
+  }
+
+  template<class Ntk>
+  partition_assignment from_mapping(Ntk const& ntk, std::map<typename Ntk::node, int> const& mapping){
+    partition_assignment result;
+    result.partition.assign(ntk.size(), 0);
+    for(auto const& [n, part] : mapping)
+      result.partition[ntk.node_to_index(n)] = part;
+    result.num_partitions = 1 + *std::max_element(result.partition.begin(), result.partition.end());
+    return result;
+  }
+
+  template<class Ntk>
+  class kahypar_partitioner : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      partition_assignment result;
+      result.num_partitions = ps.num_partitions;
+      if(ps.num_partitions == 1){
+        result.partition.assign(ntk.size(), 0);
+        return result;
+      }
+      result.partition = kahypar_partition_network(ntk, ps.num_partitions, ps.config_file, ps.imbalance);
+      return result;
+    }
+  };
+
+#ifdef ENABLE_GALOIS
+  template<class Ntk>
+  class bipart_partitioner : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      partition_assignment result;
+      result.num_partitions = ps.num_partitions;
+      result.partition.assign(ntk.size(), 0);
+
+      hypergraph<Ntk> t(ntk);
+      t.get_hypergraph(ntk);
+      if(ps.num_partitions == 1 || t.get_num_edges() == 0)
+        return result;
+      std::vector<unsigned long> offsets;
+      std::vector<uint32_t> pins;
+      t.get_indeces(offsets);
+      pins.reserve(offsets.back());
+      t.return_hyperedges(pins);
+
+      /* Galois keeps its runtime and options in globals */
+      static std::mutex mutex;
+      std::lock_guard<std::mutex> lock(mutex);
+      const int num_threads = ps.num_threads ? ps.num_threads : available_threads();
+      result.partition = biparting(offsets, pins, ntk.size(), ps.num_partitions, num_threads, PP, ps.deterministic);
+      return result;
+    }
+  };
+#endif
+
+  /* Output cone super-blocks partitioned in parallel, then refined along
+     their boundaries (hierarchical_partition) */
+  template<class Ntk>
+  class hierarchical_partitioner : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      hierarchical_params hps;
+      hps.num_partitions = ps.num_partitions;
+      hps.super_blocks = ps.super_blocks;
+      hps.config_file = ps.config_file;
+      hps.imbalance = ps.imbalance;
+      hps.num_threads = ps.num_threads ? ps.num_threads : available_threads();
+
+      hierarchical_stats st;
+      partition_assignment result;
+      result.partition = hierarchical_partition(ntk, hps, &st);
+      result.num_partitions = 1 + *std::max_element(result.partition.begin(), result.partition.end());
+      std::cout << st.super_blocks << " super-blocks, " << st.adjacent_pairs << " adjacent pairs refined in "
+                << st.refinement_rounds << " rounds, " << st.boundary_moves << " boundary moves\n";
+      return result;
+    }
+  };
+
+  /* Partitions grown in topological order (seed_partitioner) */
+  template<class Ntk>
+  class seed_partitioner_backend : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      seed_partitioner<Ntk> seeds(ntk, ps.seed_inputs, seed_partition_size(ntk, ps));
+      return from_mapping(ntk, seeds.get_mapped_part());
+    }
+  };
+
+  /* Partitions grown around timing critical seeds (fpga_seed_partitioner) */
+  template<class Ntk>
+  class fpga_seed_partitioner_backend : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      if(ps.max_net <= 0.0){
+        std::cout << "fpga_seed needs a positive max_net\n";
+        return {};
+      }
+      fpga_seed_partitioner<Ntk> seeds(ntk, ps.net_delay, ps.max_net, ps.seed_inputs, seed_partition_size(ntk, ps));
+      return from_mapping(ntk, seeds.get_mapped_part());
+    }
+  };
+
+  /* Levels around a KaHyPar bisection cutset, grouped into num_partitions
+     partitions (level_partition_manager) */
+  template<class Ntk>
+  class level_partitioner : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      level_partition_manager<Ntk> levels(ntk, ps.config_file);
+      const int coarse = std::max(1, static_cast<int>(std::ceil(double(levels.get_levels()) / std::max(1, ps.num_partitions))));
+      return from_mapping(ntk, levels.get_mapped_part(coarse));
+    }
+  };
+
+  template<class Ntk>
+  class file_partitioner : public partitioner<Ntk>{
+  public:
+    partition_assignment run(Ntk const& ntk, partitioner_params const& ps) override {
+      std::ifstream ifs(ps.partition_file);
+      if(!ifs.is_open()){
+        std::cout << "Unable to open partition data file " << ps.partition_file << "\n";
+        return {};
+      }
+      partition_assignment result;
+      result.partition.assign(ntk.size(), 0);
+      uint32_t index = 1;
+      int part;
+      while(ifs >> part){
+        if(index >= ntk.size() || part < 0){
+          std::cout << "Partition file does not match the network\n";
+          return {};
+        }
+        result.partition[index++] = part;
+      }
+      result.num_partitions = 1 + *std::max_element(result.partition.begin(), result.partition.end());
+      return result;
+    }
+  };
+
+  /* Backends by name, new ones are added with register_partitioner */
+  template<class Ntk>
+  std::map<std::string, partitioner_factory<Ntk>>& partitioner_registry(){
+    static std::map<std::string, partitioner_factory<Ntk>> registry = {
+      {"kahypar", []{ return std::make_unique<kahypar_partitioner<Ntk>>(); }},
+#ifdef ENABLE_GALOIS
+      {"bipart", []{ return std::make_unique<bipart_partitioner<Ntk>>(); }},
+#endif
+      {"hierarchical", []{ return std::make_unique<hierarchical_partitioner<Ntk>>(); }},
+      {"seed", []{ return std::make_unique<seed_partitioner_backend<Ntk>>(); }},
+      {"fpga_seed", []{ return std::make_unique<fpga_seed_partitioner_backend<Ntk>>(); }},
+      {"level", []{ return std::make_unique<level_partitioner<Ntk>>(); }},
+      {"file", []{ return std::make_unique<file_partitioner<Ntk>>(); }}};
+    return registry;
+  }
+
+  template<class Ntk>
+  void register_partitioner(std::string const& name, partitioner_factory<Ntk> factory){
+    partitioner_registry<Ntk>()[name] = std::move(factory);
+  }
+
+  template<class Ntk>
+  std::vector<std::string> partitioner_names(){
+    std::vector<std::string> names;
+    for(auto const& [name, factory] : partitioner_registry<Ntk>())
+      names.push_back(name);
+    return names;
+  }
+
+  /* Comma separated backend names, for help texts */
+  template<class Ntk>
+  std::string partitioner_list(){
+    std::string list;
+    for(auto const& name : partitioner_names<Ntk>())
+      list += (list.empty() ? "" : ", ") + name;
+    return list;
+  }
+
+  template<class Ntk>
+  void compute_partition_stats(Ntk const& ntk, partition_assignment& assignment){
+    auto& stats = assignment.stats;
+    stats.cut_size = 0;
+    stats.connectivity = 0;
+
+    /* the hyperedges of hypergraph<Ntk>: a node with its fanouts, or a PO
+       with its fanins */
+    mockturtle::fanout_view fanout{ntk};
+    std::vector<int> parts;
+    ntk.foreach_node([&](auto n){
+      parts.clear();
+      if(!ntk.is_po(n)){
+        fanout.foreach_fanout(n, [&](auto const& p){
+          parts.push_back(assignment.partition[ntk.node_to_index(p)]);
+        });
+      }
+      else if(!ntk.is_ro(n)){
+        ntk.foreach_fanin(n, [&](auto const& f){
+          parts.push_back(assignment.partition[ntk.node_to_index(ntk.get_node(f))]);
+        });
+      }
+      if(parts.empty())
+        return;
+      parts.push_back(assignment.partition[ntk.node_to_index(n)]);
+      std::sort(parts.begin(), parts.end());
+      const auto spanned = std::unique(parts.begin(), parts.end()) - parts.begin();
+      if(spanned > 1){
+        ++stats.cut_size;
+        stats.connectivity += spanned - 1;
+      }
+    });
+
+    std::vector<uint64_t> sizes(assignment.num_partitions, 0u);
+    for(auto part : assignment.partition)
+      ++sizes[part];
+    const double average = double(assignment.partition.size()) / assignment.num_partitions;
+    stats.imbalance = *std::max_element(sizes.begin(), sizes.end()) / average - 1.0;
+  }
+
+  /* Runs the backend called `name` and fills in the statistics of its
+     partitions. Unknown backends and backends that fail give an invalid
+     assignment. */
+  template<class Ntk>
+  partition_assignment run_partitioner(std::string const& name, Ntk const& ntk, partitioner_params const& ps){
+    auto const& registry = partitioner_registry<Ntk>();
+    auto it = registry.find(name);
+    if(it == registry.end()){
+      std::cout << "Unknown partitioner " << name << ", available:";
+      for(auto const& backend : partitioner_names<Ntk>())
+        std::cout << " " << backend;
+      std::cout << "\n";
+      return {};
+    }
+    if(ps.num_partitions <= 0){
+      std::cout << "Number of partitions must be positive\n";
+      return {};
+    }
+
+    oracle::profile_scope profile("partitioner");
+    auto backend = it->second();
+    allocation_scope allocations;
+    const auto start = std::chrono::steady_clock::now();
+    auto assignment = backend->run(ntk, ps);
+    const auto runtime_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const auto allocated_bytes = allocations.bytes();
+    if(!assignment.valid())
+      return {};
+    if(assignment.partition.size() != ntk.size()){
+      std::cout << "Partitioner " << name << " did not assign every node\n";
+      return {};
+    }
+
+    profile.next("partition_stats");
+    compute_partition_stats(ntk, assignment);
+    assignment.stats.runtime_ms = runtime_ms;
+    assignment.stats.allocated_bytes = allocated_bytes;
+    return assignment;
+  }
+
+} // namespace oracle
@@ -87,7 +87,6 @@ namespace oracle
 
       for(int i = 0; i < nodes2part.size(); i++){
         auto curr_node = nodes2part.at(i);
-        std::cout << "Current node = " << curr_node << "\n";
 
         if(visited[curr_node] == true){
           continue;
@@ -95,28 +94,22 @@ namespace oracle
 
         int new_pi = 0;
         ntk.foreach_fanin(curr_node, [&](auto conn, auto i){
-          std::cout << "fanin = " << conn.index << "\n";
           if(visited[ntk.get_node(conn)] == false){
             new_pi = 1;
           }
         });
 
         if(new_pi == 1 || ntk.is_pi(curr_node)){
-          std::cout << "increase pi count\n";
           num_pi++;
         }
         else{
-          std::cout << "increase internal node count\n";
           num_int++;
         }
 
         visited[curr_node] = true;
         mapped_part[curr_node] = part_idx;
-        std::cout << "num pi = " << num_pi << "\n";
-        std::cout << "num internal nodes = " << num_int << "\n";
 
         if(num_pi >= pi_const && num_int >= node_count_const){
-          std::cout << "Create partition\n";
           part_idx++;
           num_partitions++;
           num_pi = 0;
@@ -129,11 +122,19 @@ namespace oracle
       }
     }
 
-    partition_manager<Ntk> create_part_man(Ntk const& ntk){
+    partition_manager<Ntk> create_part_man(Ntk& ntk){
       partition_manager<Ntk> part_man(ntk, mapped_part, num_partitions);
       return part_man;
     }
 
+    int get_num_partitions() const {
+      return num_partitions;
+    }
+
+    std::map<node, int> const& get_mapped_part() const {
+      return mapped_part;
+    }
+
   private:
 
     int num_partitions = 1;
@@ -17,6 +17,7 @@ namespace alice
 
         protected:
         void execute(){
+          oracle::profile_scope profile("asic_map");
           if(is_set("NPN")){
             std::unordered_map<std::string, int> npn_count;
             if(is_set("aig")){
@@ -27,7 +28,9 @@ namespace alice
                 mockturtle::lut_mapping_params ps;
                 ps.cut_enumeration_ps.cut_size = 6;
                 ps.cut_enumeration_ps.cut_limit = 6;
+                oracle::profile_scope stage("lut_mapping");
                 mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::aig_network, true>, true>( mapped_aig, ps );
+                stage.next("collapse");
                 const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_aig );
                 auto const& klut = *klut_opt;
                 klut.foreach_node( [&]( auto const n ) {
@@ -62,7 +65,9 @@ namespace alice
                 ps.cut_enumeration_ps.cut_size = 6;
                 ps.cut_enumeration_ps.cut_limit = 6;
                 std::cout << "LUT mapping\n";
+                oracle::profile_scope stage("lut_mapping");
                 mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::mig_network, true>, true>( mapped_mig, ps );
+                stage.next("collapse");
                 const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_mig );
                 auto const& klut = *klut_opt;
                 klut.foreach_node( [&]( auto const n ) {
@@ -98,13 +103,17 @@ namespace alice
               ps.cut_enumeration_ps.cut_size = 4;
               ps.cut_enumeration_ps.cut_limit = 4;
               std::cout << "LUT mapping\n";
+              oracle::profile_scope stage("lut_mapping");
               mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::aig_network, true>, true>( mapped_aig, ps );
+              stage.next("collapse");
               const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_aig );
               auto const& klut = *klut_opt;
               mockturtle::topo_view klut_topo{klut};
               mockturtle::write_bench(klut_topo, filename + "KLUT.bench");
+              stage.next("techmapping");
               std::tuple<mockturtle::klut_network, std::unordered_map <int, std::string>> techmap_test = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo); 
               mockturtle::write_bench(std::get<0>(techmap_test), filename + "Techmapped.bench");
+              stage.next("write");
               std::cout << "Outputing mapped netlist\n";
               oracle::write_techmapped_verilog(std::get<0>(techmap_test), filename, std::get<1>(techmap_test), "test_top");
               mockturtle::write_bench(mockturtle::cleanup_dangling(std::get<0>(techmap_test)), filename + "cleanup.bench" );
@@ -126,13 +135,17 @@ namespace alice
               ps.cut_enumeration_ps.cut_size = 4;
               ps.cut_enumeration_ps.cut_limit = 4;
               std::cout << "LUT mapping\n";
+              oracle::profile_scope stage("lut_mapping");
               mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::mig_network, true>, true>( mapped_mig, ps );
+              stage.next("collapse");
               const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped_mig );
               auto const& klut = *klut_opt;
               mockturtle::topo_view klut_topo{klut};
               mockturtle::write_bench(klut_topo, filename + "KLUT.bench");
+              stage.next("techmapping");
               std::tuple<mockturtle::klut_network, std::unordered_map <int, std::string>> techmap_test = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo); 
               mockturtle::write_bench(std::get<0>(techmap_test), filename + "Techmapped.bench");
+              stage.next("write");
               std::cout << "Outputing mapped netlist\n";
               oracle::write_techmapped_verilog(std::get<0>(techmap_test), filename, std::get<1>(techmap_test), "top");
               mockturtle::write_bench(mockturtle::cleanup_dangling(std::get<0>(techmap_test)), filename + "cleanup.bench" );
@@ -29,16 +29,19 @@ namespace alice
         add_flag("--mig,-m", "Store file as MIG network (AIG network is default)");
         add_flag("--klut,-k", "Store file as KLUT network (AIG network is default)");
         add_flag("--xag,-x", "Store file as XAG network (AIG network is default)");
+        add_flag("--strashed", "AIG file is structurally hashed (e.g. written by ABC), read it without hash lookups");
       }
 
     protected:
       void execute(){
 
         if(oracle::checkExt(filename, "aig")){
+          mockturtle::aiger_mmap_reader_params aiger_ps;
+          aiger_ps.strashed = is_set("strashed");
           if(is_set("mig")){
             mockturtle::mig_network ntk;
             mockturtle::names_view<mockturtle::mig_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            mockturtle::read_aiger_mmap(filename, names_view, aiger_ps);
 
             store<mig_ntk>().extend() = std::make_shared<mig_names>( names_view );
             std::cout << "MIG network stored\n";
@@ -67,7 +70,7 @@ namespace alice
           else if(is_set("xag")){
             mockturtle::xag_network ntk;
             mockturtle::names_view<mockturtle::xag_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            mockturtle::read_aiger_mmap(filename, names_view, aiger_ps);
                 
             store<xag_ntk>().extend() = std::make_shared<xag_names>( names_view );
             std::cout << "XAG network stored\n";
@@ -78,7 +81,7 @@ namespace alice
           else{
             mockturtle::aig_network ntk;
             mockturtle::names_view<mockturtle::aig_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            mockturtle::read_aiger_mmap(filename, names_view, aiger_ps);
             
             store<aig_ntk>().extend() = std::make_shared<aig_names>( names_view );
             std::cout << "AIG network stored\n";
@@ -99,7 +102,7 @@ namespace alice
             if(result != lorina::return_code::success)
               std::cout << "parsing failed\n";
             
-            mockturtle::mig_npn_resynthesis resyn;
+            auto& resyn = oracle::mig_npn_database();
 
             mockturtle::mig_network ntk;
             mockturtle::names_view<mockturtle::mig_network>named_dest ( ntk );
@@ -137,7 +140,7 @@ namespace alice
             if(result != lorina::return_code::success)
               std::cout << "parsing failed\n";
 
-            mockturtle::xag_npn_resynthesis<mockturtle::xag_network> resyn;
+            auto& resyn = oracle::xag_npn_database<mockturtle::xag_network>();
 
             mockturtle::xag_network ntk;
             mockturtle::names_view<mockturtle::xag_network>named_dest ( ntk );
@@ -160,7 +163,7 @@ namespace alice
             if(result != lorina::return_code::success)
               std::cout << "parsing failed\n";
 
-            mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn;
+            auto& resyn = oracle::xag_npn_database<mockturtle::aig_network>();
 
             mockturtle::aig_network ntk;
             mockturtle::names_view<mockturtle::aig_network>named_dest ( ntk );
@@ -28,16 +28,19 @@ namespace alice
         opts.add_option( "--filename,filename", filename, "AIG file to read in" )->required();
         add_flag("--mig,-m", "Store AIG file as MIG network (AIG network is default)");
         add_flag("--xag,-x", "Store AIG file as XAG network (AIG network is default)");
+        add_flag("--strashed", "AIG file is structurally hashed (e.g. written by ABC), read it without hash lookups");
       }
 
     protected:
       void execute(){
 
         if(oracle::checkExt(filename, "aig")){
+          mockturtle::aiger_mmap_reader_params aiger_ps;
+          aiger_ps.strashed = is_set("strashed");
           if(is_set("mig")){
             mockturtle::mig_network ntk;
             mockturtle::names_view<mockturtle::mig_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            mockturtle::read_aiger_mmap(filename, names_view, aiger_ps);
 
             store<mig_ntk>().extend() = std::make_shared<mig_names>( names_view );
             std::cout << "MIG network stored\n";
@@ -48,7 +51,7 @@ namespace alice
           else if(is_set("xag")){
             mockturtle::xag_network ntk;
             mockturtle::names_view<mockturtle::xag_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            mockturtle::read_aiger_mmap(filename, names_view, aiger_ps);
                 
             store<xag_ntk>().extend() = std::make_shared<xag_names>( names_view );
             std::cout << "XAG network stored\n";
@@ -59,7 +62,7 @@ namespace alice
           else{
             mockturtle::aig_network ntk;
             mockturtle::names_view<mockturtle::aig_network> names_view{ntk};
-            lorina::read_aiger(filename, mockturtle::aiger_reader( names_view ));
+            mockturtle::read_aiger_mmap(filename, names_view, aiger_ps);
                 
             store<aig_ntk>().extend() = std::make_shared<aig_names>( names_view );
             std::cout << "AIG network stored\n";
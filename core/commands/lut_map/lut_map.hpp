@@ -32,6 +32,7 @@ namespace alice
 
     protected:
         void execute(){
+          oracle::profile_scope profile("lut_map");
             
           if(is_set("mig")){
             if(!store<mig_ntk>().empty()){
@@ -43,10 +44,12 @@ namespace alice
                 ps.cut_enumeration_ps.cut_size = lut_size;
                 ps.cut_enumeration_ps.cut_limit = cut_size;
 
+                oracle::profile_scope stage("lut_mapping");
                 mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::mig_network, true>, true>( mapped, ps );
 
                 std::cout << "number of cells = " << mapped.num_cells() << "\n";
 
+                stage.next("collapse");
                 const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped );
                 // auto const& klut = *klut_opt;
                 mockturtle::names_view<mockturtle::klut_network> names_view{*klut_opt};
@@ -64,6 +67,7 @@ namespace alice
                 std::cout << "LUT = " << mapped.num_cells() << " lev = " << klut_depth.depth() << "\n";
                 std::cout << "#LUT Level Product = " << mapped.num_cells() * klut_depth.depth() << "\n";
                 std::cout << "Finshed LUT mapping\n";
+                stage.next("write");
                 if(out_file != ""){
                   std::cout << "filename = " << out_file << "\n";
                   if(oracle::checkExt(out_file, "bench")){
@@ -91,10 +95,12 @@ namespace alice
               ps.cut_enumeration_ps.cut_size = lut_size;
               ps.cut_enumeration_ps.cut_limit = cut_size;
 
+              oracle::profile_scope stage("lut_mapping");
               mockturtle::lut_mapping<mockturtle::mapping_view<mockturtle::aig_network, true>, true>( mapped, ps );
 
               std::cout << "number of cells = " << mapped.num_cells() << "\n";
 
+              stage.next("collapse");
               const auto klut_opt = mockturtle::collapse_mapped_network<mockturtle::klut_network>( mapped );
               // auto const& klut = *klut_opt;
               mockturtle::names_view<mockturtle::klut_network> names_view{*klut_opt};
@@ -119,6 +125,7 @@ namespace alice
               std::cout << "LUT = " << mapped.num_cells() << " lev = " << klut_depth.depth() << "\n";
               std::cout << "#LUT Level Product = " << mapped.num_cells() * klut_depth.depth() << "\n";
               std::cout << "Finshed LUT mapping\n";
+              stage.next("write");
               if(out_file != ""){
                 std::cout << "filename = " << out_file << "\n";
                 if(oracle::checkExt(out_file, "bench")){
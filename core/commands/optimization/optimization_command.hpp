@@ -28,15 +28,21 @@ namespace alice
                 opts.add_option( "--out,-o", out_file, "Verilog output" );
                 opts.add_option( "--strategy,-s", strategy, "classification strategy [area delay product=0, area=1, delay=2, delay_threshold=3]" );
                 opts.add_option( "--threshold", threshold, "maximum delay threshold for strategy 3" );
+                opts.add_option( "--hybrid_margin", hybrid_margin, "With --nn_model, classify partitions whose classifier softmax margin is below this value by high effort optimization" );
                 opts.add_option( "--aig_partitions", aig_parts, "space separated list of partitions to always be AIG optimized" );
                 opts.add_option( "--mig_partitions", mig_parts, "space separated list of partitions to always be MIG optimized" );
                 opts.add_option( "--depth_partitions", depth_parts, "space separated list of partitions to always be depth optimized" );
                 opts.add_option( "--skip_partitions", skip_parts, "space separated list of partitions that will not be optimized");
                 opts.add_option( "--area_partitions", area_parts, "space separated list of partitions to always be area optimized" );
+                opts.add_option( "--backend,-b", backend, "Repartition the stored AIG with this partitioner first [" + oracle::partitioner_list<aig_names>() + "]" );
+                opts.add_option( "--num", num_partitions, "With --backend, number of partitions (Network Size / 300 if not specified)" );
+                opts.add_option( "--config", config_file, "With --backend, KaHyPar configuration file" );
                 add_flag("--aig,-a", "Perform only AIG optimization on all partitions");
                 add_flag("--mig,-m", "Perform only MIG optimization on all partitions");
                 add_flag("--combine,-c", "Combine adjacent partitions that have been classified for the same optimization");
                 add_flag("--skip-feedthrough", "Do not include feedthrough nets when writing out the file");
+                add_flag("--verify", "Check every optimized partition against its original logic and keep the original logic if both scripts fail");
+                add_flag("--project_progress", "With high effort optimization, also stop a candidate whose projected progress cannot beat the other one; faster but lossy, it may discard the better result");
         }
 
     protected:
@@ -45,6 +51,16 @@ namespace alice
         if(!store<aig_ntk>().empty()){
           auto ntk_aig = *store<aig_ntk>().current();
           mockturtle::depth_view orig_depth{ntk_aig};
+          if(is_set("backend")){
+            oracle::partitioner_params ps;
+            ps.num_partitions = num_partitions > 0 ? num_partitions : std::ceil(ntk_aig.size() / 300.0);
+            ps.config_file = config_file;
+            auto assignment = oracle::run_partitioner(backend, ntk_aig, ps);
+            if(!assignment.valid())
+              return;
+            std::cout << ntk_aig._storage->net_name << " partitioned " << assignment.num_partitions << " times with " << backend << "\n";
+            store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( ntk_aig, assignment.partition, assignment.num_partitions );
+          }
           if(!store<part_man_aig_ntk>().empty()){
             auto partitions_aig = *store<part_man_aig_ntk>().current();
             if(!nn_model.empty())
@@ -69,7 +85,7 @@ namespace alice
                                                 high, aig, mig, combine,
                                                 aig_always_partitions, mig_always_partitions,
                                                 depth_always_partitions, area_always_partitions,
-                                                skip_partitions);
+                                                skip_partitions, hybrid_margin, is_set("verify"), is_set("project_progress"));
             auto stop = std::chrono::high_resolution_clock::now();
 
 
@@ -121,6 +137,9 @@ namespace alice
     private:
         std::string nn_model{};
         std::string out_file{};
+        std::string backend{};
+        std::string config_file{};
+        int num_partitions{0};
         std::vector<int32_t> aig_parts{};
         std::vector<int32_t> mig_parts{};
         std::vector<int32_t> area_parts{};
@@ -128,6 +147,7 @@ namespace alice
         std::vector<int32_t> skip_parts{};
         unsigned strategy{0u};
         unsigned threshold{0u};
+        float hybrid_margin{0.0f};
         bool high = false;
         bool aig = false;
         bool mig = false;
@@ -29,36 +29,89 @@ namespace alice
                 opts.add_option( "--nn_model,-n", nn_model, "Trained neural network model for classification" );
                 opts.add_option( "--out,-o", out_file, "output file to write resulting network to [.v, .blif]" );
                 opts.add_option( "--strategy,-s", strategy, "classification strategy [area delay product{DEFAULT}=0, area=1, delay=2]" );
+                opts.add_option( "--hybrid_margin", hybrid_margin, "With --nn_model, classify partitions whose classifier softmax margin is below this value by high effort optimization" );
 		opts.add_option("--config,-f", config_file, "Config file", true);
+                opts.add_option( "--backend,-b", backend, "Partitioner to use, kahypar by default [" + oracle::partitioner_list<aig_names>() + "]" );
+                opts.add_option( "--profile", profile_file, "Profile the stages of this run and write the report to this file, CSV if it ends with .csv and JSON otherwise" );
+                opts.add_option( "--qor_floor", qor_floor, "With --auto_k, minimum fraction of the best sampled gate reduction a partition size must keep" );
+                add_flag("--auto_k", "Choose the number of partitions from a runtime model fitted on sampled windows of the network");
                 add_flag("--aig,-a", "Perform only AIG optimization on all partitions");
                 add_flag("--mig,-m", "Perform only MIG optimization on all partitions");
                 add_flag("--combine,-c", "Combine adjacent partitions that have been classified for the same optimization");
                 add_flag("--skip-feedthrough", "Do not include feedthrough nets when writing out the file");
+                add_flag("--verify", "Check every optimized partition against its original logic and keep the original logic if both scripts fail");
+                add_flag("--project_progress", "With high effort optimization, also stop a candidate whose projected progress cannot beat the other one; faster but lossy, it may discard the better result");
 #ifdef ENABLE_GALOIS
-                add_flag("--bipart,-g", "Use BiPart from the Galois system for partitioning");
+                add_flag("--bipart,-g", "Use BiPart from the Galois system for partitioning (same as --backend bipart)");
 #endif
         }
 
     protected:
       void execute(){
+        {
+          oracle::profile_session session(is_set("profile"));
+          optimize();
+        }
+
+        if(is_set("profile")){
+          if(oracle::profiler::get().write(profile_file))
+            std::cout << "Profile written to " << profile_file << "\n";
+          else
+            std::cout << "Unable to write " << profile_file << "\n";
+        }
+      }
 
+    private:
+      void optimize(){
+        oracle::profile_scope profile("oracle");
         if(!store<aig_ntk>().empty()){
           auto ntk = *store<aig_ntk>().current();
+          int num_parts = num_partitions;
+          std::string part_backend = is_set("backend") ? backend : "kahypar";
+#ifdef ENABLE_GALOIS
+          if(is_set("bipart"))
+            part_backend = "bipart";
+#endif
+          oracle::partition_sizing_result sizing;
+          if(is_set("auto_k")){
+            oracle::profile_scope stage("auto_k");
+            oracle::partition_sizing_params sizing_ps;
+            sizing_ps.run_aig = !is_set("mig");
+            sizing_ps.run_mig = !is_set("aig");
+            /* a classified partition runs one script, unless its margin is
+               too low for --hybrid_margin */
+            sizing_ps.run_both = nn_model.empty() || hybrid_margin > 0;
+            sizing_ps.qor_floor = qor_floor;
+            sizing_ps.backend = part_backend;
+            sizing_ps.partitioning.config_file = config_file;
+            sizing = oracle::estimate_partition_count(ntk, sizing_ps);
+            num_parts = sizing.num_partitions;
+            std::cout << "Auto partitioning: " << num_parts << " partitions of ~" << (int) sizing.partition_size << " gates, predicted runtime "
+                      << sizing.predicted_total_ms() << "ms (partitioning " << sizing.predicted_partitioning_ms
+                      << "ms + optimization " << sizing.predicted_optimization_ms << "ms)\n";
+          }
           //If number of partitions is not specified
-          if(num_partitions == 0){
+          if(num_parts == 0){
             double size = ( (double) ntk.size() ) / 300.0;
-            num_partitions = ceil(size);
+            num_parts = ceil(size);
           }
 
           mockturtle::depth_view orig_depth{ntk};
-          if(config_file == ""){
-            config_file = make_temp_config();
-          }
 
-          oracle::partition_manager<aig_names> partitions(ntk, num_partitions, config_file);
+          oracle::partitioner_params part_ps;
+          part_ps.num_partitions = num_parts;
+          part_ps.config_file = config_file;
+
+          auto part_start = std::chrono::high_resolution_clock::now();
+          auto assignment = oracle::run_partitioner(part_backend, ntk, part_ps);
+          if(!assignment.valid())
+            return;
+          num_parts = assignment.num_partitions;
+          oracle::partition_manager<aig_names> partitions(ntk, assignment.partition, num_parts);
+          auto part_stop = std::chrono::high_resolution_clock::now();
           store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
 
-          std::cout << ntk._storage->net_name << " partitioned " << num_partitions << " times\n";
+          std::cout << ntk._storage->net_name << " partitioned " << num_parts << " times\n";
           if(!nn_model.empty())
             high = false;
           else
@@ -73,10 +126,18 @@ namespace alice
           auto start = std::chrono::high_resolution_clock::now();
 
           auto ntk_mig = oracle::optimization_test(ntk, partitions, strategy, nn_model,
-            high, aig, mig, combine);
+            high, aig, mig, combine, hybrid_margin, is_set("verify"), is_set("project_progress"));
 
           auto stop = std::chrono::high_resolution_clock::now();
 
+          if(is_set("auto_k")){
+            auto part_duration = std::chrono::duration_cast<std::chrono::milliseconds>(part_stop - part_start);
+            auto opt_duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
+            std::cout << "Predicted runtime " << sizing.predicted_total_ms() << "ms, actual "
+                      << part_duration.count() + opt_duration.count() << "ms (partitioning " << part_duration.count()
+                      << "ms + optimization " << opt_duration.count() << "ms)\n";
+          }
+
           mockturtle::depth_view new_depth{ntk_mig};
           if (ntk_mig.size() != ntk.size() || orig_depth.depth() != new_depth.depth()){
             std::cout << "Final ntk size = " << ntk_mig.num_gates() << " and depth = " << new_depth.depth() << "\n";
@@ -120,20 +181,21 @@ namespace alice
           std::cout << "AIG network not stored\n";
         }
       }
-    private:
+
       std::string filename{};
+      std::string profile_file{};
       int num_partitions{0u};
       std::string nn_model{};
       std::string out_file{};
       std::string config_file{};
+      std::string backend{};
       unsigned strategy{0u};
+      double qor_floor{0.0};
+      float hybrid_margin{0.0f};
       bool high = false;
       bool aig = false;
       bool mig = false;
       bool combine = false;
-#ifdef ENABLE_GALOIS
-      bool bipart = false;
-#endif
     };
 
   ALICE_ADD_COMMAND(oracle, "Optimization");
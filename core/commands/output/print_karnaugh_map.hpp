@@ -34,7 +34,10 @@ namespace alice
       explicit print_karnaugh_command( const environment::ptr& env )
           : command( env, "Prints all the partitioned truth tables as Karnaugh maps" ){
 
-        opts.add_option("--directory,-d", directory, "Directory to write files to")->required();
+        opts.add_option("--directory,-d", directory, "Directory to write one file per k-map to");
+        opts.add_option("--dataset,-D", dataset, "Append all k-maps to a single binary dataset file");
+        add_flag("--zstd,-z", "Compress the dataset with zstd");
+        opts.add_option("--level,-l", compression_level, "zstd compression level [DEFAULT = 3]");
         opts.add_option( "--filename,-f", filename, "Classification File to read from" );
         add_flag("--tensor,-t", "Write the k-maps to tensor dataset depending on <filename>");
         add_flag("--mig,-m", "Read from the MIG network and MIG partition manager for k-maps");
@@ -44,7 +47,10 @@ namespace alice
     protected:
       void execute(){
 
-        if(is_set("mig")){
+        if(directory.empty() && dataset.empty()){
+          std::cout << "Specify a directory (-d) or a dataset file (-D)\n";
+        }
+        else if(is_set("mig")){
           std::cout << "MIG networks not supported yet\n";
         }
         else{
@@ -53,7 +59,19 @@ namespace alice
             if(!store<part_man_aig_ntk>().empty()){
               std::cout << "Writing k-map images for stored AIG network\n";
               auto partitions = *store<part_man_aig_ntk>().current();
-              partitions.write_karnaugh_maps(aig, directory);
+              if(!dataset.empty()){
+                oracle::kmap_dataset_params ps;
+                ps.compress = is_set("zstd");
+                ps.compression_level = compression_level;
+                oracle::kmap_dataset_writer writer(dataset, ps);
+                if(writer.good()){
+                  const auto num_records = partitions.write_karnaugh_dataset(aig, writer);
+                  writer.close();
+                  std::cout << "Appended " << num_records << " k-maps to " << dataset << "\n";
+                }
+              }
+              if(!directory.empty())
+                partitions.write_karnaugh_maps(aig, directory);
             }
             else{
               std::cout << "AIG not partitioned yet\n";
@@ -68,6 +86,8 @@ namespace alice
     private:
       std::string filename{};
       std::string directory{};
+      std::string dataset{};
+      int compression_level{3};
   };
 
   ALICE_ADD_COMMAND(print_karnaugh, "Output");
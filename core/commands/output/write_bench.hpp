@@ -25,16 +25,19 @@ namespace alice
           : command( env, "Writes the Boolean network into bench format" ){
 
         opts.add_option( "--filename,filename", filename, "Bench file to write out to" )->required();
+        opts.add_option( "--threads,-t", num_threads, "Number of threads formatting the netlist [DEFAULT = 1]" );
         add_flag("--mig,-m", "Read from the MIG network");
       }
 
     protected:
       void execute(){
         if(oracle::checkExt(filename, "bench")){
+          mockturtle::write_bench_params ps;
+          ps.num_threads = num_threads;
           if(is_set("mig")){
             if(!store<mig_ntk>().empty()){
               auto& mig = *store<mig_ntk>().current();
-              mockturtle::write_bench(mig, filename);
+              mockturtle::write_bench(mig, filename, ps);
             }
             else{
               std::cout << "There is not an MIG network stored.\n";
@@ -43,7 +46,7 @@ namespace alice
           else{
             if(!store<aig_ntk>().empty()){
               auto& aig = *store<aig_ntk>().current();
-              mockturtle::write_bench(aig, filename);
+              mockturtle::write_bench(aig, filename, ps);
             }
             else{
               std::cout << "There is not an AIG network stored.\n";
@@ -56,6 +59,7 @@ namespace alice
       }
     private:
       std::string filename{};
+      uint32_t num_threads{1u};
   };
 
   ALICE_ADD_COMMAND(write_bench, "Output");
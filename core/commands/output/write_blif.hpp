@@ -25,6 +25,7 @@ namespace alice
           : command( env, "Writes the Boolean network into BLIF format" ){
 
         opts.add_option( "--filename,filename", filename, "BLIF file to write out to" )->required();
+        opts.add_option( "--threads,-t", num_threads, "Number of threads formatting the netlist [DEFAULT = 1]" );
         add_flag("--mig,-m", "Read from the MIG network");
         add_flag("--skip-feedthrough", "Do not include feedthrough nets when writing out the file");
       }
@@ -33,6 +34,7 @@ namespace alice
       void execute(){
         if(oracle::checkExt(filename, "blif")){
           mockturtle::write_blif_params ps;
+          ps.num_threads = num_threads;
           if(is_set("skip-feedthrough"))
             ps.skip_feedthrough = 1u;
           if(is_set("mig")){
@@ -60,6 +62,7 @@ namespace alice
       }
     private:
       std::string filename{};
+      uint32_t num_threads{1u};
   };
 
   ALICE_ADD_COMMAND(write_blif, "Output");
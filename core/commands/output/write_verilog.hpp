@@ -25,6 +25,7 @@ namespace alice
           : command( env, "Writes the Boolean network into structural verilog" ){
 
         opts.add_option( "--filename,filename", filename, "Verilog file to write out to" )->required();
+        opts.add_option( "--threads,-t", num_threads, "Number of threads formatting the netlist [DEFAULT = 1]" );
         add_flag("--mig,-m", "Read from the MIG network");
         add_flag("--xag,-x", "Read from the XAG network");
         add_flag("--skip-feedthrough", "Do not include feedthrough nets when writing out the file");
@@ -34,6 +35,7 @@ namespace alice
         void execute(){
         if(oracle::checkExt(filename, "v")){
           mockturtle::write_verilog_params ps;
+          ps.num_threads = num_threads;
           if(is_set("skip-feedthrough"))
             ps.skip_feedthrough = 1u;
           if(is_set("mig")){
@@ -70,6 +72,7 @@ namespace alice
       }
     private:
       std::string filename{};
+      uint32_t num_threads{1u};
   };
 
   ALICE_ADD_COMMAND(write_verilog, "Output");
@@ -0,0 +1,48 @@
+#include <alice/alice.hpp>
+
+#include <iomanip>
+
+#include "kahypar_config.hpp"
+
+namespace alice
+{
+  class kahypar_contexts_command : public alice::command{
+
+    public:
+      explicit kahypar_contexts_command( const environment::ptr& env )
+        : command( env, "Lists, prepares or clears the KaHyPar contexts kept for later partitioning" ) {
+
+          opts.add_option( "--config_direc,-c", config_direc, "Configuration file of the prepared context (built-in configuration by default)" );
+          add_flag( "--prepare,-p", "Configure the context now instead of on its first use" );
+          add_flag( "--clear", "Free all kept contexts; the next partitioning configures them again" );
+        }
+
+    protected:
+      void execute(){
+        if(is_set("clear")){
+          kahypar_clear_contexts();
+          std::cout << "KaHyPar contexts cleared\n";
+        }
+        if(is_set("prepare"))
+          kahypar_prepare_context(config_direc);
+
+        auto const contexts = kahypar_cached_contexts();
+        if(contexts.empty()){
+          std::cout << "No KaHyPar contexts\n";
+        }
+        else{
+          std::cout << std::right << std::setw(8) << "uses" << "  configuration\n";
+          for(auto const& context : contexts){
+            std::cout << std::setw(8) << context.uses << "  " << (context.preset.empty() ? "built-in" : context.preset) << "\n";
+          }
+        }
+
+        config_direc.clear();
+      }
+
+    private:
+      std::string config_direc = "";
+  };
+
+  ALICE_ADD_COMMAND(kahypar_contexts, "Partitioning");
+}
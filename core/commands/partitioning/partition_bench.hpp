@@ -0,0 +1,130 @@
+#include <alice/alice.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "kahypar_config.hpp"
+
+namespace alice
+{
+  class partition_bench_command : public alice::command{
+
+    public:
+      using aig_names = mockturtle::names_view<mockturtle::aig_network>;
+      using aig_ntk = std::shared_ptr<aig_names>;
+      using mig_names = mockturtle::names_view<mockturtle::mig_network>;
+      using mig_ntk = std::shared_ptr<mig_names>;
+
+      explicit partition_bench_command( const environment::ptr& env )
+        : command( env, "Compares the partitioners on the stored network" ) {
+
+          opts.add_option( "--num,-k", num_partitions, "Number of desired partitions", true );
+          opts.add_option( "--backends,-b", backends, "Space separated partitioners to compare [" + oracle::partitioner_list<aig_names>() + "], all but file by default" );
+          opts.add_option( "--config_direc,-c", config_direc, "Path to the configuration file for KaHyPar." );
+          opts.add_option( "--file,-f", part_file, "External file containing partition information, adds the file backend" );
+          opts.add_option( "--threads,-t", num_threads, "Number of threads for BiPart and hierarchical, 0 uses every CPU available to the process" );
+          opts.add_option( "--super_blocks", super_blocks, "Super-blocks of the hierarchical backend, 0 is the square root of the number of partitions" );
+          opts.add_option( "--csv", csv_file, "Also write the results to this CSV file" );
+          add_flag( "--mig,-m", "Compare on the stored MIG network (AIG network is default)" );
+#ifdef ENABLE_GALOIS
+          add_flag( "--nondeterministic", "Let the BiPart partition depend on the number of threads and their scheduling" );
+#endif
+        }
+
+    protected:
+      void execute(){
+        if(num_partitions <= 0){
+          std::cout << "Number of partitions must be positive\n";
+          return;
+        }
+
+        if(is_set("mig")){
+          if(!store<mig_ntk>().empty())
+            bench(*store<mig_ntk>().current());
+          else
+            std::cout << "MIG network not stored\n";
+        }
+        else{
+          if(!store<aig_ntk>().empty())
+            bench(*store<aig_ntk>().current());
+          else
+            std::cout << "AIG network not stored\n";
+        }
+
+        /* options that are not given on the next call must not carry over */
+        backends.clear();
+        part_file.clear();
+        csv_file.clear();
+      }
+
+    private:
+      template<class Ntk>
+      void bench(Ntk const& ntk){
+        oracle::partitioner_params ps;
+        ps.num_partitions = num_partitions;
+        ps.config_file = config_direc;
+        ps.num_threads = num_threads;
+        ps.super_blocks = super_blocks;
+#ifdef ENABLE_GALOIS
+        ps.deterministic = !is_set("nondeterministic");
+#endif
+        ps.partition_file = part_file;
+
+        std::vector<std::string> names = backends;
+        if(names.empty()){
+          for(auto const& name : oracle::partitioner_names<Ntk>())
+            if(name != "file" || !part_file.empty())
+              names.push_back(name);
+        }
+
+        std::stringstream csv;
+        csv << "backend,partitions,cut_size,connectivity,imbalance,runtime_ms,allocated_bytes,rss_growth_kb\n";
+        std::stringstream table;
+        table << std::left << std::setw(12) << "backend" << std::right << std::setw(6) << "k" << std::setw(10) << "cut"
+              << std::setw(10) << "km1" << std::setw(11) << "imbalance" << std::setw(12) << "runtime ms" << std::setw(12)
+              << "alloc MB" << std::setw(12) << "RSS +MB" << "\n";
+        table << std::fixed;
+        for(auto const& name : names){
+          /* how far the resident set grows above its size before the run at
+             its peak during the run; resetting the peak affects the whole
+             process, so only the benchmark does it (0 outside Linux) */
+          const bool peak_reset = oracle::profiler::reset_peak_rss();
+          const auto start_rss = oracle::profiler::rss_kb();
+          auto assignment = oracle::run_partitioner(name, ntk, ps);
+          const auto peak_rss = peak_reset ? oracle::profiler::rss_kb(true) : -1;
+          const long rss_growth_kb = start_rss >= 0 && peak_rss >= 0 ? std::max(0L, peak_rss - start_rss) : 0L;
+          if(!assignment.valid()){
+            table << std::left << std::setw(12) << name << std::right << std::setw(6) << "-" << "  failed\n";
+            continue;
+          }
+          auto const& stats = assignment.stats;
+          table << std::left << std::setw(12) << name << std::right << std::setw(6) << assignment.num_partitions
+                << std::setw(10) << stats.cut_size << std::setw(10) << stats.connectivity << std::setprecision(3)
+                << std::setw(11) << stats.imbalance << std::setprecision(1) << std::setw(12) << stats.runtime_ms
+                << std::setw(12) << stats.allocated_bytes / 1048576.0 << std::setw(12) << rss_growth_kb / 1024.0 << "\n";
+          csv << name << "," << assignment.num_partitions << "," << stats.cut_size << "," << stats.connectivity << ","
+              << stats.imbalance << "," << stats.runtime_ms << "," << stats.allocated_bytes << "," << rss_growth_kb << "\n";
+        }
+        std::cout << table.str();
+
+        if(!csv_file.empty()){
+          std::ofstream os(csv_file);
+          if(os << csv.str())
+            std::cout << "Results written to " << csv_file << "\n";
+          else
+            std::cout << "Unable to write " << csv_file << "\n";
+        }
+      }
+
+      int num_partitions{2};
+      std::vector<std::string> backends;
+      std::string config_direc = "";
+      std::string part_file = "";
+      std::string csv_file = "";
+      uint32_t num_threads{0u};
+      int super_blocks{0};
+  };
+
+  ALICE_ADD_COMMAND(partition_bench, "Partitioning");
+}
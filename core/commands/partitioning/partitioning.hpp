@@ -14,11 +14,7 @@
 
 #include <sys/stat.h>
 #include <stdlib.h>
-// #include <utah/BiPart.h>
 #include "kahypar_config.hpp"
-#ifdef ENABLE_GALOIS
-#include <utah/BiPart.h>
-#endif
 
 namespace alice
 {
@@ -38,161 +34,91 @@ namespace alice
       explicit partitioning_command( const environment::ptr& env )
         : command( env, "Partitionins current network using k-means hypergraph partitioner" ) {
 
-          opts.add_option( "--num,num", num_partitions, "Number of desired partitions" )->required();
+          opts.add_option( "--num,num", num_partitions, "Number of desired partitions" );
+          opts.add_option( "--backend,-b", backend, "Partitioner to use, kahypar by default [" + oracle::partitioner_list<aig_names>() + "]" );
           opts.add_option( "--config_direc,-c", config_direc, "Path to the configuration file for KaHyPar." );
-          opts.add_option("--file,-f", part_file, "External file containing partitiion information");
+          opts.add_option("--file,-f", part_file, "External file containing partitiion information (file backend)");
+          opts.add_option( "--threads,-t", num_threads, "Number of threads for BiPart and hierarchical, 0 uses every CPU available to the process" );
+          opts.add_option( "--super_blocks", super_blocks, "Super-blocks of the hierarchical backend, 0 is the square root of the number of partitions" );
           add_flag("--mig,-m", "Partitions stored MIG network (AIG network is default)");
+          add_flag("--auto_k", "Choose the number of partitions from a runtime model fitted on sampled windows of the network");
 #ifdef ENABLE_GALOIS
-          add_flag("--bipart,-g", "Run hypergraph partitionining using BiPart from the Galois system");
+          add_flag("--bipart,-g", "Run hypergraph partitionining using BiPart from the Galois system (same as --backend bipart)");
+          add_flag("--nondeterministic", "Let the BiPart partition depend on the number of threads and their scheduling");
 #endif
         }
 
     protected:
       void execute(){
-        mockturtle::mig_npn_resynthesis resyn_mig;
-        mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn_aig;
-
-        if(is_set("mig")){
-          if(!store<mig_ntk>().empty()){
-            auto ntk = *store<mig_ntk>().current();
-            if(part_file != ""){
-              std::cout << "Partitioning stored MIG network using external file\n";
-              std::map<mockturtle::mig_network::node, int> part_data;
-              std::ifstream ifs;
-
-              ifs.open(part_file);
-              int nodeIdx = 1;
-              if(ifs.is_open()){
-                while(ifs.good()){
-                  if(nodeIdx > ntk.size()){
-                    std::cout << "Partition file contains the incorrect number of nodes\n";
-                    exit(1);
-                  }
-                  std::string part;
-                  getline(ifs, part);
-                  int test = std::stoi(part);
-                  part_data[ntk.index_to_node(nodeIdx)] = std::stoi(part);
-                  nodeIdx++;
-                }
-                ifs.close();
-                oracle::partition_manager<mig_names> partitions(ntk, part_data, num_partitions);
-                store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
-              }
-              else{
-                std::cout << "Unable to open partition data file\n";
-              }
-            }
-            else{
+        std::string name = is_set("backend") ? backend : "kahypar";
+        if(part_file != "")
+          name = "file";
 #ifdef ENABLE_GALOIS
-              if(is_set("bipart")){
-                std::cout << "Partitioning stored MIG network using Galois BiPart\n";
-                oracle::hypergraph<mig_names> t(ntk);
-                uint32_t num_vertices = 0;
-
-                t.get_hypergraph(ntk);
-                std::vector<std::vector<uint32_t>> hedges = t.get_hyperedges();
-                num_vertices = t.get_num_vertices();
-
-                int num_threads = 14;
-                scheduleMode mode = PP;
-                std::map<int, int> bipart = biparting(hedges, num_vertices, num_partitions, num_threads, mode);
-                std::map<mockturtle::mig_network::node, int> part_data;
-                ntk.foreach_node([&](auto node){
-                  part_data[node] = bipart[node];
-                });
-
-                oracle::partition_manager<mig_names> partitions(ntk, part_data, num_partitions);
-                store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
-              }
-              else
+        if(is_set("bipart"))
+          name = "bipart";
 #endif
-              {
-                std::cout << "Partitioning stored MIG network using KaHyPar\n";
-                if(config_direc == ""){
-                  config_direc = make_temp_config();
-                }
-                oracle::partition_manager<mig_names> partitions(ntk, num_partitions, config_direc);
-                store<part_man_mig_ntk>().extend() = std::make_shared<part_man_mig>( partitions );
-              }
-            }
-          }
-          else{
+
+        if(num_partitions <= 0 && !is_set("auto_k") && name != "file"){
+          std::cout << "Number of partitions not specified (use --num or --auto_k)\n";
+          return;
+        }
+
+        if(is_set("mig")){
+          if(!store<mig_ntk>().empty())
+            partition(*store<mig_ntk>().current(), store<part_man_mig_ntk>(), "MIG", name);
+          else
             std::cout << "MIG network not stored\n";
-          }
         }
         else{
-          if(!store<aig_ntk>().empty()){
-            auto ntk = *store<aig_ntk>().current();
-            if(part_file != ""){
-              std::cout << "Partitioning stored AIG network using external file\n";
-              std::map<mockturtle::aig_network::node, int> part_data;
-              std::ifstream ifs;
-
-              ifs.open(part_file);
-              int nodeIdx = 1;
-              if(ifs.is_open()){
-                while(ifs.good()){
-                  if(nodeIdx > ntk.size()){
-                    std::cout << "Partition file contains the incorrect number of nodes\n";
-                    exit(1);
-                  }
-                  std::string part;
-                  getline(ifs, part);
-                  int test = std::stoi(part);
-                  part_data[ntk.index_to_node(nodeIdx)] = std::stoi(part);
-                  nodeIdx++;
-                }
-                ifs.close();
-                oracle::partition_manager<aig_names> partitions(ntk, part_data, num_partitions);
-                store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
-              }
-              else{
-                std::cout << "Unable to open partition data file\n";
-              }
-            }
-            else{
-#ifdef ENABLE_GALOIS
-              if(is_set("bipart")){
-                std::cout << "Partitioning stored AIG network using Galois BiPart\n";
-                oracle::hypergraph<aig_names> t(ntk);
-                uint32_t num_vertices = 0;
-
-                t.get_hypergraph(ntk);
-                std::vector<std::vector<uint32_t>> hedges = t.get_hyperedges();
-                num_vertices = t.get_num_vertices();
-
-                int num_threads = 14;
-                scheduleMode mode = PP;
-                std::map<int, int> bipart = biparting(hedges, num_vertices, num_partitions, num_threads, mode);
-                std::map<mockturtle::aig_network::node, int> part_data;
-                ntk.foreach_node([&](auto node){
-                  part_data[node] = bipart[node];
-                });
-
-                oracle::partition_manager<aig_names> partitions(ntk, part_data, num_partitions);
-                store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
-              }
-              else
-#endif
-              {
-                std::cout << "Partitioning stored AIG network using KaHyPar\n";
-                if(config_direc == ""){
-                  config_direc = make_temp_config();
-                }
-                oracle::partition_manager<aig_names> partitions(ntk, num_partitions, config_direc);
-                store<part_man_aig_ntk>().extend() = std::make_shared<part_man_aig>( partitions );
-              }
-            }
-          }
-          else{
+          if(!store<aig_ntk>().empty())
+            partition(*store<aig_ntk>().current(), store<part_man_aig_ntk>(), "AIG", name);
+          else
             std::cout << "AIG network not stored\n";
-          }
         }
+
+        part_file = "";
       }
+
     private:
+      template<class Ntk, class Store>
+      void partition(Ntk ntk, Store&& parts, std::string const& type, std::string const& name){
+        std::cout << "Partitioning stored " << type << " network using " << name << "\n";
+        oracle::partitioner_params ps;
+        ps.num_partitions = num_partitions;
+        ps.config_file = config_direc;
+        ps.num_threads = num_threads;
+        ps.super_blocks = super_blocks;
+#ifdef ENABLE_GALOIS
+        ps.deterministic = !is_set("nondeterministic");
+#endif
+        ps.partition_file = part_file;
+        if(is_set("auto_k")){
+          oracle::partition_sizing_params sizing_ps;
+          sizing_ps.num_threads = num_threads;
+          sizing_ps.backend = name;
+          sizing_ps.partitioning = ps;
+          auto sizing = oracle::estimate_partition_count(ntk, sizing_ps);
+          ps.num_partitions = sizing.num_partitions;
+          std::cout << "Auto partitioning: " << ps.num_partitions << " partitions of ~" << (int) sizing.partition_size
+                    << " gates, predicted runtime " << sizing.predicted_total_ms() << "ms\n";
+        }
+        if(name == "file" && ps.num_partitions <= 0)
+          ps.num_partitions = 1;
+
+        auto assignment = oracle::run_partitioner(name, ntk, ps);
+        if(!assignment.valid())
+          return;
+        std::cout << assignment.num_partitions << " partitions, cut size " << assignment.stats.cut_size << ", imbalance "
+                  << assignment.stats.imbalance << ", " << assignment.stats.runtime_ms << "ms\n";
+        parts.extend() = std::make_shared<oracle::partition_manager<Ntk>>( ntk, assignment.partition, assignment.num_partitions );
+      }
+
       int num_partitions{};
+      std::string backend{};
       std::string config_direc = "";
       std::string part_file = "";
+      uint32_t num_threads{0u};
+      int super_blocks{0};
   };
 
   ALICE_ADD_COMMAND(partitioning, "Partitioning");
@@ -0,0 +1,71 @@
+#include <alice/alice.hpp>
+
+#include <stdio.h>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <stdlib.h>
+
+
+namespace alice
+{
+  /*Controls the stage profiler and reports its results*/
+  class profile_command : public alice::command{
+
+    public:
+      explicit profile_command( const environment::ptr& env )
+          : command( env, "Profiles the stages of the following commands (wall and CPU time, allocations, peak RSS)" ){
+
+        opts.add_option( "--write,-w", filename, "Write the report to this file, CSV if it ends with .csv and JSON otherwise" );
+        add_flag("--start,-s", "Clear the previous results and start profiling");
+        add_flag("--stop,-e", "Stop profiling");
+
+        /* the profiler belongs to the thread, a new shell on it, i.e., the
+           next server job on the same worker, starts without the results of
+           the previous one */
+        auto& profiler = oracle::profiler::get();
+        profiler.stop();
+        profiler.clear();
+      }
+
+    protected:
+      void execute(){
+        auto& profiler = oracle::profiler::get();
+        if(is_set("start") && is_set("stop")){
+          std::cout << "Only one of --start and --stop can be given\n";
+          return;
+        }
+        if(is_set("start")){
+          profiler.start();
+          std::cout << "Profiling started\n";
+          return;
+        }
+        if(is_set("stop"))
+          profiler.stop();
+
+        if(!profiler.has_results()){
+          std::cout << "Profiler has not been started\n";
+          return;
+        }
+        if(oracle::profiler::enabled()){
+          std::cout << "Profiler is running, stop it with profile --stop first\n";
+          return;
+        }
+
+        if(is_set("write")){
+          if(profiler.write(filename))
+            std::cout << "Profile written to " << filename << "\n";
+          else
+            std::cout << "Unable to write " << filename << "\n";
+        }
+        else{
+          profiler.print(std::cout);
+        }
+      }
+
+    private:
+      std::string filename{};
+  };
+
+  ALICE_ADD_COMMAND(profile, "Stats");
+}
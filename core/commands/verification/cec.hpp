@@ -0,0 +1,105 @@
+#include <alice/alice.hpp>
+
+#include <mockturtle/algorithms/sweeping_equivalence_checking.hpp>
+
+#include <stdio.h>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <stdlib.h>
+
+
+namespace alice
+{
+  /*Proves the stored AIG equivalent to the stored MIG, XAG or an AIGER file*/
+  class cec_command : public alice::command{
+
+    public:
+      explicit cec_command( const environment::ptr& env )
+          : command( env, "Combinational equivalence check of the stored AIG against the stored MIG (default), XAG or an AIGER file" ){
+
+        opts.add_option( "--file,-f", filename, "Check the stored AIG against this AIGER file" );
+        opts.add_option( "--threads,-t", ps.num_threads, "Number of output groups checked in parallel" );
+        opts.add_option( "--conflicts,-c", ps.conflict_limit, "Conflict limit for internal equivalences (0 = no limit)" );
+        opts.add_option( "--output_conflicts", ps.output_conflict_limit, "Conflict limit for output equivalences (0 = no limit)" );
+        opts.add_option( "--sim_blocks", ps.num_sim_blocks, "Number of 512-pattern blocks of random simulation" );
+        add_flag("--xag,-x", "Check the stored AIG against the stored XAG");
+        add_flag("--verbose,-v", "Print statistics");
+      }
+
+    protected:
+      void execute(){
+        if(store<aig_ntk>().empty()){
+          std::cout << "AIG network not stored\n";
+          return;
+        }
+        auto& spec = *store<aig_ntk>().current();
+        ps.verbose = is_set("verbose");
+
+        mockturtle::sweeping_equivalence_checking_stats st;
+        std::optional<bool> result;
+        bool interface_mismatch = false;
+        const auto check = [&](auto const& impl) -> std::optional<bool> {
+          if(spec.num_pis() != impl.num_pis() || spec.num_pos() != impl.num_pos()){
+            interface_mismatch = true;
+            std::cout << "Stored AIG has " << spec.num_pis() << " PIs and " << spec.num_pos() << " POs, the other network "
+                      << impl.num_pis() << " PIs and " << impl.num_pos() << " POs\n";
+            return false;
+          }
+          return mockturtle::sweeping_equivalence_checking(spec, impl, ps, &st);
+        };
+        if(!filename.empty()){
+          if(!oracle::checkExt(filename, "aig")){
+            std::cout << filename << " is not a valid aig file\n";
+            return;
+          }
+          mockturtle::aig_network impl;
+          if(lorina::read_aiger(filename, mockturtle::aiger_reader(impl)) != lorina::return_code::success){
+            std::cout << "Unable to read " << filename << "\n";
+            return;
+          }
+          result = check(impl);
+        }
+        else if(is_set("xag")){
+          if(store<xag_ntk>().empty()){
+            std::cout << "XAG network not stored\n";
+            return;
+          }
+          result = check(*store<xag_ntk>().current());
+        }
+        else{
+          if(store<mig_ntk>().empty()){
+            std::cout << "MIG network not stored\n";
+            return;
+          }
+          result = check(*store<mig_ntk>().current());
+        }
+
+        if(interface_mismatch){
+          std::cout << "Networks are NOT EQUIVALENT (PI/PO count mismatch)\n";
+        }
+        else if(!result){
+          std::cout << "Networks are UNDECIDED (" << st.num_undecided << " outputs exceeded the conflict limit)\n";
+        }
+        else if(*result){
+          std::cout << "Networks are EQUIVALENT\n";
+        }
+        else if(st.failing_output){
+          const auto o = *st.failing_output;
+          std::cout << "Networks are NOT EQUIVALENT, output "
+                    << (spec.has_output_name(o) ? spec.get_output_name(o) : std::to_string(o)) << " differs\n";
+          std::cout << "Counter-example:";
+          spec.foreach_pi([&](auto n, auto i){
+            const auto s = spec.make_signal(n);
+            std::cout << " " << (spec.has_name(s) ? spec.get_name(s) : "pi" + std::to_string(i)) << "=" << st.counter_example[i];
+          });
+          std::cout << "\n";
+        }
+      }
+    private:
+      std::string filename{};
+      mockturtle::sweeping_equivalence_checking_params ps;
+    };
+
+  ALICE_ADD_COMMAND(cec, "Verification");
+}
@@ -1,4 +1,3 @@
-
 /********************************************
  *  Source file: gts.hpp                    *
  *  Description: Header file for gts class  *
@@ -9,22 +8,32 @@
  ********************************************
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #define GTS_LOGIC_LEVEL_TAG "logic_level"
 #define GTS_GATE_LEVEL_TAG "gate_level"
 #define GTS_PNR_LEVEL_TAG "pnr_level"
 
-#define GTS_FAIL 1
-
-#define TRUE 1 
-#define FALSE 0
-
 namespace gts {
   class x_gts_opts {
   public:
     /* Configure internal variables */
     void add_benchmark_list(std::string input_list) {
       benchmark_list.assign(input_list);
-    } 
+    }
     void add_output_label_file(std::string input_filename) {
       output_label_file.assign(input_filename);
     }
@@ -46,31 +55,55 @@ namespace gts {
     void enable_pnr_level_training_set(bool input) {
       gen_pnr_level_training_set = input;
     }
+    void add_num_threads(unsigned input) {
+      num_threads = input;
+    }
+    void add_strategy(unsigned input) {
+      strategy = input;
+    }
+    void add_config_file(std::string input_filename) {
+      config_file.assign(input_filename);
+    }
+    void enable_compression(bool input) {
+      compress = input;
+    }
     /* Read internal variables */
-    std::string get_benchmark_list() {
+    std::string get_benchmark_list() const {
       return benchmark_list;
     }
-    std::string get_output_label_file() {
+    std::string get_output_label_file() const {
       return output_label_file;
     }
-    bool get_label_aig() {
+    bool get_label_aig() const {
       return label_aig;
-    } 
-    bool get_label_mig() {
+    }
+    bool get_label_mig() const {
       return label_mig;
-    } 
-    int get_partition_input_size() {
+    }
+    int get_partition_input_size() const {
       return partition_input_size;
     }
-    bool get_flag_logic_level_training_set() {
+    bool get_flag_logic_level_training_set() const {
       return gen_logic_level_training_set;
     }
-    bool get_flag_gate_level_training_set() {
+    bool get_flag_gate_level_training_set() const {
       return gen_gate_level_training_set;
     }
-    bool get_flag_pnr_level_training_set() {
+    bool get_flag_pnr_level_training_set() const {
       return gen_pnr_level_training_set;
     }
+    unsigned get_num_threads() const {
+      return num_threads;
+    }
+    unsigned get_strategy() const {
+      return strategy;
+    }
+    std::string get_config_file() const {
+      return config_file;
+    }
+    bool get_compression() const {
+      return compress;
+    }
   private:
     /* Variables to store Options */
     std::string benchmark_list{};
@@ -81,26 +114,361 @@ namespace gts {
     bool gen_logic_level_training_set{};
     bool gen_gate_level_training_set{};
     bool gen_pnr_level_training_set{};
+    unsigned num_threads{1u};
+    unsigned strategy{1u};
+    std::string config_file{};
+    bool compress{};
   };
-}
 
-namespace alice {
+  using aig_names = mockturtle::names_view<mockturtle::aig_network>;
+  using part_man_aig = oracle::partition_manager<aig_names>;
+
+  /* Label values stored in the dataset */
+  constexpr int32_t label_aig_value = 0;
+  constexpr int32_t label_mig_value = 1;
 
-  /* Implements the command gen_training_set */
+  /* Reads the benchmark list: one file per line, '#' starts a comment and
+     only the first comma separated field of a line is used */
+  inline std::vector<std::string> read_benchmark_list(std::string const& list_name) {
+    std::vector<std::string> file_names;
+    std::ifstream ifs(list_name);
+    std::string line;
+    while (std::getline(ifs, line)) {
+      line = line.substr(0, line.find('#'));
+      line = line.substr(0, line.find(','));
+      const auto first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos)
+        continue;
+      const auto last = line.find_last_not_of(" \t\r");
+      file_names.push_back(line.substr(first, last - first + 1));
+    }
+    return file_names;
+  }
+
+  /* A generic file reader for network files
+   * The file type will be recognized by the postfix
+   * .v, .blif, .bench or .aig, every type is converted into an AIG
+   */
+  inline bool read_network_file(std::string const& input_file, aig_names& aig) {
+    lorina::return_code result = lorina::return_code::parse_error;
+    if (oracle::checkExt(input_file, "aig")) {
+      result = mockturtle::read_aiger_mmap(input_file, aig);
+    } else if (oracle::checkExt(input_file, "v")) {
+      result = lorina::read_verilog(input_file, mockturtle::verilog_reader(aig));
+    } else if (oracle::checkExt(input_file, "blif") || oracle::checkExt(input_file, "bench")) {
+      mockturtle::klut_network klut;
+      mockturtle::names_view<mockturtle::klut_network> named_klut{klut};
+      if (oracle::checkExt(input_file, "blif"))
+        result = lorina::read_blif(input_file, mockturtle::blif_reader(named_klut));
+      else
+        result = lorina::read_bench(input_file, mockturtle::bench_reader(named_klut));
+      if (result == lorina::return_code::success)
+        mockturtle::node_resynthesis(aig, named_klut, oracle::xag_npn_database<mockturtle::aig_network>());
+    } else {
+      std::cout << "Error: Unable to recognize the file type of " << input_file << "!\n";
+      std::cout << "Supported files types are [.blif|.bench|.aig|.v]\n";
+      return false;
+    }
+    if (result != lorina::return_code::success) {
+      std::cout << "Error: Unable to parse " << input_file << "!\n";
+      return false;
+    }
+    return true;
+  }
+
+  /* Number and depth of the 6-LUTs a network is mapped into */
+  template<class Ntk>
+  std::pair<int, int> lut_cost(Ntk const& ntk) {
+    mockturtle::mapping_view<Ntk, true> mapped{ntk};
+    mockturtle::lut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 6;
+    mockturtle::lut_mapping<mockturtle::mapping_view<Ntk, true>, true>(mapped, ps);
+    const auto klut = *mockturtle::collapse_mapped_network<mockturtle::klut_network>(mapped);
+    mockturtle::depth_view klut_depth{klut};
+    return {static_cast<int>(klut.num_gates()), static_cast<int>(klut_depth.depth())};
+  }
+
+  /* Optimizes a partition with both scripts and returns its label.  Logic
+     level labels compare the optimized networks and stop the MIG script early
+     once it cannot win; gate level labels compare their 6-LUT mappings. */
+  inline int32_t label_partition(mockturtle::aig_network aig, mockturtle::mig_network mig, x_gts_opts const& opts) {
+    const auto strategy = opts.get_strategy();
+    if (opts.get_flag_gate_level_training_set()) {
+      oracle::aig_script aigopt;
+      oracle::mig_script migopt;
+      const auto aig_opt = aigopt.run(aig);
+      const auto mig_opt = migopt.run(mig);
+      const auto [aig_luts, aig_depth] = lut_cost(aig_opt);
+      const auto [mig_luts, mig_depth] = lut_cost(mig_opt);
+      return oracle::prefer_aig(strategy, 0u, aig_luts, aig_depth, mig_luts, mig_depth) ? label_aig_value : label_mig_value;
+    }
+
+    oracle::candidate_monitor monitor(strategy, 0u, oracle::witnessed_support(aig));
+    oracle::aig_script aigopt;
+    const auto aig_opt = aigopt.run(aig, [&](auto const&){ return monitor.keep_going(true); });
+    mockturtle::depth_view aig_depth{aig_opt};
+    monitor.finish(true, aig_opt.num_gates(), aig_depth.depth());
+
+    oracle::mig_script migopt;
+    const auto mig_opt = migopt.run(mig, [&](auto const&){ return monitor.keep_going(false); });
+    if (monitor.cancelled(false))
+      return label_aig_value;
+    mockturtle::depth_view mig_depth{mig_opt};
+    return oracle::prefer_aig(strategy, 0u, aig_opt.num_gates(), aig_depth.depth(), mig_opt.num_gates(), mig_depth.depth()) ?
+      label_aig_value : label_mig_value;
+  }
 
-  /*
-  ALICE_ADD_STORE( std::string, "benchmark_list", "benchmark_list", "benchmark_list", "benchmark_lists")
-  ALICE_ADD_STORE( std::string, "output_label_file", "output_label_file", "Output file name", "Output file name")
-  ALICE_ADD_STORE( std::bool, "label_aig", "label", "Use AIG optimization", "Use AIG optimization")
-  ALICE_ADD_STORE( std::bool, "label_mig", "label", "Use MIG optimization", "Use mIG optimization")
-  ALICE_ADD_STORE( std::int, "partition_size", "partition_size", "partition_size", "partition_size")
-  */
+  /* Benchmarks finished by earlier runs, read from `<dataset>.progress`.
+     Every line holds the size of the dataset after a benchmark was written
+     and the name of the benchmark; anything after the last line is from a
+     benchmark that did not finish and is cut off the dataset. */
+  class gts_checkpoint {
+  public:
+    explicit gts_checkpoint(std::string const& dataset)
+      : dataset(dataset), filename(dataset + ".progress") {}
+
+    bool resume() {
+      std::ifstream is(filename);
+      if (!is)
+        return true;
+      std::error_code ec;
+      if (!std::filesystem::exists(dataset, ec)) {
+        std::cout << "[w] " << dataset << " is missing, ignoring " << filename << "\n";
+        std::filesystem::remove(filename, ec);
+        return true;
+      }
+
+      uintmax_t committed = 0u;
+      std::string line;
+      while (std::getline(is, line)) {
+        std::istringstream fields(line);
+        uintmax_t size;
+        std::string name;
+        if (!(fields >> size) || !std::getline(fields >> std::ws, name))
+          break;
+        committed = size;
+        done.insert(name);
+      }
+      is.close();
+
+      if (std::filesystem::file_size(dataset, ec) > committed) {
+        std::filesystem::resize_file(dataset, committed, ec);
+        if (ec) {
+          std::cout << "Error: could not truncate " << dataset << ": " << ec.message() << "\n";
+          return false;
+        }
+      }
+      if (!done.empty())
+        std::cout << "Resuming, " << done.size() << " benchmarks already in " << dataset << "\n";
+      return true;
+    }
+
+    bool is_done(std::string const& benchmark) const {
+      return done.count(benchmark) != 0u;
+    }
+
+    /* Called after the records of `benchmark` were flushed to the dataset */
+    void commit(std::string const& benchmark) {
+      std::error_code ec;
+      const auto size = std::filesystem::file_size(dataset, ec);
+      std::ofstream os(filename, std::ios::out | std::ios::app);
+      os << size << " " << benchmark << "\n";
+    }
 
-  /* Generate labels for  */
+  private:
+    std::string dataset;
+    std::string filename;
+    std::set<std::string> done;
+  };
+
+  /* A benchmark while its partitions are being labelled */
+  struct gts_design {
+    std::string filename;
+    aig_names ntk;
+    std::unique_ptr<part_man_aig> partitions;
+    std::vector<mockturtle::aig_network> aigs;
+    std::vector<mockturtle::mig_network> migs;
+    std::vector<int32_t> labels;
+    std::atomic<int> remaining{0};
+  };
+
+  /* Labels every partition of every benchmark with the optimization that
+     wins on it and appends the k-map images of the partition outputs with
+     their labels to the dataset.
+
+     Worker threads prefer labelling partitions that are queued and otherwise
+     read and partition the next benchmark, so benchmarks are prepared while
+     the partitions of others are optimized.  The last worker to label a
+     partition of a benchmark writes its records and commits it to the
+     checkpoint, so an interrupted run continues with the next unfinished
+     benchmark. */
+  inline bool run_gts(x_gts_opts const& gts_opts) {
+    if (gts_opts.get_flag_pnr_level_training_set()) {
+      std::cout << "Error: P&R level training sets need an external place and route flow, which is not available\n";
+      return false;
+    }
+    if (gts_opts.get_partition_input_size() <= 0) {
+      std::cout << "Error: the partition size must be positive\n";
+      return false;
+    }
+
+    const auto filenames = read_benchmark_list(gts_opts.get_benchmark_list());
+    for (auto const& filename : filenames) {
+      if (!std::filesystem::exists(filename)) {
+        std::cout << "Error: File (" << filename << ") does not exist!\n";
+        return false;
+      }
+    }
+
+    const auto dataset_file = gts_opts.get_output_label_file();
+    gts_checkpoint checkpoint(dataset_file);
+    if (!checkpoint.resume())
+      return false;
+    std::vector<std::string> todo;
+    std::copy_if(filenames.begin(), filenames.end(), std::back_inserter(todo),
+                 [&](auto const& f){ return !checkpoint.is_done(f); });
+
+    oracle::kmap_dataset_params dataset_ps;
+    dataset_ps.compress = gts_opts.get_compression();
+    oracle::kmap_dataset_writer dataset(dataset_file, dataset_ps);
+    if (!dataset.good())
+      return false;
+
+    const auto config_file = gts_opts.get_config_file();
+
+    /* with only one of the labels requested, partitions with the other are
+       not written */
+    const bool keep_aig = gts_opts.get_label_aig() || !gts_opts.get_label_mig();
+    const bool keep_mig = gts_opts.get_label_mig() || !gts_opts.get_label_aig();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::pair<gts_design*, int>> queue;
+    std::size_t next_design = 0u;
+    uint32_t preparing = 0u;
+    std::atomic<bool> failed{false};
+    uint64_t num_skipped = 0u;
+    std::mutex dataset_mutex;
+    uint64_t num_records = 0u, num_partitions = 0u, num_aig = 0u, num_mig = 0u;
+
+    const auto prepare = [&](std::string const& filename) -> gts_design* {
+      auto design = new gts_design;
+      design->filename = filename;
+      if (!read_network_file(filename, design->ntk)) {
+        delete design;
+        return nullptr;
+      }
+      const int num_parts = std::max<int>(1, (design->ntk.num_gates() + gts_opts.get_partition_input_size() - 1) / gts_opts.get_partition_input_size());
+      design->partitions = std::make_unique<part_man_aig>(design->ntk, num_parts, config_file);
+
+      oracle::partition_extractor<aig_names> extractor(design->ntk);
+      for (int i = 0; i < num_parts; i++) {
+        auto part = design->partitions->create_part(design->ntk, i);
+        design->aigs.push_back(extractor.extract<mockturtle::aig_network>(part));
+        design->migs.push_back(extractor.extract<mockturtle::mig_network>(part));
+      }
+      design->labels.assign(num_parts, -1);
+      design->remaining = num_parts;
+      return design;
+    };
+
+    const auto finish = [&](gts_design* design) {
+      design->aigs.clear();
+      design->migs.clear();
+      for (auto& label : design->labels) {
+        if ((label == label_aig_value && !keep_aig) || (label == label_mig_value && !keep_mig))
+          label = -1;
+      }
+      design->partitions->generate_truth_tables(design->ntk);
+
+      std::lock_guard<std::mutex> lock(dataset_mutex);
+      const auto records = design->partitions->write_karnaugh_dataset(design->ntk, dataset, design->labels);
+      dataset.flush();
+      if (dataset.good())
+        checkpoint.commit(design->filename);
+      else
+        failed = true;
+      num_records += records;
+      std::cout << design->filename << ": " << design->labels.size() << " partitions, " << records << " k-maps\n";
+      delete design;
+    };
+
+    const auto worker = [&]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!failed) {
+        if (!queue.empty()) {
+          auto [design, part] = queue.front();
+          queue.pop_front();
+          lock.unlock();
+          const auto label = label_partition(design->aigs[part], design->migs[part], gts_opts);
+          design->labels[part] = label;
+          {
+            std::lock_guard<std::mutex> stats_lock(dataset_mutex);
+            num_partitions++;
+            (label == label_aig_value ? num_aig : num_mig)++;
+          }
+          if (--design->remaining == 0)
+            finish(design);
+          lock.lock();
+        }
+        else if (next_design < todo.size()) {
+          const auto filename = todo[next_design++];
+          preparing++;
+          lock.unlock();
+          auto design = prepare(filename);
+          lock.lock();
+          preparing--;
+          if (design) {
+            for (auto i = 0u; i < design->labels.size(); i++)
+              queue.emplace_back(design, i);
+          }
+          else {
+            std::cout << "Skipping " << filename << "\n";
+            num_skipped++;
+          }
+          cv.notify_all();
+        }
+        else if (preparing == 0u) {
+          break;
+        }
+        else {
+          cv.wait(lock);
+        }
+      }
+    };
+
+    const auto num_threads = std::max(1u, gts_opts.get_num_threads());
+    std::vector<std::thread> threads;
+    for (auto t = 1u; t < num_threads; t++)
+      threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+      t.join();
+
+    /* designs whose partitions were still queued when writing failed */
+    std::set<gts_design*> abandoned;
+    for (auto const& [design, part] : queue)
+      abandoned.insert(design);
+    for (auto design : abandoned)
+      delete design;
+
+    dataset.close();
+    std::cout << "Labelled " << num_partitions << " partitions (" << num_aig << " AIG, " << num_mig << " MIG), wrote "
+              << num_records << " k-maps to " << dataset_file << "\n";
+    if (num_skipped > 0u)
+      std::cout << num_skipped << " benchmarks could not be read\n";
+    return !failed && dataset.good();
+  }
+}
+
+namespace alice {
+
+  /* Writes the labels of a training set, one line per k-map */
   class gts_output_labels_command : public alice::command {
   public:
     explicit gts_output_labels_command ( const environment::ptr& env)
             : command (env, "Output labels from training set into a file") {
+      opts.add_option("--dataset,-d", dataset_file, "Uncompressed k-map dataset written by gts")->required();
       opts.add_option("--output_file,-o", output_label_file, "Filename to output")->required();
     }
     void echo_options() {
@@ -108,13 +476,32 @@ namespace alice {
     }
   protected:
     void execute() {
+      std::ifstream is(dataset_file, std::ios::in | std::ios::binary);
+      oracle::kmap_dataset_header header{};
+      is.read(reinterpret_cast<char*>(&header), sizeof(header));
+      if (!is || std::memcmp(header.magic, oracle::kmap_dataset_magic, sizeof(header.magic)) != 0) {
+        std::cout << dataset_file << " is not an uncompressed k-map dataset\n";
+        return;
+      }
+      std::ofstream os(output_label_file);
+      os << "label,partition,output,num_inputs,level\n";
+      oracle::kmap_record record;
+      uint64_t num_records = 0u;
+      is.seekg(header.header_size);
+      while (is.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        os << record.label << "," << record.partition << "," << record.output << "," << record.num_inputs << "," << record.level << "\n";
+        num_records++;
+        is.seekg(header.record_size - sizeof(record), std::ios::cur);
+      }
+      std::cout << "Wrote " << num_records << " labels to " << output_label_file << "\n";
     }
   private:
+    std::string dataset_file{};
     std::string output_label_file{};
   };
 
   /* Generate scripts for P&R */
-   
+
 
   /* Class for generate_training_set */
   class gts_command : public alice::command {
@@ -122,12 +509,16 @@ namespace alice {
     explicit gts_command ( const environment::ptr& env)
             : command (env, "Generates a training set for the input benchmarks") {
       opts.add_option("--benchmark_list,benchmark_list", benchmark_list, "List of benchmarks for the training set")->required();
-      opts.add_option("--output_file,-o", output_label_file, "Filename to output")->required();
+      opts.add_option("--output_file,-o", output_label_file, "k-map dataset to append the labelled images to")->required();
       opts.add_flag("--label_aig,-a", "Use AIG optimization as a label");
       opts.add_flag("--label_mig,-m", "Use MIG optimization as a label");
       opts.add_option("--partition_size,partition_size", partition_size, "Specify the partition size when generating training set")->required();
       opts.add_option("--type,type", training_set_type, "Specify the type of training set generation: [logic_level|gate_level|pnr_level]")->required();
-    } 
+      opts.add_option("--threads,-t", num_threads, "Number of partitions labelled in parallel [DEFAULT = 1]");
+      opts.add_option("--strategy,-s", strategy, "Labelling strategy [area delay product=0, area{DEFAULT}=1, delay=2]");
+      opts.add_option("--config,-c", config_file, "KaHyPar configuration file");
+      add_flag("--zstd,-z", "Compress the dataset with zstd");
+    }
     /* Function to echo options */
     void echo_options() {
       std::cout << "Echo options for confirmation:\n";
@@ -137,6 +528,7 @@ namespace alice {
       std::cout << "Type of training set: " << training_set_type << "\n";
       std::cout << "Label AIG optimizer: " << is_set("label_aig") << "\n";
       std::cout << "Label MIG optimizer: " << is_set("label_mig") << "\n";
+      std::cout << "Threads: " << num_threads << "\n";
     }
   protected:
     void execute() {
@@ -148,44 +540,44 @@ namespace alice {
       gts_opts.add_benchmark_list(benchmark_list);
       gts_opts.add_output_label_file(output_label_file);
       gts_opts.add_partition_size(partition_size);
-      gts_opts.add_label_aig(is_set("label_aig"));  
-      gts_opts.add_label_mig(is_set("label_mig"));  
-      /* Set flag for different types of training sets  */   
+      gts_opts.add_label_aig(is_set("label_aig"));
+      gts_opts.add_label_mig(is_set("label_mig"));
+      gts_opts.add_num_threads(num_threads);
+      gts_opts.add_strategy(strategy);
+      gts_opts.add_config_file(config_file);
+      gts_opts.enable_compression(is_set("zstd"));
+      /* Set flag for different types of training sets  */
       /* Logic level */
       found = training_set_type.find(GTS_LOGIC_LEVEL_TAG);
-      gts_opts.enable_logic_level_training_set(FALSE);
-      if (found != std::string::npos) {
-        gts_opts.enable_logic_level_training_set(TRUE);
-      } 
+      gts_opts.enable_logic_level_training_set(found != std::string::npos);
       /* Gate level */
       found = training_set_type.find(GTS_GATE_LEVEL_TAG);
-      gts_opts.enable_gate_level_training_set(FALSE);
-      if (found != std::string::npos) {
-        gts_opts.enable_gate_level_training_set(TRUE);
-      } 
+      gts_opts.enable_gate_level_training_set(found != std::string::npos);
       /* P&R level */
       found = training_set_type.find(GTS_PNR_LEVEL_TAG);
-      gts_opts.enable_pnr_level_training_set(FALSE);
-      if (found != std::string::npos) {
-        gts_opts.enable_pnr_level_training_set(TRUE);
-      } 
+      gts_opts.enable_pnr_level_training_set(found != std::string::npos);
+
+      const int num_types = gts_opts.get_flag_logic_level_training_set() + gts_opts.get_flag_gate_level_training_set() +
+                            gts_opts.get_flag_pnr_level_training_set();
+      if (num_types != 1) {
+        std::cout << "Specify exactly one type of training set: [logic_level|gate_level|pnr_level]\n";
+        return;
+      }
       /* Start the top-level program */
-      /* gts::run_gts(gts_opts); */
+      if (!gts::run_gts(gts_opts))
+        std::cout << "Training set generation failed\n";
     }
   private:
     std::string benchmark_list{};
     std::string output_label_file{};
     std::string training_set_type{};
+    std::string config_file{};
     int partition_size{};
-    bool label_aig{};
-    bool label_mig{};
-    bool logic_level_training_set{};
-    bool gate_level_training_set{};
-    bool pnr_level_training_set{};
+    unsigned num_threads{1u};
+    unsigned strategy{1u};
   };
 
   /* Add the command to ALICE interface*/
-  ALICE_ADD_COMMAND(gts, "Training Set Generation"); 
+  ALICE_ADD_COMMAND(gts, "Training Set Generation");
+  ALICE_ADD_COMMAND(gts_output_labels, "Training Set Generation");
 }
-
-
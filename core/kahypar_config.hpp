@@ -1,4 +1,27 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <libkahypar.h>
+
 extern const std::string KAHYPAR_DEFAULT_CONFIG;
-std::string make_temp_config();
+
+/* KaHyPar contexts are configured once per preset and kept for the lifetime
+   of the process; the number of blocks and the imbalance are set on the
+   working copy of every run.  The preset is the path of a KaHyPar ini file,
+   or empty for KAHYPAR_DEFAULT_CONFIG, which is parsed in memory. */
+struct kahypar_context_info{
+  std::string preset;
+  uint64_t uses;
+};
+
+/* Working copy of the cached context, to be released with
+   kahypar_context_free.  KaHyPar changes the context while it partitions,
+   so every run gets its own copy. */
+kahypar_context_t* kahypar_cached_context(std::string const& preset);
+
+/* Configures the context of the preset ahead of its first use */
+void kahypar_prepare_context(std::string const& preset);
+
+std::vector<kahypar_context_info> kahypar_cached_contexts();
+void kahypar_clear_contexts();
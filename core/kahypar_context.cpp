@@ -0,0 +1,54 @@
+#include "kahypar_config.hpp"
+#include <map>
+#include <mutex>
+
+namespace{
+
+  struct cached_context{
+    kahypar_context_t* context{nullptr};
+    uint64_t uses{0u};
+  };
+
+  std::mutex contexts_mutex;
+  std::map<std::string, cached_context> contexts;
+
+  /* with contexts_mutex held */
+  cached_context& configured(std::string const& preset) {
+    auto& cached = contexts[preset];
+    if (cached.context == nullptr) {
+      cached.context = kahypar_context_new();
+      if (preset.empty())
+        kahypar_configure_context_from_string(cached.context, KAHYPAR_DEFAULT_CONFIG.c_str());
+      else
+        kahypar_configure_context_from_file(cached.context, preset.c_str());
+    }
+    return cached;
+  }
+}
+
+kahypar_context_t* kahypar_cached_context(std::string const& preset) {
+  std::lock_guard<std::mutex> lock(contexts_mutex);
+  auto& cached = configured(preset);
+  ++cached.uses;
+  return kahypar_context_copy(cached.context);
+}
+
+void kahypar_prepare_context(std::string const& preset) {
+  std::lock_guard<std::mutex> lock(contexts_mutex);
+  configured(preset);
+}
+
+std::vector<kahypar_context_info> kahypar_cached_contexts() {
+  std::lock_guard<std::mutex> lock(contexts_mutex);
+  std::vector<kahypar_context_info> infos;
+  for (auto const& [preset, cached] : contexts)
+    infos.push_back({preset, cached.uses});
+  return infos;
+}
+
+void kahypar_clear_contexts() {
+  std::lock_guard<std::mutex> lock(contexts_mutex);
+  for (auto& [preset, cached] : contexts)
+    kahypar_context_free(cached.context);
+  contexts.clear();
+}
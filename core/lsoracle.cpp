@@ -12,10 +12,15 @@
 #include "algorithms/partitioning/partition_view.hpp"
 #include "algorithms/partitioning/hyperg.hpp"
 #include "utility.hpp"
+#include "profiler.hpp"
+#include "resources.hpp"
 #include "algorithms/partitioning/partition_manager.hpp"
 #include "algorithms/partitioning/cluster.hpp"
 #include "algorithms/partitioning/seed_partitioner.hpp"
 #include "algorithms/partitioning/fpga_seed_partitioner.hpp"
+#include "algorithms/partitioning/level_partition_manager.hpp"
+#include "algorithms/partitioning/hierarchical_partitioner.hpp"
+#include "algorithms/partitioning/partitioner.hpp"
 #include "algorithms/partitioning/slack_view.hpp"
 #include "algorithms/optimization/rw_script.hpp"
 #include "algorithms/optimization/aig_script.hpp"
@@ -27,11 +32,15 @@
 #include "algorithms/optimization/mig_script2.hpp"
 #include "algorithms/optimization/mig_script3.hpp"
 #include "algorithms/optimization/test_script.hpp"
+#include "algorithms/optimization/partition_verification.hpp"
+#include "algorithms/optimization/dual_candidate.hpp"
 #include "algorithms/optimization/optimization.hpp"
 #include "algorithms/optimization/optimization_test.hpp"
+#include "algorithms/optimization/partition_sizing.hpp"
 #include "algorithms/output/verilog.hpp"
 #include "algorithms/asic_mapping/techmapping.hpp"
 #include "algorithms/output/mapped_verilog.hpp"
+#include "algorithms/output/kmap_dataset.hpp"
 
 /*** Stores ***/
 #include "store/aig.hpp"
@@ -66,14 +75,20 @@
 #include "commands/stats/depth.hpp"
 #include "commands/stats/get_cones.hpp"
 #include "commands/stats/ntk_stats.hpp"
+#include "commands/stats/profile.hpp"
 
 //Partitioning
 #include "commands/partitioning/partitioning.hpp"
 #include "commands/partitioning/partition_detail.hpp"
+#include "commands/partitioning/partition_bench.hpp"
+#include "commands/partitioning/kahypar_contexts.hpp"
 
 //Classification
 #include "commands/classification/generate_truth_tables.hpp"
 
+//Training set generation
+#include "gts.hpp"
+
 //Optimization
 #include "commands/optimization/rwscript.hpp"
 #include "commands/optimization/aigscript.hpp"
@@ -95,6 +110,9 @@
 //Asic mapping
 #include "commands/asic_map/asic_map.hpp"
 
+//Verification
+#include "commands/verification/cec.hpp"
+
 //Testing
 // #include "commands/testing/find_xor.hpp"
 // #include "commands/testing/find_part.hpp"
@@ -0,0 +1,36 @@
+#include "profiler.hpp"
+
+#include <cstdlib>
+#include <new>
+
+/* Replacements of the global allocation functions that count allocations per
+   thread for the profiler. The nothrow and array forms of the default
+   library forward to these. */
+
+void* operator new(std::size_t size){
+  oracle::thread_allocations++;
+  oracle::thread_allocated_bytes += size;
+  if(void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size){
+  return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept{
+  std::free(p);
+}
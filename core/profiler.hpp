@@ -0,0 +1,406 @@
+#pragma once
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <time.h>
+
+namespace oracle{
+
+  /* Allocations made by the calling thread. They are counted by the global
+     operator new replacements in profiler.cpp, whether profiling is on or
+     not, since a thread local increment is cheaper than checking. */
+  inline thread_local uint64_t thread_allocations = 0;
+  inline thread_local uint64_t thread_allocated_bytes = 0;
+
+  /* Bytes allocated by the calling thread while the scope is open, and by
+     the worker threads that report to it with allocation_thread_scope */
+  class allocation_scope{
+  public:
+    allocation_scope() : start_bytes(thread_allocated_bytes), parent(current()){
+      current() = this;
+    }
+
+    ~allocation_scope(){
+      current() = parent;
+    }
+
+    uint64_t bytes() const {
+      return thread_allocated_bytes - start_bytes + worker_bytes.load();
+    }
+
+    /* Innermost scope of the calling thread, null if none is open */
+    static allocation_scope*& current(){
+      static thread_local allocation_scope* scope = nullptr;
+      return scope;
+    }
+
+    allocation_scope(allocation_scope const&) = delete;
+    allocation_scope& operator=(allocation_scope const&) = delete;
+
+  private:
+    friend class allocation_thread_scope;
+
+    uint64_t start_bytes;
+    allocation_scope* parent;
+    std::atomic<uint64_t> worker_bytes{0};
+  };
+
+  /* Adds the allocations of a worker thread to the scope of the thread that
+     started it, which captures it with allocation_scope::current() */
+  class allocation_thread_scope{
+  public:
+    explicit allocation_thread_scope(allocation_scope* scope) : scope(scope), start_bytes(thread_allocated_bytes){}
+
+    ~allocation_thread_scope(){
+      if(scope)
+        scope->worker_bytes += thread_allocated_bytes - start_bytes;
+    }
+
+    allocation_thread_scope(allocation_thread_scope const&) = delete;
+    allocation_thread_scope& operator=(allocation_thread_scope const&) = delete;
+
+  private:
+    allocation_scope* scope;
+    uint64_t start_bytes;
+  };
+
+  /* Totals of one stage over all of its calls. Times, allocations and peak
+     RSS are inclusive of the nested stages. CPU time is that of the thread
+     that ran the stage, work handed to other threads is accounted in their
+     own stages. */
+  struct profile_stage{
+    std::string name;
+    profile_stage* parent{nullptr};
+    std::vector<std::unique_ptr<profile_stage>> children;
+    uint64_t calls{0};
+    double wall_ms{0.0};
+    double cpu_ms{0.0};
+    uint64_t allocations{0};
+    uint64_t allocated_bytes{0};
+    long peak_rss_kb{0};
+
+    std::string path() const {
+      return parent && parent->parent ? parent->path() + "/" + name : name;
+    }
+  };
+
+  class profiler;
+
+  /* Profiler and stage a worker thread reports to, see profile_thread_scope */
+  struct profile_context{
+    profiler* owner{nullptr};
+    profile_stage* stage{nullptr};
+  };
+
+  /* Tree of stages of the commands run by one thread. Every thread that
+     calls get() has its own profiler, so the jobs of lsoracle --serve, which
+     run concurrently on different threads, are profiled separately. Stages
+     are opened with profile_scope, each thread nests them below the stage it
+     was started in (see profile_thread_scope), or below the root. The tree
+     must only be reset or reported while no scope is open, i.e., between
+     commands. */
+  class profiler{
+  public:
+    static profiler& get(){
+      auto*& p = bound();
+      if(!p){
+        static thread_local profiler instance;
+        p = &instance;
+      }
+      return *p;
+    }
+
+    /* Whether the profiler of the calling thread is running */
+    static bool enabled(){
+      auto* p = bound();
+      return p && p->_enabled.load(std::memory_order_relaxed);
+    }
+
+    static profile_context context(){ return {bound(), current()}; }
+
+    /* Clears the previous results and starts profiling */
+    void start(){
+      std::lock_guard<std::mutex> lock(mutex);
+      root = std::make_unique<profile_stage>();
+      root->name = "total";
+      current() = nullptr;
+      start_wall = std::chrono::steady_clock::now();
+      start_cpu = cpu_time_ms(CLOCK_PROCESS_CPUTIME_ID);
+      _enabled = true;
+    }
+
+    /* Stops profiling, the results are kept until the next start */
+    void stop(){
+      if(!_enabled)
+        return;
+      std::lock_guard<std::mutex> lock(mutex);
+      _enabled = false;
+      root->calls = 1;
+      root->wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_wall).count();
+      root->cpu_ms = cpu_time_ms(CLOCK_PROCESS_CPUTIME_ID) - start_cpu;
+      root->peak_rss_kb = peak_rss_kb();
+      for(auto const& c : root->children){
+        root->allocations += c->allocations;
+        root->allocated_bytes += c->allocated_bytes;
+      }
+    }
+
+    bool has_results() const { return root != nullptr; }
+
+    /* Drops the results, the profiler must not be running */
+    void clear(){
+      std::lock_guard<std::mutex> lock(mutex);
+      root.reset();
+    }
+
+    /* Stage that scopes opened by the calling thread are nested in */
+    static profile_stage*& current(){
+      static thread_local profile_stage* stage = nullptr;
+      return stage;
+    }
+
+    profile_stage* enter(std::string const& name){
+      std::lock_guard<std::mutex> lock(mutex);
+      auto* parent = current() ? current() : root.get();
+      for(auto const& c : parent->children){
+        if(c->name == name)
+          return current() = c.get();
+      }
+      parent->children.push_back(std::make_unique<profile_stage>());
+      auto* stage = parent->children.back().get();
+      stage->name = name;
+      stage->parent = parent;
+      return current() = stage;
+    }
+
+    void leave(profile_stage* stage, double wall_ms, double cpu_ms, uint64_t allocations, uint64_t bytes){
+      const auto rss = peak_rss_kb();
+      std::lock_guard<std::mutex> lock(mutex);
+      stage->calls++;
+      stage->wall_ms += wall_ms;
+      stage->cpu_ms += cpu_ms;
+      stage->allocations += allocations;
+      stage->allocated_bytes += bytes;
+      stage->peak_rss_kb = std::max(stage->peak_rss_kb, rss);
+    }
+
+    nlohmann::json to_json() const {
+      return root ? to_json(*root) : nlohmann::json::object();
+    }
+
+    /* One row per stage in depth first order, stages are named by path */
+    void write_csv(std::ostream& os) const {
+      os << "stage,depth,calls,wall_ms,cpu_ms,allocations,allocated_bytes,peak_rss_kb\n";
+      if(root)
+        write_csv(os, *root, 0);
+    }
+
+    /* Indented tree with the share of the parent's wall time */
+    void print(std::ostream& os) const {
+      if(root)
+        print(os, *root, 0, root->wall_ms);
+    }
+
+    /* Writes CSV if filename ends with .csv, JSON otherwise */
+    bool write(std::string const& filename) const {
+      std::ofstream os(filename);
+      if(!os)
+        return false;
+      if(filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0)
+        write_csv(os);
+      else
+        os << std::setw(2) << to_json() << "\n";
+      return true;
+    }
+
+    static double cpu_time_ms(clockid_t clock){
+      timespec ts;
+      clock_gettime(clock, &ts);
+      return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+    }
+
+    /* Peak RSS of the process, also across reset_peak_rss() */
+    static long peak_rss_kb(){
+      rusage usage;
+      getrusage(RUSAGE_SELF, &usage);
+      return std::max<long>(usage.ru_maxrss, peak_before_reset);
+    }
+
+    /* Restarts the high-water mark of the resident set (Linux), so that
+       rss_kb(true) reports the peak of the code that follows.  Returns false
+       if the kernel does not support it. */
+    static bool reset_peak_rss(){
+      for(auto peak = peak_rss_kb(), old = peak_before_reset.load(); old < peak; )
+        if(peak_before_reset.compare_exchange_weak(old, peak))
+          break;
+      std::ofstream os("/proc/self/clear_refs");
+      return static_cast<bool>(os << "5" << std::flush);
+    }
+
+    /* Current resident set, or its high-water mark with peak, -1 if unknown */
+    static long rss_kb(bool peak = false){
+      std::ifstream is("/proc/self/status");
+      const std::string field = peak ? "VmHWM:" : "VmRSS:";
+      for(std::string line; std::getline(is, line); )
+        if(line.compare(0, field.size(), field) == 0)
+          return std::stol(line.substr(field.size()));
+      return -1;
+    }
+
+    /* Profiler the calling thread reports to */
+    static profiler*& bound(){
+      static thread_local profiler* p = nullptr;
+      return p;
+    }
+
+  private:
+    nlohmann::json to_json(profile_stage const& stage) const {
+      nlohmann::json j = {
+        {"name", stage.name},
+        {"calls", stage.calls},
+        {"wall_ms", stage.wall_ms},
+        {"cpu_ms", stage.cpu_ms},
+        {"allocations", stage.allocations},
+        {"allocated_bytes", stage.allocated_bytes},
+        {"peak_rss_kb", stage.peak_rss_kb}};
+      auto children = nlohmann::json::array();
+      for(auto const& c : stage.children)
+        children.push_back(to_json(*c));
+      j["stages"] = children;
+      return j;
+    }
+
+    void write_csv(std::ostream& os, profile_stage const& stage, int depth) const {
+      os << stage.path() << "," << depth << "," << stage.calls << "," << stage.wall_ms << "," << stage.cpu_ms << ","
+         << stage.allocations << "," << stage.allocated_bytes << "," << stage.peak_rss_kb << "\n";
+      for(auto const& c : stage.children)
+        write_csv(os, *c, depth + 1);
+    }
+
+    void print(std::ostream& os, profile_stage const& stage, int depth, double parent_ms) const {
+      os << std::string(2 * depth, ' ') << stage.name << ": " << std::fixed << std::setprecision(2) << stage.wall_ms << " ms";
+      if(depth > 0 && parent_ms > 0)
+        os << " (" << std::setprecision(1) << 100.0 * stage.wall_ms / parent_ms << "%)";
+      os << std::setprecision(2) << ", cpu " << stage.cpu_ms << " ms, " << stage.calls << " calls, "
+         << stage.allocations << " allocations, peak RSS " << stage.peak_rss_kb << " KB\n";
+      os.unsetf(std::ios_base::floatfield);
+      for(auto const& c : stage.children)
+        print(os, *c, depth + 1, stage.wall_ms);
+    }
+
+    std::atomic<bool> _enabled{false};
+    inline static std::atomic<long> peak_before_reset{0};
+    std::mutex mutex;
+    std::unique_ptr<profile_stage> root;
+    std::chrono::steady_clock::time_point start_wall;
+    double start_cpu{0.0};
+  };
+
+  /* Measures the enclosing block as a stage nested in the current stage of
+     the calling thread. Does nothing unless the profiler is running. */
+  class profile_scope{
+  public:
+    explicit profile_scope(char const* name){
+      open(name);
+    }
+
+    ~profile_scope(){
+      close();
+    }
+
+    /* Closes this stage and opens a sibling, for sequences of passes */
+    void next(char const* name){
+      close();
+      open(name);
+    }
+
+    /* Closes this stage before the end of the block */
+    void end(){
+      close();
+    }
+
+    profile_scope(profile_scope const&) = delete;
+    profile_scope& operator=(profile_scope const&) = delete;
+
+  private:
+    void open(char const* name){
+      if(!profiler::enabled())
+        return;
+      owner = &profiler::get();
+      parent = profiler::current();
+      stage = owner->enter(name);
+      start_allocations = thread_allocations;
+      start_bytes = thread_allocated_bytes;
+      start_cpu = profiler::cpu_time_ms(CLOCK_THREAD_CPUTIME_ID);
+      start_wall = std::chrono::steady_clock::now();
+    }
+
+    void close(){
+      if(!stage)
+        return;
+      const auto wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_wall).count();
+      const auto cpu = profiler::cpu_time_ms(CLOCK_THREAD_CPUTIME_ID) - start_cpu;
+      owner->leave(stage, wall, cpu, thread_allocations - start_allocations, thread_allocated_bytes - start_bytes);
+      profiler::current() = parent;
+      stage = nullptr;
+    }
+
+    profiler* owner{nullptr};
+    profile_stage* stage{nullptr};
+    profile_stage* parent{nullptr};
+    uint64_t start_allocations{0};
+    uint64_t start_bytes{0};
+    double start_cpu{0.0};
+    std::chrono::steady_clock::time_point start_wall;
+  };
+
+  /* Runs the profiler for the lifetime of the object, if enabled, so that it
+     is stopped also when the profiled code throws. */
+  class profile_session{
+  public:
+    explicit profile_session(bool enabled) : enabled(enabled){
+      if(enabled)
+        profiler::get().start();
+    }
+
+    ~profile_session(){
+      if(enabled)
+        profiler::get().stop();
+    }
+
+    profile_session(profile_session const&) = delete;
+    profile_session& operator=(profile_session const&) = delete;
+
+  private:
+    bool enabled;
+  };
+
+  /* Nests the stages of a worker thread in the stage it was started from,
+     in the profiler of the starting thread, which captures both with
+     profiler::context(). */
+  class profile_thread_scope{
+  public:
+    explicit profile_thread_scope(profile_context const& context){
+      profiler::bound() = context.owner;
+      profiler::current() = context.stage;
+    }
+
+    ~profile_thread_scope(){
+      profiler::bound() = nullptr;
+      profiler::current() = nullptr;
+    }
+  };
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <fdeep/fdeep.hpp>
+#include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace oracle{
+
+  /* Resources that are expensive to build and never change are kept for the
+     lifetime of the process, so that a server (lsoracle --serve) only builds
+     them once and not for every job. */
+
+  /* Models are keyed by file name, a model file that changes while the
+     process runs is not reloaded */
+  inline fdeep::model const& cached_model(std::string const& model_file){
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<fdeep::model>> models;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& model = models[model_file];
+    if(!model)
+      model = std::make_unique<fdeep::model>(fdeep::load_model(model_file));
+    return *model;
+  }
+
+  /* The MIG database is traversed with the visited marks of its network, so
+     each thread builds its own copy of the NPN databases */
+  inline mockturtle::mig_npn_resynthesis& mig_npn_database(){
+    static thread_local mockturtle::mig_npn_resynthesis resyn;
+    return resyn;
+  }
+
+  template<class Ntk>
+  mockturtle::xag_npn_resynthesis<Ntk>& xag_npn_database(){
+    static thread_local mockturtle::xag_npn_resynthesis<Ntk> resyn;
+    return resyn;
+  }
+}
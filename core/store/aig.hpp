@@ -7,6 +7,7 @@
 #include <mockturtle/io/aiger_reader.hpp>
 #include <mockturtle/io/blif_reader.hpp>
 #include <mockturtle/io/verilog_reader.hpp>
+#include <mockturtle/io/snapshot.hpp>
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_blif.hpp>
 #include <mockturtle/io/write_verilog.hpp>
@@ -53,6 +54,18 @@ namespace alice
 
   }
 
+  ALICE_STORE_MEMORY( aig_ntk, aig ){
+    return oracle::network_memory_usage( *aig );
+  }
+
+  ALICE_SPILL_STORE( aig_ntk, aig, filename ){
+    mockturtle::write_snapshot( *aig, filename );
+  }
+
+  ALICE_RELOAD_STORE( aig_ntk, filename ){
+    return oracle::reload_network<mockturtle::aig_network>( filename );
+  }
+
   ALICE_ADD_STORE( part_man_aig_ntk,"part_man_aig", "pm_a", "part_man_aig", "PART_MAN_AIGs")
 
   /* Implements the short string to describe a store element in store -a */
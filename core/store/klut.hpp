@@ -45,4 +45,8 @@ namespace alice
 
   }
 
+  ALICE_STORE_MEMORY( klut_ntk, klut ){
+    return oracle::network_memory_usage( *klut );
+  }
+
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <mockturtle/io/aiger_reader.hpp>
 #include <mockturtle/io/blif_reader.hpp>
 #include <mockturtle/io/verilog_reader.hpp>
+#include <mockturtle/io/snapshot.hpp>
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_blif.hpp>
 #include <mockturtle/io/write_verilog.hpp>
@@ -53,6 +54,18 @@ namespace alice
 
   }
 
+  ALICE_STORE_MEMORY( mig_ntk, mig ){
+    return oracle::network_memory_usage( *mig );
+  }
+
+  ALICE_SPILL_STORE( mig_ntk, mig, filename ){
+    mockturtle::write_snapshot( *mig, filename );
+  }
+
+  ALICE_RELOAD_STORE( mig_ntk, filename ){
+    return oracle::reload_network<mockturtle::mig_network>( filename );
+  }
+
   ALICE_ADD_STORE( part_man_mig_ntk,"part_man_mig", "pm_m", "part_man_mig", "PART_MAN_MIGs")
 
   /* Implements the short string to describe a store element in store -a */
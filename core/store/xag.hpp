@@ -7,6 +7,7 @@
 #include <mockturtle/io/aiger_reader.hpp>
 #include <mockturtle/io/blif_reader.hpp>
 #include <mockturtle/io/verilog_reader.hpp>
+#include <mockturtle/io/snapshot.hpp>
 #include <mockturtle/io/write_bench.hpp>
 #include <mockturtle/io/write_blif.hpp>
 #include <mockturtle/io/write_verilog.hpp>
@@ -48,4 +49,16 @@ namespace alice
     os << "XAG level: " << depth.depth() << std::endl;
 
   }
+
+  ALICE_STORE_MEMORY( xag_ntk, xag ){
+    return oracle::network_memory_usage( *xag );
+  }
+
+  ALICE_SPILL_STORE( xag_ntk, xag, filename ){
+    mockturtle::write_snapshot( *xag, filename );
+  }
+
+  ALICE_RELOAD_STORE( xag_ntk, filename ){
+    return oracle::reload_network<mockturtle::xag_network>( filename );
+  }
 }
\ No newline at end of file
@@ -264,7 +264,6 @@ namespace oracle
   ***************************************************/
   mig_ntk aig_to_mig(aig_names aig, int skip_edge_min){
 
-    using NtkSource = aig_names;
     using NtkDest = mig_names;
     mockturtle::mig_network ntk;
     NtkDest mig( ntk );
@@ -282,12 +281,6 @@ namespace oracle
         mig._storage->data.latches.emplace_back(0);
       }
       node2new[n] = mig.create_pi();
-
-      if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
-      {
-        if ( aig.has_name( aig.make_signal( n ) ) )
-          mig.set_name( node2new[n], aig.get_name( aig.make_signal( n ) ) );
-      }
     } );
         
     aig.foreach_node( [&]( auto n ) {
@@ -305,28 +298,15 @@ namespace oracle
       else{
         node2new[n] = mig.create_maj(mig.get_constant( false ), children.at(0), children.at(1));
       }
-      
-      if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
-      {
-        if ( aig.has_name( aig.make_signal( n ) ) )
-          mig.set_name( node2new[n], aig.get_name( aig.make_signal( n ) ) );
-      }
-          
     } );
 
     /* map primary outputs */
     aig.foreach_po( [&]( auto const& f, auto index ) {
       mig.create_po( aig.is_complemented( f ) ? mig.create_not( node2new[f] ) : node2new[f] );
-
-      if constexpr ( mockturtle::has_has_output_name_v<NtkSource> && mockturtle::has_get_output_name_v<NtkSource> && mockturtle::has_set_output_name_v<NtkDest> )
-      {
-        if ( aig.has_output_name( index ) )
-        {
-          mig.set_output_name( index, aig.get_output_name( index ) );
-        }
-      }
     } );
 
+    mig.copy_names_from( aig, [&]( auto n ){ return node2new[n]; } );
+
     return std::make_shared<mig_names>( mig );
   }
 
@@ -371,7 +351,6 @@ namespace oracle
   }
 
   aig_ntk mig_to_aig(mig_names mig){
-    using NtkSource = mig_names;
     using NtkDest = aig_names;
     mockturtle::aig_network ntk;
     NtkDest aig( ntk );
@@ -386,12 +365,6 @@ namespace oracle
 
     mig.foreach_pi( [&]( auto n ) {
       node2new[n] = aig.create_pi();
-
-      if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
-      {
-        if ( mig.has_name( mig.make_signal( n ) ) )
-          aig.set_name( node2new[n], mig.get_name( mig.make_signal( n ) ) );
-      }
     } );
     
     std::set<mockturtle::mig_network::node> nodes_to_change;    
@@ -424,28 +397,16 @@ namespace oracle
         }
       }
       node2new[n] = aig.create_and(children.at(0), children.at(1));
-
-      if constexpr ( mockturtle::has_has_name_v<NtkSource> && mockturtle::has_get_name_v<NtkSource> && mockturtle::has_set_name_v<NtkDest> )
-      {
-        if ( mig.has_name( mig.make_signal( n ) ) )
-          aig.set_name( node2new[n], mig.get_name( mig.make_signal( n ) ) );
-      }
           
     } );
 
     /* map primary outputs */
     mig.foreach_po( [&]( auto const& f, auto index ) {
       aig.create_po( mig.is_complemented( f ) ? aig.create_not( node2new[f] ) : node2new[f] );
-
-      if constexpr ( mockturtle::has_has_output_name_v<NtkSource> && mockturtle::has_get_output_name_v<NtkSource> && mockturtle::has_set_output_name_v<NtkDest> )
-      {
-        if ( mig.has_output_name( index ) )
-        {
-          aig.set_output_name( index, mig.get_output_name( index ) );
-        }
-      }
     } );
 
+    aig.copy_names_from( mig, [&]( auto n ){ return node2new[n]; } );
+
     return std::make_shared<aig_names>( aig );
   }
 
@@ -512,4 +473,39 @@ namespace oracle
       return false;
     }
   }//end checkExt
+
+  /* Approximate number of bytes held by a named network, used by store --stats */
+  template<typename Ntk>
+  std::size_t network_memory_usage(mockturtle::names_view<Ntk> const& ntk){
+
+    auto const& storage = *ntk._storage;
+    using node_type = typename std::decay_t<decltype(storage)>::node_type;
+
+    std::size_t bytes = storage.nodes.capacity() * sizeof(node_type) +
+                        storage.inputs.capacity() * sizeof(storage.inputs[0]) +
+                        storage.outputs.capacity() * sizeof(storage.outputs[0]) +
+                        ntk.names_memory_usage();
+    if constexpr(std::is_same_v<Ntk, mockturtle::klut_network>){
+      for(auto const& n : storage.nodes)
+        bytes += n.children.capacity() * sizeof(n.children[0]);
+    }
+    if constexpr(std::is_same_v<std::decay_t<decltype(storage.hash)>, mockturtle::strash_table<node_type>>){
+      /* one control byte per slot */
+      bytes += storage.hash.capacity() * (1 + sizeof(typename mockturtle::strash_table<node_type>::value_type));
+    }
+    else{
+      bytes += storage.hash.size() * (sizeof(node_type) + sizeof(std::size_t));
+    }
+    return bytes;
+  }//end network_memory_usage
+
+  /* Reads a network spilled from a store with mockturtle::write_snapshot */
+  template<typename Ntk>
+  std::shared_ptr<mockturtle::names_view<Ntk>> reload_network(std::string const& filename){
+
+    auto ntk = std::make_shared<mockturtle::names_view<Ntk>>();
+    if(!mockturtle::read_snapshot(filename, *ntk))
+      throw fmt::format("[e] could not reload network from {}", filename);
+    return ntk;
+  }//end reload_network
 }
\ No newline at end of file
@@ -78,16 +78,19 @@ int hash(unsigned val) {
   return((unsigned)(seed/65536) % 32768);
 }
 
-std::map<int,int> biparting(std::vector<std::vector<uint32_t>> hedge, uint32_t node_num, int num_part, int num_threads, scheduleMode schedulingMode) {
+std::vector<int> biparting(std::vector<unsigned long> const& offsets, std::vector<uint32_t> const& pins, uint32_t node_num,
+                           int num_part, int num_threads, scheduleMode mode, bool deterministic) {
   galois::SharedMemSys G;
   LonestarStart(num_threads, name, desc, url);
-  uint32_t hedges = hedge.size();
+  schedulingMode = mode;
+  deterministicOrder = deterministic;
+  const uint32_t hedges = offsets.empty() ? 0 : offsets.size() - 1;
  // srand(-1);
   MetisGraph metisGraph;
   GGraph& graph = *metisGraph.getGraph();
-  std::map<int, GNode> hnets;
+  std::vector<GNode> hnets(node_num);
   // create nodes
-  for(int i = 0; i < node_num; i++){
+  for(uint32_t i = 0; i < node_num; i++){
     GNode node;
     MetisNode n1;
     n1.netnum = INT_MAX;
@@ -100,8 +103,8 @@ std::map<int,int> biparting(std::vector<std::vector<uint32_t>> hedge, uint32_t n
     graph.addCell(node);
     hnets[i] = node;
   }
-  // create hyperedges
-  for (int i = 0; i < hedges; i++){
+  // create hyperedges, hyperedge i holds pins[offsets[i]] to pins[offsets[i+1]]
+  for (uint32_t i = 0; i < hedges; i++){
     GNode a;
     MetisNode n1;
     n1.netnum = i+1;
@@ -111,11 +114,8 @@ std::map<int,int> biparting(std::vector<std::vector<uint32_t>> hedge, uint32_t n
     a = graph.createNode(n1);
     graph.addNode(a);
     graph.addHyperedge(a);
-    //for (auto v : hedge[i]) {
-    for(int j = 0; j < hedge.at(i).size(); j++){
-      auto v = hedge.at(i).at(j);
-      GNode b = hnets[v];
-      graph.addEdge(a,b);
+    for (unsigned long j = offsets[i]; j < offsets[i + 1]; j++) {
+      graph.addEdge(a, hnets[pins[j]]);
     }
   }
 
@@ -230,11 +230,9 @@ std::map<int,int> biparting(std::vector<std::vector<uint32_t>> hedge, uint32_t n
     toProcessNew.clear();
 }
   // std::ofstream ofs(output.c_str());
-  std::map<int, int> cell;
+  std::vector<int> cell(node_num, 0);
   for (auto c : graph.cellList()) {
-    int id = graph.getData(c).nodeid;
-    int p = graph.getData(c).getPart();
-    cell[id] = p;
+    cell[graph.getData(c).nodeid - 1] = graph.getData(c).getPart();
   }
   return cell;
   // for (int i = 1; i <= cell.size(); i++) {
@@ -38,4 +38,9 @@ extern cll::opt<double> imbalance;
 void Partition(MetisGraph* metisGraph, unsigned coarsenTo, unsigned refineTo); 
 int computingCut(GGraph& g); 
 int hash(unsigned val); 
-std::map<int, int> biparting(std::vector<std::vector<uint32_t>> hedge, uint32_t nodes, int num_part, int num_threads, scheduleMode schedulingMode);
+// Partitions the hypergraph given in CSR form: hyperedge i connects the nodes
+// pins[offsets[i]] to pins[offsets[i+1]] - 1, nodes are numbered from 0.
+// Returns the partition of every node. With `deterministic` the result does
+// not depend on num_threads.
+std::vector<int> biparting(std::vector<unsigned long> const& offsets, std::vector<uint32_t> const& pins, uint32_t nodes,
+                           int num_part, int num_threads, scheduleMode mode, bool deterministic);
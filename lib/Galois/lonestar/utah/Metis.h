@@ -23,6 +23,8 @@
 #include "galois/graphs/MorphHyperGraph.h"
 #include "galois/AtomicWrapper.h"
 
+#include <cmath>
+
 class MetisNode;
 using GGraph   = galois::graphs::MorphHyperGraph<MetisNode, int, true>;
 using GNode    = GGraph::GraphNode;
@@ -184,6 +186,26 @@ public:
 };
 
 
+// When set, nodes are ordered by exact gain/weight with ties broken by
+// nodeid, which makes the partition independent of the number of threads
+extern bool deterministicOrder;
+
+// Order of the refinement and balancing moves: higher gain per weight first
+inline bool gainRatioGreater(GGraph& g, GNode lpw, GNode rpw) {
+  MetisNode& l = g.getData(lpw);
+  MetisNode& r = g.getData(rpw);
+  if (deterministicOrder) {
+    const long long lg = (long long)l.getGain() * r.getWeight();
+    const long long rg = (long long)r.getGain() * l.getWeight();
+    if (lg != rg)
+      return lg > rg;
+    return l.nodeid < r.nodeid;
+  }
+  if (fabs((float)(l.getGain() * (1.0f / l.getWeight())) - (float)(r.getGain() * (1.0f / r.getWeight()))) < 0.00001f)
+    return (float)l.nodeid < (float)r.nodeid;
+  return (float)(l.getGain() * (1.0f / l.getWeight())) > (float)(r.getGain() * (1.0f / r.getWeight()));
+}
+
 // Metrics
 unsigned graphStat(GGraph& graph);
 // Coarsening
@@ -31,6 +31,7 @@
 #include <climits>
 #include <array>
 const bool multiSeed = true;
+bool deterministicOrder = false;
 
 namespace {
 // final
@@ -142,8 +143,7 @@ void partition(MetisGraph* mcg) {
 
     for (auto c :nodelistz) nodeListz.push_back(c);
     std::sort(nodeListz.begin(), nodeListz.end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g->getData(lpw).getGain()) * (1.0f / g->getData(lpw).getWeight())) - (float)((g->getData(rpw).getGain()) * (1.0f / g->getData(rpw).getWeight()))) < 0.00001f) return (float)g->getData(lpw).nodeid < (float)g->getData(rpw).nodeid;
-      return (float) ((g->getData(lpw).getGain()) * (1.0f / g->getData(lpw).getWeight())) > (float)((g->getData(rpw).getGain()) * (1.0f / g->getData(rpw).getWeight()));
+    return gainRatioGreater(*g, lpw, rpw);
     });
     int i = 0;
     for (auto zz : nodeListz) {
@@ -185,8 +185,7 @@ else {
     for (auto c :nodelistz) nodeListz.push_back(c);
 	
     std::sort(nodeListz.begin(), nodeListz.end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g->getData(lpw).getGain()) * (1.0f / g->getData(lpw).getWeight())) - (float)((g->getData(rpw).getGain()) * (1.0f / g->getData(rpw).getWeight()))) < 0.00001f) return (float)g->getData(lpw).nodeid < (float)g->getData(rpw).nodeid;
-      return (float) ((g->getData(lpw).getGain()) * (1.0f / g->getData(lpw).getWeight())) > (float)((g->getData(rpw).getGain()) * (1.0f / g->getData(rpw).getWeight()));
+    return gainRatioGreater(*g, lpw, rpw);
     });
 
   int i = 0;
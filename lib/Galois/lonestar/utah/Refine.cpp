@@ -363,8 +363,7 @@ void parallel_make_balance(GGraph& g, float tol, int p) {
 		}
 
 		std::sort(nodeListz[idx].begin(), nodeListz[idx].end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) - (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()))) < 0.00001f) return (float)g.getData(lpw).nodeid < (float)g.getData(rpw).nodeid;
-      return (float) ((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) > (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()));
+    return gainRatioGreater(g, lpw, rpw);
     });
 
 	}, galois::steal());
@@ -402,8 +401,7 @@ void parallel_make_balance(GGraph& g, float tol, int p) {
 		nodeListzNegGain.push_back(x);
 
 	std::sort(nodeListzNegGain.begin(), nodeListzNegGain.end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) - (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()))) < 0.00001f) return (float)g.getData(lpw).nodeid < (float)g.getData(rpw).nodeid;
-      return (float) ((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) > (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()));
+    return gainRatioGreater(g, lpw, rpw);
     });
 
 	for(auto zz: nodeListzNegGain){
@@ -470,8 +468,7 @@ void parallel_make_balance(GGraph& g, float tol, int p) {
                 }
 
                 std::sort(nodeListo[idx].begin(), nodeListo[idx].end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) - (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()))) < 0.00001f) return (float)g.getData(lpw).nodeid < (float)g.getData(rpw).nodeid;
-      return (float) ((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) > (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()));
+    return gainRatioGreater(g, lpw, rpw);
     });
 
         });
@@ -511,8 +508,7 @@ void parallel_make_balance(GGraph& g, float tol, int p) {
                 nodeListoNegGain.push_back(x);
 
         std::sort(nodeListoNegGain.begin(), nodeListoNegGain.end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) - (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()))) < 0.00001f) return (float)g.getData(lpw).nodeid < (float)g.getData(rpw).nodeid;
-      return (float) ((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) > (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()));
+    return gainRatioGreater(g, lpw, rpw);
     });
 
         for(auto zz: nodeListoNegGain){
@@ -570,8 +566,7 @@ void make_balance(GGraph& g, float tol, int p) {
     for (auto x : nodelistz)
        nodeListz.push_back(x);
     std::sort(nodeListz.begin(), nodeListz.end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) - (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()))) < 0.00001f) return (float)g.getData(lpw).nodeid < (float)g.getData(rpw).nodeid;
-      return (float) ((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) > (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()));
+    return gainRatioGreater(g, lpw, rpw);
     });
     int i = 0;
       for (auto zz : nodeListz) {
@@ -603,8 +598,7 @@ void make_balance(GGraph& g, float tol, int p) {
         nodeListo.push_back(x);
 
       std::sort(nodeListo.begin(), nodeListo.end(), [&g] (GNode& lpw, GNode& rpw) {
-    if (fabs((float)((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) - (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()))) < 0.00001f) return (float)g.getData(lpw).nodeid < (float)g.getData(rpw).nodeid;
-      return (float) ((g.getData(lpw).getGain()) * (1.0f / g.getData(lpw).getWeight())) > (float)((g.getData(rpw).getGain()) * (1.0f / g.getData(rpw).getWeight()));
+    return gainRatioGreater(g, lpw, rpw);
     });
 
       int i = 0;
@@ -194,6 +194,55 @@ inline std::string to_string<type>( type const& element )
 template<> \
 inline void print<type>( std::ostream& os, type const& element )
 
+/*! \brief Returns the approximate memory of a store element
+
+  This macro is used to return the number of bytes that is shown for each store
+  entry in the output of ``store --stats``.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param element Reference to the store element
+*/
+#define ALICE_STORE_MEMORY(type, element) \
+template<> \
+inline std::size_t memory_usage<type>( type const& element )
+
+/*! \brief Writes an evicted store element to a file
+
+  This macro enables spilling for a store: entries evicted by the store policy
+  are written to a file instead of being removed.  It must be used together
+  with :c:macro:`ALICE_RELOAD_STORE`.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param element Reference to the store element
+  \param filename Filename to write to
+*/
+#define ALICE_SPILL_STORE(type, element, filename) \
+template<> \
+inline bool can_spill<type>() \
+{ \
+  return true; \
+} \
+template<> \
+inline void spill<type>( type const& element, const std::string& filename )
+
+/*! \brief Restores a spilled store element
+
+  This macro is used to read back a store element that was written with the
+  code of :c:macro:`ALICE_SPILL_STORE` when it is accessed again.
+
+  The macro must be followed by a code block.
+
+  \param type Store type
+  \param filename Filename to read from
+*/
+#define ALICE_RELOAD_STORE(type, filename) \
+template<> \
+inline type reload<type>( const std::string& filename )
+
 /*! \brief Prints statistics about a store element to the terminal
 
   This macro is used to generate the output that is printed when calling ``ps``
@@ -536,6 +585,7 @@ extern "C" { \
       if ( result ) \
       { \
         const auto json = it->second->log(); \
+        cli->env->enforce_store_policies(); \
         if ( log && !json.is_null() ) { \
           const auto dump = json.dump(); \
           strncpy( log, dump.c_str(), size ); \
@@ -565,6 +615,13 @@ extern "C" { \
 int main( int argc, char ** argv ) \
 { \
   _ALICE_MAIN_BODY(prefix) \
+  cli.set_factory( []() { \
+    auto job_cli = std::make_unique<cli_t>( #prefix ); \
+    insert_read_commands<cli_t, alice_read_tags, std::tuple_size<alice_read_tags>::value> jrc( *job_cli ); \
+    insert_write_commands<cli_t, alice_write_tags, std::tuple_size<alice_write_tags>::value> jwc( *job_cli ); \
+    insert_commands<cli_t, alice_commands, std::tuple_size<alice_commands>::value> jc( *job_cli ); \
+    return job_cli; \
+  } ); \
   return cli.run( argc, argv ); \
 }
 #endif
@@ -34,8 +34,10 @@
 
 #include <chrono>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <regex>
+#include <sstream>
 #include <string>
 
 #include <CLI11.hpp>
@@ -44,6 +46,7 @@
 #include "command.hpp"
 #include "detail/logging.hpp"
 #include "readline.hpp"
+#include "server.hpp"
 
 #include "commands/alias.hpp"
 #include "commands/convert.hpp"
@@ -111,6 +114,19 @@ public:
     opts.add_flag( "-n,--counter", "show a counter in the prefix" );
     opts.add_flag( "-i,--interactive", "continue in interactive mode after processing commands (in command or file mode)" );
     opts.add_option( "-l,--log", logname, "logs the execution and stores many statistical information" );
+    opts.add_flag( "--serve", "run as batch server, accepting jobs from standard input or from --socket" );
+    opts.add_option( "--socket", socket_path, "with --serve, accept jobs from clients of this Unix domain socket" );
+    opts.add_option( "--jobs", num_jobs, "with --serve, number of jobs to run concurrently (default: number of cores)" );
+  }
+
+  /*! \brief Removes the files of spilled store entries
+
+    Commands keep the environment alive, so this cannot be left to the
+    destructors of the stores.
+  */
+  ~cli()
+  {
+    env->remove_spill_files();
   }
 
   /*! \brief Sets the current category
@@ -179,6 +195,52 @@ public:
     insert_command( name, std::make_shared<write_io_command<Tag, S...>>( env, label ) );
   }
 
+  /*! \brief Sets how the shells of server jobs are created
+
+    The macro :c:macro:`ALICE_MAIN` sets a factory that creates a shell with
+    the same stores and commands.  Without a factory, ``--serve`` is not
+    available.
+
+    \param f Function that returns a new shell
+  */
+  void set_factory( std::function<std::unique_ptr<cli>()> f )
+  {
+    factory = f;
+  }
+
+  /*! \brief Runs a script
+
+    Runs the new-line or semicolon separated commands of a script, as ``-f``
+    does for a file.  This is how the batch server runs its jobs.
+
+    \param script Commands
+    \return True if every command succeeded
+  */
+  bool run_script( const std::string& script )
+  {
+    std::istringstream in( script );
+    std::string line;
+    auto result = true;
+
+    while ( getline( in, line ) )
+    {
+      detail::trim( line );
+      if ( line.empty() || line[0] == '#' )
+      {
+        continue;
+      }
+
+      result = execute_line( preprocess_alias( line ) ) && result;
+
+      if ( env->quit )
+      {
+        break;
+      }
+    }
+
+    return result;
+  }
+
   /*! \brief Runs the shell
 
     This function is only used if the CLI is used in stand-alone mode, not when
@@ -210,6 +272,17 @@ public:
 
     read_aliases();
 
+    if ( opts.count( "--serve" ) )
+    {
+      if ( !factory )
+      {
+        env->err() << "[e] this shell cannot run as server" << std::endl;
+        return 1;
+      }
+      job_server<cli> server( factory, num_jobs );
+      return socket_path.empty() ? server.serve_stream( STDIN_FILENO, STDOUT_FILENO ) : server.serve_socket( socket_path );
+    }
+
     if ( opts.count( "-l" ) )
     {
       env->log = true;
@@ -344,6 +417,15 @@ private:
         env->logger.log( it->second->log(), line, now );
       }
 
+      try
+      {
+        env->enforce_store_policies();
+      }
+      catch ( const std::string& e )
+      {
+        env->err() << e << std::endl;
+      }
+
       return result;
     }
     else
@@ -456,6 +538,10 @@ private:
 
   std::string command, file, logname;
 
+  std::string socket_path;
+  unsigned num_jobs{0u};
+  std::function<std::unique_ptr<cli>()> factory;
+
   unsigned counter{1u};
   /*! \endcond */
 };
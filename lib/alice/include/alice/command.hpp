@@ -209,6 +209,28 @@ public:
     return ALICE_SETTINGS_WITH_DEFAULT_OPTION && _default_option == option;
   }
 
+  /*! \brief Applies the retention policies of all stores
+
+    Called by the CLI after each command, when no references to store
+    elements are held anymore.
+  */
+  void enforce_store_policies()
+  {
+    for ( const auto& enforce : _store_policies )
+    {
+      enforce();
+    }
+  }
+
+  /*! \brief Removes the files of all spilled store entries */
+  void remove_spill_files()
+  {
+    for ( const auto& cleanup : _store_cleanups )
+    {
+      cleanup();
+    }
+  }
+
 private:
   /*! \brief Adds store to environment */
   template<typename T>
@@ -217,7 +239,14 @@ private:
     constexpr auto key = store_info<T>::key;
     constexpr auto name = store_info<T>::name;
 
-    _stores.emplace( key, std::shared_ptr<void>( new alice::store_container<T>( name ) ) );
+    auto* container = new alice::store_container<T>( name );
+    if ( can_spill<T>() )
+    {
+      container->set_spill_functions( spill<T>, reload<T> );
+    }
+    _stores.emplace( key, std::shared_ptr<void>( container ) );
+    _store_policies.emplace_back( [container]() { container->enforce_policy(); } );
+    _store_cleanups.emplace_back( [container]() { container->remove_spill_files(); } );
   }
 
 private:
@@ -239,6 +268,8 @@ private:
 
 private:
   std::unordered_map<std::string, std::shared_ptr<void>> _stores;
+  std::vector<std::function<void()>> _store_policies;
+  std::vector<std::function<void()>> _store_cleanups;
   std::unordered_map<std::string, std::shared_ptr<command>> _commands;
   std::unordered_map<std::string, std::vector<std::string>> _categories;
   std::unordered_map<std::string, std::string> _aliases;
@@ -101,11 +101,12 @@ private:
     {
       if ( is_set( "all" ) )
       {
-        auto ctr{0u};
-        for ( const auto& elem : store<Store>().data() )
+        /* by index, such that spilled entries are reloaded */
+        const auto& _store = store<Store>();
+        for ( auto ctr = 0u; ctr < _store.size(); ++ctr )
         {
-          env->out() << "[i] \033[1;34m" << name << "\033[0m \033[1;33m" << ctr++ << "\033[0m\n";
-          print_statistics<Store>( env->out(), elem );
+          env->out() << "[i] \033[1;34m" << name << "\033[0m \033[1;33m" << ctr << "\033[0m\n";
+          print_statistics<Store>( env->out(), _store[ctr] );
         }
         env->set_default_option( option );
       }
@@ -142,9 +143,10 @@ private:
       if ( is_set( "all" ) )
       {
         auto arr = nlohmann::json::array();
-        for ( const auto& elem : store<Store>().data() )
+        const auto& _store = store<Store>();
+        for ( auto i = 0u; i < _store.size(); ++i )
         {
-          arr.push_back( log_statistics<Store>( elem ) );
+          arr.push_back( log_statistics<Store>( _store[i] ) );
         }
         ret["all"] = arr;
       }
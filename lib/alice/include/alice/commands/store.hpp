@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include <fstream>
 #include <vector>
 
 #include <fmt/format.h>
@@ -50,6 +51,9 @@ public:
   {
     add_flag( "--show", "show contents" );
     add_flag( "--clear", "clear contents" );
+    add_flag( "--stats", "show memory used by each entry" );
+    add_option( "--max_entries", max_entries, "keep at most this many entries in memory, evicting the least recently used (0: no limit)" );
+    add_option( "--spill_dir", spill_dir, "write evicted entries into this directory instead of removing them" );
 
     []( ... ) {}( add_option_helper<S>( opts )... );
   }
@@ -58,13 +62,22 @@ protected:
   rules validity_rules() const
   {
     return {
-        {[this]() { return static_cast<unsigned>( is_set( "show" ) ) + static_cast<unsigned>( is_set( "clear" ) ) <= 1u; }, "only one operation can be specified"},
+        {[this]() { return static_cast<unsigned>( is_set( "show" ) ) + static_cast<unsigned>( is_set( "clear" ) ) + static_cast<unsigned>( is_set( "stats" ) ) <= 1u; }, "only one operation can be specified"},
         {[this]() { (void)this; return env->has_default_option() || any_true_helper<bool>( {is_set( store_info<S>::option )...} ); }, "no store has been specified"}};
   }
 
   void execute()
   {
-    if ( is_set( "show" ) || !is_set( "clear" ) )
+    if ( is_set( "max_entries" ) || is_set( "spill_dir" ) )
+    {
+      []( ... ) {}( set_policy<S>()... );
+    }
+
+    if ( is_set( "stats" ) )
+    {
+      []( ... ) {}( stats_store<S>()... );
+    }
+    else if ( is_set( "show" ) || !is_set( "clear" ) )
     {
       []( ... ) {}( show_store<S>()... );
     }
@@ -81,6 +94,10 @@ protected:
     return map;
   }
 
+private:
+  unsigned max_entries{0u};
+  std::string spill_dir;
+
 private:
   template<typename Store>
   int show_store()
@@ -103,7 +120,14 @@ private:
         for ( const auto& element : _store.data() )
         {
           env->out() << fmt::format( "  {} {:2}: ", ( _store.current_index() == index ? '*' : ' ' ), index );
-          env->out() << to_string<Store>( element ) << std::endl;
+          if ( _store.is_spilled( index ) )
+          {
+            env->out() << fmt::format( "spilled to {}", _store.spill_file( index ) ) << std::endl;
+          }
+          else
+          {
+            env->out() << to_string<Store>( element ) << std::endl;
+          }
           ++index;
         }
       }
@@ -114,6 +138,75 @@ private:
     return 0;
   }
 
+  template<typename Store>
+  int stats_store()
+  {
+    constexpr auto option = store_info<Store>::option;
+    constexpr auto name_plural = store_info<Store>::name_plural;
+
+    const auto& _store = store<Store>();
+
+    if ( is_set( option ) || env->is_default_option( option ) )
+    {
+      const auto& policy = _store.policy();
+      env->out() << fmt::format( "[i] {} in store: {} ({} in memory), limit: {}, spill directory: {}", name_plural, _store.size(), _store.num_resident(),
+                                 policy.max_entries == 0u ? std::string( "none" ) : std::to_string( policy.max_entries ),
+                                 policy.spill_directory.empty() ? std::string( "none" ) : policy.spill_directory )
+                 << std::endl;
+
+      std::size_t total_memory = 0u, total_disk = 0u;
+      for ( auto index = 0u; index < _store.size(); ++index )
+      {
+        env->out() << fmt::format( "  {} {:2}: ", ( _store.current_index() == static_cast<int>( index ) ? '*' : ' ' ), index );
+        if ( _store.is_spilled( index ) )
+        {
+          /* do not reload, report the size of the file instead */
+          std::ifstream in( _store.spill_file( index ), std::ifstream::binary | std::ifstream::ate );
+          const std::size_t bytes = in ? static_cast<std::size_t>( in.tellg() ) : 0u;
+          total_disk += bytes;
+          env->out() << fmt::format( "spilled, {} bytes on disk", bytes ) << std::endl;
+        }
+        else
+        {
+          const auto bytes = memory_usage<Store>( _store.data()[index] );
+          total_memory += bytes;
+          env->out() << fmt::format( "resident, {} bytes", bytes ) << std::endl;
+        }
+      }
+      env->out() << fmt::format( "  total: {} bytes in memory, {} bytes on disk", total_memory, total_disk ) << std::endl;
+
+      env->set_default_option( option );
+    }
+
+    return 0;
+  }
+
+  template<typename Store>
+  int set_policy()
+  {
+    constexpr auto option = store_info<Store>::option;
+
+    if ( is_set( option ) || env->is_default_option( option ) )
+    {
+      auto& _store = store<Store>();
+      auto policy = _store.policy();
+      if ( is_set( "max_entries" ) )
+      {
+        policy.max_entries = max_entries;
+      }
+      if ( is_set( "spill_dir" ) )
+      {
+        policy.spill_directory = spill_dir;
+      }
+      if ( !policy.spill_directory.empty() && !can_spill<Store>() )
+      {
+        env->err() << fmt::format( "[w] {} cannot be spilled, evicted entries are removed", store_info<Store>::name_plural ) << std::endl;
+      }
+      _store.set_policy( policy );
+    }
+    return 0;
+  }
+
   template<typename Store>
   int clear_store()
   {
@@ -173,7 +173,7 @@ void create_python_module( const CLI& cli, py::module& m )
 
   for ( const auto& p : cli.env->commands() )
   {
-    m.def( p.first.c_str(), [p]( py::kwargs kwargs ) -> py::object {
+    m.def( p.first.c_str(), [p, env = cli.env]( py::kwargs kwargs ) -> py::object {
       std::vector<std::string> pargs = {p.first};
 
       for ( const auto& kp : kwargs )
@@ -204,6 +204,7 @@ void create_python_module( const CLI& cli, py::module& m )
       p.second->run( pargs );
 
       const auto log = p.second->log();
+      env->enforce_store_policies();
 
       if ( log.is_object() )
       {
@@ -0,0 +1,521 @@
+/* alice: C++ command shell library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+  \file server.hpp
+  \brief Batch server that runs command scripts as jobs
+
+  The server keeps one process alive for many scripts, so that resources the
+  commands cache process wide are only loaded once.  Requests and responses
+  are framed by a header line followed by a payload of the given size:
+
+    job <id> <size>\n<payload>        runs the payload as a script
+    quit\n                            ends the connection
+    shutdown\n                        stops the server
+
+    done <id> <status> <size>\n<out>  status is 0 if every command succeeded
+    error <message>\n                 malformed request
+
+  The payload is a script of new-line or semicolon separated commands.  Every
+  job runs in a fresh shell, i.e., with empty stores, and jobs run
+  concurrently on a pool of threads.  Standard output and error of a job are
+  captured and returned as its output.
+
+  Output is captured per job by replacing the stream buffers of ``std::cout``
+  and ``std::cerr``, the streams themselves are shared by all jobs.  Their
+  format state (precision, ``std::fixed``, width, fill) is therefore process
+  wide: a command that changes it must restore it, or format into a local
+  stream, otherwise concurrent jobs print with its settings.  Output written
+  with ``printf`` or ``fmt::print`` goes to the file descriptor directly and
+  is not captured; it ends up in the log of the server (standard error in
+  stdin mode).
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace alice
+{
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* Stream buffer that writes to a buffer selected by the calling thread, or to
+   the original buffer of the stream if the thread did not select one */
+class routed_streambuf : public std::streambuf
+{
+public:
+  explicit routed_streambuf( std::streambuf* fallback )
+      : fallback( fallback )
+  {
+  }
+
+  static std::streambuf*& target()
+  {
+    static thread_local std::streambuf* buf = nullptr;
+    return buf;
+  }
+
+protected:
+  int_type overflow( int_type ch ) override
+  {
+    if ( traits_type::eq_int_type( ch, traits_type::eof() ) )
+    {
+      return traits_type::not_eof( ch );
+    }
+    return current()->sputc( traits_type::to_char_type( ch ) );
+  }
+
+  std::streamsize xsputn( const char* s, std::streamsize n ) override
+  {
+    return current()->sputn( s, n );
+  }
+
+  int sync() override
+  {
+    return current()->pubsync();
+  }
+
+private:
+  std::streambuf* current() const
+  {
+    auto* buf = target();
+    return buf ? buf : fallback;
+  }
+
+  std::streambuf* fallback;
+};
+
+/* Buffered reader of header lines and payloads from a file descriptor */
+class frame_reader
+{
+public:
+  explicit frame_reader( int fd )
+      : fd( fd )
+  {
+  }
+
+  bool read_line( std::string& line )
+  {
+    line.clear();
+    char c;
+    while ( get( c ) )
+    {
+      if ( c == '\n' )
+      {
+        return true;
+      }
+      line += c;
+    }
+    return !line.empty();
+  }
+
+  bool read_payload( std::size_t size, std::string& payload )
+  {
+    payload.resize( size );
+    for ( auto i = 0u; i < size; ++i )
+    {
+      if ( !get( payload[i] ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  bool get( char& c )
+  {
+    if ( pos == end )
+    {
+      ssize_t n;
+      do
+      {
+        n = ::read( fd, buffer, sizeof( buffer ) );
+      } while ( n < 0 && errno == EINTR );
+      if ( n <= 0 )
+      {
+        return false;
+      }
+      pos = 0;
+      end = n;
+    }
+    c = buffer[pos++];
+    return true;
+  }
+
+  int fd;
+  char buffer[1 << 16];
+  std::size_t pos = 0;
+  std::size_t end = 0;
+};
+
+inline bool write_all( int fd, const std::string& data )
+{
+  std::size_t done = 0;
+  while ( done < data.size() )
+  {
+    const auto n = ::send( fd, data.data() + done, data.size() - done, MSG_NOSIGNAL );
+    if ( n < 0 && errno == ENOTSOCK )
+    {
+      /* pipes in stdin mode */
+      const auto m = ::write( fd, data.data() + done, data.size() - done );
+      if ( m <= 0 )
+      {
+        return false;
+      }
+      done += m;
+      continue;
+    }
+    if ( n < 0 && errno == EINTR )
+    {
+      continue;
+    }
+    if ( n <= 0 )
+    {
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
+} // namespace detail
+/*! \endcond */
+
+/*! \brief Runs scripts of a CLI as concurrent jobs
+
+  ``Cli`` must provide ``bool run_script( const std::string& )``.  The
+  factory creates the shell of every job.
+*/
+template<class Cli>
+class job_server
+{
+public:
+  using factory_t = std::function<std::unique_ptr<Cli>()>;
+
+  job_server( factory_t factory, unsigned num_threads )
+      : factory( factory ),
+        num_threads( num_threads ? num_threads : std::max( 1u, std::thread::hardware_concurrency() ) )
+  {
+  }
+
+  /*! \brief Serves requests from a file descriptor, usually standard input
+
+    Responses are written to ``out_fd``.  Everything else the process writes
+    to that descriptor is redirected to standard error, so that it cannot
+    interleave with the responses.
+  */
+  int serve_stream( int in_fd, int out_fd )
+  {
+    const auto response_fd = ::dup( out_fd );
+    ::dup2( STDERR_FILENO, out_fd );
+
+    auto conn = std::make_shared<connection>( in_fd, response_fd );
+    start();
+    serve_connection( conn );
+    stop();
+    return 0;
+  }
+
+  /*! \brief Serves requests from clients of a Unix domain socket
+
+    Returns once a client sends ``shutdown``.
+  */
+  int serve_socket( const std::string& path )
+  {
+    sockaddr_un addr{};
+    if ( path.size() >= sizeof( addr.sun_path ) )
+    {
+      std::cerr << "[e] socket path " << path << " is too long" << std::endl;
+      return 1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy( addr.sun_path, path.c_str(), sizeof( addr.sun_path ) - 1 );
+
+    listen_fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+    ::unlink( path.c_str() );
+    if ( listen_fd < 0 || ::bind( listen_fd, reinterpret_cast<sockaddr*>( &addr ), sizeof( addr ) ) < 0 || ::listen( listen_fd, 64 ) < 0 )
+    {
+      std::cerr << "[e] cannot listen on " << path << ": " << std::strerror( errno ) << std::endl;
+      return 1;
+    }
+    std::cerr << "[i] serving on " << path << " with " << num_threads << " threads" << std::endl;
+
+    start();
+    while ( !stopping )
+    {
+      const auto fd = ::accept( listen_fd, nullptr, nullptr );
+      if ( fd < 0 )
+      {
+        if ( errno == EINTR )
+        {
+          continue;
+        }
+        break;
+      }
+
+      /* clients such as the Yosys plugin connect once per module, so the
+         connection threads are detached and only counted */
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        ++num_clients;
+      }
+      std::thread( [this, fd]() {
+        serve_connection( std::make_shared<connection>( fd, fd ) );
+        std::lock_guard<std::mutex> lock( mutex );
+        --num_clients;
+        done_cv.notify_all();
+      } ).detach();
+    }
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      done_cv.wait( lock, [this]() { return num_clients == 0u; } );
+    }
+    stop();
+    ::close( listen_fd );
+    ::unlink( path.c_str() );
+    return 0;
+  }
+
+private:
+  struct connection
+  {
+    connection( int in_fd, int out_fd )
+        : in_fd( in_fd ),
+          out_fd( out_fd )
+    {
+    }
+
+    ~connection()
+    {
+      ::close( out_fd );
+    }
+
+    void send( const std::string& data )
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      detail::write_all( out_fd, data );
+    }
+
+    int in_fd;
+    int out_fd;
+    std::mutex mutex;
+  };
+
+  struct job
+  {
+    std::shared_ptr<connection> conn;
+    std::string id;
+    std::string script;
+  };
+
+  void start()
+  {
+    ::signal( SIGPIPE, SIG_IGN );
+
+    out_buf = std::make_unique<detail::routed_streambuf>( std::cout.rdbuf() );
+    err_buf = std::make_unique<detail::routed_streambuf>( std::cerr.rdbuf() );
+    old_out = std::cout.rdbuf( out_buf.get() );
+    old_err = std::cerr.rdbuf( err_buf.get() );
+
+    for ( auto i = 0u; i < num_threads; ++i )
+    {
+      workers.emplace_back( [this]() { work(); } );
+    }
+  }
+
+  void stop()
+  {
+    stopping = true;
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+    }
+    cv.notify_all();
+    for ( auto& t : workers )
+    {
+      t.join();
+    }
+    workers.clear();
+
+    std::cout.rdbuf( old_out );
+    std::cerr.rdbuf( old_err );
+  }
+
+  void serve_connection( std::shared_ptr<connection> conn )
+  {
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      if ( stopping )
+      {
+        return;
+      }
+      client_fds.insert( conn->in_fd );
+    }
+
+    detail::frame_reader reader( conn->in_fd );
+    std::string line;
+    while ( reader.read_line( line ) )
+    {
+      std::istringstream header( line );
+      std::string kind;
+      header >> kind;
+
+      if ( kind == "quit" )
+      {
+        break;
+      }
+      if ( kind == "shutdown" )
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+        if ( listen_fd >= 0 )
+        {
+          ::shutdown( listen_fd, SHUT_RDWR );
+        }
+        /* wakes up the readers of the other clients */
+        for ( auto fd : client_fds )
+        {
+          ::shutdown( fd, SHUT_RD );
+        }
+        break;
+      }
+
+      std::string id;
+      std::size_t size;
+      if ( kind != "job" || !( header >> id >> size ) )
+      {
+        conn->send( "error malformed request: " + line + "\n" );
+        break;
+      }
+
+      job j{conn, id, {}};
+      if ( !reader.read_payload( size, j.script ) )
+      {
+        break;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        queue.push_back( std::move( j ) );
+      }
+      cv.notify_one();
+    }
+
+    /* in stdin mode the server ends with the input, after the queued jobs */
+    std::unique_lock<std::mutex> lock( mutex );
+    done_cv.wait( lock, [&]() { return std::none_of( queue.begin(), queue.end(), [&]( auto const& j ) { return j.conn == conn; } ) && !running.count( conn.get() ); } );
+    client_fds.erase( conn->in_fd );
+  }
+
+  void work()
+  {
+    while ( true )
+    {
+      job j;
+      {
+        std::unique_lock<std::mutex> lock( mutex );
+        cv.wait( lock, [this]() { return stopping || !queue.empty(); } );
+        if ( queue.empty() )
+        {
+          return;
+        }
+        j = std::move( queue.front() );
+        queue.pop_front();
+        running.insert( j.conn.get() );
+      }
+
+      std::ostringstream out;
+      detail::routed_streambuf::target() = out.rdbuf();
+      auto ok = false;
+      try
+      {
+        auto cli = factory();
+        ok = cli->run_script( j.script );
+      }
+      catch ( const std::exception& e )
+      {
+        out << "[e] " << e.what() << std::endl;
+      }
+      catch ( const std::string& e )
+      {
+        out << "[e] " << e << std::endl;
+      }
+      detail::routed_streambuf::target() = nullptr;
+
+      const auto output = out.str();
+      j.conn->send( "done " + j.id + " " + ( ok ? "0" : "1" ) + " " + std::to_string( output.size() ) + "\n" + output );
+
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        running.erase( running.find( j.conn.get() ) );
+      }
+      done_cv.notify_all();
+    }
+  }
+
+  factory_t factory;
+  unsigned num_threads;
+  int listen_fd = -1;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::condition_variable done_cv;
+  std::deque<job> queue;
+  std::multiset<connection*> running;
+  std::atomic<bool> stopping{false};
+  std::set<int> client_fds;
+  std::size_t num_clients = 0u;
+  std::vector<std::thread> workers;
+
+  std::unique_ptr<detail::routed_streambuf> out_buf;
+  std::unique_ptr<detail::routed_streambuf> err_buf;
+  std::streambuf* old_out = nullptr;
+  std::streambuf* old_err = nullptr;
+};
+
+} // namespace alice
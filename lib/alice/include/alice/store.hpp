@@ -32,6 +32,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstdio>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -40,6 +43,21 @@
 namespace alice
 {
 
+/*! \brief Retention policy of a store
+
+  At most ``max_entries`` entries are kept in memory (0 means no limit).  When
+  a command leaves more entries in the store, the least recently used ones
+  (except the current one) are evicted.  If ``spill_directory`` is set and the
+  store element type can be spilled, evicted entries are written to a file in
+  that directory and reloaded when they are accessed again; otherwise they are
+  removed from the store.
+*/
+struct store_policy
+{
+  std::size_t max_entries{0u};
+  std::string spill_directory;
+};
+
 /*! \brief Store container
  */
 template<class T>
@@ -60,6 +78,7 @@ public:
     {
       throw fmt::format( "[e] no current {} available", _name );
     }
+    touch( _current );
     return _data[_current];
   }
 
@@ -71,6 +90,7 @@ public:
     {
       throw fmt::format( "[e] no current {} available", _name );
     }
+    touch( _current );
     return _data[_current];
   }
 
@@ -98,6 +118,7 @@ public:
     {
       throw fmt::format( "[e] index {} is out of bounds", index );
     }
+    touch( index );
     return _data[index];
   }
 
@@ -111,6 +132,7 @@ public:
     {
       throw fmt::format( "[e] index {} is out of bounds", index );
     }
+    touch( index );
     return _data[index];
   }
 
@@ -129,6 +151,9 @@ public:
   }
 
   /*! \brief Constant access to store elements
+
+    Spilled entries are not reloaded and hold a default constructed element,
+    use ``operator[]`` to access entries one by one.
    */
   inline const std::vector<T>& data() const
   {
@@ -147,6 +172,7 @@ public:
     if ( i < _data.size() )
     {
       _current = i;
+      touch( i );
     }
   }
 
@@ -158,6 +184,8 @@ public:
   {
     _current = _data.size();
     _data.push_back( T() );
+    _spilled.emplace_back();
+    _last_use.push_back( ++_clock );
     return _data.back();
   }
 
@@ -165,14 +193,159 @@ public:
    */
   void clear()
   {
+    remove_spill_files();
     _data.clear();
+    _spilled.clear();
+    _last_use.clear();
     _current = -1;
   }
 
+  ~store_container()
+  {
+    remove_spill_files();
+  }
+
+  /*! \brief Returns the retention policy */
+  inline const store_policy& policy() const
+  {
+    return _policy;
+  }
+
+  /*! \brief Sets the retention policy, which is applied by `enforce_policy` */
+  inline void set_policy( const store_policy& policy )
+  {
+    _policy = policy;
+  }
+
+  /*! \brief Sets the functions to write an element to a file and to read it back */
+  void set_spill_functions( std::function<void( const T&, const std::string& )> spill,
+                            std::function<T( const std::string& )> reload )
+  {
+    _spill = spill;
+    _reload = reload;
+  }
+
+  /*! \brief Returns whether the entry at given index is spilled to a file */
+  inline bool is_spilled( std::size_t index ) const
+  {
+    return index < _spilled.size() && !_spilled[index].empty();
+  }
+
+  /*! \brief Returns the file of a spilled entry, or an empty string */
+  inline std::string spill_file( std::size_t index ) const
+  {
+    return is_spilled( index ) ? _spilled[index] : std::string();
+  }
+
+  /*! \brief Returns the number of entries held in memory */
+  std::size_t num_resident() const
+  {
+    std::size_t count = 0u;
+    for ( const auto& file : _spilled )
+    {
+      count += file.empty() ? 1u : 0u;
+    }
+    return count;
+  }
+
+  /*! \brief Evicts the least recently used entries beyond the policy limit
+
+    Must not be called while references to store elements are held, it is
+    called by the CLI after each command.
+  */
+  void enforce_policy()
+  {
+    if ( _policy.max_entries == 0u )
+    {
+      return;
+    }
+
+    auto resident = num_resident();
+    while ( resident > _policy.max_entries )
+    {
+      std::size_t victim = _data.size();
+      for ( auto i = 0u; i < _data.size(); ++i )
+      {
+        if ( static_cast<int>( i ) != _current && _spilled[i].empty() && ( victim == _data.size() || _last_use[i] < _last_use[victim] ) )
+        {
+          victim = i;
+        }
+      }
+      if ( victim == _data.size() )
+      {
+        break;
+      }
+
+      if ( !_policy.spill_directory.empty() && _spill )
+      {
+        const auto filename = fmt::format( "{}/alice_{}_{:x}_{}.snap", _policy.spill_directory, _name, reinterpret_cast<std::uintptr_t>( this ), _spill_counter++ );
+        _spill( _data[victim], filename );
+        _data[victim] = T();
+        _spilled[victim] = filename;
+      }
+      else
+      {
+        _data.erase( _data.begin() + victim );
+        _spilled.erase( _spilled.begin() + victim );
+        _last_use.erase( _last_use.begin() + victim );
+        if ( _current > static_cast<int>( victim ) )
+        {
+          --_current;
+        }
+      }
+      --resident;
+    }
+  }
+
+  /*! \brief Removes all spill files, spilled entries are removed as well */
+  void remove_spill_files()
+  {
+    for ( auto i = _data.size(); i-- > 0u; )
+    {
+      if ( !_spilled[i].empty() )
+      {
+        std::remove( _spilled[i].c_str() );
+        _data.erase( _data.begin() + i );
+        _spilled.erase( _spilled.begin() + i );
+        _last_use.erase( _last_use.begin() + i );
+        if ( _current > static_cast<int>( i ) )
+        {
+          --_current;
+        }
+      }
+    }
+  }
+
+private:
+  /* marks an entry as used and reloads it if it is spilled */
+  void touch( std::size_t index ) const
+  {
+    if ( !_spilled[index].empty() )
+    {
+      if ( !_reload )
+      {
+        throw fmt::format( "[e] cannot reload {} {} from {}", _name, index, _spilled[index] );
+      }
+      _data[index] = _reload( _spilled[index] );
+      std::remove( _spilled[index].c_str() );
+      _spilled[index].clear();
+    }
+    _last_use[index] = ++_clock;
+  }
+
 private:
   std::string _name;
-  std::vector<T> _data;
+  /* entries are reloaded by const accessors */
+  mutable std::vector<T> _data;
+  mutable std::vector<std::string> _spilled;
+  mutable std::vector<uint64_t> _last_use;
+  mutable uint64_t _clock{0u};
   int _current{-1};
+
+  store_policy _policy;
+  std::function<void( const T&, const std::string& )> _spill;
+  std::function<T( const std::string& )> _reload;
+  std::size_t _spill_counter{0u};
 };
 
 }
@@ -158,6 +158,66 @@ nlohmann::json log_statistics( StoreType const& element )
   return nlohmann::json({});
 }
 
+/*! \brief Approximate number of bytes a store element occupies in memory
+
+  \verbatim embed:rst
+      This routine is called by ``store --stats``.  You can use
+      :c:macro:`ALICE_STORE_MEMORY` to implement this function.
+  \endverbatim
+
+  \param element Store element
+*/
+template<typename StoreType>
+std::size_t memory_usage( StoreType const& element )
+{
+  (void)element;
+  return 0u;
+}
+
+/*! \brief Controls whether store elements can be spilled to files
+
+  If this function is overriden to return true, then also the functions
+  `spill` and `reload` must be implemented for the same store type.  Stores
+  whose elements can be spilled move evicted entries to files instead of
+  removing them, see ``store_policy``.
+
+  \verbatim embed:rst
+      You can use :c:macro:`ALICE_SPILL_STORE` and :c:macro:`ALICE_RELOAD_STORE`
+      to implement these functions.
+  \endverbatim
+*/
+template<typename StoreType>
+bool can_spill()
+{
+  return false;
+}
+
+/*! \brief Writes a store element to a file from which `reload` restores it
+
+  \param element Store element
+  \param filename Filename to write to
+*/
+template<typename StoreType>
+void spill( StoreType const& element, const std::string& filename )
+{
+  (void)element;
+  (void)filename;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
+/*! \brief Restores a store element written by `spill`
+
+  The function may throw a `std::string` with an error message.
+
+  \param filename Filename to read from
+*/
+template<typename StoreType>
+StoreType reload( const std::string& filename )
+{
+  (void)filename;
+  throw std::runtime_error( "[e] unimplemented function" );
+}
+
 /*! \brief Controls whether a store entry can read from a specific format
 
   If this function is overriden to return true, then also the function `read`
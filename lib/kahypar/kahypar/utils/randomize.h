@@ -35,7 +35,8 @@ class Randomize {
   Randomize& operator= (Randomize&&) = delete;
 
   static Randomize & instance() {
-    static Randomize instance;
+    // one per thread, so that independent partitioner runs can be concurrent
+    static thread_local Randomize instance;
     return instance;
   }
 
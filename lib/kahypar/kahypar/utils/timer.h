@@ -111,7 +111,8 @@ class Timer {
   }
 
   static Timer & instance() {
-    static Timer instance;
+    // one per thread, so that independent partitioner runs can be concurrent
+    static thread_local Timer instance;
     return instance;
   }
 
@@ -20,6 +20,8 @@
 
 #include "libkahypar.h"
 
+#include <sstream>
+
 #include "kahypar/application/command_line_options.h"
 #include "kahypar/io/hypergraph_io.h"
 #include "kahypar/macros.h"
@@ -66,6 +68,33 @@ void kahypar_configure_context_from_file(kahypar_context_t* kahypar_context,
                              ini_file_name);
 }
 
+void kahypar_configure_context_from_string(kahypar_context_t* kahypar_context,
+                                           const char* ini) {
+  std::istringstream ini_stream(ini);
+  kahypar::parseIniToContext(*reinterpret_cast<kahypar::Context*>(kahypar_context),
+                             ini_stream);
+}
+
+// Unlike the copy constructor, the copy does not report its statistics to
+// the original, so the two can be freed in any order.
+kahypar_context_t* kahypar_context_copy(const kahypar_context_t* kahypar_context) {
+  const kahypar::Context& context = *reinterpret_cast<const kahypar::Context*>(kahypar_context);
+  kahypar::Context* copy = new kahypar::Context();
+  copy->partition = context.partition;
+  copy->preprocessing = context.preprocessing;
+  copy->coarsening = context.coarsening;
+  copy->initial_partitioning = context.initial_partitioning;
+  copy->local_search = context.local_search;
+  copy->evolutionary = context.evolutionary;
+  copy->type = context.type;
+  copy->partition_evolutionary = context.partition_evolutionary;
+  return reinterpret_cast<kahypar_context_t*>(copy);
+}
+
+void kahypar_set_quiet_mode(kahypar_context_t* kahypar_context, int quiet) {
+  reinterpret_cast<kahypar::Context*>(kahypar_context)->partition.quiet_mode = quiet != 0;
+}
+
 void kahypar_set_fixed_vertices(kahypar_hypergraph_t* kahypar_hypergraph,
                                 const kahypar_partition_id_t* fixed_vertex_blocks) {
   kahypar::Hypergraph& hypergraph = *reinterpret_cast<kahypar::Hypergraph*>(kahypar_hypergraph);
@@ -0,0 +1,202 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <lorina/aiger.hpp>
+#include <mockturtle/io/aiger_reader.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/networks/strash_table.hpp>
+#include <mockturtle/utils/stopwatch.hpp>
+
+#include <experiments.hpp>
+
+using namespace mockturtle;
+
+/* Replays the structural hashing traffic of building and rewriting a network:
+   find-then-insert of every gate, lookups of present and absent keys, and
+   erase-and-reinsert of half of the gates. */
+template<class Table, class Node>
+double replay( std::vector<Node> const& gates, std::vector<Node> const& misses )
+{
+  stopwatch<>::duration time{0};
+  uint64_t found{0};
+  {
+    stopwatch t( time );
+
+    Table table;
+    table.reserve( 10000u );
+    table.set_resizing_parameters( .4f, .95f );
+    for ( auto i = 0u; i < gates.size(); ++i )
+    {
+      if ( table.find( gates[i] ) == table.end() )
+      {
+        table[gates[i]] = i + 1;
+      }
+    }
+    for ( auto round = 0u; round < 4u; ++round )
+    {
+      for ( auto const& n : gates )
+      {
+        found += table.find( n ) != table.end();
+      }
+      for ( auto const& n : misses )
+      {
+        found += table.find( n ) != table.end();
+      }
+    }
+    for ( auto i = 0u; i < gates.size(); i += 2u )
+    {
+      table.erase( gates[i] );
+    }
+    for ( auto i = 0u; i < gates.size(); i += 2u )
+    {
+      table[gates[i]] = i + 1;
+    }
+  }
+  if ( found != 4u * gates.size() )
+  {
+    fmt::print( "[e] lookups found {} of {} entries\n", found, 4u * gates.size() );
+  }
+  return 1000 * to_seconds( time );
+}
+
+template<class Node>
+double bulk_rebuild( std::vector<Node> const& gates )
+{
+  stopwatch<>::duration time{0};
+  strash_table<Node> table;
+  {
+    stopwatch t( time );
+    table.rebuild( gates, []( auto ) { return true; } );
+  }
+  return 1000 * to_seconds( time );
+}
+
+template<class Ntk>
+std::pair<std::vector<typename Ntk::storage::element_type::node_type>, std::vector<typename Ntk::storage::element_type::node_type>> hashed_nodes( Ntk const& ntk )
+{
+  std::vector<typename Ntk::storage::element_type::node_type> gates, misses;
+  ntk.foreach_gate( [&]( auto n ) {
+    gates.push_back( ntk._storage->nodes[n] );
+
+    /* a key that is never hashed: the first child is the complement of the
+       second one */
+    auto miss = ntk._storage->nodes[n];
+    miss.children[0].data = miss.children[1].data ^ 1;
+    misses.push_back( miss );
+  } );
+  return {gates, misses};
+}
+
+/* root of the LSOracle tree this copy of mockturtle lives in */
+#define LSORACLE_PATH EXPERIMENTS_PATH "../../../"
+
+std::vector<std::string> aiger_files( std::vector<std::string> const& roots )
+{
+  namespace fs = std::filesystem;
+
+  std::vector<std::string> files;
+  for ( auto const& root : roots )
+  {
+    std::error_code ec;
+    if ( fs::is_regular_file( root, ec ) )
+    {
+      files.push_back( root );
+      continue;
+    }
+    std::vector<std::string> found;
+    for ( fs::recursive_directory_iterator it( root, ec ), end; !ec && it != end; it.increment( ec ) )
+    {
+      if ( it->is_regular_file( ec ) && it->path().extension() == ".aig" )
+      {
+        found.push_back( it->path().string() );
+      }
+    }
+    std::sort( found.begin(), found.end() );
+    files.insert( files.end(), found.begin(), found.end() );
+  }
+  return files;
+}
+
+int main( int argc, char** argv )
+{
+  using namespace experiments;
+
+  experiment<std::string, std::string, uint32_t, double, double, double, double> exp( "strash_table", "benchmark", "network", "gates", "sparse_hash_map_ms", "strash_table_ms", "speedup", "bulk_rebuild_ms" );
+
+  /* AIGER files or directories given on the command line replace the AIGs of
+     the LSOracle tree (benchmarks/, generated by its Makefile, and
+     tests/end_to_end/); the EPFL benchmarks are the last resort */
+  std::vector<std::string> roots( argv + 1, argv + argc );
+  if ( roots.empty() )
+  {
+    roots = {LSORACLE_PATH "benchmarks", LSORACLE_PATH "tests/end_to_end"};
+  }
+  std::vector<std::string> benchmarks = aiger_files( roots );
+  const bool epfl = benchmarks.empty();
+  if ( epfl )
+  {
+    benchmarks = epfl_benchmarks();
+  }
+
+  for ( auto const& benchmark : benchmarks )
+  {
+    fmt::print( "[i] processing {}\n", benchmark );
+    const auto path = epfl ? benchmark_path( benchmark ) : benchmark;
+    const auto name = epfl ? benchmark : std::filesystem::path( benchmark ).lexically_normal().lexically_proximate( std::filesystem::path( LSORACLE_PATH ).lexically_normal() ).string();
+
+    aig_network aig;
+    lorina::read_aiger( path, aiger_reader( aig ) );
+    {
+      const auto [gates, misses] = hashed_nodes( aig );
+      using node_t = aig_storage::node_type;
+      const auto t_spp = replay<spp::sparse_hash_map<node_t, std::size_t, aig_hash<node_t>>>( gates, misses );
+      const auto t_flat = replay<strash_table<node_t>>( gates, misses );
+      exp( name, "aig", aig.num_gates(), t_spp, t_flat, t_spp / t_flat, bulk_rebuild( gates ) );
+    }
+
+    mig_network mig;
+    lorina::read_aiger( path, aiger_reader( mig ) );
+    {
+      const auto [gates, misses] = hashed_nodes( mig );
+      using node_t = mig_storage::node_type;
+      const auto t_spp = replay<spp::sparse_hash_map<node_t, std::size_t, node_hash<node_t>>>( gates, misses );
+      const auto t_flat = replay<strash_table<node_t>>( gates, misses );
+      exp( name, "mig", mig.num_gates(), t_spp, t_flat, t_spp / t_flat, bulk_rebuild( gates ) );
+    }
+  }
+
+  exp.save();
+  exp.table();
+
+  return 0;
+}
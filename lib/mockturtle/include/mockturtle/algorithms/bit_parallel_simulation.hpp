@@ -0,0 +1,611 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bit_parallel_simulation.hpp
+  \brief Bit-parallel pattern simulation of AIGs, MIGs and XAGs
+*/
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../traits.hpp"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <immintrin.h>
+#define MOCKTURTLE_SIMULATION_X86
+#endif
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for bit_parallel_simulator.
+ *
+ * The data structure `bit_parallel_simulation_params` holds configurable
+ * parameters with default arguments for `bit_parallel_simulator`.
+ */
+struct bit_parallel_simulation_params
+{
+  /*! \brief Patterns per block (rounded up to a power of two, at least 64). */
+  uint32_t block_size{256u};
+
+  /*! \brief Reuse the buffer of a node once all its fanouts are simulated. */
+  bool recycle_buffers{true};
+
+  /*! \brief Seed of the random pattern generator. */
+  uint64_t seed{1u};
+};
+
+namespace detail
+{
+
+struct sim_instruction
+{
+  enum op_t : uint8_t
+  {
+    and2,
+    xor2,
+    maj3,
+    xor3
+  };
+
+  op_t op;
+  std::array<uint32_t, 3> in; /* buffer slots of the fanins */
+  std::array<uint64_t, 3> neg; /* all-ones for complemented fanins */
+  uint32_t out;
+};
+
+/* evaluates one instruction on blocks of `words` words */
+inline void sim_scalar( sim_instruction const& ins, uint64_t* buf, uint32_t words )
+{
+  uint64_t* out = buf + ins.out * words;
+  uint64_t const* a = buf + ins.in[0] * words;
+  uint64_t const* b = buf + ins.in[1] * words;
+  uint64_t const* c = buf + ins.in[2] * words;
+  const auto na = ins.neg[0], nb = ins.neg[1], nc = ins.neg[2];
+
+  switch ( ins.op )
+  {
+  case sim_instruction::and2:
+    for ( auto w = 0u; w < words; ++w )
+      out[w] = ( a[w] ^ na ) & ( b[w] ^ nb );
+    break;
+  case sim_instruction::xor2:
+    for ( auto w = 0u; w < words; ++w )
+      out[w] = a[w] ^ b[w] ^ na ^ nb;
+    break;
+  case sim_instruction::maj3:
+    for ( auto w = 0u; w < words; ++w )
+    {
+      const auto x = a[w] ^ na, y = b[w] ^ nb, z = c[w] ^ nc;
+      out[w] = ( x & y ) | ( z & ( x | y ) );
+    }
+    break;
+  case sim_instruction::xor3:
+    for ( auto w = 0u; w < words; ++w )
+      out[w] = a[w] ^ b[w] ^ c[w] ^ na ^ nb ^ nc;
+    break;
+  }
+}
+
+inline void sim_run_scalar( std::vector<sim_instruction> const& program, uint64_t* buf, uint32_t words )
+{
+  if ( words == 1u )
+  {
+    for ( auto const& ins : program )
+    {
+      const auto x = buf[ins.in[0]] ^ ins.neg[0], y = buf[ins.in[1]] ^ ins.neg[1];
+      switch ( ins.op )
+      {
+      case sim_instruction::and2:
+        buf[ins.out] = x & y;
+        break;
+      case sim_instruction::xor2:
+        buf[ins.out] = x ^ y;
+        break;
+      case sim_instruction::maj3:
+      {
+        const auto z = buf[ins.in[2]] ^ ins.neg[2];
+        buf[ins.out] = ( x & y ) | ( z & ( x | y ) );
+        break;
+      }
+      case sim_instruction::xor3:
+        buf[ins.out] = x ^ y ^ buf[ins.in[2]] ^ ins.neg[2];
+        break;
+      }
+    }
+    return;
+  }
+
+  for ( auto const& ins : program )
+  {
+    sim_scalar( ins, buf, words );
+  }
+}
+
+#if defined( MOCKTURTLE_SIMULATION_X86 )
+/* `words` must be a multiple of 4 */
+__attribute__( ( target( "avx2" ) ) ) inline void sim_run_avx2( std::vector<sim_instruction> const& program, uint64_t* buf, uint32_t words )
+{
+  for ( auto const& ins : program )
+  {
+    auto* out = reinterpret_cast<__m256i*>( buf + ins.out * words );
+    auto const* a = reinterpret_cast<__m256i const*>( buf + ins.in[0] * words );
+    auto const* b = reinterpret_cast<__m256i const*>( buf + ins.in[1] * words );
+    auto const* c = reinterpret_cast<__m256i const*>( buf + ins.in[2] * words );
+    const auto na = _mm256_set1_epi64x( ins.neg[0] );
+    const auto nb = _mm256_set1_epi64x( ins.neg[1] );
+    const auto nc = _mm256_set1_epi64x( ins.neg[2] );
+
+    for ( auto v = 0u; v < words / 4u; ++v )
+    {
+      const auto x = _mm256_xor_si256( _mm256_loadu_si256( a + v ), na );
+      const auto y = _mm256_xor_si256( _mm256_loadu_si256( b + v ), nb );
+      __m256i r;
+      switch ( ins.op )
+      {
+      case sim_instruction::and2:
+        r = _mm256_and_si256( x, y );
+        break;
+      case sim_instruction::xor2:
+        r = _mm256_xor_si256( x, y );
+        break;
+      case sim_instruction::maj3:
+      {
+        const auto z = _mm256_xor_si256( _mm256_loadu_si256( c + v ), nc );
+        r = _mm256_or_si256( _mm256_and_si256( x, y ), _mm256_and_si256( z, _mm256_or_si256( x, y ) ) );
+        break;
+      }
+      default:
+        r = _mm256_xor_si256( _mm256_xor_si256( x, y ), _mm256_xor_si256( _mm256_loadu_si256( c + v ), nc ) );
+        break;
+      }
+      _mm256_storeu_si256( out + v, r );
+    }
+  }
+}
+
+/* `words` must be a multiple of 8 */
+__attribute__( ( target( "avx512f" ) ) ) inline void sim_run_avx512( std::vector<sim_instruction> const& program, uint64_t* buf, uint32_t words )
+{
+  for ( auto const& ins : program )
+  {
+    auto* out = buf + ins.out * words;
+    auto const* a = buf + ins.in[0] * words;
+    auto const* b = buf + ins.in[1] * words;
+    auto const* c = buf + ins.in[2] * words;
+    const auto na = _mm512_set1_epi64( ins.neg[0] );
+    const auto nb = _mm512_set1_epi64( ins.neg[1] );
+    const auto nc = _mm512_set1_epi64( ins.neg[2] );
+
+    for ( auto w = 0u; w < words; w += 8u )
+    {
+      const auto x = _mm512_xor_si512( _mm512_loadu_si512( a + w ), na );
+      const auto y = _mm512_xor_si512( _mm512_loadu_si512( b + w ), nb );
+      __m512i r;
+      switch ( ins.op )
+      {
+      case sim_instruction::and2:
+        r = _mm512_and_si512( x, y );
+        break;
+      case sim_instruction::xor2:
+        r = _mm512_xor_si512( x, y );
+        break;
+      case sim_instruction::maj3:
+        /* majority is truth table 0xe8 */
+        r = _mm512_ternarylogic_epi64( x, y, _mm512_xor_si512( _mm512_loadu_si512( c + w ), nc ), 0xe8 );
+        break;
+      default:
+        r = _mm512_ternarylogic_epi64( x, y, _mm512_xor_si512( _mm512_loadu_si512( c + w ), nc ), 0x96 );
+        break;
+      }
+      _mm512_storeu_si512( out + w, r );
+    }
+  }
+}
+#endif
+
+} // namespace detail
+
+/*! \brief Bit-parallel pattern simulator
+ *
+ * Compiles the transitive fanin of the outputs of an AIG, MIG or XAG (any
+ * network of 2-input AND/XOR and 3-input MAJ/XOR3 gates) into a flat program
+ * in topological order, and evaluates it on blocks of `block_size` patterns.
+ * Every node owns a buffer of `block_size` bits.  By default, buffers of nodes
+ * whose fanouts have all been evaluated are reused by later nodes, so the
+ * memory grows with the width of the network rather than its size.
+ *
+ * Gates are evaluated with AVX-512 or AVX2 kernels if the CPU supports them,
+ * and with scalar code otherwise.
+ *
+ * Patterns are streamed block by block: write the input buffers (or use
+ * `fill_random` / `fill_exhaustive`), call `simulate`, and read the results
+ * with `output` (or `value` for any node if `recycle_buffers` is false).
+ *
+ * **Required network functions:**
+ * - `foreach_pi`
+ * - `foreach_po`
+ * - `foreach_fanin`
+ * - `fanin_size`
+ * - `get_node`
+ * - `is_complemented`
+ * - `is_constant`
+ * - `is_pi`
+ * - `node_to_index`
+ * - `size`
+ *
+ \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      bit_parallel_simulator<aig_network> sim( aig );
+      sim.simulate_random( 64u, [&]( auto const& s ) {
+        const auto* f = s.output( 0 );
+        // f[0] ... f[s.words() - 1]
+      } );
+ \endverbatim
+ */
+template<class Ntk>
+class bit_parallel_simulator
+{
+public:
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+
+  explicit bit_parallel_simulator( Ntk const& ntk, bit_parallel_simulation_params const& ps = {} )
+      : _ntk( ntk ), _ps( ps ), _rng( ps.seed )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+    static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+    static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+    static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+    static_assert( has_is_complemented_v<Ntk>, "Ntk does not implement the is_complemented method" );
+    static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+
+    _words = 1u;
+    while ( 64u * _words < ps.block_size )
+    {
+      _words <<= 1u;
+    }
+
+    compile( ntk );
+    _buffers.assign( static_cast<std::size_t>( _num_slots ) * _words, 0u );
+    _outputs.assign( static_cast<std::size_t>( _po_slots.size() ) * _words, 0u );
+
+#if defined( MOCKTURTLE_SIMULATION_X86 )
+    if ( _words % 8u == 0u && __builtin_cpu_supports( "avx512f" ) )
+    {
+      _kernel = kernel::avx512;
+    }
+    else if ( _words % 4u == 0u && __builtin_cpu_supports( "avx2" ) )
+    {
+      _kernel = kernel::avx2;
+    }
+#endif
+  }
+
+  /*! \brief Number of 64-bit words per block. */
+  uint32_t words() const
+  {
+    return _words;
+  }
+
+  /*! \brief Number of patterns per block. */
+  uint32_t block_size() const
+  {
+    return 64u * _words;
+  }
+
+  /*! \brief Number of node buffers after recycling. */
+  uint32_t num_buffers() const
+  {
+    return _num_slots;
+  }
+
+  uint32_t num_pis() const
+  {
+    return _num_pis;
+  }
+
+  uint32_t num_pos() const
+  {
+    return static_cast<uint32_t>( _po_slots.size() );
+  }
+
+  /*! \brief Input buffer of the `index`-th primary input. */
+  uint64_t* input( uint32_t index )
+  {
+    assert( index < _num_pis );
+    return _buffers.data() + static_cast<std::size_t>( 1u + index ) * _words;
+  }
+
+  /*! \brief Output values of the `index`-th primary output after `simulate`. */
+  uint64_t const* output( uint32_t index ) const
+  {
+    return _outputs.data() + static_cast<std::size_t>( index ) * _words;
+  }
+
+  /*! \brief Values of node `n` after `simulate`
+   *
+   * Only valid for primary inputs and outputs, and for all simulated nodes
+   * if `recycle_buffers` is false.  Returns nullptr for nodes outside the
+   * transitive fanin of the outputs.
+   */
+  uint64_t const* value( node const& n ) const
+  {
+    const auto index = _node_slots[_ntk.node_to_index( n )];
+    return index == UINT32_MAX ? nullptr : _buffers.data() + static_cast<std::size_t>( index ) * _words;
+  }
+
+  /*! \brief Evaluates all gates on the current input block. */
+  void simulate()
+  {
+    switch ( _kernel )
+    {
+#if defined( MOCKTURTLE_SIMULATION_X86 )
+    case kernel::avx512:
+      detail::sim_run_avx512( _program, _buffers.data(), _words );
+      break;
+    case kernel::avx2:
+      detail::sim_run_avx2( _program, _buffers.data(), _words );
+      break;
+#endif
+    default:
+      detail::sim_run_scalar( _program, _buffers.data(), _words );
+      break;
+    }
+
+    for ( auto i = 0u; i < _po_slots.size(); ++i )
+    {
+      auto const* src = _buffers.data() + static_cast<std::size_t>( _po_slots[i] ) * _words;
+      auto* dst = _outputs.data() + static_cast<std::size_t>( i ) * _words;
+      for ( auto w = 0u; w < _words; ++w )
+      {
+        dst[w] = src[w] ^ _po_neg[i];
+      }
+    }
+  }
+
+  /*! \brief Fills all input buffers with random patterns. */
+  void fill_random()
+  {
+    for ( auto i = 0u; i < _num_pis; ++i )
+    {
+      auto* in = input( i );
+      for ( auto w = 0u; w < _words; ++w )
+      {
+        in[w] = _rng();
+      }
+    }
+  }
+
+  /*! \brief Number of blocks needed to enumerate all input assignments. */
+  uint64_t num_exhaustive_blocks() const
+  {
+    const auto block_vars = 6u + static_cast<uint32_t>( __builtin_ctz( _words ) );
+    return _num_pis <= block_vars ? 1u : ( UINT64_C( 1 ) << ( _num_pis - block_vars ) );
+  }
+
+  /*! \brief Fills the input buffers with the `block`-th block of all input assignments
+   *
+   * Pattern `p` of block `b` assigns input `i` to bit `i` of `b * block_size() + p`.
+   */
+  void fill_exhaustive( uint64_t block )
+  {
+    static constexpr uint64_t projections[] = {
+        UINT64_C( 0xaaaaaaaaaaaaaaaa ), UINT64_C( 0xcccccccccccccccc ), UINT64_C( 0xf0f0f0f0f0f0f0f0 ),
+        UINT64_C( 0xff00ff00ff00ff00 ), UINT64_C( 0xffff0000ffff0000 ), UINT64_C( 0xffffffff00000000 )};
+    const auto word_vars = static_cast<uint32_t>( __builtin_ctz( _words ) );
+
+    for ( auto i = 0u; i < _num_pis; ++i )
+    {
+      auto* in = input( i );
+      for ( auto w = 0u; w < _words; ++w )
+      {
+        if ( i < 6u )
+          in[w] = projections[i];
+        else if ( i < 6u + word_vars )
+          in[w] = ( ( w >> ( i - 6u ) ) & 1u ) ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+        else
+          in[w] = ( ( block >> ( i - 6u - word_vars ) ) & 1u ) ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+      }
+    }
+  }
+
+  /*! \brief Simulates `num_blocks` random blocks, calling `fn( *this )` after each. */
+  template<class Fn>
+  void simulate_random( uint64_t num_blocks, Fn&& fn )
+  {
+    for ( auto b = 0u; b < num_blocks; ++b )
+    {
+      fill_random();
+      simulate();
+      fn( *this );
+    }
+  }
+
+  /*! \brief Simulates all input assignments, calling `fn( *this, block )` after each block. */
+  template<class Fn>
+  void simulate_exhaustive( Fn&& fn )
+  {
+    const auto num_blocks = num_exhaustive_blocks();
+    for ( auto b = UINT64_C( 0 ); b < num_blocks; ++b )
+    {
+      fill_exhaustive( b );
+      simulate();
+      fn( *this, b );
+    }
+  }
+
+private:
+  enum class kernel
+  {
+    scalar,
+    avx2,
+    avx512
+  };
+
+  /* Orders the gates in the transitive fanin of the outputs topologically
+     and assigns buffer slots; slot 0 holds constant 0, slots 1 to num_pis
+     the inputs. */
+  void compile( Ntk const& ntk )
+  {
+    _node_slots.assign( ntk.size(), UINT32_MAX );
+    _node_slots[ntk.node_to_index( ntk.get_node( ntk.get_constant( false ) ) )] = 0u;
+
+    _num_pis = 0u;
+    ntk.foreach_pi( [&]( auto const& n ) {
+      _node_slots[ntk.node_to_index( n )] = 1u + _num_pis++;
+    } );
+    _num_slots = 1u + _num_pis;
+
+    /* topological order by iterative DFS from the outputs */
+    std::vector<node> order;
+    std::vector<uint8_t> state( ntk.size(), 0u );
+    std::vector<uint32_t> refs( ntk.size(), 0u );
+    std::vector<std::pair<node, bool>> stack;
+    ntk.foreach_po( [&]( auto const& f ) {
+      stack.emplace_back( ntk.get_node( f ), false );
+      while ( !stack.empty() )
+      {
+        const auto [n, expanded] = stack.back();
+        stack.pop_back();
+        const auto index = ntk.node_to_index( n );
+        if ( expanded )
+        {
+          state[index] = 2u;
+          order.push_back( n );
+          continue;
+        }
+        if ( state[index] != 0u || _node_slots[index] != UINT32_MAX )
+          continue;
+        state[index] = 1u;
+        stack.emplace_back( n, true );
+        ntk.foreach_fanin( n, [&]( auto const& g ) {
+          const auto child = ntk.get_node( g );
+          refs[ntk.node_to_index( child )]++;
+          if ( state[ntk.node_to_index( child )] == 0u )
+            stack.emplace_back( child, false );
+        } );
+      }
+    } );
+
+    /* outputs keep their buffers */
+    ntk.foreach_po( [&]( auto const& f ) {
+      refs[ntk.node_to_index( ntk.get_node( f ) )] = UINT32_MAX;
+    } );
+
+    std::vector<uint32_t> free_slots;
+    _program.reserve( order.size() );
+    for ( auto const& n : order )
+    {
+      detail::sim_instruction ins{};
+      uint32_t k{0};
+      ntk.foreach_fanin( n, [&]( auto const& g ) {
+        ins.in[k] = _node_slots[ntk.node_to_index( ntk.get_node( g ) )];
+        ins.neg[k] = ntk.is_complemented( g ) ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+        ++k;
+      } );
+      assert( k == 2u || k == 3u );
+
+      if ( k == 2u )
+      {
+        ins.op = detail::sim_instruction::and2;
+        if constexpr ( has_is_xor_v<Ntk> )
+        {
+          if ( ntk.is_xor( n ) )
+            ins.op = detail::sim_instruction::xor2;
+        }
+      }
+      else
+      {
+        ins.op = detail::sim_instruction::maj3;
+        if constexpr ( has_is_xor3_v<Ntk> )
+        {
+          if ( ntk.is_xor3( n ) )
+            ins.op = detail::sim_instruction::xor3;
+        }
+      }
+
+      if ( _ps.recycle_buffers && !free_slots.empty() )
+      {
+        ins.out = free_slots.back();
+        free_slots.pop_back();
+      }
+      else
+      {
+        ins.out = _num_slots++;
+      }
+      _node_slots[ntk.node_to_index( n )] = ins.out;
+      _program.push_back( ins );
+
+      /* release fanins whose last fanout this was */
+      if ( _ps.recycle_buffers )
+      {
+        ntk.foreach_fanin( n, [&]( auto const& g ) {
+          const auto child = ntk.node_to_index( ntk.get_node( g ) );
+          if ( refs[child] != UINT32_MAX && --refs[child] == 0u && _node_slots[child] > _num_pis )
+          {
+            free_slots.push_back( _node_slots[child] );
+          }
+        } );
+      }
+    }
+
+    ntk.foreach_po( [&]( auto const& f ) {
+      _po_slots.push_back( _node_slots[ntk.node_to_index( ntk.get_node( f ) )] );
+      _po_neg.push_back( ntk.is_complemented( f ) ? ~UINT64_C( 0 ) : UINT64_C( 0 ) );
+    } );
+  }
+
+private:
+  Ntk const& _ntk;
+  bit_parallel_simulation_params _ps;
+  std::mt19937_64 _rng;
+  kernel _kernel{kernel::scalar};
+
+  uint32_t _words{4u};
+  uint32_t _num_pis{0u};
+  uint32_t _num_slots{0u};
+
+  std::vector<uint32_t> _node_slots;
+  std::vector<detail::sim_instruction> _program;
+  std::vector<uint32_t> _po_slots;
+  std::vector<uint64_t> _po_neg;
+
+  std::vector<uint64_t> _buffers;
+  std::vector<uint64_t> _outputs;
+};
+
+} // namespace mockturtle
@@ -35,7 +35,9 @@
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <optional>
+#include <queue>
 #include <set>
 #include <type_traits>
 #include <vector>
@@ -591,26 +593,16 @@ public:
       net_queue.pop();
       auto node = ntk.index_to_node(curr_node);
 
-      
-      for(int i = 0; i < ntk._storage->nodes[node].children.size(); i++){
 
-        int childIdx = ntk._storage->nodes[node].children[i].index;
-        bool is_valid = true;
-        //Make sure a valid child index is found
-        if(childIdx < 0){
-          is_valid = false;
-        }
+      ntk.foreach_fanin(node, [&](auto const& conn){
+        int childIdx = ntk.node_to_index(ntk.get_node(conn));
 
         if(!visited[childIdx]){
-
-          if(is_valid){
-
-            net_queue.push(childIdx);
-            visited[childIdx] = true;
-            cone.insert(ntk.index_to_node(childIdx));
-          }
+          net_queue.push(childIdx);
+          visited[childIdx] = true;
+          cone.insert(ntk.index_to_node(childIdx));
         }
-      }
+      });
     }
     return cone;
   }//BFS_traversal()
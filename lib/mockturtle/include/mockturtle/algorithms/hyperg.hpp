@@ -67,7 +67,7 @@ std::cout << "HERE\n";
 
     else if (ntk.is_po(node)) {
       ntk.foreach_fanin(node, [&](auto const &conn, auto i) {
-        connections.push_back(ntk._storage->nodes[node].children[i].index);
+        connections.push_back(ntk.node_to_index(ntk.get_node(conn)));
       });
     }
 
@@ -0,0 +1,677 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file sweeping_equivalence_checking.hpp
+  \brief Combinational equivalence checking by simulation and SAT sweeping
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../networks/aig.hpp"
+#include "../traits.hpp"
+#include "../utils/node_map.hpp"
+#include "../utils/stopwatch.hpp"
+#include "../views/topo_view.hpp"
+#include "bit_parallel_simulation.hpp"
+#include "cnf.hpp"
+
+#include <fmt/format.h>
+#include <percy/solvers/bsat2.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for sweeping_equivalence_checking.
+ *
+ * The data structure `sweeping_equivalence_checking_params` holds
+ * configurable parameters with default arguments for
+ * `sweeping_equivalence_checking`.
+ */
+struct sweeping_equivalence_checking_params
+{
+  /*! \brief Number of random pattern blocks used to compute signatures. */
+  uint32_t num_sim_blocks{4u};
+
+  /*! \brief Patterns per simulation block. */
+  uint32_t sim_block_size{512u};
+
+  /*! \brief Conflict limit for proving an internal equivalence (0: none). */
+  uint32_t conflict_limit{100u};
+
+  /*! \brief Conflict limit for proving an output equivalence (0: none). */
+  uint32_t output_conflict_limit{0u};
+
+  /*! \brief Number of output groups swept in parallel. */
+  uint32_t num_threads{1u};
+
+  /*! \brief Seed for random simulation. */
+  uint64_t seed{1u};
+
+  /*! \brief Be verbose. */
+  bool verbose{false};
+};
+
+/*! \brief Statistics for sweeping_equivalence_checking.
+ *
+ * The data structure `sweeping_equivalence_checking_stats` provides data
+ * collected by running `sweeping_equivalence_checking`.
+ */
+struct sweeping_equivalence_checking_stats
+{
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{};
+
+  /*! \brief Runtime of random simulation. */
+  stopwatch<>::duration time_simulation{};
+
+  /*! \brief Runtime of SAT sweeping, summed over all threads. */
+  stopwatch<>::duration time_sweeping{};
+
+  /*! \brief Number of output pairs. */
+  uint32_t num_outputs{0u};
+
+  /*! \brief Output pairs that are structurally identical. */
+  uint32_t num_structural{0u};
+
+  /*! \brief Output pairs proved equivalent. */
+  uint32_t num_proved{0u};
+
+  /*! \brief Output pairs left undecided by the conflict limit. */
+  uint32_t num_undecided{0u};
+
+  /*! \brief Internal nodes merged into an equivalent node. */
+  uint32_t num_merged{0u};
+
+  /*! \brief Number of SAT calls. */
+  uint32_t num_sat_calls{0u};
+
+  /*! \brief SAT calls that returned a counter-example for an internal pair. */
+  uint32_t num_refinements{0u};
+
+  /*! \brief SAT calls that exceeded the conflict limit. */
+  uint32_t num_timeouts{0u};
+
+  /*! \brief Index of a non-equivalent output pair, if any. */
+  std::optional<uint32_t> failing_output;
+
+  /*! \brief Counter-example, in case the networks are not equivalent. */
+  std::vector<bool> counter_example;
+
+  void report() const
+  {
+    std::cout << fmt::format( "[i] outputs        = {} ({} structural, {} proved, {} undecided)\n",
+                              num_outputs, num_structural, num_proved, num_undecided );
+    std::cout << fmt::format( "[i] merged nodes   = {}\n", num_merged );
+    std::cout << fmt::format( "[i] SAT calls      = {} ({} refinements, {} timeouts)\n",
+                              num_sat_calls, num_refinements, num_timeouts );
+    std::cout << fmt::format( "[i] simulation     = {:>5.2f} secs\n", to_seconds( time_simulation ) );
+    std::cout << fmt::format( "[i] sweeping       = {:>5.2f} secs\n", to_seconds( time_sweeping ) );
+    std::cout << fmt::format( "[i] total time     = {:>5.2f} secs\n", to_seconds( time_total ) );
+  }
+};
+
+namespace detail
+{
+
+/* Sweeps the transitive fanin of a group of output pairs in topological
+   order.  Nodes are mapped to SAT literals; a node proved equivalent to an
+   earlier node with the same signature takes over that node's literal, so
+   the CNF only ever contains one variable per equivalence class. */
+class sweeping_worker
+{
+public:
+  using node = aig_network::node;
+  using signal = aig_network::signal;
+
+  enum class result
+  {
+    equal,
+    differ,
+    undecided
+  };
+
+  sweeping_worker( aig_network const& aig, std::vector<uint64_t> const& sigs, std::vector<uint8_t> const& phase,
+                   sweeping_equivalence_checking_params const& ps, std::atomic<bool>& stop )
+      : aig_( aig ), sigs_( sigs ), phase_( phase ), ps_( ps ), stop_( stop )
+  {
+  }
+
+  void run( std::vector<std::pair<signal, signal>> const& outputs, std::vector<uint32_t> const& output_ids )
+  {
+    stopwatch<> t( st.time_sweeping );
+
+    collect_cone( outputs );
+    lits_.assign( aig_.size(), 0u );
+    cex_values_.assign( aig_.size(), 0u );
+    local_sigs_ = sigs_;
+
+    solver_.set_nr_vars( aig_.num_pis() + 1 );
+    solver_.add_clause( std::vector<uint32_t>{make_lit( 0, true )} );
+    next_var_ = aig_.num_pis() + 1;
+
+    for ( auto n : cone_ )
+    {
+      if ( stop_ )
+        return;
+      sweep_node( n );
+    }
+
+    for ( auto i = 0u; i < outputs.size() && !stop_; ++i )
+    {
+      const auto a = literal( outputs[i].first );
+      const auto b = literal( outputs[i].second );
+      const auto res = a == b ? result::equal : prove( a, b, ps_.output_conflict_limit );
+      if ( res == result::equal )
+      {
+        ++st.num_proved;
+      }
+      else if ( res == result::undecided )
+      {
+        ++st.num_undecided;
+      }
+      else
+      {
+        st.failing_output = output_ids[i];
+        st.counter_example.clear();
+        for ( auto j = 1u; j <= aig_.num_pis(); ++j )
+        {
+          st.counter_example.push_back( solver_.var_value( j ) );
+        }
+        stop_ = true;
+      }
+    }
+  }
+
+  sweeping_equivalence_checking_stats st;
+
+private:
+  void collect_cone( std::vector<std::pair<signal, signal>> const& outputs )
+  {
+    std::vector<uint8_t> in_cone( aig_.size(), 0u );
+    std::vector<node> stack;
+    for ( auto const& [a, b] : outputs )
+    {
+      stack.push_back( aig_.get_node( a ) );
+      stack.push_back( aig_.get_node( b ) );
+    }
+    while ( !stack.empty() )
+    {
+      const auto n = stack.back();
+      stack.pop_back();
+      if ( in_cone[n] )
+        continue;
+      in_cone[n] = 1u;
+      aig_.foreach_fanin( n, [&]( auto const& f ) {
+        stack.push_back( aig_.get_node( f ) );
+      } );
+    }
+
+    /* node indexes of the combined AIG are in topological order */
+    in_cone[0] = 1u;
+    for ( auto n = 0u; n < aig_.size(); ++n )
+    {
+      if ( in_cone[n] )
+        cone_.push_back( n );
+    }
+  }
+
+  uint32_t literal( signal const& f ) const
+  {
+    return lit_not_cond( lits_[aig_.get_node( f )], aig_.is_complemented( f ) );
+  }
+
+  uint64_t key( node const& n ) const
+  {
+    const uint64_t mask = num_cex_ == 64u ? ~UINT64_C( 0 ) : ( ( UINT64_C( 1 ) << num_cex_ ) - 1u );
+    uint64_t seed = local_sigs_[n];
+    hash_combine( seed, ( cex_values_[n] ^ ( phase_[n] ? ~UINT64_C( 0 ) : 0u ) ) & mask );
+    return seed;
+  }
+
+  uint32_t create_and( uint32_t a, uint32_t b )
+  {
+    if ( a > b )
+      std::swap( a, b );
+    if ( a == b )
+      return a;
+    if ( a == lit_not( b ) || a == make_lit( 0 ) )
+      return make_lit( 0 );
+    if ( a == make_lit( 0, true ) )
+      return b;
+
+    const auto k = ( static_cast<uint64_t>( a ) << 32 ) | b;
+    if ( const auto it = strash_.find( k ); it != strash_.end() )
+      return it->second;
+
+    const auto v = make_lit( next_var_++ );
+    solver_.add_clause( std::vector<uint32_t>{lit_not( v ), a} );
+    solver_.add_clause( std::vector<uint32_t>{lit_not( v ), b} );
+    solver_.add_clause( std::vector<uint32_t>{v, lit_not( a ), lit_not( b )} );
+    strash_.emplace( k, v );
+    return v;
+  }
+
+  void sweep_node( node const& n )
+  {
+    if ( aig_.is_constant( n ) )
+    {
+      lits_[n] = make_lit( 0 );
+    }
+    else if ( aig_.is_pi( n ) )
+    {
+      lits_[n] = make_lit( aig_.node_to_index( n ) );
+    }
+    else
+    {
+      std::array<uint32_t, 2> fanin;
+      aig_.foreach_fanin( n, [&]( auto const& f, auto i ) {
+        fanin[i] = literal( f );
+      } );
+      lits_[n] = create_and( fanin[0], fanin[1] );
+    }
+
+    while ( true )
+    {
+      const auto it = reps_.find( key( n ) );
+      if ( it == reps_.end() )
+      {
+        reps_.emplace( key( n ), n );
+        rep_nodes_.push_back( n );
+        return;
+      }
+
+      const auto r = it->second;
+      const auto other = lit_not_cond( lits_[r], phase_[n] != phase_[r] );
+      const auto res = lits_[n] == other ? result::equal : prove( lits_[n], other, ps_.conflict_limit );
+      if ( res == result::equal )
+      {
+        lits_[n] = other;
+        ++st.num_merged;
+        return;
+      }
+      if ( res == result::undecided )
+      {
+        return;
+      }
+
+      ++st.num_refinements;
+      refine();
+    }
+  }
+
+  result prove( uint32_t a, uint32_t b, uint32_t conflict_limit )
+  {
+    for ( auto const& assumptions : {std::array<int, 2>{int( a ), int( lit_not( b ) )},
+                                     std::array<int, 2>{int( lit_not( a ) ), int( b )}} )
+    {
+      ++st.num_sat_calls;
+      auto lits = assumptions;
+      switch ( solver_.solve( lits.data(), lits.data() + 2, conflict_limit ) )
+      {
+      case percy::synth_result::success:
+        return result::differ;
+      case percy::synth_result::failure:
+        break;
+      default:
+        ++st.num_timeouts;
+        return result::undecided;
+      }
+    }
+    return result::equal;
+  }
+
+  /* adds the last satisfying assignment as a pattern and splits the classes */
+  void refine()
+  {
+    if ( num_cex_ == 64u )
+    {
+      for ( auto n : cone_ )
+      {
+        hash_combine( local_sigs_[n], cex_values_[n] ^ ( phase_[n] ? ~UINT64_C( 0 ) : 0u ) );
+        cex_values_[n] = 0u;
+      }
+      num_cex_ = 0u;
+    }
+
+    const auto bit = UINT64_C( 1 ) << num_cex_++;
+    for ( auto n : cone_ )
+    {
+      if ( aig_.is_constant( n ) )
+        continue;
+      bool value = true;
+      if ( aig_.is_pi( n ) )
+      {
+        value = solver_.var_value( aig_.node_to_index( n ) );
+      }
+      else
+      {
+        aig_.foreach_fanin( n, [&]( auto const& f ) {
+          value = value && ( ( ( cex_values_[aig_.get_node( f )] & bit ) != 0 ) != aig_.is_complemented( f ) );
+        } );
+      }
+      if ( value )
+        cex_values_[n] |= bit;
+    }
+
+    reps_.clear();
+    for ( auto r : rep_nodes_ )
+    {
+      reps_.emplace( key( r ), r );
+    }
+  }
+
+private:
+  aig_network const& aig_;
+  std::vector<uint64_t> const& sigs_;
+  std::vector<uint8_t> const& phase_;
+  sweeping_equivalence_checking_params const& ps_;
+  std::atomic<bool>& stop_;
+
+  std::vector<node> cone_;
+  std::vector<uint32_t> lits_;
+  std::vector<uint64_t> local_sigs_;
+  std::vector<uint64_t> cex_values_;
+  uint32_t num_cex_{0u};
+
+  std::unordered_map<uint64_t, node> reps_;
+  std::vector<node> rep_nodes_;
+  std::unordered_map<uint64_t, uint32_t> strash_;
+
+  percy::bsat_wrapper solver_;
+  uint32_t next_var_{0u};
+};
+
+template<class NtkSpec, class NtkImpl>
+class sweeping_equivalence_checking_impl
+{
+public:
+  using signal = aig_network::signal;
+
+  sweeping_equivalence_checking_impl( NtkSpec const& spec, NtkImpl const& impl, sweeping_equivalence_checking_params const& ps, sweeping_equivalence_checking_stats& st )
+      : spec_( spec ),
+        impl_( impl ),
+        ps_( ps ),
+        st_( st )
+  {
+  }
+
+  std::optional<bool> run()
+  {
+    stopwatch<> t( st_.time_total );
+
+    for ( auto i = 0u; i < spec_.num_pis(); ++i )
+    {
+      aig_.create_pi();
+    }
+    const auto spec_pos = copy( spec_ );
+    const auto impl_pos = copy( impl_ );
+
+    st_.num_outputs = spec_.num_pos();
+    std::vector<uint32_t> open;
+    for ( auto i = 0u; i < spec_pos.size(); ++i )
+    {
+      aig_.create_po( spec_pos[i] );
+      aig_.create_po( impl_pos[i] );
+      if ( spec_pos[i] == impl_pos[i] )
+        ++st_.num_structural;
+      else
+        open.push_back( i );
+    }
+    if ( open.empty() )
+      return true;
+
+    if ( !simulate( open ) )
+      return false;
+
+    /* contiguous output ranges tend to share logic */
+    const auto num_groups = std::max( 1u, std::min<uint32_t>( ps_.num_threads, open.size() ) );
+    std::vector<std::unique_ptr<sweeping_worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stop{false};
+    for ( auto g = 0u; g < num_groups; ++g )
+    {
+      std::vector<std::pair<signal, signal>> outputs;
+      std::vector<uint32_t> ids;
+      for ( auto k = open.size() * g / num_groups; k < open.size() * ( g + 1 ) / num_groups; ++k )
+      {
+        outputs.emplace_back( spec_pos[open[k]], impl_pos[open[k]] );
+        ids.push_back( open[k] );
+      }
+      workers.emplace_back( std::make_unique<sweeping_worker>( aig_, sigs_, phase_, ps_, stop ) );
+      threads.emplace_back( [w = workers.back().get(), outputs = std::move( outputs ), ids = std::move( ids )]() {
+        w->run( outputs, ids );
+      } );
+    }
+    for ( auto& th : threads )
+    {
+      th.join();
+    }
+
+    for ( auto const& w : workers )
+    {
+      st_.time_sweeping += w->st.time_sweeping;
+      st_.num_proved += w->st.num_proved;
+      st_.num_undecided += w->st.num_undecided;
+      st_.num_merged += w->st.num_merged;
+      st_.num_sat_calls += w->st.num_sat_calls;
+      st_.num_refinements += w->st.num_refinements;
+      st_.num_timeouts += w->st.num_timeouts;
+      if ( w->st.failing_output && !st_.failing_output )
+      {
+        st_.failing_output = w->st.failing_output;
+        st_.counter_example = w->st.counter_example;
+      }
+    }
+
+    if ( st_.failing_output )
+      return false;
+    if ( st_.num_undecided > 0u )
+      return std::nullopt;
+    return true;
+  }
+
+private:
+  template<class Ntk>
+  std::vector<signal> copy( Ntk const& ntk )
+  {
+    node_map<signal, Ntk> old_to_new( ntk );
+    old_to_new[ntk.get_constant( false )] = aig_.get_constant( false );
+    ntk.foreach_pi( [&]( auto const& n, auto i ) {
+      old_to_new[n] = aig_.make_signal( aig_.pi_at( i ) );
+    } );
+
+    topo_view topo{ntk};
+    topo.foreach_gate( [&]( auto const& n ) {
+      std::array<signal, 3> fs;
+      uint32_t k{0};
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        fs[k++] = old_to_new[f] ^ ntk.is_complemented( f );
+      } );
+
+      if ( k == 2u )
+      {
+        bool is_xor = false;
+        if constexpr ( has_is_xor_v<Ntk> )
+        {
+          is_xor = ntk.is_xor( n );
+        }
+        old_to_new[n] = is_xor ? aig_.create_xor( fs[0], fs[1] ) : aig_.create_and( fs[0], fs[1] );
+      }
+      else
+      {
+        assert( k == 3u );
+        bool is_xor3 = false;
+        if constexpr ( has_is_xor3_v<Ntk> )
+        {
+          is_xor3 = ntk.is_xor3( n );
+        }
+        old_to_new[n] = is_xor3 ? aig_.create_xor( aig_.create_xor( fs[0], fs[1] ), fs[2] ) : aig_.create_maj( fs[0], fs[1], fs[2] );
+      }
+    } );
+
+    std::vector<signal> pos;
+    ntk.foreach_po( [&]( auto const& f ) {
+      pos.push_back( old_to_new[f] ^ ntk.is_complemented( f ) );
+    } );
+    return pos;
+  }
+
+  /* computes phase-normalized signatures of all nodes; returns false if an
+     output pair is already distinguished by a random pattern */
+  bool simulate( std::vector<uint32_t> const& open )
+  {
+    stopwatch<> t( st_.time_simulation );
+
+    bit_parallel_simulation_params sps;
+    sps.block_size = ps_.sim_block_size;
+    sps.recycle_buffers = false;
+    sps.seed = ps_.seed;
+    bit_parallel_simulator<aig_network> sim( aig_, sps );
+
+    sigs_.assign( aig_.size(), 0u );
+    phase_.assign( aig_.size(), 0u );
+    for ( auto b = 0u; b < ps_.num_sim_blocks; ++b )
+    {
+      sim.fill_random();
+      sim.simulate();
+
+      for ( auto i : open )
+      {
+        const auto* a = sim.output( 2 * i );
+        const auto* c = sim.output( 2 * i + 1 );
+        for ( auto w = 0u; w < sim.words(); ++w )
+        {
+          if ( const auto diff = a[w] ^ c[w]; diff != 0u )
+          {
+            const auto bit = __builtin_ctzll( diff );
+            st_.failing_output = i;
+            st_.counter_example.clear();
+            for ( auto j = 0u; j < aig_.num_pis(); ++j )
+            {
+              st_.counter_example.push_back( ( sim.input( j )[w] >> bit ) & 1u );
+            }
+            return false;
+          }
+        }
+      }
+
+      aig_.foreach_node( [&]( auto const& n ) {
+        const auto* v = sim.value( n );
+        if ( !v )
+          return;
+        if ( b == 0u )
+          phase_[n] = v[0] & 1u;
+        const auto mask = phase_[n] ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+        for ( auto w = 0u; w < sim.words(); ++w )
+        {
+          hash_combine( sigs_[n], v[w] ^ mask );
+        }
+      } );
+    }
+    return true;
+  }
+
+private:
+  NtkSpec const& spec_;
+  NtkImpl const& impl_;
+  sweeping_equivalence_checking_params const& ps_;
+  sweeping_equivalence_checking_stats& st_;
+
+  aig_network aig_;
+  std::vector<uint64_t> sigs_;
+  std::vector<uint8_t> phase_;
+};
+
+} // namespace detail
+
+/*! \brief Combinational equivalence checking by simulation and SAT sweeping.
+ *
+ * Checks whether two networks with the same number of inputs and outputs
+ * compute the same functions.  Both networks are merged into one AIG that
+ * shares the inputs, so identical structure is merged by structural hashing.
+ * Random simulation then computes a signature for every node; outputs whose
+ * signatures differ are refuted immediately.  The remaining outputs are split
+ * into `num_threads` groups, and the fanin cone of each group is swept bottom
+ * up: each node is checked with an incremental SAT solver against an earlier
+ * node with the same signature, merged if equivalent, and every
+ * counter-example refines the signatures.
+ *
+ * Returns `true` if all outputs are equivalent, `false` if some output is not
+ * (the counter-example and output index are written to the statistics), and
+ * `nullopt` if an output check exceeded `output_conflict_limit`.
+ *
+ * The networks may be AIGs, MIGs, XAGs or XMGs.
+ *
+ * \param spec First network
+ * \param impl Second network
+ * \param ps Parameters
+ * \param pst Statistics
+ */
+template<class NtkSpec, class NtkImpl>
+std::optional<bool> sweeping_equivalence_checking( NtkSpec const& spec, NtkImpl const& impl, sweeping_equivalence_checking_params const& ps = {}, sweeping_equivalence_checking_stats* pst = nullptr )
+{
+  static_assert( is_network_type_v<NtkSpec>, "NtkSpec is not a network type" );
+  static_assert( is_network_type_v<NtkImpl>, "NtkImpl is not a network type" );
+  static_assert( has_num_pis_v<NtkSpec> && has_num_pis_v<NtkImpl>, "Ntk does not implement the num_pis method" );
+  static_assert( has_num_pos_v<NtkSpec> && has_num_pos_v<NtkImpl>, "Ntk does not implement the num_pos method" );
+  static_assert( has_foreach_fanin_v<NtkSpec> && has_foreach_fanin_v<NtkImpl>, "Ntk does not implement the foreach_fanin method" );
+
+  if ( spec.num_pis() != impl.num_pis() || spec.num_pos() != impl.num_pos() )
+  {
+    std::cout << "[e] networks must have the same number of inputs and outputs\n";
+    return std::nullopt;
+  }
+
+  sweeping_equivalence_checking_stats st;
+  detail::sweeping_equivalence_checking_impl<NtkSpec, NtkImpl> impl_( spec, impl, ps, st );
+  const auto result = impl_.run();
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+
+  if ( pst )
+  {
+    *pst = st;
+  }
+
+  return result;
+}
+
+} /* namespace mockturtle */
@@ -0,0 +1,443 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file aiger_mmap_reader.hpp
+  \brief Memory-mapped reader for binary AIGER files
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../traits.hpp"
+#include "aiger_reader.hpp"
+#include <lorina/aiger.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for read_aiger_mmap. */
+struct aiger_mmap_reader_params
+{
+  /*! \brief The file is known to be structurally hashed (e.g., written by
+      ABC).  AIGs then create gates without hash lookups and build the hash
+      table once at the end. */
+  bool strashed{false};
+};
+
+namespace detail
+{
+
+/* Read-only view of a whole file, mapped into memory when possible and
+   read into a buffer otherwise */
+class mapped_file
+{
+public:
+  explicit mapped_file( std::string const& filename )
+  {
+    const auto fd = ::open( filename.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+      return;
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+      _size = static_cast<std::size_t>( st.st_size );
+      auto const addr = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if ( addr != MAP_FAILED )
+      {
+        _mapped = addr;
+        _data = static_cast<uint8_t const*>( addr );
+        ::madvise( addr, _size, MADV_SEQUENTIAL );
+      }
+    }
+    ::close( fd );
+
+    /* pipes and other special files cannot be mapped */
+    if ( !_data )
+    {
+      std::ifstream in( filename, std::ifstream::binary );
+      _buffer.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+      _data = reinterpret_cast<uint8_t const*>( _buffer.data() );
+      _size = _buffer.size();
+    }
+    _good = true;
+  }
+
+  mapped_file( mapped_file const& ) = delete;
+  mapped_file& operator=( mapped_file const& ) = delete;
+
+  ~mapped_file()
+  {
+    if ( _mapped )
+    {
+      ::munmap( _mapped, _size );
+    }
+  }
+
+  bool good() const { return _good; }
+  uint8_t const* begin() const { return _data; }
+  uint8_t const* end() const { return _data + _size; }
+
+private:
+  bool _good{false};
+  void* _mapped{nullptr};
+  uint8_t const* _data{nullptr};
+  std::size_t _size{0};
+  std::vector<char> _buffer;
+};
+
+/* Reads an unsigned decimal number after optional blanks */
+inline bool aiger_parse_uint( uint8_t const*& p, uint8_t const* end, uint32_t& value )
+{
+  while ( p != end && *p == ' ' )
+  {
+    ++p;
+  }
+  if ( p == end || *p < '0' || *p > '9' )
+  {
+    return false;
+  }
+
+  uint64_t v{0};
+  while ( p != end && *p >= '0' && *p <= '9' )
+  {
+    v = v * 10u + ( *p++ - '0' );
+    if ( v > 0xffffffffu )
+    {
+      return false;
+    }
+  }
+  value = static_cast<uint32_t>( v );
+  return true;
+}
+
+inline bool aiger_parse_eol( uint8_t const*& p, uint8_t const* end )
+{
+  if ( p != end && *p == '\r' )
+  {
+    ++p;
+  }
+  if ( p == end || *p != '\n' )
+  {
+    return false;
+  }
+  ++p;
+  return true;
+}
+
+/* Decodes one delta of the binary AND section (7 bits per byte, the MSB
+   marks that more bytes follow) */
+inline bool aiger_decode( uint8_t const*& p, uint8_t const* end, uint32_t& value )
+{
+  uint32_t v{0};
+  for ( auto shift = 0u; p != end && shift < 35u; shift += 7u )
+  {
+    const auto ch = *p++;
+    v |= static_cast<uint32_t>( ch & 0x7f ) << shift;
+    if ( ( ch & 0x80 ) == 0 )
+    {
+      value = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace detail
+
+/*! \brief Reads a binary AIGER file through a memory mapping.
+
+  Fast path for `lorina::read_aiger` with `aiger_reader`, which creates the
+  same network including names: the header is used to pre-size the network
+  and the signal table, and the AND section is decoded directly from the
+  mapped file.  ASCII AIGER files and files with the AIGER 1.9 property
+  sections are handed to lorina.
+
+  **Required network functions:**
+  - `create_pi`
+  - `create_po`
+  - `get_constant`
+  - `create_not`
+  - `create_and`
+
+  \param filename Name of the file
+  \param ntk Network to add the inputs, gates and outputs to
+  \param ps Parameters
+  \param diag An optional diagnostic engine for parse errors
+*/
+template<class Ntk>
+lorina::return_code read_aiger_mmap( std::string const& filename, Ntk& ntk, aiger_mmap_reader_params const& ps = {}, lorina::diagnostic_engine* diag = nullptr )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_create_pi_v<Ntk>, "Ntk does not implement the create_pi function" );
+  static_assert( has_create_po_v<Ntk>, "Ntk does not implement the create_po function" );
+  static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant function" );
+  static_assert( has_create_not_v<Ntk>, "Ntk does not implement the create_not function" );
+  static_assert( has_create_and_v<Ntk>, "Ntk does not implement the create_and function" );
+
+  const auto error = [&]( std::string const& message ) {
+    if ( diag )
+    {
+      diag->report( lorina::diagnostic_level::fatal, message );
+    }
+    return lorina::return_code::parse_error;
+  };
+
+  const auto file_name = lorina::detail::word_exp_filename( filename );
+  detail::mapped_file file( file_name );
+  if ( !file.good() )
+  {
+    return error( "could not open file `" + filename + "`" );
+  }
+
+  auto p = file.begin();
+  const auto end = file.end();
+
+  /* header */
+  const auto starts_with = [&]( char const* magic ) {
+    return end - p >= 4 && std::equal( magic, magic + 4, p );
+  };
+  if ( starts_with( "aag " ) )
+  {
+    return lorina::read_ascii_aiger( filename, aiger_reader( ntk ), diag );
+  }
+  if ( !starts_with( "aig " ) )
+  {
+    return error( "could not parse AIGER header" );
+  }
+  p += 4;
+
+  uint32_t num_vars, num_inputs, num_latches, num_outputs, num_ands;
+  if ( !detail::aiger_parse_uint( p, end, num_vars ) || !detail::aiger_parse_uint( p, end, num_inputs ) ||
+       !detail::aiger_parse_uint( p, end, num_latches ) || !detail::aiger_parse_uint( p, end, num_outputs ) ||
+       !detail::aiger_parse_uint( p, end, num_ands ) )
+  {
+    return error( "could not parse AIGER header" );
+  }
+  if ( !detail::aiger_parse_eol( p, end ) )
+  {
+    return lorina::read_aiger( filename, aiger_reader( ntk ), diag );
+  }
+  if ( uint64_t{num_inputs} + num_latches + num_ands != num_vars )
+  {
+    return error( "AIGER header: M is not the sum of I, L and A" );
+  }
+
+  if constexpr ( has_reserve_nodes_v<Ntk> )
+  {
+    /* M variables plus the constant */
+    ntk.reserve_nodes( uint64_t{num_vars} + 1u );
+  }
+
+  using signal = typename Ntk::signal;
+  std::vector<signal> signals;
+  signals.reserve( uint64_t{num_vars} + 1u );
+
+  signals.push_back( ntk.get_constant( false ) );
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    signals.push_back( ntk.create_pi() );
+  }
+  for ( auto i = 0u; i < num_latches; ++i )
+  {
+    signals.push_back( ntk.create_ro() );
+  }
+
+  std::vector<std::pair<uint32_t, int8_t>> latches( num_latches );
+  for ( auto& [next, reset] : latches )
+  {
+    /* like lorina, only explicit 0 and 1 initialize the latch */
+    uint32_t init;
+    reset = -1;
+    if ( !detail::aiger_parse_uint( p, end, next ) )
+    {
+      return error( "could not parse latch" );
+    }
+    if ( detail::aiger_parse_uint( p, end, init ) && init <= 1u )
+    {
+      reset = static_cast<int8_t>( init );
+    }
+    if ( !detail::aiger_parse_eol( p, end ) )
+    {
+      return error( "could not parse latch" );
+    }
+  }
+
+  std::vector<uint32_t> outputs( num_outputs );
+  for ( auto& lit : outputs )
+  {
+    if ( !detail::aiger_parse_uint( p, end, lit ) || !detail::aiger_parse_eol( p, end ) )
+    {
+      return error( "could not parse output" );
+    }
+  }
+
+  const auto max_lit = 2u * uint64_t{num_vars} + 1u;
+  for ( auto lit : outputs )
+  {
+    if ( lit > max_lit )
+      return error( "output literal out of range" );
+  }
+  for ( auto const& latch : latches )
+  {
+    if ( latch.first > max_lit )
+      return error( "latch literal out of range" );
+  }
+
+  const auto literal = [&]( uint32_t lit ) {
+    auto const& s = signals[lit >> 1];
+    return ( lit & 1 ) ? ntk.create_not( s ) : s;
+  };
+
+  /* and gates, the right-hand sides are given as differences to the
+     left-hand side: lhs > rhs0 >= rhs1 */
+  const auto read_ands = [&]( auto&& create_and ) {
+    for ( uint64_t lhs = 2u * ( uint64_t{num_inputs} + num_latches + 1u ); signals.size() <= num_vars; lhs += 2u )
+    {
+      uint32_t d0, d1;
+      if ( !detail::aiger_decode( p, end, d0 ) || !detail::aiger_decode( p, end, d1 ) || d0 == 0u || d0 > lhs || d1 > lhs - d0 )
+      {
+        return false;
+      }
+      const auto rhs0 = static_cast<uint32_t>( lhs - d0 );
+      signals.push_back( create_and( literal( rhs0 ), literal( rhs0 - d1 ) ) );
+    }
+    return true;
+  };
+
+  const auto create_hashed = [&]( signal const& a, signal const& b ) { return ntk.create_and( a, b ); };
+  bool ands_ok;
+  if constexpr ( has_create_and_unhashed_v<Ntk> )
+  {
+    if ( ps.strashed )
+    {
+      ands_ok = read_ands( [&]( signal const& a, signal const& b ) { return ntk.create_and_unhashed( a, b ); } );
+      ntk.rehash_gates();
+    }
+    else
+    {
+      ands_ok = read_ands( create_hashed );
+    }
+  }
+  else
+  {
+    (void)ps;
+    ands_ok = read_ands( create_hashed );
+  }
+  if ( !ands_ok )
+  {
+    return error( "could not parse AND gate " + std::to_string( signals.size() ) );
+  }
+
+  for ( auto lit : outputs )
+  {
+    ntk.create_po( literal( lit ) );
+  }
+  for ( auto const& [next, reset] : latches )
+  {
+    ntk.create_ri( literal( next ), reset );
+  }
+
+  /* symbol table, up to the comment section */
+  std::vector<std::string> input_names( num_inputs ), latch_names( num_latches ), output_names( num_outputs );
+  while ( p != end && *p != 'c' )
+  {
+    const auto type = *p++;
+    uint32_t index;
+    const auto has_index = detail::aiger_parse_uint( p, end, index );
+    if ( p != end && *p == ' ' )
+    {
+      ++p;
+    }
+    const auto name_begin = p;
+    while ( p != end && *p != '\n' )
+    {
+      ++p;
+    }
+    auto name_end = p;
+    if ( name_end != name_begin && *( name_end - 1 ) == '\r' )
+    {
+      --name_end;
+    }
+    if ( p != end )
+    {
+      ++p;
+    }
+    if ( !has_index )
+    {
+      continue;
+    }
+
+    std::string name( name_begin, name_end );
+    if ( type == 'i' && index < num_inputs )
+      input_names[index] = std::move( name );
+    else if ( type == 'l' && index < num_latches )
+      latch_names[index] = std::move( name );
+    else if ( type == 'o' && index < num_outputs )
+      output_names[index] = std::move( name );
+  }
+
+  if constexpr ( has_set_name_v<Ntk> )
+  {
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      ntk.set_name( signals[1u + i], input_names[i].empty() ? "pi" + std::to_string( i ) : input_names[i] );
+    }
+    for ( auto i = 0u; i < num_latches; ++i )
+    {
+      if ( !latch_names[i].empty() )
+        ntk.set_name( signals[1u + num_inputs + i], latch_names[i] );
+    }
+  }
+  if constexpr ( has_set_output_name_v<Ntk> )
+  {
+    for ( auto i = 0u; i < num_outputs; ++i )
+    {
+      ntk.set_output_name( i, output_names[i].empty() ? "po" + std::to_string( i ) : output_names[i] );
+    }
+    for ( auto i = 0u; i < num_latches; ++i )
+    {
+      ntk.set_output_name( num_outputs + i, "li" + std::to_string( i + 1u ) );
+    }
+  }
+
+  return lorina::return_code::success;
+}
+
+} /* namespace mockturtle */
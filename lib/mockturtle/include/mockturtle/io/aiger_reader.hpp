@@ -193,10 +193,16 @@ namespace mockturtle
       }
     }
 
-    void on_header( uint64_t, uint64_t num_inputs, uint64_t num_latches, uint64_t, uint64_t ) const override
+    void on_header( uint64_t num_vars, uint64_t num_inputs, uint64_t num_latches, uint64_t, uint64_t ) const override
     {
       _num_inputs = num_inputs;
 
+      /* M variables plus the constant */
+      if constexpr ( has_reserve_nodes_v<Ntk> )
+      {
+        _ntk.reserve_nodes( num_vars + 1u );
+      }
+
       /* constant */
       signals.push_back( _ntk.get_constant( false ) );
 
@@ -0,0 +1,445 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file snapshot.hpp
+  \brief Binary snapshots of AIGs, XAGs, and MIGs
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../networks/storage.hpp"
+#include "../traits.hpp"
+
+namespace mockturtle
+{
+
+namespace detail
+{
+
+/* "LSONTK" followed by the format version */
+static constexpr std::array<char, 8> snapshot_magic = {'L', 'S', 'O', 'N', 'T', 'K', 0, 1};
+
+enum class snapshot_gate : uint8_t
+{
+  and2 = 0,
+  xor2 = 1,
+  maj3 = 2,
+  xor3 = 3
+};
+
+inline void snapshot_put( std::ostream& os, uint32_t value )
+{
+  os.write( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+}
+
+inline void snapshot_put( std::ostream& os, uint64_t value )
+{
+  os.write( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+}
+
+inline void snapshot_put( std::ostream& os, std::string const& value )
+{
+  snapshot_put( os, static_cast<uint32_t>( value.size() ) );
+  os.write( value.data(), value.size() );
+}
+
+template<typename T>
+inline T snapshot_get( std::istream& is )
+{
+  T value{};
+  is.read( reinterpret_cast<char*>( &value ), sizeof( value ) );
+  return value;
+}
+
+template<>
+inline std::string snapshot_get<std::string>( std::istream& is )
+{
+  const auto size = snapshot_get<uint32_t>( is );
+  std::string value( is ? size : 0u, '\0' );
+  is.read( &value[0], value.size() );
+  return value;
+}
+
+} /* namespace detail */
+
+/*! \brief Writes a binary snapshot of a network into an output stream
+ *
+ * The snapshot keeps everything needed to rebuild the network as it is in
+ * memory: primary inputs and outputs, latches with their reset values, all
+ * live gates (including dangling ones), signal and output names, the network
+ * name, and latch information.  Gates are written in topological order, so
+ * indexes in the rebuilt network may differ.  Literals in the snapshot are
+ * `2 * index + complement`, where index 0 is the constant, indexes 1 to
+ * `num_pis` are the combinational inputs, and gates follow.
+ *
+ * An overloaded variant exists that writes the snapshot into a file.
+ *
+ * **Required network functions:**
+ * - `foreach_pi`
+ * - `foreach_po`
+ * - `foreach_gate`
+ * - `foreach_fanin`
+ * - `is_xor`
+ * - `is_xor3`
+ * - `num_latches`
+ * - `latch_reset`
+ *
+ * \param ntk Network
+ * \param os Output stream
+ */
+template<class Ntk>
+void write_snapshot( Ntk const& ntk, std::ostream& os )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_foreach_gate_v<Ntk>, "Ntk does not implement the foreach_gate method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_is_xor_v<Ntk>, "Ntk does not implement the is_xor method" );
+
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+
+  constexpr uint32_t unmapped = UINT32_MAX;
+  std::vector<uint32_t> index( ntk.size(), unmapped );
+  index[ntk.node_to_index( ntk.get_node( ntk.get_constant( false ) ) )] = 0u;
+
+  uint32_t next = 1u;
+  ntk.foreach_pi( [&]( auto const& n ) {
+    index[ntk.node_to_index( n )] = next++;
+  } );
+
+  /* all live gates in topological order, fanins may have larger indexes
+     than their fanouts after substitutions */
+  std::vector<node> order;
+  std::vector<std::pair<node, bool>> stack;
+  ntk.foreach_gate( [&]( auto const& root ) {
+    if ( index[ntk.node_to_index( root )] != unmapped )
+      return;
+    stack.emplace_back( root, false );
+    while ( !stack.empty() )
+    {
+      const auto [n, expanded] = stack.back();
+      stack.pop_back();
+      if ( index[ntk.node_to_index( n )] != unmapped )
+        continue;
+      if ( expanded )
+      {
+        index[ntk.node_to_index( n )] = next++;
+        order.push_back( n );
+        continue;
+      }
+      stack.emplace_back( n, true );
+      ntk.foreach_fanin( n, [&]( auto const& f ) {
+        if ( index[ntk.node_to_index( ntk.get_node( f ) )] == unmapped )
+        {
+          stack.emplace_back( ntk.get_node( f ), false );
+        }
+      } );
+    }
+  } );
+
+  const auto literal = [&]( signal const& f ) {
+    return 2u * index[ntk.node_to_index( ntk.get_node( f ) )] + ( ntk.is_complemented( f ) ? 1u : 0u );
+  };
+
+  os.write( detail::snapshot_magic.data(), detail::snapshot_magic.size() );
+  detail::snapshot_put( os, ntk._storage->net_name );
+  detail::snapshot_put( os, static_cast<uint32_t>( ntk.num_pis() ) );
+  detail::snapshot_put( os, static_cast<uint32_t>( ntk.num_latches() ) );
+  detail::snapshot_put( os, static_cast<uint32_t>( order.size() ) );
+  detail::snapshot_put( os, static_cast<uint32_t>( ntk.num_pos() ) );
+
+  for ( auto i = 0u; i < ntk.num_latches(); ++i )
+  {
+    os.put( static_cast<char>( ntk.latch_reset( i ) ) );
+  }
+
+  for ( auto const& n : order )
+  {
+    uint32_t fanin_size = 0u;
+    std::array<uint32_t, 3> fanins{};
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      fanins[fanin_size++] = literal( f );
+    } );
+
+    detail::snapshot_gate kind = detail::snapshot_gate::and2;
+    if ( ntk.is_xor3( n ) )
+      kind = detail::snapshot_gate::xor3;
+    else if ( fanin_size == 3u )
+      kind = detail::snapshot_gate::maj3;
+    else if ( ntk.is_xor( n ) )
+      kind = detail::snapshot_gate::xor2;
+
+    os.put( static_cast<char>( kind ) );
+    for ( auto i = 0u; i < ( fanin_size == 3u ? 3u : 2u ); ++i )
+    {
+      detail::snapshot_put( os, fanins[i] );
+    }
+  }
+
+  ntk.foreach_po( [&]( auto const& f ) {
+    detail::snapshot_put( os, literal( f ) );
+  } );
+
+  /* names of both polarities of every mapped node */
+  std::vector<std::pair<uint32_t, std::string>> names;
+  if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
+  {
+    ntk.foreach_node( [&]( auto const& n ) {
+      if ( index[ntk.node_to_index( n )] == unmapped )
+        return;
+      for ( auto const& s : {ntk.make_signal( n ), !ntk.make_signal( n )} )
+      {
+        if ( ntk.has_name( s ) )
+        {
+          names.emplace_back( literal( s ), ntk.get_name( s ) );
+        }
+      }
+    } );
+  }
+  detail::snapshot_put( os, static_cast<uint32_t>( names.size() ) );
+  for ( auto const& [lit, name] : names )
+  {
+    detail::snapshot_put( os, lit );
+    detail::snapshot_put( os, name );
+  }
+
+  names.clear();
+  if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
+  {
+    for ( auto i = 0u; i < ntk.num_pos(); ++i )
+    {
+      if ( ntk.has_output_name( i ) )
+      {
+        names.emplace_back( i, ntk.get_output_name( i ) );
+      }
+    }
+  }
+  detail::snapshot_put( os, static_cast<uint32_t>( names.size() ) );
+  for ( auto const& [i, name] : names )
+  {
+    detail::snapshot_put( os, i );
+    detail::snapshot_put( os, name );
+  }
+
+  /* latch information is keyed by node */
+  std::vector<std::pair<uint32_t, latch_info const*>> latches;
+  for ( auto const& [n, info] : ntk._storage->latch_information )
+  {
+    if ( n < index.size() && index[n] != unmapped )
+    {
+      latches.emplace_back( index[n], &info );
+    }
+  }
+  detail::snapshot_put( os, static_cast<uint32_t>( latches.size() ) );
+  for ( auto const& [i, info] : latches )
+  {
+    detail::snapshot_put( os, i );
+    detail::snapshot_put( os, info->control );
+    detail::snapshot_put( os, info->init );
+    detail::snapshot_put( os, info->type );
+  }
+}
+
+/*! \brief Writes a binary snapshot of a network into a file
+ *
+ * \param ntk Network
+ * \param filename Filename
+ */
+template<class Ntk>
+void write_snapshot( Ntk const& ntk, std::string const& filename )
+{
+  std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+  write_snapshot( ntk, os );
+  os.close();
+}
+
+/*! \brief Reads a binary snapshot from an input stream
+ *
+ * Rebuilds the network written by `write_snapshot` into the empty network
+ * `ntk`.  Names are only restored if the network supports them.
+ *
+ * An overloaded variant exists that reads the snapshot from a file.
+ *
+ * **Required network functions:**
+ * - `create_pi`
+ * - `create_ro`
+ * - `create_po`
+ * - `create_ri`
+ * - `create_and`
+ * - `create_xor`
+ * - `create_maj`
+ * - `create_xor3`
+ *
+ * \param is Input stream
+ * \param ntk Empty network
+ * \return Whether a well-formed snapshot was read
+ */
+template<class Ntk>
+bool read_snapshot( std::istream& is, Ntk& ntk )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_create_pi_v<Ntk>, "Ntk does not implement the create_pi method" );
+  static_assert( has_create_po_v<Ntk>, "Ntk does not implement the create_po method" );
+  static_assert( has_create_and_v<Ntk>, "Ntk does not implement the create_and method" );
+  static_assert( has_create_xor_v<Ntk>, "Ntk does not implement the create_xor method" );
+  static_assert( has_create_maj_v<Ntk>, "Ntk does not implement the create_maj method" );
+  static_assert( has_create_xor3_v<Ntk>, "Ntk does not implement the create_xor3 method" );
+
+  using signal = typename Ntk::signal;
+
+  std::array<char, 8> magic;
+  is.read( magic.data(), magic.size() );
+  if ( !is || magic != detail::snapshot_magic )
+    return false;
+
+  ntk._storage->net_name = detail::snapshot_get<std::string>( is );
+  const auto num_pis = detail::snapshot_get<uint32_t>( is );
+  const auto num_latches = detail::snapshot_get<uint32_t>( is );
+  const auto num_gates = detail::snapshot_get<uint32_t>( is );
+  const auto num_pos = detail::snapshot_get<uint32_t>( is );
+  if ( !is || num_latches > num_pis || num_latches > num_pos )
+    return false;
+
+  std::vector<int8_t> resets( num_latches );
+  for ( auto& reset : resets )
+  {
+    reset = static_cast<int8_t>( is.get() );
+  }
+
+  std::vector<signal> signals;
+  signals.reserve( 1u + num_pis + num_gates );
+  signals.push_back( ntk.get_constant( false ) );
+  for ( auto i = 0u; i < num_pis; ++i )
+  {
+    signals.push_back( i < num_pis - num_latches ? ntk.create_pi() : ntk.create_ro() );
+  }
+
+  bool valid = true;
+  const auto get = [&]() {
+    const auto lit = detail::snapshot_get<uint32_t>( is );
+    if ( ( lit >> 1u ) >= signals.size() )
+    {
+      valid = false;
+      return signals[0];
+    }
+    return ( lit & 1u ) ? ntk.create_not( signals[lit >> 1u] ) : signals[lit >> 1u];
+  };
+
+  for ( auto i = 0u; i < num_gates && valid && is; ++i )
+  {
+    const auto kind = static_cast<detail::snapshot_gate>( is.get() );
+    const auto a = get();
+    const auto b = get();
+    switch ( kind )
+    {
+    case detail::snapshot_gate::and2:
+      signals.push_back( ntk.create_and( a, b ) );
+      break;
+    case detail::snapshot_gate::xor2:
+      signals.push_back( ntk.create_xor( a, b ) );
+      break;
+    case detail::snapshot_gate::maj3:
+      signals.push_back( ntk.create_maj( a, b, get() ) );
+      break;
+    case detail::snapshot_gate::xor3:
+      signals.push_back( ntk.create_xor3( a, b, get() ) );
+      break;
+    default:
+      valid = false;
+    }
+  }
+
+  for ( auto i = 0u; i < num_pos && valid && is; ++i )
+  {
+    const auto f = get();
+    if ( i < num_pos - num_latches )
+      ntk.create_po( f );
+    else
+      ntk.create_ri( f, resets[i - ( num_pos - num_latches )] );
+  }
+
+  const auto num_names = detail::snapshot_get<uint32_t>( is );
+  for ( auto i = 0u; i < num_names && valid && is; ++i )
+  {
+    const auto f = get();
+    const auto name = detail::snapshot_get<std::string>( is );
+    if constexpr ( has_set_name_v<Ntk> )
+    {
+      ntk.set_name( f, name );
+    }
+  }
+
+  const auto num_output_names = detail::snapshot_get<uint32_t>( is );
+  for ( auto i = 0u; i < num_output_names && valid && is; ++i )
+  {
+    const auto index = detail::snapshot_get<uint32_t>( is );
+    const auto name = detail::snapshot_get<std::string>( is );
+    if constexpr ( has_set_output_name_v<Ntk> )
+    {
+      ntk.set_output_name( index, name );
+    }
+  }
+
+  const auto num_latch_infos = detail::snapshot_get<uint32_t>( is );
+  for ( auto i = 0u; i < num_latch_infos && valid && is; ++i )
+  {
+    const auto index = detail::snapshot_get<uint32_t>( is );
+    latch_info info;
+    info.control = detail::snapshot_get<std::string>( is );
+    info.init = detail::snapshot_get<uint64_t>( is );
+    info.type = detail::snapshot_get<std::string>( is );
+    if ( index >= signals.size() )
+    {
+      valid = false;
+      break;
+    }
+    ntk._storage->latch_information[ntk.get_node( signals[index] )] = info;
+  }
+
+  return valid && static_cast<bool>( is );
+}
+
+/*! \brief Reads a binary snapshot from a file
+ *
+ * \param filename Filename
+ * \param ntk Empty network
+ * \return Whether a well-formed snapshot was read
+ */
+template<class Ntk>
+bool read_snapshot( std::string const& filename, Ntk& ntk )
+{
+  std::ifstream is( filename.c_str(), std::ifstream::in | std::ifstream::binary );
+  return is && read_snapshot( is, ntk );
+}
+
+} /* namespace mockturtle */
@@ -35,162 +35,193 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
-#include <fmt/format.h>
 #include <kitty/operations.hpp>
 #include <kitty/print.hpp>
 
 #include "../traits.hpp"
+#include "../utils/output_buffer.hpp"
 
 namespace mockturtle
 {
 
-/*! \brief Writes network in BENCH format into output stream
- *
- * An overloaded variant exists that writes the network into a file.
- *
- * **Required network functions:**
- * - `is_constant`
- * - `is_pi`
- * - `is_complemented`
- * - `get_node`
- * - `num_pos`
- * - `node_to_index`
- * - `node_function`
- *
- * \param ntk Network
- * \param os Output stream
- */
+struct write_bench_params
+{
+  /*! \brief Number of threads formatting the nodes; the output is the same for any number. */
+  uint32_t num_threads = 1u;
+};
+
+namespace detail
+{
+
 template<class Ntk>
-void write_bench( Ntk const& ntk, std::ostream& os )
+void write_bench( Ntk const& ntk, output_buffer& out, write_bench_params const& ps )
 {
-  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
-  static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
-  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
-  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
-  static_assert( has_is_complemented_v<Ntk>, "Ntk does not implement the is_complemented method" );
-  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
-  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
-  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
-  static_assert( has_node_function_v<Ntk>, "Ntk does not implement the node_function method" );
+  using node = typename Ntk::node;
 
-  node_map<std::string, Ntk> node_names( ntk );
-  std::map<uint32_t, std::string> output_names;
+  std::vector<std::string> input_names, output_names;
 
   ntk.foreach_pi( [&]( auto const& pi, auto index ) {
     auto signal = ntk.make_signal( pi );
-    if(index < ntk.num_pis() - ntk.num_latches()){
+    if ( index < ntk.num_pis() - ntk.num_latches() )
+    {
       if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-      {  
-        node_names[signal] = ntk.has_name( signal ) ? ntk.get_name( signal ) : fmt::format( "pi{}", index );
-        // if(node_names[signal].find('[') != std::string::npos || node_names[signal].find('[') != std::string::npos)
-        //   node_names[signal].insert(node_names[signal].begin(),'\\');
+      {
+        input_names.push_back( ntk.has_name( signal ) ? ntk.get_name( signal ) : "pi" + std::to_string( index ) );
       }
       else
       {
-        node_names[signal] = fmt::format( "pi{}", index);
+        input_names.push_back( "pi" + std::to_string( index ) );
       }
     }
     else
     {
+      input_names.emplace_back();
       std::cout << "latch outputs not supported yet for bench writer\n";
     }
   } );
 
-  ntk.foreach_po( [&]( auto const& po, auto index ) {
-    if(index < ntk.num_pos() - ntk.num_latches())
+  ntk.foreach_po( [&]( auto const&, auto index ) {
+    if ( index < ntk.num_pos() - ntk.num_latches() )
     {
       if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
-      {  
-        output_names[index] = ntk.has_output_name( index ) ? ntk.get_output_name( index ) : fmt::format( "po{}", index );
-        // if(output_names[index].find('[') != std::string::npos || output_names[index].find('[') != std::string::npos)
-        //   output_names[index].insert(output_names[index].begin(),'\\');
+      {
+        output_names.push_back( ntk.has_output_name( index ) ? ntk.get_output_name( index ) : "po" + std::to_string( index ) );
       }
       else
       {
-        output_names[index] = fmt::format( "po{}", index );
+        output_names.push_back( "po" + std::to_string( index ) );
       }
     }
     else
     {
+      output_names.emplace_back();
       std::cout << "latch inputs not supported yet for bench writer\n";
     }
   } );
 
-  ntk.foreach_pi( [&]( auto const& n ) {
-    os << fmt::format( "INPUT({})\n", node_names[ntk.make_signal(n)] );
-  } );
+  for ( auto const& name : input_names )
+  {
+    out << "INPUT(" << name << ")\n";
+  }
 
-  ntk.foreach_po( [&]( auto const& po, auto index ) {
-    os << fmt::format( "OUTPUT({})\n", output_names[index] );
-  } );
+  for ( auto const& name : output_names )
+  {
+    out << "OUTPUT(" << name << ")\n";
+  }
 
-  os << fmt::format( "new_n{} = gnd\n", ntk.node_to_index( ntk.get_node( ntk.get_constant( false ) ) ) );
+  out << "new_n";
+  out.append_uint( ntk.node_to_index( ntk.get_node( ntk.get_constant( false ) ) ) ) << " = gnd\n";
   if ( ntk.get_node( ntk.get_constant( false ) ) != ntk.get_node( ntk.get_constant( true ) ) )
   {
-    os << fmt::format( "new_n{} = vdd\n", ntk.node_to_index( ntk.get_node( ntk.get_constant( true ) ) ) );
+    out << "new_n";
+    out.append_uint( ntk.node_to_index( ntk.get_node( ntk.get_constant( true ) ) ) ) << " = vdd\n";
   }
 
+  std::vector<node> nodes;
   ntk.foreach_node( [&]( auto const& n ) {
-    if ( ntk.is_constant( n ) || ntk.is_ci( n ) )
-      return; /* continue */
-
-    auto func = ntk.node_function( n );
-    std::string children;
-    auto first = true;
-    ntk.foreach_fanin( n, [&]( auto const& c, auto i ) {
-      if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-      {
-        signal<Ntk> const s = ntk.make_signal( ntk.node_to_index( ntk.get_node( c ) ) );
-        std::string const name = ntk.has_name( s ) ? ntk.get_name( s ) : fmt::format( "new_n{}", ntk.get_node( s ) );
-        node_names[c] = name;
-      }
-      else
-      {
-        node_names[c] = fmt::format( "new_n{} ", ntk.node_to_index( ntk.get_node( c ) ) );
-      }
-      if ( ntk.is_complemented( c ) )
-      {
-        kitty::flip_inplace( func, i );
-      }
-      if ( first )
-      {
-        first = false;
-      }
-      else
-      {
-        children += ", ";
-      }
-
-      children += fmt::format( "{}", node_names[c] );
-    } );
+    if ( !ntk.is_constant( n ) && !ntk.is_ci( n ) )
+      nodes.push_back( n );
+  } );
 
-    os << fmt::format( "new_n{} = LUT 0x{} ({})\n",
-                       ntk.node_to_index( n ),
-                       kitty::to_hex( func ), children );
+  format_in_chunks( out, nodes.size(), ps.num_threads, [&]( uint64_t begin, uint64_t end, output_buffer& buf ) {
+    for ( auto k = begin; k < end; ++k )
+    {
+      const auto n = nodes[k];
+      auto func = ntk.node_function( n );
+      ntk.foreach_fanin( n, [&]( auto const& c, auto i ) {
+        if ( ntk.is_complemented( c ) )
+        {
+          kitty::flip_inplace( func, i );
+        }
+      } );
+
+      buf << "new_n";
+      buf.append_uint( ntk.node_to_index( n ) ) << " = LUT 0x" << kitty::to_hex( func ) << " (";
+      ntk.foreach_fanin( n, [&]( auto const& c, auto i ) {
+        if ( i != 0 )
+        {
+          buf << ", ";
+        }
+        if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
+        {
+          signal<Ntk> const s = ntk.make_signal( ntk.get_node( c ) );
+          if ( ntk.has_name( s ) )
+          {
+            buf << ntk.get_name( s );
+            return;
+          }
+          buf << "new_n";
+          buf.append_uint( ntk.node_to_index( ntk.get_node( c ) ) );
+        }
+        else
+        {
+          buf << "new_n";
+          buf.append_uint( ntk.node_to_index( ntk.get_node( c ) ) ) << ' ';
+        }
+      } );
+      buf << ")\n";
+    }
   } );
 
   /* outputs */
   ntk.foreach_po( [&]( auto const& s, auto i ) {
     if ( ntk.is_constant( ntk.get_node( s ) ) )
     {
-      os << fmt::format( "{} = {}\n",
-                         output_names[i],
-                         ( ntk.constant_value( ntk.get_node( s ) ) ^ ntk.is_complemented( s ) ) ? "vdd" : "gnd" );
+      out << output_names[i] << " = " << ( ( ntk.constant_value( ntk.get_node( s ) ) ^ ntk.is_complemented( s ) ) ? "vdd" : "gnd" ) << '\n';
     }
     else
     {
-      os << fmt::format( "{} = LUT 0x{} (new_n{})\n",
-                         output_names[i],
-                         ntk.is_complemented( s ) ? 1 : 2,
-                         ntk.node_to_index( ntk.get_node( s ) ) );
+      out << output_names[i] << " = LUT 0x" << ( ntk.is_complemented( s ) ? '1' : '2' ) << " (new_n";
+      out.append_uint( ntk.node_to_index( ntk.get_node( s ) ) ) << ")\n";
     }
   } );
 
-  os << std::flush;
+  out.flush();
+}
+
+} // namespace detail
+
+/*! \brief Writes network in BENCH format into output stream
+ *
+ * An overloaded variant exists that writes the network into a file.
+ *
+ * The text is formatted into a large buffer, with `ps.num_threads` > 1
+ * chunks of the nodes are formatted concurrently.
+ *
+ * **Required network functions:**
+ * - `is_constant`
+ * - `is_pi`
+ * - `is_complemented`
+ * - `get_node`
+ * - `num_pos`
+ * - `node_to_index`
+ * - `node_function`
+ *
+ * \param ntk Network
+ * \param os Output stream
+ */
+template<class Ntk>
+void write_bench( Ntk const& ntk, std::ostream& os, write_bench_params const& ps = {} )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_is_complemented_v<Ntk>, "Ntk does not implement the is_complemented method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( has_node_function_v<Ntk>, "Ntk does not implement the node_function method" );
+
+  output_buffer out( os );
+  detail::write_bench( ntk, out, ps );
 }
 
 /*! \brief Writes network in BENCH format into a file
+ *
+ * The file is written with `write(2)` from the output buffer.
  *
  * **Required network functions:**
  * - `is_constant`
@@ -205,11 +236,10 @@ void write_bench( Ntk const& ntk, std::ostream& os )
  * \param filename Filename
  */
 template<class Ntk>
-void write_bench( Ntk const& ntk, std::string const& filename )
+void write_bench( Ntk const& ntk, std::string const& filename, write_bench_params const& ps = {} )
 {
-  std::ofstream os( filename.c_str(), std::ofstream::out );
-  write_bench( ntk, os );
-  os.close();
+  output_buffer out( filename );
+  detail::write_bench( ntk, out, ps );
 }
 
 } /* namespace mockturtle */
@@ -33,6 +33,7 @@
 #pragma once
 
 #include "../traits.hpp"
+#include "../utils/output_buffer.hpp"
 #include "../views/topo_view.hpp"
 
 #include <kitty/constructors.hpp>
@@ -40,11 +41,10 @@
 #include <kitty/operations.hpp>
 #include <kitty/print.hpp>
 
-#include <fmt/format.h>
-
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace mockturtle
 {
@@ -52,214 +52,246 @@ namespace mockturtle
   struct write_blif_params
   {
     uint32_t skip_feedthrough = 0u;
+
+    /*! \brief Number of threads formatting the nodes; the output is the same for any number. */
+    uint32_t num_threads = 1u;
   };
 
-/*! \brief Writes network in BLIF format into output stream
- *
- * An overloaded variant exists that writes the network into a file.
- *
- * **Required network functions:**
- * - `fanin_size`
- * - `foreach_fanin`
- * - `foreach_pi`
- * - `foreach_po`
- * - `get_node`
- * - `is_constant`
- * - `is_pi`
- * - `node_function`
- * - `node_to_index`
- * - `num_pis`
- * - `num_pos`
- *
- * \param ntk Network
- * \param os Output stream
- */
+namespace detail
+{
+
 template<class Ntk>
-void write_blif( Ntk const& topo_ntk, std::ostream& os, write_blif_params const& ps = {} )
+void write_blif( Ntk const& topo_ntk, output_buffer& out, write_blif_params const& ps )
 {
-  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
-  static_assert( has_fanin_size_v<Ntk>, "Ntk does not implement the fanin_size method" );
-  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
-  static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
-  static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
-  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
-  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
-  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
-  static_assert( has_num_pis_v<Ntk>, "Ntk does not implement the num_pis method" );
-  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
-  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
-  static_assert( has_node_function_v<Ntk>, "Ntk does not implement the node_function method" );
+  using node = typename Ntk::node;
 
-  // topo_view topo_ntk{ntk};
+  constexpr auto has_names = has_has_name_v<Ntk> && has_get_name_v<Ntk>;
+
+  /* signal names, nodes without a name are called after their index */
+  const auto put_node_name = [&]( output_buffer& buf, node const& n ) {
+    if constexpr ( has_names )
+    {
+      signal<Ntk> const s = topo_ntk.make_signal( n );
+      if ( topo_ntk.has_name( s ) )
+      {
+        buf << topo_ntk.get_name( s );
+        return;
+      }
+    }
+    buf.append( "new_n", 5u ).append_uint( topo_ntk.node_to_index( n ) );
+  };
+  const auto node_name = [&]( node const& n ) {
+    output_buffer buf;
+    put_node_name( buf, n );
+    return std::string( buf.data(), buf.size() );
+  };
+  const auto output_name = [&]( uint32_t index ) {
+    if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
+    {
+      if ( topo_ntk.has_output_name( index ) )
+        return topo_ntk.get_output_name( index );
+    }
+    return "po" + std::to_string( index );
+  };
 
   /* write model */
-  os << ".model top\n";
+  out << ".model top\n";
 
   /* write inputs */
   if ( topo_ntk.num_pis() > 0u )
   {
-      os << ".inputs ";
-      topo_ntk.foreach_pi( [&]( auto const& n, auto index ) {
-        if ( ( ( index + 1 ) <= topo_ntk.num_pis() - topo_ntk.num_latches() ) ) {
-          if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-          {
-            signal<Ntk> const s = topo_ntk.make_signal( topo_ntk.node_to_index( n ) );
-            std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "pi{}", topo_ntk.get_node( s ) );
-            os << name << ' ';
-          }
-          else
+    out << ".inputs ";
+    topo_ntk.foreach_pi( [&]( auto const& n, auto index ) {
+      if ( ( index + 1 ) <= topo_ntk.num_pis() - topo_ntk.num_latches() )
+      {
+        if constexpr ( has_names )
+        {
+          signal<Ntk> const s = topo_ntk.make_signal( n );
+          if ( topo_ntk.has_name( s ) )
           {
-            os << fmt::format( "pi{} ", topo_ntk.node_to_index( n ) );
+            out << topo_ntk.get_name( s ) << ' ';
+            return;
           }
         }
-      } );
-      os << "\n";
+        out << "pi";
+        out.append_uint( topo_ntk.node_to_index( n ) ) << ' ';
+      }
+    } );
+    out << "\n";
   }
 
   /* write outputs */
   if ( topo_ntk.num_pos() > 0u )
   {
-    os << ".outputs ";
-    topo_ntk.foreach_po( [&]( auto const& f, auto index ) {
-        (void)f;
-        if( index < topo_ntk.num_pos() - topo_ntk.num_latches() ) {
-          if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
-          {
-            std::string const output_name = topo_ntk.has_output_name( index ) ? topo_ntk.get_output_name( index ) : fmt::format( "po{}", index );
-            os << output_name << ' ';
-          }
-          else
-          {
-            os << fmt::format( "po{} ", index );
-          }
-        }
-      });
-    os << "\n";
+    out << ".outputs ";
+    topo_ntk.foreach_po( [&]( auto const&, auto index ) {
+      if ( index < topo_ntk.num_pos() - topo_ntk.num_latches() )
+      {
+        out << output_name( index ) << ' ';
+      }
+    } );
+    out << "\n";
   }
 
   if ( topo_ntk.num_latches() > 0u )
   {
     topo_ntk.foreach_po( [&]( auto const& f, auto index ) {
-      if( index >= topo_ntk.num_pos() - topo_ntk.num_latches() ) {
-        os << ".latch ";
-        auto const ro_sig = topo_ntk.make_signal( topo_ntk.ri_to_ro( f ) );
-        if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
+      if ( index >= topo_ntk.num_pos() - topo_ntk.num_latches() )
+      {
+        out << ".latch ";
+        const auto ro = topo_ntk.ri_to_ro( f );
+        if constexpr ( has_names )
         {
-          std::string const ri_name = topo_ntk.has_output_name( index ) ? topo_ntk.get_output_name( index ) : fmt::format( "new_n{}", topo_ntk.get_node( f ) );
-          std::string const ro_name = topo_ntk.has_name( ro_sig ) ? topo_ntk.get_name( ro_sig ) : fmt::format( "new_n{}", topo_ntk.get_node( ro_sig ) );
-          os << ri_name << " " << ro_name << " 0\n";
+          if ( topo_ntk.has_output_name( index ) )
+            out << topo_ntk.get_output_name( index );
+          else
+            out.append( "new_n", 5u ).append_uint( topo_ntk.node_to_index( topo_ntk.get_node( f ) ) );
+          out << ' ';
+          put_node_name( out, ro );
         }
         else
         {
-          os << fmt::format( "new_n{} new_n{} 0\n", topo_ntk.node_to_index( topo_ntk.get_node( f ) ), topo_ntk.node_to_index( topo_ntk.get_node( ro_sig ) ) );
+          out.append( "new_n", 5u ).append_uint( topo_ntk.node_to_index( topo_ntk.get_node( f ) ) );
+          out.append( " new_n", 6u ).append_uint( topo_ntk.node_to_index( ro ) );
         }
+        out << " 0\n";
       }
-    }) ;
+    } );
   }
 
   /* write constants */
-  os << ".names new_n0\n";
-  os << "0\n";
+  out << ".names new_n0\n";
+  out << "0\n";
 
   if ( topo_ntk.get_constant( false ) != topo_ntk.get_constant( true ) )
   {
-    os << ".names new_n1\n";
-    os << "1\n";
+    out << ".names new_n1\n";
+    out << "1\n";
   }
 
   /* write nodes */
+  std::vector<node> nodes;
   topo_ntk.foreach_node( [&]( auto const& n ) {
+    if ( !topo_ntk.is_constant( n ) && !topo_ntk.is_ci( n ) )
+      nodes.push_back( n );
+  } );
 
-      if ( topo_ntk.is_constant( n ) || topo_ntk.is_ci( n ) )
-        return; /* continue */
+  format_in_chunks( out, nodes.size(), ps.num_threads, [&]( uint64_t begin, uint64_t end, output_buffer& buf ) {
+    for ( auto i = begin; i < end; ++i )
+    {
+      const auto n = nodes[i];
 
       /* write truth table of node */
-      auto func = topo_ntk.node_function( n );
+      const auto cubes = isop( topo_ntk.node_function( n ) );
 
-      if(isop( func ).size() == 0){
-        if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-        {
-          auto const s = topo_ntk.make_signal( topo_ntk.node_to_index( n ) );
-          std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
-          os << fmt::format( ".names {}\n", name );
-          os << "0" << '\n';
-        }
-        else
-        {
-          os << fmt::format( ".names new_n{}\n", topo_ntk.node_to_index( n ) );
-          os << "0" << '\n';
-        }
-        return;
-      }
-
-      os << fmt::format( ".names " );
-
-      /* write fanins of node */
-      topo_ntk.foreach_fanin( n, [&]( auto const& f ) {
-          if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-          {
-            signal<Ntk> const s = topo_ntk.make_signal( topo_ntk.node_to_index( topo_ntk.get_node( f ) ) );
-            std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
-            os << name << ' ';
-          }
-          else
-          {
-            os << fmt::format( "new_n{} ", topo_ntk.node_to_index( topo_ntk.get_node( f ) ) );
-          }
-        });
-
-      /* write fanout of node */
-      if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-      {
-        auto const s = topo_ntk.make_signal( topo_ntk.node_to_index( n ) );
-        std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
-        os << name << '\n';
-      }
-      else
+      buf << ".names ";
+      if ( cubes.empty() )
       {
-        os << fmt::format( "new_n{}\n", topo_ntk.node_to_index( n ) );
+        put_node_name( buf, n );
+        buf << "\n0\n";
+        continue;
       }
 
+      /* write fanins and fanout of node */
+      topo_ntk.foreach_fanin( n, [&]( auto const& f ) {
+        put_node_name( buf, topo_ntk.get_node( f ) );
+        buf << ' ';
+      } );
+      put_node_name( buf, n );
+      buf << '\n';
 
-      int count = 0;
-      for ( auto cube : isop( func ) )
+      const auto num_fanins = topo_ntk.fanin_size( n );
+      for ( auto cube : cubes )
       {
         topo_ntk.foreach_fanin( n, [&]( auto const& f, auto index ) {
-            if ( cube.get_mask( index ) && topo_ntk.is_complemented( f ) )
-              cube.flip_bit( index );
-          });
+          if ( cube.get_mask( index ) && topo_ntk.is_complemented( f ) )
+            cube.flip_bit( index );
+        } );
 
-        cube.print( topo_ntk.fanin_size( n ), os );
-        os << " 1\n";
-        count++;
+        for ( auto k = 0u; k < num_fanins; ++k )
+        {
+          buf << ( cube.get_mask( k ) ? ( cube.get_bit( k ) ? '1' : '0' ) : '-' );
+        }
+        buf.append( " 1\n", 3u );
       }
-    });
+    }
+  } );
 
   if ( topo_ntk.num_pos() > 0u )
   {
-    topo_ntk.foreach_po( [&]( auto const& f, auto index ){
+    topo_ntk.foreach_po( [&]( auto const& f, auto index ) {
       auto const minterm_string = topo_ntk.is_complemented( f ) ? "0" : "1";
-      if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> && has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
+      if constexpr ( has_names && has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
       {
-        signal<Ntk> const s = topo_ntk.make_signal( topo_ntk.node_to_index( topo_ntk.get_node( f ) ) );
-        std::string const node_name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
-        std::string const output_name = topo_ntk.has_output_name( index ) ? topo_ntk.get_output_name( index ) : fmt::format( "po{}", index );
-        if(!ps.skip_feedthrough || (node_name != output_name))
-          os << fmt::format( ".names {} {}\n{} 1\n", node_name, output_name, minterm_string, index );
+        const auto driver_name = node_name( topo_ntk.get_node( f ) );
+        const auto po_name = output_name( index );
+        if ( !ps.skip_feedthrough || ( driver_name != po_name ) )
+          out << ".names " << driver_name << ' ' << po_name << '\n' << minterm_string << " 1\n";
       }
       else
       {
-        if(!ps.skip_feedthrough || (topo_ntk.node_to_index( topo_ntk.node_to_index( topo_ntk.get_node( f ) ) ) != index))
-          os << fmt::format( ".names new_n{} po{}\n{} 1\n", topo_ntk.node_to_index( topo_ntk.node_to_index( topo_ntk.get_node( f ) ) ), index, minterm_string );
+        const auto driver = topo_ntk.node_to_index( topo_ntk.get_node( f ) );
+        if ( !ps.skip_feedthrough || ( driver != index ) )
+        {
+          out.append( ".names new_n", 12u ).append_uint( driver );
+          out.append( " po", 3u ).append_uint( index ) << '\n' << minterm_string << " 1\n";
+        }
       }
-    });
+    } );
   }
 
-  os << ".end\n";
-  os << std::flush;
+  out << ".end\n";
+  out.flush();
+}
+
+} // namespace detail
+
+/*! \brief Writes network in BLIF format into output stream
+ *
+ * An overloaded variant exists that writes the network into a file.
+ *
+ * The text is formatted into a large buffer, with `ps.num_threads` > 1
+ * chunks of the nodes are formatted concurrently.
+ *
+ * **Required network functions:**
+ * - `fanin_size`
+ * - `foreach_fanin`
+ * - `foreach_pi`
+ * - `foreach_po`
+ * - `get_node`
+ * - `is_constant`
+ * - `is_pi`
+ * - `node_function`
+ * - `node_to_index`
+ * - `num_pis`
+ * - `num_pos`
+ *
+ * \param ntk Network
+ * \param os Output stream
+ */
+template<class Ntk>
+void write_blif( Ntk const& topo_ntk, std::ostream& os, write_blif_params const& ps = {} )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_fanin_size_v<Ntk>, "Ntk does not implement the fanin_size method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+  static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_num_pis_v<Ntk>, "Ntk does not implement the num_pis method" );
+  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( has_node_function_v<Ntk>, "Ntk does not implement the node_function method" );
+
+  output_buffer out( os );
+  detail::write_blif( topo_ntk, out, ps );
 }
 
 /*! \brief Writes network in BLIF format into a file
+ *
+ * The file is written with `write(2)` from the output buffer.
  *
  * **Required network functions:**
  * - `fanin_size`
@@ -280,9 +312,8 @@ void write_blif( Ntk const& topo_ntk, std::ostream& os, write_blif_params const&
 template<class Ntk>
 void write_blif( Ntk const& ntk, std::string const& filename, write_blif_params const& ps = {} )
 {
-  std::ofstream os( filename.c_str(), std::ofstream::out );
-  write_blif( ntk, os, ps );
-  os.close();
+  output_buffer out( filename );
+  detail::write_blif( ntk, out, ps );
 }
 
 } /* namespace mockturtle */
@@ -35,13 +35,10 @@
 #include <fstream>
 #include <iostream>
 #include <string>
-
-#include <ez/direct_iterator.hpp>
-#include <fmt/format.h>
+#include <vector>
 
 #include "../traits.hpp"
-#include "../utils/node_map.hpp"
-#include "../utils/string_utils.hpp"
+#include "../utils/output_buffer.hpp"
 #include "../views/topo_view.hpp"
 
 namespace mockturtle
@@ -49,33 +46,299 @@ namespace mockturtle
 
   using namespace std::string_literals;
 
-  namespace detail
-  {
-    template<int Fanin, class Ntk>
-    std::pair<std::array<std::string, Fanin>, std::array<std::string, Fanin>>
-    format_fanin( Ntk const& ntk, node<Ntk> const& n, node_map<std::string, Ntk>& node_names )
-    {
-      std::array<std::string, Fanin> children, inv;
-      ntk.foreach_fanin( n, [&]( auto const& f, auto i ) {
-        children[i] = node_names[f];
-        inv[i] = ntk.is_complemented( f ) ? "~" : "";
-      } );
-      return {children, inv};
-    }
-  } // namespace detail
-
   struct write_verilog_params
   {
     std::string module_name = "top";
     std::vector<std::pair<std::string, uint32_t>> input_names;
     std::vector<std::pair<std::string, uint32_t>> output_names;
     uint32_t skip_feedthrough = 0u;
+
+    /*! \brief Number of threads formatting the gates; the output is the same for any number. */
+    uint32_t num_threads = 1u;
   };
 
+  namespace detail
+  {
+    inline std::string escape_verilog_name( std::string name )
+    {
+      if ( name.find( '[' ) != std::string::npos )
+        name.insert( name.begin(), '\\' );
+      return name;
+    }
+
+    inline void join_names( output_buffer& out, std::vector<std::string> const& names, char const* sep )
+    {
+      for ( auto i = 0u; i < names.size(); ++i )
+      {
+        if ( i != 0u )
+          out << sep;
+        out << names[i];
+      }
+    }
+
+    template<class Ntk>
+    void write_verilog( Ntk const& ntk, output_buffer& out, write_verilog_params const& ps )
+    {
+      using node = typename Ntk::node;
+
+      const auto num_inputs = ntk.num_pis() - ntk.num_latches();
+      const auto num_outputs = ntk.num_pos() - ntk.num_latches();
+
+      //counting number of digits to add leading 0's
+      const auto digits_in = static_cast<uint32_t>( std::to_string( num_inputs ).length() );
+      const auto digits_out = static_cast<uint32_t>( std::to_string( num_outputs ).length() );
+
+      const auto padded = []( char const* prefix, uint64_t index, uint32_t width ) {
+        auto name = std::to_string( index );
+        if ( name.size() < width )
+          name.insert( 0u, width - name.size(), '0' );
+        return prefix + name;
+      };
+
+      /* only inputs and register outputs have names, gates are named after their index */
+      std::vector<uint32_t> ci_slot( ntk.size(), 0u );
+      std::vector<std::string> xs, ys, ros, ris;
+      ntk.foreach_pi( [&]( auto const& pi, auto index ) {
+        const auto s = ntk.make_signal( pi );
+        std::string name;
+        if ( index < num_inputs )
+        {
+          if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
+            name = ntk.has_name( s ) ? escape_verilog_name( ntk.get_name( s ) ) : padded( "pi", index, digits_in );
+          else
+            name = padded( "pi", index, digits_in );
+          xs.push_back( name );
+        }
+        else
+        {
+          const auto latch_index = index - num_inputs + 1u;
+          if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
+            name = ntk.has_name( s ) ? escape_verilog_name( ntk.get_name( s ) ) : "lo" + std::to_string( latch_index );
+          else
+            name = "lo" + std::to_string( latch_index );
+          ros.push_back( name );
+        }
+        ci_slot[ntk.node_to_index( pi )] = static_cast<uint32_t>( xs.size() + ros.size() );
+      } );
+
+      ntk.foreach_po( [&]( auto const&, auto index ) {
+        std::string name;
+        if ( index < num_outputs )
+        {
+          if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
+            name = ntk.has_output_name( index ) ? escape_verilog_name( ntk.get_output_name( index ) ) : padded( "po", index, digits_out );
+          else
+            name = padded( "po", index, digits_out );
+          ys.push_back( name );
+        }
+        else
+        {
+          const auto latch_index = index - num_outputs + 1u;
+          if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
+            name = ntk.has_output_name( index ) ? escape_verilog_name( ntk.get_output_name( index ) ) : "li" + std::to_string( latch_index );
+          else
+            name = "li" + std::to_string( latch_index );
+          ris.push_back( name );
+        }
+      } );
+
+      /* inputs and register outputs in the order of foreach_pi */
+      std::vector<std::string const*> ci_names( xs.size() + ros.size() );
+      {
+        auto x = 0u, r = 0u;
+        ntk.foreach_pi( [&]( auto const& pi, auto index ) {
+          ci_names[ci_slot[ntk.node_to_index( pi )] - 1u] = index < num_inputs ? &xs[x++] : &ros[r++];
+        } );
+      }
+
+      const auto const0 = ntk.get_node( ntk.get_constant( false ) );
+      const auto put_name = [&]( output_buffer& buf, node const& n ) {
+        const auto index = ntk.node_to_index( n );
+        if ( ntk.is_constant( n ) )
+          buf << ( n == const0 ? "1'b0" : "1'b1" );
+        else if ( ci_slot[index] != 0u )
+          buf << *ci_names[ci_slot[index] - 1u];
+        else
+          buf.append( "new_n", 5u ).append_uint( index );
+      };
+      const auto put_fanin = [&]( output_buffer& buf, signal<Ntk> const& f ) {
+        if ( ntk.is_complemented( f ) )
+          buf << '~';
+        put_name( buf, ntk.get_node( f ) );
+      };
+      const auto name_of = [&]( node const& n ) {
+        output_buffer buf;
+        put_name( buf, n );
+        return std::string( buf.data(), buf.size() );
+      };
+
+      if ( ntk.num_latches() > 0 )
+      {
+        out << "module " << ps.module_name << "(clock , ";
+        join_names( out, xs, " , " );
+        out << " , ";
+        join_names( out, ys, " , " );
+        out << " );\n  input clock ;\n  input ";
+        join_names( out, xs, " , " );
+        out << " ;\n  output ";
+        join_names( out, ys, " , " );
+        out << " ;\n  reg ";
+        join_names( out, ros, " , " );
+        out << " ;\n";
+      }
+      else
+      {
+        out << "module " << ps.module_name << '(';
+        join_names( out, xs, " , " );
+        out << " , ";
+        join_names( out, ys, " , " );
+        out << " );\n  input ";
+        join_names( out, xs, " , " );
+        out << " ;\n  output ";
+        join_names( out, ys, " , " );
+        out << " ;\n";
+      }
+
+      /* declare wires */
+      if ( ntk.num_gates() > 0 )
+      {
+        out << "  wire ";
+        auto first = true;
+        ntk.foreach_gate( [&]( auto const& n ) {
+          const auto index = ntk.node_to_index( n );
+          if ( index > ntk.num_pis() )
+          {
+            if ( first )
+              first = false;
+            else
+              out << ", ";
+            out.append( "new_n", 5u ).append_uint( index );
+          }
+        } );
+
+        for ( auto const& ri : ris )
+        {
+          out << ", " << ri;
+        }
+        out << ";\n";
+      }
+
+      std::vector<node> gates;
+      gates.reserve( ntk.num_gates() );
+      topo_view ntk_topo{ntk};
+      ntk_topo.foreach_node( [&]( auto const& n ) {
+        if ( !ntk.is_constant( n ) && !ntk.is_ci( n ) )
+          gates.push_back( n );
+      } );
+
+      format_in_chunks( out, gates.size(), ps.num_threads, [&]( uint64_t begin, uint64_t end, output_buffer& buf ) {
+        std::array<signal<Ntk>, 3> fanins;
+        for ( auto g = begin; g < end; ++g )
+        {
+          const auto n = gates[g];
+          buf.append( "  assign new_n", 14u ).append_uint( ntk.node_to_index( n ) ).append( " = ", 3u );
+
+          char const* op = nullptr;
+          if ( ntk.is_and( n ) )
+            op = " & ";
+          else if ( ntk.is_or( n ) )
+            op = " | ";
+          else if ( ntk.is_xor( n ) )
+            op = " ^ ";
+
+          if ( op )
+          {
+            ntk.foreach_fanin( n, [&]( auto const& f, auto i ) { fanins[i] = f; return i < 1; } );
+            put_fanin( buf, fanins[0] );
+            buf << op;
+            put_fanin( buf, fanins[1] );
+            buf.append( " ;\n", 3u );
+          }
+          else if ( ntk.is_xor3( n ) || ntk.is_maj( n ) )
+          {
+            ntk.foreach_fanin( n, [&]( auto const& f, auto i ) { fanins[i] = f; return i < 2; } );
+            if ( ntk.is_xor3( n ) )
+            {
+              put_fanin( buf, fanins[0] );
+              buf.append( " ^ ", 3u );
+              put_fanin( buf, fanins[1] );
+              buf.append( " ^ ", 3u );
+              put_fanin( buf, fanins[2] );
+              buf.append( " ;\n", 3u );
+            }
+            else if ( ntk.is_constant( ntk.get_node( fanins[0] ) ) )
+            {
+              put_fanin( buf, fanins[1] );
+              buf << ( ntk.is_complemented( fanins[0] ) ? " | " : " & " );
+              put_fanin( buf, fanins[2] );
+              buf.append( " ;\n", 3u );
+            }
+            else
+            {
+              for ( auto const& [a, b] : {std::make_pair( 0, 1 ), std::make_pair( 0, 2 ), std::make_pair( 1, 2 )} )
+              {
+                buf.append( "( ", 2u );
+                put_fanin( buf, fanins[a] );
+                buf.append( " & ", 3u );
+                put_fanin( buf, fanins[b] );
+                buf << ( b == 2 && a == 1 ? " );\n" : " ) | " );
+              }
+            }
+          }
+          else
+          {
+            buf << "unknown gate;\n";
+          }
+        }
+      } );
+
+      ntk.foreach_po( [&]( auto const& f, auto i ) {
+        auto const& name = i < num_outputs ? ys[i] : ris[i - num_outputs];
+        if ( !ps.skip_feedthrough || name != name_of( ntk.get_node( f ) ) )
+        {
+          out << "  assign " << name << " = ";
+          put_fanin( out, f );
+          out << " ;\n";
+        }
+      } );
+
+      if ( ntk.num_latches() > 0 )
+      {
+        out << " always @ (posedge clock) begin\n";
+
+        ntk.foreach_ro( [&]( auto const& ro ) {
+          const auto ri_node = ntk.ro_to_ri( ntk.make_signal( ro ) );
+          out << "    ";
+          put_name( out, ro );
+          out << " <= " << ris[ntk.ri_index( ri_node )] << " ;\n";
+        } );
+
+        out << " end\n";
+
+        out << " initial begin\n";
+        ntk.foreach_ro( [&]( auto const& ro ) {
+          out << "    ";
+          put_name( out, ro );
+          out << " <= 1'b0;\n";
+        } );
+
+        out << " end\n";
+      }
+
+      out << "endmodule\n";
+      out.flush();
+    }
+  } // namespace detail
+
 /*! \brief Writes network in structural Verilog format into output stream
  *
  * An overloaded variant exists that writes the network into a file.
  *
+ * Names are only kept for inputs, outputs and registers, gates are named
+ * after their index.  The text is formatted into a large buffer, with
+ * `ps.num_threads` > 1 chunks of the gates in topological order are
+ * formatted concurrently.
+ *
  * **Required network functions:**
  * - `num_latches`
  * - `num_pis`
@@ -122,233 +385,14 @@ namespace mockturtle
     static_assert( has_is_xor3_v<Ntk>, "Ntk does not implement the is_xor3 method" );
     static_assert( has_is_maj_v<Ntk>, "Ntk does not implement the is_maj method" );
     static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
-    
-    //counting number of digits to add leading 0's
-    auto digitsIn  = std::to_string(ntk.num_pis()-ntk.num_latches()).length();
-    auto digitsOut = std::to_string(ntk.num_pos()-ntk.num_latches()).length();
-
-    node_map<std::string, Ntk> node_names( ntk );
-    // node_map<std::string, Ntk> output_names( ntk );
-    std::map<uint32_t, std::string> output_names;
-    std::map<uint32_t, std::string> ri_names;
-    // node_map<std::string, Ntk> ri_names( ntk );
-    std::vector<std::string> xs, ys, ros, ris;
-    auto latch_index = 1u;
-    ntk.foreach_pi( [&]( auto const& pi, auto index ) {
-      auto signal = ntk.make_signal( pi );
-      if(index < ntk.num_pis() - ntk.num_latches()){
-        if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-        {  
-          node_names[signal] = ntk.has_name( signal ) ? ntk.get_name( signal ) : fmt::format( "pi{0:0{1}}", index, digitsIn );
-          if(node_names[signal].find('[') != std::string::npos || node_names[signal].find('[') != std::string::npos)
-            node_names[signal].insert(node_names[signal].begin(),'\\');
-        }
-        else
-        {
-          node_names[signal] = fmt::format( "pi{0:0{1}}", index, digitsIn );
-        }
-        xs.push_back(node_names[signal]);
-      }
-      else
-      {
-        if(ntk.num_latches()>0) 
-        {
-          if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-          {  
-            node_names[signal] = ntk.has_name( signal ) ? ntk.get_name( signal ) : fmt::format( "lo{}", latch_index );
-            if(node_names[signal].find('[') != std::string::npos || node_names[signal].find('[') != std::string::npos)
-              node_names[signal].insert(node_names[signal].begin(),'\\');
-          }
-          else
-          {
-            node_names[signal] = fmt::format( "lo{}", latch_index );
-          }
-        }
-        latch_index++;
-        ros.push_back(node_names[signal]);
-      }
-    } );
-
-    latch_index = 1u;
-    ntk.foreach_po( [&]( auto const& po, auto index ) {
-      if(index < ntk.num_pos() - ntk.num_latches())
-      {
-        if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
-        {  
-          output_names[index] = ntk.has_output_name( index ) ? ntk.get_output_name( index ) : fmt::format( "po{0:0{1}}", index, digitsOut );
-          if(output_names[index].find('[') != std::string::npos || output_names[index].find('[') != std::string::npos)
-            output_names[index].insert(output_names[index].begin(),'\\');
-        }
-        else
-        {
-          output_names[index] = fmt::format( "po{0:0{1}}", index, digitsOut );
-        }
-        ys.push_back(output_names[index]);
-      }
-      else
-      {
-        if(ntk.num_latches()>0) 
-        {
-          if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
-          {  
-            ri_names[latch_index] = ntk.has_output_name( index ) ? ntk.get_output_name( index ) : fmt::format( "li{}", latch_index );
-            if(ri_names[latch_index].find('[') != std::string::npos || ri_names[latch_index].find('[') != std::string::npos)
-              ri_names[latch_index].insert(ri_names[latch_index].begin(),'\\');
-          }
-          else
-          {
-            ri_names[latch_index] = fmt::format( "li{}", latch_index );
-          }
-        }
-        ris.push_back(ri_names[latch_index]);
-        latch_index++;
-      }
-    } );
-
-    if(ntk.num_latches()>0) {
-      std::string clk = "clock";
-        os << fmt::format( "module {}({} , {} , {} );\n", ps.module_name, clk, fmt::join(xs, " , "), fmt::join(ys, " , ") )
-           << fmt::format( "  input {} ;\n", clk )
-           << fmt::format( "  input {} ;\n", fmt::join(xs, " , ") )
-           << fmt::format( "  output {} ;\n", fmt::join(ys, " , ") )
-           << fmt::format( "  reg {} ;\n", fmt::join(ros, " , ") );
-    }
 
-    else {
-        os << fmt::format( "module {}({} , {} );\n", ps.module_name, fmt::join(xs, " , "), fmt::join(ys, " , ") )
-           << fmt::format( "  input {} ;\n", fmt::join(xs, " , ") )
-           << fmt::format( "  output {} ;\n", fmt::join(ys, " , ") );
-    }
-
-    
-    node_names[ntk.get_constant( false )] = "1'b0";
-    if ( ntk.get_node( ntk.get_constant( false ) ) != ntk.get_node( ntk.get_constant( true ) ) )
-    {
-      node_names[ntk.get_constant( true )] = "1'b1";
-    }
-
-    topo_view ntk_topo{ntk};
-
-    /* declare wires */
-    if ( ntk.num_gates() > 0 )
-    {
-      os << "  wire ";
-      auto first = true;
-      ntk.foreach_gate( [&]( auto const& n ) {
-        auto index = ntk.node_to_index( n );
-        if(index > ntk.num_pis()) {
-          if (first)
-            first = false;
-          else
-            os << ", ";
-          os << fmt::format("new_n{}", ntk.node_to_index(n));
-        }
-      } );
-
-      ntk.foreach_ri( [&](auto ri, auto index ) {
-        os << ", ";
-        os << ri_names[index + 1];
-      } );
-      os << ";\n";
-    }
-    ntk_topo.foreach_node( [&]( auto const& n ) {
-      if ( ntk.is_constant( n ) || ntk.is_ci( n ) )
-        return true;
-
-      if ( ntk.is_and( n ) )
-      {
-        const auto [children, inv] = detail::format_fanin<2, Ntk>( ntk, n, node_names );
-        os << fmt::format( "  assign new_n{} = {}{} & {}{} ;\n", ntk.node_to_index( n ),
-                           inv[0], children[0], inv[1], children[1] );
-      }
-      else if ( ntk.is_or( n ) )
-      {
-        const auto [children, inv] = detail::format_fanin<2, Ntk>( ntk, n, node_names );
-        os << fmt::format( "  assign new_n{} = {}{} | {}{} ;\n", ntk.node_to_index( n ),
-                           inv[0], children[0], inv[1], children[1] );
-      }
-      else if ( ntk.is_xor( n ) )
-      {
-        const auto [children, inv] = detail::format_fanin<2, Ntk>( ntk, n, node_names );
-        os << fmt::format( "  assign new_n{} = {}{} ^ {}{} ;\n", ntk.node_to_index( n ),
-                           inv[0], children[0], inv[1], children[1] );
-      }
-      else if ( ntk.is_xor3( n ) )
-      {
-        const auto [children, inv] = detail::format_fanin<3, Ntk>( ntk, n, node_names );
-        os << fmt::format( "  assign new_n{} = {}{} ^ {}{} ^ {}{} ;\n", ntk.node_to_index( n ),
-                           inv[0], children[0], inv[1], children[1], inv[2], children[2] );
-      }
-      else if ( ntk.is_maj( n ) )
-      {   
-        signal<Ntk> first_child;
-        ntk.foreach_fanin( n, [&]( auto const& f ) { first_child = f; return false; } );
-
-        const auto [children, inv] = detail::format_fanin<3, Ntk>( ntk, n, node_names );
-        if ( ntk.is_constant( ntk.get_node( first_child ) ) )
-        {
-          os << fmt::format( "  assign new_n{0} = {1}{3} {5} {2}{4} ;\n",
-                             ntk.node_to_index( n ),
-                             inv[1], inv[2], children[1], children[2],
-                             ntk.is_complemented( first_child ) ? "|" : "&" );
-        }
-        else
-        {
-          os << fmt::format( "  assign new_n{0} = ( {1}{4} & {2}{5} ) | ( {1}{4} & {3}{6} ) | ( {2}{5} & {3}{6} );\n",
-                             ntk.node_to_index( n ),
-                             inv[0], inv[1], inv[2], children[0], children[1], children[2] );
-        }
-      }
-      else
-      {
-        os << fmt::format( "  assign new_n{} = unknown gate;\n", ntk.node_to_index( n ) );
-      }
-
-      node_names[n] = fmt::format( "new_n{}", ntk.node_to_index( n ) );
-      return true;
-    } );
-
-    latch_index = 1u;
-    ntk.foreach_po( [&]( auto const& f, auto i ) {
-      if(i < ntk.num_pos() - ntk.num_latches()){
-        if(!ps.skip_feedthrough || (output_names[i] != node_names[f])){
-          os << fmt::format( "  assign {} = {}{} ;\n", output_names[i], ntk.is_complemented( f ) ? "~" : "", node_names[f] );
-        }
-      }
-      else{
-        if(ntk.num_latches()>0){
-          if(!ps.skip_feedthrough || (ri_names[latch_index] != node_names[f]))
-            os << fmt::format( "  assign {} = {}{} ;\n", ri_names[latch_index], ntk.is_complemented( f ) ? "~" : "", node_names[f] );
-          latch_index++;
-        }
-      }
-      
-    } );
-
-    if(ntk.num_latches() > 0) {
-      os << " always @ (posedge clock) begin\n";
-
-      ntk.foreach_ro([&](auto const &ro, auto i) {
-        auto ro_sig = ntk.make_signal(ro);
-        auto ri_node = ntk.ro_to_ri(ro_sig);
-        os << fmt::format("    {} <= {} ;\n", node_names[ro_sig], ri_names[ntk.ri_index(ri_node) + 1]);
-      });
-
-      os << " end\n";
-
-      os << " initial begin\n";
-      ntk.foreach_ro([&](auto const &f, auto i) {
-        os << fmt::format("    {} <= 1'b0;\n", node_names[f]);
-      });
-
-      os << " end\n";
-    }
-
-    os << "endmodule\n"
-       << std::flush;
+    output_buffer out( os );
+    detail::write_verilog( ntk, out, ps );
   }
 
 /*! \brief Writes network in structural Verilog format into a file
+ *
+ * The file is written with `write(2)` from the output buffer.
  *
  * **Required network functions:**
  * - `num_pis`
@@ -376,8 +420,7 @@ namespace mockturtle
   template<class Ntk>
   void write_verilog( Ntk const& ntk, std::string const& filename, write_verilog_params const& ps = {} )
   {
-    std::ofstream os( filename.c_str(), std::ofstream::out );
-    write_verilog( ntk, os, ps );
-    os.close();
+    output_buffer out( filename );
+    detail::write_verilog( ntk, out, ps );
   }
-} /* namespace mockturtle */
\ No newline at end of file
+} /* namespace mockturtle */
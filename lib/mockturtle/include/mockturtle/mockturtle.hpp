@@ -33,9 +33,11 @@
 #pragma once
 
 #include "mockturtle/traits.hpp"
+#include "mockturtle/algorithms/bit_parallel_simulation.hpp"
 #include "mockturtle/algorithms/simulation.hpp"
 #include "mockturtle/algorithms/dont_cares.hpp"
 #include "mockturtle/algorithms/equivalence_checking.hpp"
+#include "mockturtle/algorithms/sweeping_equivalence_checking.hpp"
 #include "mockturtle/algorithms/balancing.hpp"
 #include "mockturtle/algorithms/lut_mapping.hpp"
 #include "mockturtle/algorithms/bi_decomposition.hpp"
@@ -83,6 +85,7 @@
 #include "mockturtle/generators/random_logic_generator.hpp"
 #include "mockturtle/generators/modular_arithmetic.hpp"
 #include "mockturtle/io/aiger_reader.hpp"
+#include "mockturtle/io/aiger_mmap_reader.hpp"
 #include "mockturtle/io/write_bench.hpp"
 #include "mockturtle/io/bench_reader.hpp"
 #include "mockturtle/io/verilog_reader.hpp"
@@ -92,7 +95,10 @@
 #include "mockturtle/io/write_dot.hpp"
 #include "mockturtle/io/pla_reader.hpp"
 #include "mockturtle/io/write_dimacs.hpp"
+#include "mockturtle/io/snapshot.hpp"
 #include "mockturtle/networks/aig.hpp"
+#include "mockturtle/networks/compact_aig.hpp"
+#include "mockturtle/networks/compact_mig.hpp"
 #include "mockturtle/networks/events.hpp"
 #include "mockturtle/networks/klut.hpp"
 #include "mockturtle/networks/xmg.hpp"
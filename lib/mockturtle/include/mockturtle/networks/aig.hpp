@@ -47,6 +47,7 @@
 #include "detail/foreach.hpp"
 #include "events.hpp"
 #include "storage.hpp"
+#include "strash_table.hpp"
 
 namespace mockturtle
 {
@@ -86,7 +87,8 @@ struct aig_storage_data
 */
 using aig_storage = storage<regular_node<2, 2, 1>,
                             aig_storage_data,
-                            aig_hash<regular_node<2, 2, 1>>>;
+                            aig_hash<regular_node<2, 2, 1>>,
+                            strash_table<regular_node<2, 2, 1>>>;
 
 class aig_network
 {
@@ -329,10 +331,10 @@ public:
 
     const auto index = _storage->nodes.size();
 
-    if ( index >= .9 * _storage->nodes.capacity() )
+    /* grow only once full, a reservation from reserve_nodes is used up exactly */
+    if ( index >= _storage->nodes.capacity() )
     {
       _storage->nodes.reserve( static_cast<uint64_t>( 3.1415f * index ) );
-      _storage->hash.reserve( static_cast<uint64_t>( 3.1415f * index ) );
     }
 
     _storage->nodes.push_back( node );
@@ -351,6 +353,51 @@ public:
     return {index, 0};
   }
 
+  /*! \brief Appends an AND gate without structural hashing
+
+    For readers of networks that are known to be structurally hashed: the
+    gate is neither looked up in nor inserted into the hash table, which has
+    to be re-created with `rehash_gates` once all gates are created.
+    Trivial cases are still simplified.
+  */
+  signal create_and_unhashed( signal a, signal b )
+  {
+    if ( a.index > b.index )
+    {
+      std::swap( a, b );
+    }
+
+    if ( a.index == b.index )
+    {
+      return ( a.complement == b.complement ) ? a : get_constant( false );
+    }
+    else if ( a.index == 0 )
+    {
+      return a.complement ? b : get_constant( false );
+    }
+
+    const auto index = _storage->nodes.size();
+    auto& node = _storage->nodes.emplace_back();
+    node.children[0] = a;
+    node.children[1] = b;
+
+    _storage->nodes[a.index].data[0].h1++;
+    _storage->nodes[b.index].data[0].h1++;
+
+    for ( auto const& fn : _events->on_add )
+    {
+      fn( index );
+    }
+
+    return {index, 0};
+  }
+
+  /*! \brief Re-creates the structural hash table from all live gates */
+  void rehash_gates()
+  {
+    _storage->hash.rebuild( _storage->nodes, [this]( auto i ) { return !is_ci( i ) && !is_dead( i ); } );
+  }
+
   signal create_nand( signal const& a, signal const& b )
   {
     return !create_and( a, b );
@@ -1083,6 +1130,18 @@ public:
   {
     return *_events;
   }
+
+  /*! \brief Pre-sizes node storage for `num_nodes` nodes in total
+   *
+   * `num_nodes` counts the constant, the combinational inputs and the gates,
+   * e.g., M + 1 from an AIGER header.  The structural hash table is sized for
+   * the same number of entries, so that creating them does not reallocate.
+   */
+  void reserve_nodes( uint64_t num_nodes )
+  {
+    _storage->nodes.reserve( num_nodes );
+    _storage->hash.reserve( num_nodes );
+  }
 #pragma endregion
 
 public:
@@ -0,0 +1,199 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file compact_aig.hpp
+  \brief AIG logic network with 32-bit literals
+*/
+
+#pragma once
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operators.hpp>
+
+#include "detail/compact_network.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief AIG with compact node storage
+
+  Implements the same network interface as `aig_network`, but a node takes 8
+  bytes for its two literal children plus 12 bytes of side data, and the
+  structural hash table stores only node indexes.  Networks are limited to
+  2^31 nodes.
+*/
+class compact_aig_network : public detail::compact_network_base<compact_aig_network, 2>
+{
+public:
+  using base = detail::compact_network_base<compact_aig_network, 2>;
+
+  using base::base;
+
+#pragma region Create binary functions
+  signal create_and( signal a, signal b )
+  {
+    /* order inputs */
+    if ( a.index > b.index )
+    {
+      std::swap( a, b );
+    }
+
+    /* trivial cases */
+    if ( a.index == b.index )
+    {
+      return ( a.complement == b.complement ) ? a : get_constant( false );
+    }
+    else if ( a.index == 0 )
+    {
+      return a.complement ? b : get_constant( false );
+    }
+
+    return create_gate( {a, b} );
+  }
+#pragma endregion
+
+#pragma region Create ternary functions
+  signal create_maj( signal const& a, signal const& b, signal const& c )
+  {
+    return create_or( create_and( a, b ), create_and( c, !create_and( !a, !b ) ) );
+  }
+
+  signal create_maj_part( signal const& a, signal const& b, signal const& c )
+  {
+    return create_maj( a, b, c );
+  }
+
+  signal create_xor3( signal const& a, signal const& b, signal const& c )
+  {
+    return create_xor( create_xor( a, b ), c );
+  }
+#pragma endregion
+
+#pragma region Create arbitrary functions
+  signal clone_node( compact_aig_network const& other, node const& source, std::vector<signal> const& children )
+  {
+    (void)other;
+    (void)source;
+    assert( children.size() == 2u );
+    return create_and( children[0u], children[1u] );
+  }
+#pragma endregion
+
+#pragma region Restructuring
+  /*! \brief Trivial cases of `replace_in_node` on children sorted by index */
+  static std::optional<signal> simplify( std::array<signal, 2> const& fs )
+  {
+    if ( fs[0].index == fs[1].index )
+    {
+      return ( fs[0].complement != fs[1].complement ) ? signal( 0, 0 ) : fs[1];
+    }
+    else if ( fs[0].index == 0 ) /* constant child */
+    {
+      return fs[0].complement ? fs[1] : signal( 0, 0 );
+    }
+    return std::nullopt;
+  }
+#pragma endregion
+
+#pragma region Structural properties
+  bool is_and( node const& n ) const
+  {
+    return n > 0 && !is_ci( n );
+  }
+
+  bool is_maj( node const& n ) const
+  {
+    (void)n;
+    return false;
+  }
+#pragma endregion
+
+#pragma region Functional properties
+  kitty::dynamic_truth_table node_function( const node& n ) const
+  {
+    (void)n;
+    kitty::dynamic_truth_table _and( 2 );
+    _and._bits[0] = 0x8;
+    return _and;
+  }
+#pragma endregion
+
+#pragma region Value simulation
+  template<typename Iterator>
+  iterates_over_t<Iterator, bool>
+  compute( node const& n, Iterator begin, Iterator end ) const
+  {
+    (void)end;
+
+    assert( n != 0 && !is_ci( n ) );
+
+    auto const& children = _storage->nodes[n].children;
+
+    auto v1 = *begin++;
+    auto v2 = *begin++;
+
+    return ( v1 ^ ( children[0] & 1 ) ) && ( v2 ^ ( children[1] & 1 ) );
+  }
+
+  template<typename Iterator>
+  iterates_over_truth_table_t<Iterator>
+  compute( node const& n, Iterator begin, Iterator end ) const
+  {
+    (void)end;
+
+    assert( n != 0 && !is_ci( n ) );
+
+    auto const& children = _storage->nodes[n].children;
+
+    auto tt1 = *begin++;
+    auto tt2 = *begin++;
+
+    return ( ( children[0] & 1 ) ? ~tt1 : tt1 ) & ( ( children[1] & 1 ) ? ~tt2 : tt2 );
+  }
+#pragma endregion
+};
+
+} // namespace mockturtle
+
+namespace std
+{
+
+template<>
+struct hash<mockturtle::compact_aig_network::signal>
+{
+  uint64_t operator()( mockturtle::compact_aig_network::signal const &s ) const noexcept
+  {
+    uint64_t k = s.data;
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+  }
+}; /* hash */
+
+} // namespace std
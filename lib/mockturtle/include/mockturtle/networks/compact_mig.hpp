@@ -0,0 +1,255 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file compact_mig.hpp
+  \brief MIG logic network with 32-bit literals
+*/
+
+#pragma once
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operators.hpp>
+
+#include "detail/compact_network.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief MIG with compact node storage
+
+  Implements the same network interface as `mig_network`, but a node takes 12
+  bytes for its three literal children plus 12 bytes of side data, and the
+  structural hash table stores only node indexes.  Networks are limited to
+  2^31 nodes.
+*/
+class compact_mig_network : public detail::compact_network_base<compact_mig_network, 3>
+{
+public:
+  using base = detail::compact_network_base<compact_mig_network, 3>;
+
+  using base::base;
+
+#pragma region Create binary / ternary functions
+  signal create_maj( signal a, signal b, signal c )
+  {
+    std::array<signal, 3> fs{a, b, c};
+    sort_by_index( fs );
+
+    /* trivial cases */
+    if ( const auto s = simplify( fs ); s )
+    {
+      return *s;
+    }
+
+    /*  complemented edges minimization */
+    auto node_complement = false;
+    if ( static_cast<unsigned>( fs[0].complement ) + static_cast<unsigned>( fs[1].complement ) +
+             static_cast<unsigned>( fs[2].complement ) >=
+         2u )
+    {
+      node_complement = true;
+      for ( auto& f : fs )
+      {
+        f.complement = !f.complement;
+      }
+    }
+
+    return create_gate( fs ) ^ node_complement;
+  }
+
+  signal create_maj_part( signal a, signal b, signal c )
+  {
+    std::array<signal, 3> fs{a, b, c};
+    sort_by_index( fs );
+
+    /* trivial cases */
+    if ( const auto s = simplify( fs ); s )
+    {
+      return *s;
+    }
+
+    return create_gate( fs );
+  }
+
+  signal create_and( signal const& a, signal const& b )
+  {
+    return create_maj( get_constant( false ), a, b );
+  }
+
+  signal create_xor3( signal const& a, signal const& b, signal const& c )
+  {
+    const auto f = create_maj( a, !b, c );
+    const auto g = create_maj( a, b, !c );
+    return create_maj( !a, f, g );
+  }
+#pragma endregion
+
+#pragma region Create arbitrary functions
+  signal clone_node( compact_mig_network const& other, node const& source, std::vector<signal> const& children )
+  {
+    (void)other;
+    (void)source;
+    assert( children.size() == 3u );
+    return create_maj( children[0u], children[1u], children[2u] );
+  }
+#pragma endregion
+
+#pragma region Restructuring
+  /*! \brief Trivial cases of `replace_in_node` on children sorted by index */
+  static std::optional<signal> simplify( std::array<signal, 3> const& fs )
+  {
+    if ( fs[0].index == fs[1].index )
+    {
+      return ( fs[0].complement == fs[1].complement ) ? fs[0] : fs[2];
+    }
+    else if ( fs[1].index == fs[2].index )
+    {
+      return ( fs[1].complement == fs[2].complement ) ? fs[1] : fs[0];
+    }
+    return std::nullopt;
+  }
+
+  void substitute_node_of_parents( std::vector<node> const& parents, node const& old_node, signal const& new_signal )
+  {
+    std::stack<std::pair<node, signal>> to_substitute;
+    to_substitute.push( {old_node, new_signal} );
+
+    while ( !to_substitute.empty() )
+    {
+      const auto [_old, _new] = to_substitute.top();
+      to_substitute.pop();
+
+      for ( auto const& p : parents )
+      {
+        if ( is_ci( p ) || is_dead( p ) )
+          continue; /* ignore CIs and dead nodes */
+
+        if ( const auto repl = replace_in_node( p, _old, _new ); repl )
+        {
+          to_substitute.push( *repl );
+        }
+      }
+
+      /* check outputs */
+      replace_in_outputs( _old, _new );
+
+      // reset fan-in of old node
+      take_out_node( _old );
+    }
+  }
+#pragma endregion
+
+#pragma region Structural properties
+  bool is_and( node const& n ) const
+  {
+    return n > 0 && !is_ci( n ) && _storage->nodes[n].children[0] == 0u;
+  }
+
+  bool is_maj( node const& n ) const
+  {
+    return n > 0 && !is_ci( n );
+  }
+#pragma endregion
+
+#pragma region Functional properties
+  kitty::dynamic_truth_table node_function( const node& n ) const
+  {
+    (void)n;
+    kitty::dynamic_truth_table _maj( 3 );
+    _maj._bits[0] = 0xe8;
+    return _maj;
+  }
+#pragma endregion
+
+#pragma region Value simulation
+  template<typename Iterator>
+  iterates_over_t<Iterator, bool>
+  compute( node const& n, Iterator begin, Iterator end ) const
+  {
+    (void)end;
+
+    assert( n != 0 && !is_ci( n ) );
+
+    auto const& children = _storage->nodes[n].children;
+
+    auto v1 = *begin++ ^ ( children[0] & 1 );
+    auto v2 = *begin++ ^ ( children[1] & 1 );
+    auto v3 = *begin++ ^ ( children[2] & 1 );
+
+    return ( v1 && v2 ) || ( v3 && v1 ) || ( v3 && v2 );
+  }
+
+  template<typename Iterator>
+  iterates_over_truth_table_t<Iterator>
+  compute( node const& n, Iterator begin, Iterator end ) const
+  {
+    (void)end;
+
+    assert( n != 0 && !is_ci( n ) );
+
+    auto const& children = _storage->nodes[n].children;
+
+    auto tt1 = *begin++;
+    auto tt2 = *begin++;
+    auto tt3 = *begin++;
+
+    return kitty::ternary_majority( ( children[0] & 1 ) ? ~tt1 : tt1, ( children[1] & 1 ) ? ~tt2 : tt2, ( children[2] & 1 ) ? ~tt3 : tt3 );
+  }
+#pragma endregion
+
+private:
+  static void sort_by_index( std::array<signal, 3>& fs )
+  {
+    if ( fs[0].index > fs[1].index )
+      std::swap( fs[0], fs[1] );
+    if ( fs[1].index > fs[2].index )
+      std::swap( fs[1], fs[2] );
+    if ( fs[0].index > fs[1].index )
+      std::swap( fs[0], fs[1] );
+  }
+};
+
+} // namespace mockturtle
+
+namespace std
+{
+
+template<>
+struct hash<mockturtle::compact_mig_network::signal>
+{
+  uint64_t operator()( mockturtle::compact_mig_network::signal const &s ) const noexcept
+  {
+    uint64_t k = s.data;
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+  }
+}; /* hash */
+
+} // namespace std
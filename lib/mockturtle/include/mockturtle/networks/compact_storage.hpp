@@ -0,0 +1,254 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file compact_storage.hpp
+  \brief Storage with 32-bit literals for compact AIGs and MIGs
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "storage.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Node of a compact network
+
+  Children are 32-bit literals, `( index << 1 ) | complement`.  Combinational
+  inputs have all children set to their input index, which cannot happen for
+  a gate since structural hashing removes gates with equal children.
+*/
+template<int Fanin>
+struct compact_node
+{
+  std::array<uint32_t, Fanin> children{};
+
+  bool operator==( compact_node<Fanin> const& other ) const
+  {
+    return children == other.children;
+  }
+};
+
+/*! \brief Per-node data of a compact network, kept apart from the nodes
+
+  `fanout`: Fan-out size (we use MSB to indicate whether a node is dead)
+  `value`: Application-specific value
+  `visited`: Visited flag
+*/
+struct compact_node_data
+{
+  uint32_t fanout{0};
+  uint32_t value{0};
+  uint32_t visited{0};
+};
+
+/*! \brief Index-only structural hash table
+
+  Open addressing with linear probing over a power-of-two array of node
+  indexes.  Keys are not stored: a probe re-reads the children of the node it
+  finds from the node array, so the table costs 4 bytes per slot.  Index 0 is
+  the constant node, which is never hashed, and marks an empty slot.
+*/
+template<int Fanin>
+class compact_strash
+{
+public:
+  using key_type = std::array<uint32_t, Fanin>;
+
+  static constexpr uint32_t empty = 0u;
+  static constexpr uint32_t deleted = UINT32_MAX;
+
+  static uint64_t hash( key_type const& key )
+  {
+    uint64_t seed = 0x9e3779b97f4a7c15;
+    for ( auto const& lit : key )
+    {
+      hash_combine( seed, lit );
+    }
+    return seed;
+  }
+
+  template<class Nodes>
+  uint32_t find( key_type const& key, Nodes const& nodes ) const
+  {
+    if ( _slots.empty() )
+      return 0u;
+
+    const auto mask = _slots.size() - 1u;
+    for ( auto i = hash( key ) & mask;; i = ( i + 1u ) & mask )
+    {
+      const auto index = _slots[i];
+      if ( index == empty )
+        return 0u;
+      if ( index != deleted && nodes[index].children == key )
+        return index;
+    }
+  }
+
+  template<class Nodes>
+  void insert( uint32_t index, Nodes const& nodes )
+  {
+    if ( 2u * ( _size + _deleted + 1u ) > _slots.size() )
+    {
+      rehash( std::max<std::size_t>( 4u * ( _size + 1u ), 64u ), nodes );
+    }
+    place( index, nodes );
+    ++_size;
+  }
+
+  /*! \brief Removes `index`, whose children must still be those it was inserted with. */
+  template<class Nodes>
+  void erase( uint32_t index, Nodes const& nodes )
+  {
+    if ( _slots.empty() )
+      return;
+
+    const auto mask = _slots.size() - 1u;
+    for ( auto i = hash( nodes[index].children ) & mask;; i = ( i + 1u ) & mask )
+    {
+      if ( _slots[i] == empty )
+        return;
+      if ( _slots[i] == index )
+      {
+        _slots[i] = deleted;
+        --_size;
+        ++_deleted;
+        return;
+      }
+    }
+  }
+
+  template<class Nodes>
+  void reserve( std::size_t n, Nodes const& nodes )
+  {
+    if ( 2u * n > _slots.size() )
+    {
+      rehash( 2u * n, nodes );
+    }
+  }
+
+  std::size_t size() const
+  {
+    return _size;
+  }
+
+  std::size_t capacity() const
+  {
+    return _slots.size();
+  }
+
+private:
+  template<class Nodes>
+  void place( uint32_t index, Nodes const& nodes )
+  {
+    const auto mask = _slots.size() - 1u;
+    auto i = hash( nodes[index].children ) & mask;
+    while ( _slots[i] != empty && _slots[i] != deleted )
+    {
+      i = ( i + 1u ) & mask;
+    }
+    if ( _slots[i] == deleted )
+    {
+      --_deleted;
+    }
+    _slots[i] = index;
+  }
+
+  template<class Nodes>
+  void rehash( std::size_t min_slots, Nodes const& nodes )
+  {
+    std::size_t num_slots = 64u;
+    while ( num_slots < min_slots )
+    {
+      num_slots <<= 1u;
+    }
+
+    std::vector<uint32_t> old_slots( num_slots, empty );
+    old_slots.swap( _slots );
+    _deleted = 0u;
+    for ( auto index : old_slots )
+    {
+      if ( index != empty && index != deleted )
+      {
+        place( index, nodes );
+      }
+    }
+  }
+
+  std::vector<uint32_t> _slots;
+  std::size_t _size{0u};
+  std::size_t _deleted{0u};
+};
+
+struct compact_storage_data
+{
+  uint32_t num_pis = 0u;
+  uint32_t num_pos = 0u;
+  std::vector<int8_t> latches;
+  uint32_t trav_id = 0u;
+};
+
+/*! \brief Storage container of compact networks
+
+  Nodes hold only their children, per-node data lives in `node_data` at the
+  same index, and outputs are stored as literals.
+*/
+template<int Fanin>
+struct compact_storage
+{
+  compact_storage()
+  {
+    nodes.reserve( 10000u );
+    node_data.reserve( 10000u );
+
+    /* we generally reserve the first node for a constant */
+    nodes.emplace_back();
+    node_data.emplace_back();
+  }
+
+  using node_type = compact_node<Fanin>;
+
+  std::vector<node_type> nodes;
+  std::vector<compact_node_data> node_data;
+  std::vector<uint32_t> inputs;
+  std::vector<uint32_t> outputs;
+
+  std::string net_name;
+  std::unordered_map<uint64_t, latch_info> latch_information;
+
+  compact_strash<Fanin> hash;
+
+  compact_storage_data data;
+};
+
+} /* namespace mockturtle */
@@ -0,0 +1,935 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file compact_network.hpp
+  \brief Common implementation of compact AIGs and MIGs
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include <ez/direct_iterator.hpp>
+
+#include "../../traits.hpp"
+#include "../../utils/algorithm.hpp"
+#include "../compact_storage.hpp"
+#include "../events.hpp"
+#include "foreach.hpp"
+
+namespace mockturtle
+{
+
+namespace detail
+{
+
+/*! \brief Network interface shared by `compact_aig_network` and `compact_mig_network`
+ *
+ * `Ntk` is the derived network, which implements gate creation, the trivial
+ * cases of `replace_in_node` (as `simplify`) and simulation.
+ */
+template<class Ntk, int Fanin>
+class compact_network_base
+{
+public:
+#pragma region Types and constructors
+  static constexpr auto min_fanin_size = static_cast<uint32_t>( Fanin );
+  static constexpr auto max_fanin_size = static_cast<uint32_t>( Fanin );
+
+  using base_type = Ntk;
+  using storage = std::shared_ptr<compact_storage<Fanin>>;
+  using node = uint32_t;
+
+  struct signal
+  {
+    signal() = default;
+
+    signal( uint32_t index, uint32_t complement )
+        : complement( complement ), index( index )
+    {
+    }
+
+    explicit signal( uint32_t data )
+        : data( data )
+    {
+    }
+
+    union {
+      struct
+      {
+        uint32_t complement : 1;
+        uint32_t index : 31;
+      };
+      uint32_t data;
+    };
+
+    signal operator!() const
+    {
+      return signal( data ^ 1 );
+    }
+
+    signal operator+() const
+    {
+      return {index, 0};
+    }
+
+    signal operator-() const
+    {
+      return {index, 1};
+    }
+
+    signal operator^( bool complement ) const
+    {
+      return signal( data ^ ( complement ? 1 : 0 ) );
+    }
+
+    bool operator==( signal const& other ) const
+    {
+      return data == other.data;
+    }
+
+    bool operator!=( signal const& other ) const
+    {
+      return data != other.data;
+    }
+
+    bool operator<( signal const& other ) const
+    {
+      return data < other.data;
+    }
+  };
+
+  compact_network_base()
+      : _storage( std::make_shared<compact_storage<Fanin>>() ),
+        _events( std::make_shared<network_events<base_type>>() )
+  {
+  }
+
+  compact_network_base( storage s )
+      : _storage( s ),
+        _events( std::make_shared<network_events<base_type>>() )
+  {
+  }
+#pragma endregion
+
+#pragma region Primary I / O and constants
+  signal get_constant( bool value ) const
+  {
+    return {0, static_cast<uint32_t>( value ? 1 : 0 )};
+  }
+
+  signal create_pi( std::string const& name = {} )
+  {
+    (void)name;
+
+    const auto index = create_ci();
+    ++_storage->data.num_pis;
+    return {index, 0};
+  }
+
+  uint32_t create_po( signal const& f, std::string const& name = {} )
+  {
+    (void)name;
+
+    /* increase ref-count to children */
+    _storage->node_data[f.index].fanout++;
+    auto const po_index = static_cast<uint32_t>( _storage->outputs.size() );
+    _storage->outputs.emplace_back( f.data );
+    ++_storage->data.num_pos;
+    return po_index;
+  }
+
+  signal create_ro( std::string const& name = {} )
+  {
+    (void)name;
+
+    return {create_ci(), 0};
+  }
+
+  uint32_t create_ri( signal const& f, int8_t reset = 0, std::string const& name = {} )
+  {
+    (void)name;
+
+    /* increase ref-count to children */
+    _storage->node_data[f.index].fanout++;
+    auto const ri_index = static_cast<uint32_t>( _storage->outputs.size() );
+    _storage->outputs.emplace_back( f.data );
+    _storage->data.latches.emplace_back( reset );
+    return ri_index;
+  }
+
+  int8_t latch_reset( uint32_t index ) const
+  {
+    assert( index < _storage->data.latches.size() );
+    return _storage->data.latches[index];
+  }
+
+  bool is_combinational() const
+  {
+    return ( static_cast<uint32_t>( _storage->inputs.size() ) == _storage->data.num_pis &&
+             static_cast<uint32_t>( _storage->outputs.size() ) == _storage->data.num_pos );
+  }
+
+  bool is_constant( node const& n ) const
+  {
+    return n == 0;
+  }
+
+  bool is_ci( node const& n ) const
+  {
+    auto const& children = _storage->nodes[n].children;
+    return n != 0 && std::all_of( children.begin() + 1, children.end(), [&]( auto c ) { return c == children[0]; } );
+  }
+
+  bool is_pi( node const& n ) const
+  {
+    return is_ci( n ) && _storage->nodes[n].children[0] < _storage->data.num_pis;
+  }
+
+  bool is_ro( node const& n ) const
+  {
+    return is_ci( n ) && _storage->nodes[n].children[0] >= _storage->data.num_pis;
+  }
+
+  bool is_po( node const& n ) const
+  {
+    return std::any_of( _storage->outputs.begin(), _storage->outputs.end(), [&]( auto lit ) { return ( lit >> 1 ) == n; } );
+  }
+
+  bool constant_value( node const& n ) const
+  {
+    (void)n;
+    return false;
+  }
+#pragma endregion
+
+#pragma region Create unary functions
+  signal create_buf( signal const& a )
+  {
+    return a;
+  }
+
+  signal create_not( signal const& a )
+  {
+    return !a;
+  }
+#pragma endregion
+
+#pragma region Create binary functions
+  signal create_nand( signal const& a, signal const& b )
+  {
+    return !ntk().create_and( a, b );
+  }
+
+  signal create_or( signal const& a, signal const& b )
+  {
+    return !ntk().create_and( !a, !b );
+  }
+
+  signal create_nor( signal const& a, signal const& b )
+  {
+    return ntk().create_and( !a, !b );
+  }
+
+  signal create_lt( signal const& a, signal const& b )
+  {
+    return ntk().create_and( !a, b );
+  }
+
+  signal create_le( signal const& a, signal const& b )
+  {
+    return !ntk().create_and( a, !b );
+  }
+
+  signal create_xor( signal const& a, signal const& b )
+  {
+    const auto fcompl = a.complement ^ b.complement;
+    const auto c1 = ntk().create_and( +a, -b );
+    const auto c2 = ntk().create_and( +b, -a );
+    return ntk().create_and( !c1, !c2 ) ^ !fcompl;
+  }
+
+  signal create_xnor( signal const& a, signal const& b )
+  {
+    return !create_xor( a, b );
+  }
+
+  signal create_ite( signal cond, signal f_then, signal f_else )
+  {
+    bool f_compl{false};
+    if ( f_then.index < f_else.index )
+    {
+      std::swap( f_then, f_else );
+      cond.complement ^= 1;
+    }
+    if ( f_then.complement )
+    {
+      f_then.complement = 0;
+      f_else.complement ^= 1;
+      f_compl = true;
+    }
+
+    return ntk().create_and( !ntk().create_and( !cond, f_else ), !ntk().create_and( cond, f_then ) ) ^ !f_compl;
+  }
+#pragma endregion
+
+#pragma region Create nary functions
+  signal create_nary_and( std::vector<signal> const& fs )
+  {
+    return tree_reduce( fs.begin(), fs.end(), get_constant( true ), [this]( auto const& a, auto const& b ) { return ntk().create_and( a, b ); } );
+  }
+
+  signal create_nary_or( std::vector<signal> const& fs )
+  {
+    return tree_reduce( fs.begin(), fs.end(), get_constant( false ), [this]( auto const& a, auto const& b ) { return create_or( a, b ); } );
+  }
+
+  signal create_nary_xor( std::vector<signal> const& fs )
+  {
+    return tree_reduce( fs.begin(), fs.end(), get_constant( false ), [this]( auto const& a, auto const& b ) { return ntk().create_xor( a, b ); } );
+  }
+#pragma endregion
+
+#pragma region Restructuring
+  std::optional<std::pair<node, signal>> replace_in_node( node const& n, node const& old_node, signal new_signal )
+  {
+    auto& nobj = _storage->nodes[n];
+
+    std::array<signal, Fanin> fs;
+    auto fanin = Fanin;
+    for ( auto i = 0; i < Fanin; ++i )
+    {
+      fs[i] = signal( nobj.children[i] );
+      if ( fanin == Fanin && fs[i].index == old_node )
+      {
+        fanin = i;
+      }
+    }
+    if ( fanin == Fanin )
+    {
+      return std::nullopt;
+    }
+    new_signal.complement ^= fs[fanin].complement;
+    fs[fanin] = new_signal;
+
+    // determine potential new children of node n
+    std::sort( fs.begin(), fs.end(), []( auto const& a, auto const& b ) { return a.index < b.index; } );
+
+    // check for trivial cases?
+    if ( const auto s = Ntk::simplify( fs ); s )
+    {
+      return std::make_pair( n, *s );
+    }
+
+    // node already in hash table
+    const auto key = to_key( fs );
+    if ( const auto index = _storage->hash.find( key, _storage->nodes ); index != 0 )
+    {
+      return std::make_pair( n, signal( index, 0 ) );
+    }
+
+    // remember before
+    std::vector<signal> old_children;
+    for ( auto c : nobj.children )
+    {
+      old_children.emplace_back( c );
+    }
+
+    // erase old node in hash table, and insert updated node
+    _storage->hash.erase( n, _storage->nodes );
+    nobj.children = key;
+    _storage->hash.insert( n, _storage->nodes );
+
+    // update the reference counter of the new signal
+    _storage->node_data[new_signal.index].fanout++;
+
+    for ( auto const& fn : _events->on_modified )
+    {
+      fn( n, old_children );
+    }
+
+    return std::nullopt;
+  }
+
+  void replace_in_outputs( node const& old_node, signal const& new_signal )
+  {
+    for ( auto& output : _storage->outputs )
+    {
+      if ( ( output >> 1 ) == old_node )
+      {
+        output = ( new_signal ^ static_cast<bool>( output & 1 ) ).data;
+
+        // increment fan-in of new node
+        _storage->node_data[new_signal.index].fanout++;
+      }
+    }
+  }
+
+  void take_out_node( node const& n )
+  {
+    /* we cannot delete CIs or constants */
+    if ( n == 0 || is_ci( n ) )
+      return;
+
+    _storage->node_data[n].fanout = UINT32_C( 0x80000000 ); /* fanout size 0, but dead */
+    _storage->hash.erase( n, _storage->nodes );
+
+    for ( auto const& fn : _events->on_delete )
+    {
+      fn( n );
+    }
+
+    for ( auto c : _storage->nodes[n].children )
+    {
+      const auto child = c >> 1;
+      if ( fanout_size( child ) == 0 )
+      {
+        continue;
+      }
+      if ( decr_fanout_size( child ) == 0 )
+      {
+        take_out_node( child );
+      }
+    }
+  }
+
+  inline bool is_dead( node const& n ) const
+  {
+    return ( _storage->node_data[n].fanout >> 31 ) & 1;
+  }
+
+  void substitute_node( node const& old_node, signal const& new_signal )
+  {
+    std::stack<std::pair<node, signal>> to_substitute;
+    to_substitute.push( {old_node, new_signal} );
+
+    while ( !to_substitute.empty() )
+    {
+      const auto [_old, _new] = to_substitute.top();
+      to_substitute.pop();
+
+      for ( auto idx = 1u; idx < _storage->nodes.size(); ++idx )
+      {
+        if ( is_ci( idx ) || is_dead( idx ) )
+          continue; /* ignore CIs and dead nodes */
+
+        if ( const auto repl = replace_in_node( idx, _old, _new ); repl )
+        {
+          to_substitute.push( *repl );
+        }
+      }
+
+      /* check outputs */
+      replace_in_outputs( _old, _new );
+
+      // reset fan-in of old node
+      take_out_node( _old );
+    }
+  }
+#pragma endregion
+
+#pragma region Structural properties
+  auto size() const
+  {
+    return static_cast<uint32_t>( _storage->nodes.size() );
+  }
+
+  auto num_cis() const
+  {
+    return static_cast<uint32_t>( _storage->inputs.size() );
+  }
+
+  auto num_cos() const
+  {
+    return static_cast<uint32_t>( _storage->outputs.size() );
+  }
+
+  uint32_t num_latches() const
+  {
+    return static_cast<uint32_t>( _storage->data.latches.size() );
+  }
+
+  auto num_pis() const
+  {
+    return static_cast<uint32_t>( _storage->inputs.size() );
+  }
+
+  auto num_pos() const
+  {
+    return static_cast<uint32_t>( _storage->outputs.size() );
+  }
+
+  auto num_registers() const
+  {
+    assert( static_cast<uint32_t>( _storage->inputs.size() - _storage->data.num_pis ) == static_cast<uint32_t>( _storage->outputs.size() - _storage->data.num_pos ) );
+    return static_cast<uint32_t>( _storage->inputs.size() - _storage->data.num_pis );
+  }
+
+  auto num_gates() const
+  {
+    return static_cast<uint32_t>( _storage->hash.size() );
+  }
+
+  uint32_t fanin_size( node const& n ) const
+  {
+    if ( is_constant( n ) || is_ci( n ) )
+      return 0;
+    return Fanin;
+  }
+
+  uint32_t fanout_size( node const& n ) const
+  {
+    return _storage->node_data[n].fanout & UINT32_C( 0x7FFFFFFF );
+  }
+
+  uint32_t incr_fanout_size( node const& n ) const
+  {
+    return _storage->node_data[n].fanout++ & UINT32_C( 0x7FFFFFFF );
+  }
+
+  uint32_t decr_fanout_size( node const& n ) const
+  {
+    return --_storage->node_data[n].fanout & UINT32_C( 0x7FFFFFFF );
+  }
+
+  bool is_or( node const& n ) const
+  {
+    (void)n;
+    return false;
+  }
+
+  bool is_xor( node const& n ) const
+  {
+    (void)n;
+    return false;
+  }
+
+  bool is_ite( node const& n ) const
+  {
+    (void)n;
+    return false;
+  }
+
+  bool is_xor3( node const& n ) const
+  {
+    (void)n;
+    return false;
+  }
+#pragma endregion
+
+#pragma region Nodes and signals
+  node get_node( signal const& f ) const
+  {
+    return f.index;
+  }
+
+  signal make_signal( node const& n ) const
+  {
+    return signal( n, 0 );
+  }
+
+  bool is_complemented( signal const& f ) const
+  {
+    return f.complement;
+  }
+
+  uint32_t node_to_index( node const& n ) const
+  {
+    return n;
+  }
+
+  node index_to_node( uint32_t index ) const
+  {
+    return index;
+  }
+
+  node ci_at( uint32_t index ) const
+  {
+    assert( index < _storage->inputs.size() );
+    return _storage->inputs[index];
+  }
+
+  signal co_at( uint32_t index ) const
+  {
+    assert( index < _storage->outputs.size() );
+    return signal( _storage->outputs[index] );
+  }
+
+  node pi_at( uint32_t index ) const
+  {
+    assert( index < _storage->data.num_pis );
+    return _storage->inputs[index];
+  }
+
+  signal po_at( uint32_t index ) const
+  {
+    assert( index < _storage->data.num_pos );
+    return signal( _storage->outputs[index] );
+  }
+
+  node ro_at( uint32_t index ) const
+  {
+    assert( index < _storage->inputs.size() - _storage->data.num_pis );
+    return _storage->inputs[_storage->data.num_pis + index];
+  }
+
+  signal ri_at( uint32_t index ) const
+  {
+    assert( index < _storage->outputs.size() - _storage->data.num_pos );
+    return signal( _storage->outputs[_storage->data.num_pos + index] );
+  }
+
+  uint32_t ci_index( node const& n ) const
+  {
+    assert( is_ci( n ) );
+    return _storage->nodes[n].children[0];
+  }
+
+  uint32_t co_index( signal const& s ) const
+  {
+    const auto it = std::find( _storage->outputs.begin(), _storage->outputs.end(), s.data );
+    return it == _storage->outputs.end() ? -1 : static_cast<uint32_t>( it - _storage->outputs.begin() );
+  }
+
+  uint32_t pi_index( node const& n ) const
+  {
+    assert( is_ci( n ) );
+    return _storage->nodes[n].children[0];
+  }
+
+  uint32_t po_index( signal const& s ) const
+  {
+    return co_index( s );
+  }
+
+  uint32_t ro_index( node const& n ) const
+  {
+    assert( is_ci( n ) );
+    return _storage->nodes[n].children[0] - _storage->data.num_pis;
+  }
+
+  uint32_t ri_index( signal const& s ) const
+  {
+    const auto begin = _storage->outputs.begin() + _storage->data.num_pos;
+    const auto it = std::find( begin, _storage->outputs.end(), s.data );
+    return it == _storage->outputs.end() ? -1 : static_cast<uint32_t>( it - begin );
+  }
+
+  signal ro_to_ri( signal const& s ) const
+  {
+    return signal( _storage->outputs[_storage->data.num_pos + _storage->nodes[s.index].children[0] - _storage->data.num_pis] );
+  }
+
+  node ri_to_ro( signal const& s ) const
+  {
+    return _storage->inputs[_storage->data.num_pis + ri_index( s )];
+  }
+#pragma endregion
+
+#pragma region Node and signal iterators
+  template<typename Fn>
+  void foreach_node( Fn&& fn ) const
+  {
+    detail::foreach_element_if( ez::make_direct_iterator<uint32_t>( 0 ),
+                                ez::make_direct_iterator<uint32_t>( static_cast<uint32_t>( _storage->nodes.size() ) ),
+                                [this]( auto n ) { return !is_dead( n ); },
+                                fn );
+  }
+
+  template<typename Fn>
+  void foreach_ci( Fn&& fn ) const
+  {
+    detail::foreach_element( _storage->inputs.begin(), _storage->inputs.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_co( Fn&& fn ) const
+  {
+    foreach_literal( _storage->outputs.begin(), _storage->outputs.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_pi( Fn&& fn ) const
+  {
+    detail::foreach_element( _storage->inputs.begin(), _storage->inputs.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_po( Fn&& fn ) const
+  {
+    foreach_literal( _storage->outputs.begin(), _storage->outputs.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_ro( Fn&& fn ) const
+  {
+    detail::foreach_element( _storage->inputs.begin() + _storage->data.num_pis, _storage->inputs.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_ri( Fn&& fn ) const
+  {
+    foreach_literal( _storage->outputs.begin() + _storage->data.num_pos, _storage->outputs.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_register( Fn&& fn ) const
+  {
+    static_assert( detail::is_callable_with_index_v<Fn, std::pair<signal, node>, void> ||
+                   detail::is_callable_without_index_v<Fn, std::pair<signal, node>, void> ||
+                   detail::is_callable_with_index_v<Fn, std::pair<signal, node>, bool> ||
+                   detail::is_callable_without_index_v<Fn, std::pair<signal, node>, bool> );
+
+    assert( _storage->inputs.size() - _storage->data.num_pis == _storage->outputs.size() - _storage->data.num_pos );
+    const auto num_registers = _storage->inputs.size() - _storage->data.num_pis;
+    for ( auto i = 0u; i < num_registers; ++i )
+    {
+      const auto reg = std::make_pair( signal( _storage->outputs[_storage->data.num_pos + i] ), node( _storage->inputs[_storage->data.num_pis + i] ) );
+      if constexpr ( detail::is_callable_without_index_v<Fn, std::pair<signal, node>, bool> )
+      {
+        if ( !fn( reg ) )
+          return;
+      }
+      else if constexpr ( detail::is_callable_with_index_v<Fn, std::pair<signal, node>, bool> )
+      {
+        if ( !fn( reg, i ) )
+          return;
+      }
+      else if constexpr ( detail::is_callable_without_index_v<Fn, std::pair<signal, node>, void> )
+      {
+        fn( reg );
+      }
+      else
+      {
+        fn( reg, i );
+      }
+    }
+  }
+
+  template<typename Fn>
+  void foreach_gate( Fn&& fn ) const
+  {
+    detail::foreach_element_if( ez::make_direct_iterator<uint32_t>( 1 ), /* start from 1 to avoid constant */
+                                ez::make_direct_iterator<uint32_t>( static_cast<uint32_t>( _storage->nodes.size() ) ),
+                                [this]( auto n ) { return !is_ci( n ) && !is_dead( n ); },
+                                fn );
+  }
+
+  template<typename Fn>
+  void foreach_fanin( node const& n, Fn&& fn ) const
+  {
+    if ( n == 0 || is_ci( n ) )
+      return;
+
+    static_assert( detail::is_callable_without_index_v<Fn, signal, bool> ||
+                   detail::is_callable_with_index_v<Fn, signal, bool> ||
+                   detail::is_callable_without_index_v<Fn, signal, void> ||
+                   detail::is_callable_with_index_v<Fn, signal, void> );
+
+    auto const& children = _storage->nodes[n].children;
+    for ( auto i = 0u; i < static_cast<uint32_t>( Fanin ); ++i )
+    {
+      if constexpr ( detail::is_callable_without_index_v<Fn, signal, bool> )
+      {
+        if ( !fn( signal( children[i] ) ) )
+          return;
+      }
+      else if constexpr ( detail::is_callable_with_index_v<Fn, signal, bool> )
+      {
+        if ( !fn( signal( children[i] ), i ) )
+          return;
+      }
+      else if constexpr ( detail::is_callable_without_index_v<Fn, signal, void> )
+      {
+        fn( signal( children[i] ) );
+      }
+      else
+      {
+        fn( signal( children[i] ), i );
+      }
+    }
+  }
+#pragma endregion
+
+#pragma region Custom node values
+  void clear_values() const
+  {
+    std::for_each( _storage->node_data.begin(), _storage->node_data.end(), []( auto& d ) { d.value = 0; } );
+  }
+
+  auto value( node const& n ) const
+  {
+    return _storage->node_data[n].value;
+  }
+
+  void set_value( node const& n, uint32_t v ) const
+  {
+    _storage->node_data[n].value = v;
+  }
+
+  auto incr_value( node const& n ) const
+  {
+    return _storage->node_data[n].value++;
+  }
+
+  auto decr_value( node const& n ) const
+  {
+    return --_storage->node_data[n].value;
+  }
+#pragma endregion
+
+#pragma region Visited flags
+  void clear_visited() const
+  {
+    std::for_each( _storage->node_data.begin(), _storage->node_data.end(), []( auto& d ) { d.visited = 0; } );
+  }
+
+  auto visited( node const& n ) const
+  {
+    return _storage->node_data[n].visited;
+  }
+
+  void set_visited( node const& n, uint32_t v ) const
+  {
+    _storage->node_data[n].visited = v;
+  }
+
+  uint32_t trav_id() const
+  {
+    return _storage->data.trav_id;
+  }
+
+  void incr_trav_id() const
+  {
+    ++_storage->data.trav_id;
+  }
+#pragma endregion
+
+#pragma region General methods
+  auto& events() const
+  {
+    return *_events;
+  }
+
+  /*! \brief Pre-sizes node storage for `num_nodes` nodes in total
+   *
+   * `num_nodes` counts the constant, the combinational inputs and the gates,
+   * e.g., M + 1 from an AIGER header.  The structural hash table is sized for
+   * the same number of entries, so that creating them does not reallocate.
+   */
+  void reserve_nodes( uint64_t num_nodes )
+  {
+    _storage->nodes.reserve( num_nodes );
+    _storage->node_data.reserve( num_nodes );
+    _storage->hash.reserve( num_nodes, _storage->nodes );
+  }
+#pragma endregion
+
+protected:
+  Ntk& ntk()
+  {
+    return static_cast<Ntk&>( *this );
+  }
+
+  static std::array<uint32_t, Fanin> to_key( std::array<signal, Fanin> const& fs )
+  {
+    std::array<uint32_t, Fanin> key;
+    for ( auto i = 0; i < Fanin; ++i )
+    {
+      key[i] = fs[i].data;
+    }
+    return key;
+  }
+
+  node create_ci()
+  {
+    const auto index = static_cast<node>( _storage->nodes.size() );
+    auto& nobj = _storage->nodes.emplace_back();
+    nobj.children.fill( static_cast<uint32_t>( _storage->inputs.size() ) );
+    _storage->node_data.emplace_back();
+    _storage->inputs.emplace_back( index );
+    return index;
+  }
+
+  /*! \brief Returns the gate with children `fs` (sorted by index), creating it if needed. */
+  signal create_gate( std::array<signal, Fanin> const& fs )
+  {
+    const auto key = to_key( fs );
+
+    /* structural hashing */
+    if ( const auto existing = _storage->hash.find( key, _storage->nodes ); existing != 0 )
+    {
+      return {existing, 0};
+    }
+
+    const auto index = static_cast<node>( _storage->nodes.size() );
+
+    /* grow only once full, a reservation from reserve_nodes is used up exactly */
+    if ( index >= _storage->nodes.capacity() )
+    {
+      _storage->nodes.reserve( static_cast<uint64_t>( 3.1415f * index ) );
+      _storage->node_data.reserve( static_cast<uint64_t>( 3.1415f * index ) );
+    }
+
+    _storage->nodes.emplace_back().children = key;
+    _storage->node_data.emplace_back();
+    _storage->hash.insert( index, _storage->nodes );
+
+    /* increase ref-count to children */
+    for ( auto const& f : fs )
+    {
+      _storage->node_data[f.index].fanout++;
+    }
+
+    for ( auto const& fn : _events->on_add )
+    {
+      fn( index );
+    }
+
+    return {index, 0};
+  }
+
+  template<class Iterator, class Fn>
+  void foreach_literal( Iterator begin, Iterator end, Fn&& fn ) const
+  {
+    detail::foreach_element_transform<Iterator, signal>( begin, end, []( auto lit ) { return signal( lit ); }, fn );
+  }
+
+public:
+  std::shared_ptr<compact_storage<Fanin>> _storage;
+  std::shared_ptr<network_events<base_type>> _events;
+};
+
+} // namespace detail
+
+} // namespace mockturtle
@@ -46,6 +46,7 @@
 #include "detail/foreach.hpp"
 #include "events.hpp"
 #include "storage.hpp"
+#include "strash_table.hpp"
 
 namespace mockturtle
 {
@@ -71,7 +72,9 @@ struct mig_storage_data
 
 using mig_node = regular_node<3, 2, 1>;
 using mig_storage = storage<mig_node,
-                            mig_storage_data>;
+                            mig_storage_data,
+                            node_hash<mig_node>,
+                            strash_table<mig_node>>;
 
 class mig_network
 {
@@ -337,10 +340,10 @@ public:
 
     const auto index = _storage->nodes.size();
 
-    if ( index >= .9 * _storage->nodes.capacity() )
+    /* grow only once full, a reservation from reserve_nodes is used up exactly */
+    if ( index >= _storage->nodes.capacity() )
     {
       _storage->nodes.reserve( static_cast<uint64_t>( 3.1415f * index ) );
-      _storage->hash.reserve( static_cast<uint64_t>( 3.1415f * index ) );
     }
 
     _storage->nodes.push_back( node );
@@ -407,10 +410,10 @@ public:
 
     const auto index = _storage->nodes.size();
 
-    if ( index >= .9 * _storage->nodes.capacity() )
+    /* grow only once full, a reservation from reserve_nodes is used up exactly */
+    if ( index >= _storage->nodes.capacity() )
     {
       _storage->nodes.reserve( static_cast<uint64_t>( 3.1415f * index ) );
-      _storage->hash.reserve( static_cast<uint64_t>( 3.1415f * index ) );
     }
 
     _storage->nodes.push_back( node );
@@ -1202,6 +1205,18 @@ public:
   {
     return *_events;
   }
+
+  /*! \brief Pre-sizes node storage for `num_nodes` nodes in total
+   *
+   * `num_nodes` counts the constant, the combinational inputs and the gates,
+   * e.g., M + 1 from an AIGER header.  The structural hash table is sized for
+   * the same number of entries, so that creating them does not reallocate.
+   */
+  void reserve_nodes( uint64_t num_nodes )
+  {
+    _storage->nodes.reserve( num_nodes );
+    _storage->hash.reserve( num_nodes );
+  }
 #pragma endregion
 
 public:
@@ -187,7 +187,8 @@ struct empty_storage_data
 {
 };
 
-template<typename Node, typename T = empty_storage_data, typename NodeHasher = node_hash<Node>>
+template<typename Node, typename T = empty_storage_data, typename NodeHasher = node_hash<Node>,
+         typename HashTable = spp::sparse_hash_map<Node, std::size_t, NodeHasher>>
 struct storage
 {
   storage()
@@ -210,7 +211,7 @@ struct storage
   std::unordered_map<uint64_t, latch_info> latch_information;
   // std::unordered_map<node_type, latch_info> latch_information;
 
-  spp::sparse_hash_map<node_type, std::size_t, NodeHasher> hash;
+  HashTable hash;
 
   T data;
 };
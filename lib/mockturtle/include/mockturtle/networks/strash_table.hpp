@@ -0,0 +1,375 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file strash_table.hpp
+  \brief Flat structural hash table for 2- and 3-input nodes
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace mockturtle
+{
+
+/*! \brief Open-addressing structural hash table
+
+  Maps the children of a node to its index.  Keys are the child literals
+  packed into 32 bits each (64 bits for AIGs, 96 bits for MIGs), so node
+  indexes must fit into 31 bits.
+
+  Slots are organized in groups of 16 with one control byte per slot, which
+  holds 7 bits of the hash of a full slot or marks it as empty or deleted.  A
+  lookup compares the control bytes of a whole group against the tag at once
+  (with SSE2 when available) and only reads the keys of matching slots.  A
+  lookup stops at the first group with an empty slot.
+
+  The interface follows the subset of `std::unordered_map` used by the
+  networks: `find` returns a pointer to the entry, or `end()`.
+*/
+template<typename Node>
+class strash_table
+{
+public:
+  static constexpr std::size_t fanin = std::tuple_size<decltype( Node::children )>::value;
+  static_assert( fanin == 2 || fanin == 3, "strash_table supports 2- and 3-input nodes" );
+
+  using key_type = std::array<uint32_t, fanin>;
+
+  struct value_type
+  {
+    key_type first;
+    uint32_t second;
+  };
+
+  using iterator = value_type*;
+  using const_iterator = value_type const*;
+
+  static constexpr std::size_t group_size = 16u;
+
+public:
+  strash_table()
+      : _ctrl( group_size, ctrl_empty ), _slots( group_size )
+  {
+  }
+
+  iterator end() { return nullptr; }
+  const_iterator end() const { return nullptr; }
+
+  std::size_t size() const { return _size; }
+  bool empty() const { return _size == 0u; }
+  std::size_t capacity() const { return _ctrl.size(); }
+
+  iterator find( Node const& n )
+  {
+    return find_key( pack( n ) );
+  }
+
+  const_iterator find( Node const& n ) const
+  {
+    return const_cast<strash_table*>( this )->find_key( pack( n ) );
+  }
+
+  uint32_t& operator[]( Node const& n )
+  {
+    const auto key = pack( n );
+    const auto h = hash( key );
+    if ( auto it = find_key( key, h ); it != end() )
+    {
+      return it->second;
+    }
+    return insert_unique( key, h, 0u )->second;
+  }
+
+  std::size_t erase( Node const& n )
+  {
+    const auto key = pack( n );
+    const auto h = hash( key );
+    const auto it = find_key( key, h );
+    if ( it == end() )
+    {
+      return 0u;
+    }
+
+    const auto pos = static_cast<std::size_t>( it - _slots.data() );
+    const auto group = pos & ~( group_size - 1u );
+    /* probes only continue past full groups, so a slot in a group that
+       still has an empty slot can be freed directly */
+    if ( match_empty( group ) != 0u )
+    {
+      _ctrl[pos] = ctrl_empty;
+    }
+    else
+    {
+      _ctrl[pos] = ctrl_deleted;
+      ++_deleted;
+    }
+    --_size;
+    return 1u;
+  }
+
+  void clear()
+  {
+    std::fill( _ctrl.begin(), _ctrl.end(), ctrl_empty );
+    _size = 0u;
+    _deleted = 0u;
+  }
+
+  /*! \brief Makes room for `n` entries without further growth. */
+  void reserve( std::size_t n )
+  {
+    if ( n > max_entries( capacity() ) )
+    {
+      rehash( slots_for( n ) );
+    }
+  }
+
+  /*! \brief Accepted for compatibility with `spp::sparse_hash_map`; the
+      maximum load factor is fixed. */
+  void set_resizing_parameters( float, float )
+  {
+  }
+
+  /*! \brief Rebuilds the table from a node array
+
+    Clears the table, sizes it once for all entries, and inserts every node
+    index `i` of `nodes` for which `is_hashed( i )` holds, without looking up
+    duplicates.  Used to re-create the table after compacting a network.
+  */
+  template<class Nodes, class Fn>
+  void rebuild( Nodes const& nodes, Fn&& is_hashed )
+  {
+    std::size_t count{0};
+    for ( auto i = 0u; i < nodes.size(); ++i )
+    {
+      if ( is_hashed( i ) )
+        ++count;
+    }
+
+    if ( count > max_entries( capacity() ) )
+    {
+      _ctrl.assign( slots_for( count ), ctrl_empty );
+      _slots.resize( _ctrl.size() );
+    }
+    clear();
+
+    for ( auto i = 0u; i < nodes.size(); ++i )
+    {
+      if ( is_hashed( i ) )
+      {
+        const auto key = pack( nodes[i] );
+        place( key, hash( key ), i );
+        ++_size;
+      }
+    }
+  }
+
+private:
+  static constexpr int8_t ctrl_empty = -128;
+  static constexpr int8_t ctrl_deleted = -2;
+
+  static key_type pack( Node const& n )
+  {
+    key_type key;
+    for ( auto i = 0u; i < fanin; ++i )
+    {
+      assert( n.children[i].data < ( UINT64_C( 1 ) << 32 ) );
+      key[i] = static_cast<uint32_t>( n.children[i].data );
+    }
+    return key;
+  }
+
+  static uint64_t hash( key_type const& key )
+  {
+    uint64_t h = key[0] * UINT64_C( 0x9e3779b97f4a7c15 );
+    h ^= key[1] * UINT64_C( 0xc2b2ae3d27d4eb4f );
+    if constexpr ( fanin == 3 )
+    {
+      h ^= key[2] * UINT64_C( 0x165667b19e3779f9 );
+    }
+    h ^= h >> 29;
+    h *= UINT64_C( 0xbf58476d1ce4e5b9 );
+    h ^= h >> 32;
+    return h;
+  }
+
+  static int8_t tag( uint64_t h )
+  {
+    return static_cast<int8_t>( h & 0x7f );
+  }
+
+  static std::size_t max_entries( std::size_t slots )
+  {
+    return slots - slots / 8u; /* 87.5% */
+  }
+
+  static std::size_t slots_for( std::size_t n )
+  {
+    std::size_t slots = group_size;
+    while ( max_entries( slots ) < n )
+    {
+      slots <<= 1u;
+    }
+    return slots;
+  }
+
+  /* bit i is set if control byte i of the group equals c */
+  uint32_t match( std::size_t group, int8_t c ) const
+  {
+#if defined( __SSE2__ )
+    const auto ctrl = _mm_loadu_si128( reinterpret_cast<__m128i const*>( _ctrl.data() + group ) );
+    return static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( ctrl, _mm_set1_epi8( c ) ) ) );
+#else
+    uint32_t mask{0};
+    for ( auto i = 0u; i < group_size; ++i )
+    {
+      mask |= static_cast<uint32_t>( _ctrl[group + i] == c ) << i;
+    }
+    return mask;
+#endif
+  }
+
+  uint32_t match_empty( std::size_t group ) const
+  {
+    return match( group, ctrl_empty );
+  }
+
+  /* bit i is set if slot i of the group is empty or deleted */
+  uint32_t match_free( std::size_t group ) const
+  {
+#if defined( __SSE2__ )
+    const auto ctrl = _mm_loadu_si128( reinterpret_cast<__m128i const*>( _ctrl.data() + group ) );
+    return static_cast<uint32_t>( _mm_movemask_epi8( ctrl ) ); /* sign bit marks free slots */
+#else
+    uint32_t mask{0};
+    for ( auto i = 0u; i < group_size; ++i )
+    {
+      mask |= static_cast<uint32_t>( _ctrl[group + i] < 0 ) << i;
+    }
+    return mask;
+#endif
+  }
+
+  static uint32_t lowest_bit( uint32_t mask )
+  {
+    return static_cast<uint32_t>( __builtin_ctz( mask ) );
+  }
+
+  iterator find_key( key_type const& key )
+  {
+    return find_key( key, hash( key ) );
+  }
+
+  iterator find_key( key_type const& key, uint64_t h )
+  {
+    const auto mask = _ctrl.size() - 1u;
+    const auto t = tag( h );
+    auto group = ( h >> 7 ) & mask & ~( group_size - 1u );
+    for ( auto probes = 0u; probes < _ctrl.size(); probes += group_size )
+    {
+      for ( auto m = match( group, t ); m != 0u; m &= m - 1u )
+      {
+        auto& slot = _slots[group + lowest_bit( m )];
+        if ( slot.first == key )
+        {
+          return &slot;
+        }
+      }
+      if ( match_empty( group ) != 0u )
+      {
+        return end();
+      }
+      group = ( group + group_size ) & mask;
+    }
+    return end();
+  }
+
+  iterator place( key_type const& key, uint64_t h, uint32_t value )
+  {
+    const auto mask = _ctrl.size() - 1u;
+    auto group = ( h >> 7 ) & mask & ~( group_size - 1u );
+    while ( true )
+    {
+      if ( const auto m = match_free( group ); m != 0u )
+      {
+        const auto pos = group + lowest_bit( m );
+        if ( _ctrl[pos] == ctrl_deleted )
+        {
+          --_deleted;
+        }
+        _ctrl[pos] = tag( h );
+        _slots[pos] = {key, value};
+        return &_slots[pos];
+      }
+      group = ( group + group_size ) & mask;
+    }
+  }
+
+  iterator insert_unique( key_type const& key, uint64_t h, uint32_t value )
+  {
+    if ( _size + _deleted + 1u > max_entries( capacity() ) )
+    {
+      /* only grow if the table is actually full, otherwise drop tombstones */
+      rehash( _size + 1u > max_entries( capacity() ) / 2u ? 2u * capacity() : capacity() );
+    }
+    ++_size;
+    return place( key, h, value );
+  }
+
+  void rehash( std::size_t slots )
+  {
+    std::vector<int8_t> old_ctrl( slots, ctrl_empty );
+    std::vector<value_type> old_slots( slots );
+    old_ctrl.swap( _ctrl );
+    old_slots.swap( _slots );
+    _deleted = 0u;
+
+    for ( auto i = 0u; i < old_ctrl.size(); ++i )
+    {
+      if ( old_ctrl[i] >= 0 )
+      {
+        place( old_slots[i].first, hash( old_slots[i].first ), old_slots[i].second );
+      }
+    }
+  }
+
+private:
+  std::vector<int8_t> _ctrl;
+  std::vector<value_type> _slots;
+  std::size_t _size{0u};
+  std::size_t _deleted{0u};
+};
+
+} /* namespace mockturtle */
@@ -742,6 +742,36 @@ template<class Ntk>
 inline constexpr bool has_num_gates_v = has_num_gates<Ntk>::value;
 #pragma endregion
 
+#pragma region has_reserve_nodes
+template<class Ntk, class = void>
+struct has_reserve_nodes : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_reserve_nodes<Ntk, std::void_t<decltype( std::declval<Ntk>().reserve_nodes( uint64_t() ) )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_reserve_nodes_v = has_reserve_nodes<Ntk>::value;
+#pragma endregion
+
+#pragma region has_create_and_unhashed
+template<class Ntk, class = void>
+struct has_create_and_unhashed : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_create_and_unhashed<Ntk, std::void_t<decltype( std::declval<Ntk>().create_and_unhashed( std::declval<signal<Ntk>>(), std::declval<signal<Ntk>>() ) ), decltype( std::declval<Ntk>().rehash_gates() )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_create_and_unhashed_v = has_create_and_unhashed<Ntk>::value;
+#pragma endregion
+
 #pragma region has_num_registers
 template<class Ntk, class = void>
 struct has_num_registers : std::false_type
@@ -0,0 +1,272 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file output_buffer.hpp
+  \brief Buffered text output for the netlist writers
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace mockturtle
+{
+
+/*! \brief Append-only character buffer
+
+  Text is formatted directly into one large, reused buffer, which is handed
+  to its sink whenever it fills up: a file descriptor written with
+  `write(2)`, an output stream, or nothing, in which case the buffer grows
+  and keeps everything (used to format parts of a file in parallel).
+*/
+class output_buffer
+{
+public:
+  static constexpr std::size_t default_capacity = 1u << 20u;
+
+  /*! \brief Buffer without sink */
+  output_buffer()
+  {
+    _data.reserve( 4096u );
+  }
+
+  explicit output_buffer( std::ostream& os )
+      : _os( &os )
+  {
+    _data.reserve( default_capacity );
+  }
+
+  /*! \brief Creates or truncates `filename`
+
+    Like `std::ofstream`, a file that cannot be opened or written is not an
+    error, the text is dropped and `good` returns false.
+  */
+  explicit output_buffer( std::string const& filename )
+      : _fd( ::open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 ) ), _owns_fd( _fd >= 0 ), _good( _fd >= 0 )
+  {
+    _data.reserve( default_capacity );
+  }
+
+  output_buffer( output_buffer const& ) = delete;
+  output_buffer& operator=( output_buffer const& ) = delete;
+
+  ~output_buffer()
+  {
+    flush();
+    if ( _owns_fd )
+    {
+      ::close( _fd );
+    }
+  }
+
+  output_buffer& operator<<( char c )
+  {
+    reserve( 1u );
+    _data.push_back( c );
+    return *this;
+  }
+
+  output_buffer& operator<<( char const* s )
+  {
+    return append( s, std::strlen( s ) );
+  }
+
+  output_buffer& operator<<( std::string const& s )
+  {
+    return append( s.data(), s.size() );
+  }
+
+  output_buffer& operator<<( output_buffer const& other )
+  {
+    return append( other._data.data(), other._data.size() );
+  }
+
+  output_buffer& append( char const* s, std::size_t n )
+  {
+    if ( has_sink() && n >= default_capacity )
+    {
+      flush();
+      write_out( s, n );
+      return *this;
+    }
+    reserve( n );
+    _data.insert( _data.end(), s, s + n );
+    return *this;
+  }
+
+  /*! \brief Appends `value` in decimal, padded with zeros to `width` digits */
+  output_buffer& append_uint( uint64_t value, uint32_t width = 0u )
+  {
+    static constexpr char digits[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    char tmp[20];
+    auto p = tmp + sizeof( tmp );
+    while ( value >= 100u )
+    {
+      const auto i = ( value % 100u ) * 2u;
+      value /= 100u;
+      *--p = digits[i + 1];
+      *--p = digits[i];
+    }
+    if ( value >= 10u )
+    {
+      *--p = digits[value * 2u + 1];
+      *--p = digits[value * 2u];
+    }
+    else
+    {
+      *--p = static_cast<char>( '0' + value );
+    }
+
+    const auto length = static_cast<uint32_t>( tmp + sizeof( tmp ) - p );
+    reserve( std::max( length, width ) );
+    if ( width > length )
+    {
+      _data.insert( _data.end(), width - length, '0' );
+    }
+    _data.insert( _data.end(), p, tmp + sizeof( tmp ) );
+    return *this;
+  }
+
+  bool good() const { return _good; }
+
+  std::size_t size() const { return _data.size(); }
+  char const* data() const { return _data.data(); }
+
+  void clear() { _data.clear(); }
+
+  /*! \brief Clears the buffer and frees its memory */
+  void release() { std::vector<char>().swap( _data ); }
+
+  /*! \brief Hands the buffered text to the sink */
+  void flush()
+  {
+    if ( !has_sink() )
+    {
+      return;
+    }
+    write_out( _data.data(), _data.size() );
+    _data.clear();
+    if ( _os )
+    {
+      _os->flush();
+    }
+  }
+
+private:
+  bool has_sink() const
+  {
+    return _fd >= 0 || _os || !_good;
+  }
+
+  void reserve( std::size_t n )
+  {
+    if ( has_sink() && _data.size() + n > _data.capacity() )
+    {
+      write_out( _data.data(), _data.size() );
+      _data.clear();
+    }
+  }
+
+  void write_out( char const* s, std::size_t n )
+  {
+    if ( _os )
+    {
+      _os->write( s, n );
+      return;
+    }
+    while ( n > 0u && _good )
+    {
+      const auto written = ::write( _fd, s, n );
+      if ( written < 0 )
+      {
+        if ( errno != EINTR )
+          _good = false;
+        continue;
+      }
+      s += written;
+      n -= static_cast<std::size_t>( written );
+    }
+  }
+
+private:
+  std::vector<char> _data;
+  std::ostream* _os{nullptr};
+  int _fd{-1};
+  bool _owns_fd{false};
+  bool _good{true};
+};
+
+/*! \brief Formats `count` items in order into `out`
+
+  `fn( begin, end, buffer )` formats the items in `[begin, end)`.  With more
+  than one thread, the items are split into contiguous chunks that are
+  formatted concurrently into separate buffers and then appended in order,
+  so the output does not depend on the number of threads.
+*/
+template<class Fn>
+void format_in_chunks( output_buffer& out, uint64_t count, uint32_t num_threads, Fn&& fn )
+{
+  /* small outputs are not worth the threads */
+  const auto num_chunks = std::max<uint64_t>( 1u, std::min<uint64_t>( num_threads, count / 4096u ) );
+  if ( num_chunks == 1u )
+  {
+    fn( uint64_t{0}, count, out );
+    return;
+  }
+
+  std::vector<output_buffer> chunks( num_chunks );
+  std::vector<std::thread> threads;
+  for ( auto c = 0u; c < num_chunks; ++c )
+  {
+    threads.emplace_back( [&, c]() {
+      fn( count * c / num_chunks, count * ( c + 1u ) / num_chunks, chunks[c] );
+    } );
+  }
+  for ( auto c = 0u; c < num_chunks; ++c )
+  {
+    threads[c].join();
+    out << chunks[c];
+    chunks[c].release();
+  }
+}
+
+} // namespace mockturtle
@@ -30,15 +30,118 @@
   \author Heinz Riener
 */
 
+
 #pragma once
 
 #include "../traits.hpp"
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace mockturtle
 {
 
+/*! \brief Append-only storage of names
+
+  Name characters are kept in one arena.  Hierarchical names share their
+  prefix (everything up to the last '.', '/' or '[') through an interned
+  prefix table, so only the last component is stored per name.
+*/
+class name_arena
+{
+public:
+  struct entry
+  {
+    uint32_t prefix{0}; /* 0 means unnamed, otherwise prefix id + 1 */
+    uint32_t offset{0};
+    uint32_t length{0};
+  };
+
+  entry add( std::string const& name )
+  {
+    const auto split = name.find_last_of( "./[" );
+    const auto suffix = split == std::string::npos ? 0u : split + 1u;
+
+    entry e;
+    e.prefix = intern( name.substr( 0, suffix ) ) + 1u;
+    e.offset = static_cast<uint32_t>( _chars.size() );
+    e.length = static_cast<uint32_t>( name.size() - suffix );
+    _chars.insert( _chars.end(), name.begin() + suffix, name.end() );
+    return e;
+  }
+
+  std::string get( entry const& e ) const
+  {
+    std::string name;
+    auto const& prefix = _prefixes[e.prefix - 1u];
+    name.reserve( prefix.size() + e.length );
+    name.append( prefix );
+    name.append( _chars.data() + e.offset, e.length );
+    return name;
+  }
+
+  /*! \brief Appends all names of `other`; returns the functions that move its
+      entries into this arena. */
+  auto merge( name_arena const& other )
+  {
+    const auto shift = static_cast<uint32_t>( _chars.size() );
+    _chars.insert( _chars.end(), other._chars.begin(), other._chars.end() );
+
+    std::vector<uint32_t> prefix_ids;
+    prefix_ids.reserve( other._prefixes.size() );
+    for ( auto const& p : other._prefixes )
+    {
+      prefix_ids.push_back( intern( p ) + 1u );
+    }
+
+    return [shift, prefix_ids = std::move( prefix_ids )]( entry e ) {
+      if ( e.prefix != 0u )
+      {
+        e.prefix = prefix_ids[e.prefix - 1u];
+        e.offset += shift;
+      }
+      return e;
+    };
+  }
+
+  bool empty() const
+  {
+    return _chars.empty() && _prefixes.empty();
+  }
+
+  /*! \brief Approximate number of bytes held by the arena */
+  std::size_t memory_usage() const
+  {
+    auto bytes = _chars.capacity() + _prefixes.capacity() * sizeof( std::string );
+    for ( auto const& p : _prefixes )
+    {
+      /* each prefix is stored twice, once as key of the interning map */
+      bytes += 2u * p.capacity() + sizeof( std::string ) + sizeof( uint32_t );
+    }
+    return bytes;
+  }
+
+private:
+  uint32_t intern( std::string const& prefix )
+  {
+    const auto it = _prefix_ids.emplace( prefix, static_cast<uint32_t>( _prefixes.size() ) );
+    if ( it.second )
+    {
+      _prefixes.push_back( prefix );
+    }
+    return it.first->second;
+  }
+
+private:
+  std::vector<char> _chars;
+  std::vector<std::string> _prefixes;
+  std::unordered_map<std::string, uint32_t> _prefix_ids;
+};
+
 template<class Ntk>
 class names_view : public Ntk
 {
@@ -55,6 +158,7 @@ public:
 
   names_view( names_view<Ntk> const& named_ntk )
     : Ntk( named_ntk )
+    , _arena( named_ntk._arena )
     , _signal_names( named_ntk._signal_names )
     , _output_names( named_ntk._output_names )
   {
@@ -62,18 +166,18 @@ public:
 
   names_view<Ntk>& operator=( names_view<Ntk> const& named_ntk )
   {
-    std::map<signal, std::string> new_signal_names;
+    std::vector<name_arena::entry> new_signal_names;
     std::vector<signal> current_pis;
     this->foreach_pi( [&]( auto const& n ) {
       current_pis.emplace_back( this->make_signal( n ) );
     });
     named_ntk.foreach_pi( [&]( auto const& n, auto i ) {
-      if ( const auto it = _signal_names.find( current_pis[i] ); it != _signal_names.end() )
-        new_signal_names[named_ntk.make_signal( n )] = it->second;
+      if ( const auto e = find( _signal_names, slot( current_pis[i] ) ); e.prefix != 0u )
+        at( new_signal_names, named_ntk.slot( named_ntk.make_signal( n ) ) ) = e;
     } );
 
     Ntk::operator=( named_ntk );
-    _signal_names = new_signal_names;
+    _signal_names = std::move( new_signal_names );
     return *this;
   }
 
@@ -99,37 +203,118 @@ public:
 
   bool has_name( signal const& s ) const
   {
-    return ( _signal_names.find( s ) != _signal_names.end() );
+    return find( _signal_names, slot( s ) ).prefix != 0u;
   }
 
   void set_name( signal const& s, std::string const& name )
   {
-    _signal_names[s] = name;
+    at( _signal_names, slot( s ) ) = _arena.add( name );
   }
 
   std::string get_name( signal const& s ) const
   {
-    return _signal_names.at( s );
+    return get( _signal_names, slot( s ) );
   }
 
   bool has_output_name( uint32_t index ) const
   {
-    return ( _output_names.find( index ) != _output_names.end() );
+    return find( _output_names, index ).prefix != 0u;
   }
 
   void set_output_name( uint32_t index, std::string const& name )
   {
-    _output_names[index] = name;
+    at( _output_names, index ) = _arena.add( name );
   }
 
   std::string get_output_name( uint32_t index ) const
   {
-    return _output_names.at( index );
+    return get( _output_names, index );
+  }
+
+  /*! \brief Copies all names of `other` in bulk
+
+    `map` takes a node of `other` and returns the signal of this network it
+    was translated to.  Names of both polarities of every node of `other`
+    except the constant are moved over, and output names are copied by
+    index.  The name characters are appended to this network's arena in one
+    block instead of one string per name.
+  */
+  template<class OtherNtk, class Fn>
+  void copy_names_from( names_view<OtherNtk> const& other, Fn&& map )
+  {
+    const auto move = _arena.merge( other._arena );
+
+    other.foreach_node( [&]( auto const& n ) {
+      if ( other.is_constant( n ) )
+        return;
+
+      const auto s = map( n );
+      for ( auto c = 0u; c < 2u; ++c )
+      {
+        if ( const auto e = find( other._signal_names, 2u * other.node_to_index( n ) + c ); e.prefix != 0u )
+        {
+          at( _signal_names, slot( s ) ^ c ) = move( e );
+        }
+      }
+    } );
+
+    if ( _output_names.size() < other._output_names.size() )
+    {
+      _output_names.resize( other._output_names.size() );
+    }
+    for ( auto i = 0u; i < other._output_names.size(); ++i )
+    {
+      if ( other._output_names[i].prefix != 0u )
+      {
+        _output_names[i] = move( other._output_names[i] );
+      }
+    }
+  }
+
+  /*! \brief Approximate number of bytes held by the names */
+  std::size_t names_memory_usage() const
+  {
+    return _arena.memory_usage() + ( _signal_names.capacity() + _output_names.capacity() ) * sizeof( name_arena::entry );
+  }
+
+private:
+  template<class>
+  friend class names_view;
+
+  /* both polarities of a node have their own name */
+  uint32_t slot( signal const& s ) const
+  {
+    return 2u * this->node_to_index( this->get_node( s ) ) + ( this->is_complemented( s ) ? 1u : 0u );
+  }
+
+  static name_arena::entry find( std::vector<name_arena::entry> const& entries, uint32_t index )
+  {
+    return index < entries.size() ? entries[index] : name_arena::entry{};
+  }
+
+  static name_arena::entry& at( std::vector<name_arena::entry>& entries, uint32_t index )
+  {
+    if ( index >= entries.size() )
+    {
+      entries.resize( std::max<std::size_t>( index + 1u, 2u * entries.size() ) );
+    }
+    return entries[index];
+  }
+
+  std::string get( std::vector<name_arena::entry> const& entries, uint32_t index ) const
+  {
+    const auto e = find( entries, index );
+    if ( e.prefix == 0u )
+    {
+      throw std::out_of_range( "names_view: no name for " + std::to_string( index ) );
+    }
+    return _arena.get( e );
   }
 
 private:
-  std::map<signal, std::string> _signal_names;
-  std::map<uint32_t, std::string> _output_names;
+  name_arena _arena;
+  std::vector<name_arena::entry> _signal_names;
+  std::vector<name_arena::entry> _output_names;
 }; /* names_view */
 
 template<class T>
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+
+#include <mockturtle/algorithms/bit_parallel_simulation.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/networks/xmg.hpp>
+
+#include <kitty/dynamic_truth_table.hpp>
+
+using namespace mockturtle;
+
+template<class Ntk>
+static void check_against_truth_tables( Ntk const& ntk, bit_parallel_simulation_params const& ps = {} )
+{
+  default_simulator<kitty::dynamic_truth_table> tt_sim( ntk.num_pis() );
+  const auto tts = simulate<kitty::dynamic_truth_table>( ntk, tt_sim );
+
+  bit_parallel_simulator<Ntk> sim( ntk, ps );
+  sim.simulate_exhaustive( [&]( auto const& s, uint64_t block ) {
+    for ( auto i = 0u; i < s.num_pos(); ++i )
+    {
+      for ( auto p = 0u; p < s.block_size(); ++p )
+      {
+        const auto pattern = block * s.block_size() + p;
+        if ( pattern >= tts[i].num_bits() )
+          break;
+        CHECK( ( ( s.output( i )[p / 64u] >> ( p % 64u ) ) & 1u ) == kitty::get_bit( tts[i], pattern ) );
+      }
+    }
+  } );
+}
+
+TEST_CASE( "Bit-parallel simulation of XOR AIG", "[bit_parallel_simulation]" )
+{
+  aig_network aig;
+
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto f1 = aig.create_nand( a, b );
+  const auto f2 = aig.create_nand( a, f1 );
+  const auto f3 = aig.create_nand( b, f1 );
+  const auto f4 = aig.create_nand( f2, f3 );
+  aig.create_po( f4 );
+  aig.create_po( !f4 );
+
+  bit_parallel_simulator<aig_network> sim( aig );
+  sim.fill_exhaustive( 0u );
+  sim.simulate();
+  CHECK( ( sim.output( 0 )[0] & 0xf ) == 0x6 );
+  CHECK( ( sim.output( 1 )[0] & 0xf ) == 0x9 );
+}
+
+TEST_CASE( "Bit-parallel simulation of adders", "[bit_parallel_simulation]" )
+{
+  aig_network aig;
+  mig_network mig;
+  xag_network xag;
+  xmg_network xmg;
+
+  const auto build = [&]( auto& ntk ) {
+    std::vector<typename std::decay_t<decltype( ntk )>::signal> a( 6 ), b( 6 );
+    std::generate( a.begin(), a.end(), [&]() { return ntk.create_pi(); } );
+    std::generate( b.begin(), b.end(), [&]() { return ntk.create_pi(); } );
+    auto carry = ntk.create_pi();
+    carry_ripple_adder_inplace( ntk, a, b, carry );
+    std::for_each( a.begin(), a.end(), [&]( auto f ) { ntk.create_po( f ); } );
+    ntk.create_po( carry );
+  };
+  build( aig );
+  build( mig );
+  build( xag );
+  build( xmg );
+
+  check_against_truth_tables( aig );
+  check_against_truth_tables( mig );
+  check_against_truth_tables( xag );
+  check_against_truth_tables( xmg );
+  check_against_truth_tables( aig, {64u, false, 1u} );
+  check_against_truth_tables( mig, {512u, true, 1u} );
+}
+
+TEST_CASE( "Bit-parallel simulation recycles buffers", "[bit_parallel_simulation]" )
+{
+  aig_network aig;
+
+  std::vector<aig_network::signal> pis( 8 );
+  std::generate( pis.begin(), pis.end(), [&]() { return aig.create_pi(); } );
+
+  auto f = pis[0];
+  for ( auto i = 0u; i < 200u; ++i )
+  {
+    f = aig.create_and( f, pis[1u + i % 7u] );
+    f = aig.create_or( f, pis[( 3u * i ) % 8u] );
+  }
+  aig.create_po( f );
+
+  bit_parallel_simulator<aig_network> recycled( aig );
+  bit_parallel_simulator<aig_network> full( aig, {256u, false, 1u} );
+  CHECK( recycled.num_buffers() < 1u + 8u + 4u );
+  CHECK( full.num_buffers() > 1u + 8u + 200u );
+
+  for ( auto block = 0u; block < 4u; ++block )
+  {
+    recycled.fill_random();
+    full.fill_random();
+    recycled.simulate();
+    full.simulate();
+    for ( auto w = 0u; w < recycled.words(); ++w )
+    {
+      CHECK( recycled.output( 0 )[w] == full.output( 0 )[w] );
+    }
+  }
+}
@@ -0,0 +1,91 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/algorithms/sweeping_equivalence_checking.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/networks/xag.hpp>
+
+using namespace mockturtle;
+
+template<class Ntk>
+static Ntk adder( uint32_t bitwidth, bool swap_operands = false, bool faulty = false )
+{
+  Ntk ntk;
+  std::vector<typename Ntk::signal> a( bitwidth ), b( bitwidth );
+  std::generate( a.begin(), a.end(), [&]() { return ntk.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return ntk.create_pi(); } );
+  auto carry = ntk.get_constant( false );
+  if ( swap_operands )
+    std::swap( a, b );
+  carry_ripple_adder_inplace( ntk, a, b, carry );
+  if ( faulty )
+  {
+    /* flip an output if all inputs are 1 */
+    std::vector<typename Ntk::signal> pis;
+    ntk.foreach_pi( [&]( auto const& n ) { pis.push_back( ntk.make_signal( n ) ); } );
+    a[3] = ntk.create_xor( a[3], ntk.create_nary_and( pis ) );
+  }
+  std::for_each( a.begin(), a.end(), [&]( auto f ) { ntk.create_po( f ); } );
+  ntk.create_po( carry );
+  return ntk;
+}
+
+TEST_CASE( "Sweeping equivalence check on an XAG and an AIG", "[sweeping_equivalence_checking]" )
+{
+  xag_network xag;
+  const auto a = xag.create_pi();
+  const auto b = xag.create_pi();
+  xag.create_po( xag.create_xor( a, b ) );
+
+  aig_network aig;
+  const auto a_ = aig.create_pi();
+  const auto b_ = aig.create_pi();
+  const auto f1 = aig.create_nand( a_, b_ );
+  const auto f2 = aig.create_nand( a_, f1 );
+  const auto f3 = aig.create_nand( b_, f1 );
+  aig.create_po( aig.create_nand( f2, f3 ) );
+
+  const auto result = sweeping_equivalence_checking( xag, aig );
+  CHECK( result );
+  CHECK( *result );
+}
+
+TEST_CASE( "Sweeping equivalence check on adders", "[sweeping_equivalence_checking]" )
+{
+  const auto aig = adder<aig_network>( 16u );
+  const auto mig = adder<mig_network>( 16u, true );
+
+  sweeping_equivalence_checking_params ps;
+  sweeping_equivalence_checking_stats st;
+  for ( auto threads : {1u, 4u} )
+  {
+    ps.num_threads = threads;
+    const auto result = sweeping_equivalence_checking( aig, mig, ps, &st );
+    CHECK( result );
+    CHECK( *result );
+    CHECK( st.num_proved + st.num_structural == 17u );
+  }
+}
+
+TEST_CASE( "Sweeping equivalence check finds counter-example", "[sweeping_equivalence_checking]" )
+{
+  const auto aig = adder<aig_network>( 8u );
+
+  const auto wrong = adder<aig_network>( 8u, false, true );
+
+  sweeping_equivalence_checking_stats st;
+  const auto result = sweeping_equivalence_checking( aig, wrong, {}, &st );
+  CHECK( result );
+  CHECK( !*result );
+  REQUIRE( st.failing_output );
+  CHECK( *st.failing_output == 3u );
+  REQUIRE( st.counter_example.size() == 16u );
+
+  const auto expected = simulate<bool>( aig, default_simulator<bool>( st.counter_example ) );
+  const auto actual = simulate<bool>( wrong, default_simulator<bool>( st.counter_example ) );
+  CHECK( expected[*st.failing_output] != actual[*st.failing_output] );
+}
@@ -0,0 +1,164 @@
+#include <catch.hpp>
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <mockturtle/io/aiger_mmap_reader.hpp>
+#include <mockturtle/io/aiger_reader.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/views/names_view.hpp>
+
+#include <lorina/aiger.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+void encode( std::string& out, uint32_t x )
+{
+  while ( x & ~0x7f )
+  {
+    out += static_cast<char>( ( x & 0x7f ) | 0x80 );
+    x >>= 7;
+  }
+  out += static_cast<char>( x );
+}
+
+/* binary version of
+     aag 7 2 1 2 4 / 2 / 4 / 6 8 / 6 / 7 / 8 2 6 / 10 3 7 / 12 9 11 / 14 4 12 */
+std::string binary_file()
+{
+  std::string file{"aig 7 2 1 2 4\n8\n6\n7\n"};
+  const std::vector<std::array<uint32_t, 3>> ands = {{8, 6, 2}, {10, 7, 3}, {12, 11, 9}, {14, 12, 4}};
+  for ( auto const& [lhs, rhs0, rhs1] : ands )
+  {
+    encode( file, lhs - rhs0 );
+    encode( file, rhs0 - rhs1 );
+  }
+  file += "i0 x0\ni1 x1\nl0 s0\no0 y0\nc\ncomment\n";
+  return file;
+}
+
+std::string write_temp( std::string const& contents )
+{
+  const std::string filename = "aiger_mmap_reader_test.aig";
+  std::ofstream os( filename, std::ofstream::binary );
+  os << contents;
+  return filename;
+}
+
+} // namespace
+
+TEST_CASE( "read a binary AIGER file with read_aiger_mmap", "[aiger_mmap_reader]" )
+{
+  const auto filename = write_temp( binary_file() );
+
+  names_view<aig_network> aig;
+  CHECK( read_aiger_mmap( filename, aig ) == lorina::return_code::success );
+
+  CHECK( aig.num_cis() == 3 );
+  CHECK( aig.num_latches() == 1 );
+  CHECK( aig.num_cos() == 3 );
+  CHECK( aig.num_gates() == 4 );
+
+  CHECK( aig.get_name( aig.make_signal( aig.pi_at( 0 ) ) ) == "x0" );
+  CHECK( aig.get_name( aig.make_signal( aig.pi_at( 1 ) ) ) == "x1" );
+  CHECK( aig.get_name( aig.make_signal( aig.ro_at( 0 ) ) ) == "s0" );
+  CHECK( aig.get_output_name( 0 ) == "y0" );
+  CHECK( aig.get_output_name( 1 ) == "po1" );
+  CHECK( aig.get_output_name( 2 ) == "li1" );
+
+  names_view<aig_network> ref;
+  CHECK( lorina::read_aiger( filename, aiger_reader( ref ) ) == lorina::return_code::success );
+  CHECK( ref.size() == aig.size() );
+  aig.foreach_co( [&]( auto const& f, auto i ) {
+    CHECK( f == ref.co_at( i ) );
+  } );
+
+  std::remove( filename.c_str() );
+}
+
+TEST_CASE( "read a structurally hashed AIGER file without hash lookups", "[aiger_mmap_reader]" )
+{
+  const auto filename = write_temp( binary_file() );
+
+  aig_network aig;
+  aiger_mmap_reader_params ps;
+  ps.strashed = true;
+  CHECK( read_aiger_mmap( filename, aig, ps ) == lorina::return_code::success );
+  CHECK( aig.num_gates() == 4 );
+
+  /* the hash table is rebuilt, existing gates are found again */
+  const auto size = aig.size();
+  const auto x0 = aig.make_signal( aig.pi_at( 0 ) );
+  const auto s0 = aig.make_signal( aig.ro_at( 0 ) );
+  aig.create_and( x0, s0 );
+  CHECK( aig.size() == size );
+  aig.create_and( x0, !s0 );
+  CHECK( aig.size() == size + 1 );
+
+  mig_network mig;
+  CHECK( read_aiger_mmap( filename, mig, ps ) == lorina::return_code::success );
+  CHECK( mig.num_gates() == 4 );
+
+  std::remove( filename.c_str() );
+}
+
+TEST_CASE( "read_aiger_mmap falls back to lorina and reports errors", "[aiger_mmap_reader]" )
+{
+  auto filename = write_temp( "aag 3 2 0 1 1\n2\n4\n6\n6 2 4\n" );
+  aig_network aig;
+  CHECK( read_aiger_mmap( filename, aig ) == lorina::return_code::success );
+  CHECK( aig.num_gates() == 1 );
+  CHECK( aig.num_pos() == 1 );
+
+  /* truncated AND section */
+  auto file = binary_file();
+  filename = write_temp( file.substr( 0, file.find( "i0" ) - 3 ) );
+  aig_network truncated;
+  CHECK( read_aiger_mmap( filename, truncated ) == lorina::return_code::parse_error );
+
+  std::remove( filename.c_str() );
+  aig_network missing;
+  CHECK( read_aiger_mmap( filename, missing ) == lorina::return_code::parse_error );
+}
+
+TEST_CASE( "read_aiger_mmap reserves node and hash capacity from the header", "[aiger_mmap_reader]" )
+{
+  /* more gates than the default reservation of the storage */
+  const uint32_t num_ands = 20000u;
+  const uint32_t num_vars = 3u + num_ands;
+
+  std::string file = "aig " + std::to_string( num_vars ) + " 2 1 1 " + std::to_string( num_ands ) + "\n6\n" + std::to_string( 2u * num_vars ) + "\n";
+  for ( auto i = 0u; i < num_ands; ++i )
+  {
+    const uint32_t lhs = 2u * ( i + 4u );
+    const uint32_t rhs0 = lhs - 2u + ( i & 1u );
+    encode( file, lhs - rhs0 );
+    encode( file, rhs0 - ( i % 2u == 0u ? 4u : 3u ) );
+  }
+  const auto filename = write_temp( file );
+
+  for ( auto strashed : {false, true} )
+  {
+    aig_network aig;
+    aiger_mmap_reader_params ps;
+    ps.strashed = strashed;
+    CHECK( read_aiger_mmap( filename, aig, ps ) == lorina::return_code::success );
+
+    CHECK( aig.size() == num_vars + 1u );
+    CHECK( aig.num_gates() == num_ands );
+    CHECK( aig._storage->nodes.capacity() == num_vars + 1u );
+
+    const auto hash_capacity = aig._storage->hash.capacity();
+    aig._storage->hash.reserve( num_vars + 1u );
+    CHECK( aig._storage->hash.capacity() == hash_capacity );
+  }
+
+  std::remove( filename.c_str() );
+}
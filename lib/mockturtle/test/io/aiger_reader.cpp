@@ -120,3 +120,30 @@ TEST_CASE( "read a sequential ASCII Aiger file into an AIG network", "[aiger_rea
   CHECK( names.has_name( aig.po_at( 0 ), "foobar" ) );
   CHECK( names.has_name( aig.po_at( 1 ), "barbar" ) );
 }
+
+TEST_CASE( "reserve node and hash capacity from the Aiger header", "[aiger_reader]" )
+{
+  /* more gates than the default reservation of the storage */
+  uint32_t const num_ands = 20000u;
+  uint32_t const num_vars = 2u + num_ands;
+
+  std::ostringstream file;
+  file << "aag " << num_vars << " 2 0 1 " << num_ands << "\n2\n4\n" << 2u * num_vars << "\n";
+  for ( auto i = 0u; i < num_ands; ++i )
+  {
+    file << 2u * ( i + 3u ) << " " << ( i == 0u ? 2u : 2u * ( i + 2u ) + ( i & 1u ) ) << " " << ( i % 2u == 0u ? 4u : 3u ) << "\n";
+  }
+
+  aig_network aig;
+  std::istringstream in( file.str() );
+  auto const result = lorina::read_ascii_aiger( in, aiger_reader( aig ) );
+  CHECK( result == lorina::return_code::success );
+
+  CHECK( aig.size() == num_vars + 1u );
+  CHECK( aig.num_gates() == num_ands );
+  CHECK( aig._storage->nodes.capacity() == num_vars + 1u );
+
+  auto const hash_capacity = aig._storage->hash.capacity();
+  aig._storage->hash.reserve( num_vars + 1u );
+  CHECK( aig._storage->hash.capacity() == hash_capacity );
+}
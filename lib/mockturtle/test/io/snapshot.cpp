@@ -0,0 +1,83 @@
+#include <catch.hpp>
+
+#include <sstream>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/io/snapshot.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <mockturtle/views/names_view.hpp>
+
+using namespace mockturtle;
+
+template<class Ntk>
+void check_round_trip()
+{
+  names_view<Ntk> ntk;
+  std::vector<typename Ntk::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return ntk.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return ntk.create_pi(); } );
+  auto carry = ntk.create_pi();
+  ntk.set_name( a[0], "a0" );
+  ntk.set_name( carry, "cin" );
+  carry_ripple_adder_inplace( ntk, a, b, carry );
+  std::for_each( a.begin(), a.end(), [&]( auto f ) { ntk.create_po( f ); } );
+  ntk.create_po( !carry );
+  ntk.set_output_name( 4u, "cout" );
+
+  std::stringstream ss;
+  write_snapshot( ntk, ss );
+
+  names_view<Ntk> copy;
+  CHECK( read_snapshot( ss, copy ) );
+  CHECK( copy.num_pis() == ntk.num_pis() );
+  CHECK( copy.num_pos() == ntk.num_pos() );
+  CHECK( copy.num_gates() == ntk.num_gates() );
+  CHECK( copy.get_name( copy.make_signal( copy.pi_at( 0 ) ) ) == "a0" );
+  CHECK( copy.get_name( copy.make_signal( copy.pi_at( 8 ) ) ) == "cin" );
+  CHECK( copy.get_output_name( 4u ) == "cout" );
+
+  default_simulator<kitty::dynamic_truth_table> sim( ntk.num_pis() );
+  CHECK( simulate<kitty::dynamic_truth_table>( ntk, sim ) == simulate<kitty::dynamic_truth_table>( copy, sim ) );
+}
+
+TEST_CASE( "snapshot round trip of combinational networks", "[snapshot]" )
+{
+  check_round_trip<aig_network>();
+  check_round_trip<xag_network>();
+  check_round_trip<mig_network>();
+}
+
+TEST_CASE( "snapshot round trip of an AIG with latches", "[snapshot]" )
+{
+  aig_network aig;
+  const auto a = aig.create_pi();
+  const auto q0 = aig.create_ro();
+  const auto q1 = aig.create_ro();
+  aig.create_po( aig.create_and( q0, q1 ) );
+  aig.create_ri( aig.create_xor( a, q0 ), 0 );
+  aig.create_ri( !q1, 1 );
+
+  std::stringstream ss;
+  write_snapshot( aig, ss );
+
+  aig_network copy;
+  CHECK( read_snapshot( ss, copy ) );
+  CHECK( copy.num_pis() == 3u );
+  CHECK( copy.num_pos() == 3u );
+  CHECK( copy.num_latches() == 2u );
+  CHECK( copy.latch_reset( 0 ) == 0 );
+  CHECK( copy.latch_reset( 1 ) == 1 );
+  CHECK( copy.num_gates() == aig.num_gates() );
+}
+
+TEST_CASE( "reject malformed snapshots", "[snapshot]" )
+{
+  std::stringstream ss( "not a snapshot" );
+  aig_network aig;
+  CHECK( !read_snapshot( ss, aig ) );
+}
@@ -0,0 +1,126 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mockturtle/io/write_bench.hpp>
+#include <mockturtle/io/write_blif.hpp>
+#include <mockturtle/io/write_verilog.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/utils/output_buffer.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+/* enough gates that four threads each format a chunk of their own */
+template<class Ntk>
+Ntk make_network( uint32_t num_gates )
+{
+  Ntk ntk;
+  std::vector<signal<Ntk>> fs;
+  for ( auto i = 0u; i < 64u; ++i )
+  {
+    fs.push_back( ntk.create_pi() );
+  }
+
+  uint64_t seed = 0x2545f4914f6cdd1d;
+  const auto next = [&]() {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+  };
+
+  while ( ntk.num_gates() < num_gates )
+  {
+    const auto r = next();
+    const auto a = fs[r % fs.size()];
+    const auto b = fs[( r >> 20 ) % fs.size()];
+    switch ( ( r >> 40 ) % 3u )
+    {
+    case 0u:
+      fs.push_back( ntk.create_and( a, b ) );
+      break;
+    case 1u:
+      fs.push_back( ntk.create_or( a, ntk.create_not( b ) ) );
+      break;
+    default:
+      fs.push_back( ntk.create_xor( a, b ) );
+      break;
+    }
+  }
+
+  for ( auto i = fs.size() - 100u; i < fs.size(); ++i )
+  {
+    ntk.create_po( fs[i] );
+  }
+  return ntk;
+}
+
+template<class Ntk, class Params, class Write>
+void check_same_output( Ntk const& ntk, Write&& write )
+{
+  Params ps1, ps4;
+  ps1.num_threads = 1u;
+  ps4.num_threads = 4u;
+
+  std::ostringstream out1, out4;
+  write( ntk, out1, ps1 );
+  write( ntk, out4, ps4 );
+
+  CHECK( out1.str().size() > 0u );
+  CHECK( out1.str() == out4.str() );
+}
+
+} // namespace
+
+TEST_CASE( "format items in chunks independently of the number of threads", "[threaded_writers]" )
+{
+  const auto format = [&]( uint32_t num_threads ) {
+    std::ostringstream os;
+    {
+      output_buffer out( os );
+      out << "begin\n";
+      format_in_chunks( out, 50000u, num_threads, [&]( uint64_t begin, uint64_t end, output_buffer& buf ) {
+        for ( auto i = begin; i < end; ++i )
+        {
+          buf << "item ";
+          buf.append_uint( i ) << '\n';
+        }
+      } );
+      out << "end\n";
+    }
+    return os.str();
+  };
+
+  const auto expected = format( 1u );
+  CHECK( expected.substr( 0, 18 ) == "begin\nitem 0\nitem " );
+  CHECK( format( 4u ) == expected );
+  CHECK( format( 7u ) == expected );
+}
+
+TEST_CASE( "write Verilog with one and four threads", "[threaded_writers]" )
+{
+  const auto write = []( auto const& ntk, std::ostream& os, write_verilog_params const& ps ) { write_verilog( ntk, os, ps ); };
+  check_same_output<aig_network, write_verilog_params>( make_network<aig_network>( 40000u ), write );
+  check_same_output<mig_network, write_verilog_params>( make_network<mig_network>( 40000u ), write );
+}
+
+TEST_CASE( "write BLIF with one and four threads", "[threaded_writers]" )
+{
+  const auto write = []( auto const& ntk, std::ostream& os, write_blif_params const& ps ) { write_blif( ntk, os, ps ); };
+  check_same_output<aig_network, write_blif_params>( make_network<aig_network>( 40000u ), write );
+  check_same_output<klut_network, write_blif_params>( make_network<klut_network>( 40000u ), write );
+}
+
+TEST_CASE( "write BENCH with one and four threads", "[threaded_writers]" )
+{
+  const auto write = []( auto const& ntk, std::ostream& os, write_bench_params const& ps ) { write_bench( ntk, os, ps ); };
+  check_same_output<aig_network, write_bench_params>( make_network<aig_network>( 40000u ), write );
+  check_same_output<klut_network, write_bench_params>( make_network<klut_network>( 40000u ), write );
+}
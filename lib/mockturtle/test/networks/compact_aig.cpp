@@ -0,0 +1,361 @@
+#include <catch.hpp>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/compact_aig.hpp>
+#include <mockturtle/traits.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "create and use constants in a compact AIG", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  CHECK( aig.size() == 1 );
+  CHECK( has_get_constant_v<compact_aig_network> );
+  CHECK( has_is_constant_v<compact_aig_network> );
+  CHECK( has_get_node_v<compact_aig_network> );
+  CHECK( has_is_complemented_v<compact_aig_network> );
+  CHECK( sizeof( compact_aig_network::signal ) == 4u );
+
+  const auto c0 = aig.get_constant( false );
+  CHECK( aig.is_constant( aig.get_node( c0 ) ) );
+  CHECK( !aig.is_pi( aig.get_node( c0 ) ) );
+  CHECK( aig.get_node( c0 ) == 0 );
+  CHECK( !aig.is_complemented( c0 ) );
+
+  const auto c1 = aig.get_constant( true );
+
+  CHECK( aig.get_node( c1 ) == 0 );
+  CHECK( aig.is_complemented( c1 ) );
+
+  CHECK( c0 != c1 );
+  CHECK( c0 == !c1 );
+  CHECK( -c0 == c1 );
+  CHECK( c0 == +c1 );
+}
+
+TEST_CASE( "create and use primary inputs and outputs in a compact AIG", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  CHECK( has_create_pi_v<compact_aig_network> );
+  CHECK( has_create_po_v<compact_aig_network> );
+
+  const auto c0 = aig.get_constant( false );
+  auto x1 = aig.create_pi();
+
+  CHECK( aig.size() == 2 );
+  CHECK( aig.num_pis() == 1 );
+  CHECK( aig.is_pi( aig.get_node( x1 ) ) );
+  CHECK( x1.index == 1 );
+  CHECK( x1.complement == 0 );
+  CHECK( ( !x1 ).complement == 1 );
+  CHECK( ( x1 ^ true ) == !x1 );
+
+  aig.create_po( c0 );
+  aig.create_po( x1 );
+  aig.create_po( !x1 );
+
+  CHECK( aig.size() == 2 );
+  CHECK( aig.num_pos() == 3 );
+
+  aig.foreach_po( [&]( auto s, auto i ) {
+    switch ( i )
+    {
+    case 0:
+      CHECK( s == c0 );
+      break;
+    case 1:
+      CHECK( s == x1 );
+      break;
+    case 2:
+      CHECK( s == !x1 );
+      break;
+    }
+  } );
+}
+
+TEST_CASE( "create binary operations in a compact AIG", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  CHECK( has_create_and_v<compact_aig_network> );
+  CHECK( has_create_or_v<compact_aig_network> );
+  CHECK( has_create_xor_v<compact_aig_network> );
+
+  const auto x1 = aig.create_pi();
+  const auto x2 = aig.create_pi();
+
+  CHECK( aig.create_and( x1, x1 ) == x1 );
+  CHECK( aig.create_and( x1, !x1 ) == aig.get_constant( false ) );
+  CHECK( aig.create_and( x1, aig.get_constant( true ) ) == x1 );
+  CHECK( aig.create_and( aig.get_constant( false ), x2 ) == aig.get_constant( false ) );
+  CHECK( aig.size() == 3 );
+
+  const auto f1 = aig.create_and( x1, x2 );
+  CHECK( aig.size() == 4 );
+
+  const auto f2 = aig.create_nand( x1, x2 );
+  CHECK( aig.size() == 4 );
+  CHECK( f1 == !f2 );
+
+  aig.create_or( x1, x2 );
+  CHECK( aig.size() == 5 );
+
+  aig.create_xor( x1, x2 );
+  CHECK( aig.size() == 8 );
+}
+
+TEST_CASE( "hash nodes in a compact AIG", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  auto a = aig.create_pi();
+  auto b = aig.create_pi();
+  auto c = aig.create_pi();
+
+  auto f = aig.create_and( a, b );
+  auto g = aig.create_and( b, a );
+  auto h = aig.create_and( !a, b );
+
+  CHECK( aig.size() == 6u );
+  CHECK( aig.num_gates() == 2u );
+  CHECK( aig._storage->hash.size() == 2u );
+  CHECK( aig.get_node( f ) == aig.get_node( g ) );
+  CHECK( aig.get_node( f ) != aig.get_node( h ) );
+
+  /* enough gates to grow the table several times */
+  std::vector<compact_aig_network::signal> gates{a, b, c};
+  for ( auto i = 0u; i < 500u; ++i )
+  {
+    gates.push_back( aig.create_and( gates[i], !gates[i + 1] ) );
+  }
+  const auto num_gates = aig.num_gates();
+  CHECK( aig._storage->hash.size() == num_gates );
+  for ( auto i = 0u; i < 500u; ++i )
+  {
+    CHECK( aig.create_and( !gates[i + 1], gates[i] ) == gates[i + 3] );
+  }
+  CHECK( aig.num_gates() == num_gates );
+}
+
+TEST_CASE( "structural properties of a compact AIG", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  CHECK( has_size_v<compact_aig_network> );
+  CHECK( has_num_gates_v<compact_aig_network> );
+  CHECK( has_fanin_size_v<compact_aig_network> );
+  CHECK( has_fanout_size_v<compact_aig_network> );
+
+  const auto x1 = aig.create_pi();
+  const auto x2 = aig.create_pi();
+
+  const auto f1 = aig.create_and( x1, x2 );
+  const auto f2 = aig.create_or( x1, x2 );
+
+  aig.create_po( f1 );
+  aig.create_po( f2 );
+
+  CHECK( aig.size() == 5 );
+  CHECK( aig.num_pis() == 2 );
+  CHECK( aig.num_pos() == 2 );
+  CHECK( aig.num_gates() == 2 );
+  CHECK( aig.fanin_size( aig.get_node( x1 ) ) == 0 );
+  CHECK( aig.fanin_size( aig.get_node( f1 ) ) == 2 );
+  CHECK( aig.fanout_size( aig.get_node( x1 ) ) == 2 );
+  CHECK( aig.fanout_size( aig.get_node( x2 ) ) == 2 );
+  CHECK( aig.fanout_size( aig.get_node( f1 ) ) == 1 );
+  CHECK( aig.fanout_size( aig.get_node( f2 ) ) == 1 );
+  CHECK( aig.is_and( aig.get_node( f1 ) ) );
+  CHECK( !aig.is_and( aig.get_node( x1 ) ) );
+}
+
+TEST_CASE( "node and signal iteration in a compact AIG", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  const auto x1 = aig.create_pi();
+  const auto x2 = aig.create_pi();
+  const auto f1 = aig.create_and( x1, x2 );
+  const auto f2 = aig.create_or( x1, x2 );
+  aig.create_po( f1 );
+  aig.create_po( f2 );
+
+  uint32_t mask{0}, counter{0};
+  aig.foreach_node( [&]( auto n, auto i ) { mask |= ( 1 << n ); counter += i; } );
+  CHECK( mask == 31 );
+  CHECK( counter == 10 );
+
+  mask = counter = 0;
+  aig.foreach_node( [&]( auto n, auto i ) { mask |= ( 1 << n ); counter += i; return false; } );
+  CHECK( mask == 1 );
+  CHECK( counter == 0 );
+
+  mask = counter = 0;
+  aig.foreach_pi( [&]( auto n, auto i ) { mask |= ( 1 << n ); counter += i; } );
+  CHECK( mask == 6 );
+  CHECK( counter == 1 );
+
+  mask = counter = 0;
+  aig.foreach_po( [&]( auto s, auto i ) { mask |= ( 1 << aig.get_node( s ) ); counter += i; } );
+  CHECK( mask == 24 );
+  CHECK( counter == 1 );
+
+  mask = counter = 0;
+  aig.foreach_gate( [&]( auto n, auto i ) { mask |= ( 1 << n ); counter += i; } );
+  CHECK( mask == 24 );
+  CHECK( counter == 1 );
+
+  mask = counter = 0;
+  aig.foreach_fanin( aig.get_node( f1 ), [&]( auto s, auto i ) { mask |= ( 1 << aig.get_node( s ) ); counter += i; } );
+  CHECK( mask == 6 );
+  CHECK( counter == 1 );
+
+  aig.foreach_fanin( aig.get_node( f2 ), [&]( auto s ) { CHECK( aig.is_complemented( s ) ); } );
+}
+
+TEST_CASE( "compute values in compact AIGs", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  CHECK( has_compute_v<compact_aig_network, bool> );
+  CHECK( has_compute_v<compact_aig_network, kitty::dynamic_truth_table> );
+
+  const auto x1 = aig.create_pi();
+  const auto x2 = aig.create_pi();
+  const auto f1 = aig.create_and( !x1, x2 );
+  const auto f2 = aig.create_and( x1, !x2 );
+  aig.create_po( f1 );
+  aig.create_po( f2 );
+
+  std::vector<bool> values{{true, false}};
+
+  CHECK( aig.compute( aig.get_node( f1 ), values.begin(), values.end() ) == false );
+  CHECK( aig.compute( aig.get_node( f2 ), values.begin(), values.end() ) == true );
+
+  std::vector<kitty::dynamic_truth_table> xs{2, kitty::dynamic_truth_table( 2 )};
+  kitty::create_nth_var( xs[0], 0 );
+  kitty::create_nth_var( xs[1], 1 );
+
+  CHECK( aig.compute( aig.get_node( f1 ), xs.begin(), xs.end() ) == ( ~xs[0] & xs[1] ) );
+  CHECK( aig.compute( aig.get_node( f2 ), xs.begin(), xs.end() ) == ( xs[0] & ~xs[1] ) );
+}
+
+TEST_CASE( "custom node values and visited flags in compact AIGs", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  CHECK( has_clear_values_v<compact_aig_network> );
+  CHECK( has_set_value_v<compact_aig_network> );
+  CHECK( has_clear_visited_v<compact_aig_network> );
+  CHECK( has_set_visited_v<compact_aig_network> );
+
+  const auto x1 = aig.create_pi();
+  const auto x2 = aig.create_pi();
+  aig.create_po( aig.create_and( x1, x2 ) );
+  aig.create_po( aig.create_or( x1, x2 ) );
+
+  aig.clear_values();
+  aig.foreach_node( [&]( auto n ) {
+    CHECK( aig.value( n ) == 0 );
+    aig.set_value( n, n );
+    CHECK( aig.value( n ) == n );
+    CHECK( aig.incr_value( n ) == n );
+    CHECK( aig.value( n ) == n + 1 );
+    CHECK( aig.decr_value( n ) == n );
+    CHECK( aig.value( n ) == n );
+  } );
+  aig.clear_values();
+  aig.foreach_node( [&]( auto n ) {
+    CHECK( aig.value( n ) == 0 );
+  } );
+
+  aig.clear_visited();
+  aig.foreach_node( [&]( auto n ) {
+    CHECK( aig.visited( n ) == 0 );
+    aig.set_visited( n, static_cast<uint32_t>( n ) );
+    CHECK( aig.visited( n ) == static_cast<uint32_t>( n ) );
+  } );
+  aig.clear_visited();
+  aig.foreach_node( [&]( auto n ) {
+    CHECK( aig.visited( n ) == 0 );
+  } );
+}
+
+TEST_CASE( "substitute nodes with propagation in compact AIGs", "[compact_aig]" )
+{
+  CHECK( has_substitute_node_v<compact_aig_network> );
+  CHECK( has_replace_in_node_v<compact_aig_network> );
+
+  compact_aig_network aig;
+  const auto x1 = aig.create_pi();
+  const auto x2 = aig.create_pi();
+  const auto x3 = aig.create_pi();
+
+  const auto f1 = aig.create_and( x1, x2 );
+  const auto f2 = aig.create_and( x1, x3 );
+  const auto f3 = aig.create_and( f1, f2 );
+
+  aig.create_po( f3 );
+
+  CHECK( aig.num_gates() == 3u );
+  CHECK( aig._storage->hash.size() == 3u );
+  CHECK( aig.fanout_size( aig.get_node( f1 ) ) == 1u );
+  CHECK( aig.fanout_size( aig.get_node( f2 ) ) == 1u );
+
+  /* f1 becomes f2, and f3 = f2 & f2 collapses to f2 */
+  aig.substitute_node( aig.get_node( x2 ), x3 );
+
+  CHECK( aig.num_gates() == 1u );
+  CHECK( aig._storage->hash.size() == 1u );
+  CHECK( aig.is_dead( aig.get_node( f1 ) ) );
+  CHECK( aig.is_dead( aig.get_node( f3 ) ) );
+  CHECK( !aig.is_dead( aig.get_node( f2 ) ) );
+  CHECK( aig.po_at( 0 ) == f2 );
+  CHECK( aig.fanout_size( aig.get_node( f2 ) ) == 1u );
+
+  /* the hash table still finds the surviving gate */
+  CHECK( aig.create_and( x3, x1 ) == f2 );
+
+  aig = cleanup_dangling( aig );
+
+  CHECK( aig.num_gates() == 1u );
+}
+
+TEST_CASE( "cut rewriting of a compact AIG preserves its function", "[compact_aig]" )
+{
+  compact_aig_network aig;
+
+  std::vector<compact_aig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return aig.create_pi(); } );
+  auto carry = aig.create_pi();
+  /* a redundant majority, a0 b3 + a0 c + b3 c */
+  aig.create_po( aig.create_or( aig.create_or( aig.create_and( a[0], b[3] ), aig.create_and( a[0], carry ) ), aig.create_and( b[3], carry ) ) );
+  carry_ripple_adder_inplace( aig, a, b, carry );
+  std::for_each( a.begin(), a.end(), [&]( auto f ) { aig.create_po( f ); } );
+  aig.create_po( carry );
+
+  const auto before = simulate<kitty::static_truth_table<9>>( aig );
+  const auto gates_before = aig.num_gates();
+
+  xag_npn_resynthesis<compact_aig_network> resyn;
+  cut_rewriting_params ps;
+  ps.cut_enumeration_ps.cut_size = 4;
+  cut_rewriting( aig, resyn, ps );
+  aig = cleanup_dangling( aig );
+
+  CHECK( aig.num_pis() == 9u );
+  CHECK( aig.num_pos() == 6u );
+  CHECK( aig.num_gates() < gates_before );
+  CHECK( simulate<kitty::static_truth_table<9>>( aig ) == before );
+}
@@ -0,0 +1,339 @@
+#include <catch.hpp>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/node_resynthesis/akers.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/compact_mig.hpp>
+#include <mockturtle/traits.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "create and use constants in a compact MIG", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  CHECK( mig.size() == 1 );
+  CHECK( has_get_constant_v<compact_mig_network> );
+  CHECK( has_is_constant_v<compact_mig_network> );
+  CHECK( sizeof( compact_mig_network::signal ) == 4u );
+
+  const auto c0 = mig.get_constant( false );
+  CHECK( mig.is_constant( mig.get_node( c0 ) ) );
+  CHECK( !mig.is_pi( mig.get_node( c0 ) ) );
+  CHECK( mig.get_node( c0 ) == 0 );
+  CHECK( !mig.is_complemented( c0 ) );
+
+  const auto c1 = mig.get_constant( true );
+
+  CHECK( mig.get_node( c1 ) == 0 );
+  CHECK( mig.is_complemented( c1 ) );
+  CHECK( c0 == !c1 );
+}
+
+TEST_CASE( "create binary and ternary operations in a compact MIG", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  CHECK( has_create_and_v<compact_mig_network> );
+  CHECK( has_create_or_v<compact_mig_network> );
+  CHECK( has_create_xor_v<compact_mig_network> );
+  CHECK( has_create_maj_v<compact_mig_network> );
+
+  const auto x1 = mig.create_pi();
+  const auto x2 = mig.create_pi();
+
+  const auto f1 = mig.create_and( x1, x2 );
+  CHECK( mig.size() == 4 );
+  CHECK( mig.num_gates() == 1 );
+
+  const auto f2 = mig.create_nand( x1, x2 );
+  CHECK( mig.size() == 4 );
+  CHECK( f1 == !f2 );
+
+  const auto f3 = mig.create_or( x1, x2 );
+  CHECK( mig.size() == 5 );
+
+  const auto f4 = mig.create_nor( x1, x2 );
+  CHECK( mig.size() == 5 );
+  CHECK( f3 == !f4 );
+
+  mig.create_xor( x1, x2 );
+  CHECK( mig.size() == 8 );
+
+  mig.create_maj( x1, x2, f1 );
+  CHECK( mig.size() == 9 );
+
+  CHECK( mig.create_maj( x1, x2, mig.get_constant( false ) ) == f1 );
+  CHECK( mig.create_maj( x1, x2, mig.get_constant( true ) ) == f3 );
+  CHECK( mig.create_maj( x1, x1, x2 ) == x1 );
+  CHECK( mig.create_maj( x1, !x1, x2 ) == x2 );
+  CHECK( mig.size() == 9 );
+
+  const auto x3 = mig.create_pi();
+
+  /* at most one complemented child is stored */
+  const auto f8 = mig.create_maj( x1, x2, x3 );
+  const auto f9 = mig.create_maj( !x1, !x2, !x3 );
+  const auto f10 = mig.create_maj( !x1, !x2, x3 );
+  CHECK( f8 == !f9 );
+  CHECK( mig.is_complemented( f10 ) );
+
+  uint32_t complemented{0};
+  mig.foreach_fanin( mig.get_node( f10 ), [&]( auto const& s ) {
+    complemented += mig.is_complemented( s ) ? 1u : 0u;
+  } );
+  CHECK( complemented == 1u );
+}
+
+TEST_CASE( "hash nodes in a compact MIG", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  auto a = mig.create_pi();
+  auto b = mig.create_pi();
+  auto c = mig.create_pi();
+
+  auto f = mig.create_maj( a, b, c );
+  auto g = mig.create_maj( c, a, b );
+
+  CHECK( mig.size() == 5u );
+  CHECK( mig.num_gates() == 1u );
+  CHECK( mig.get_node( f ) == mig.get_node( g ) );
+
+  auto f1 = mig.create_maj( a, !b, c );
+  auto g1 = mig.create_maj( !b, c, a );
+
+  CHECK( mig.size() == 6u );
+  CHECK( mig.num_gates() == 2u );
+  CHECK( mig.get_node( f1 ) == mig.get_node( g1 ) );
+  CHECK( mig._storage->hash.size() == 2u );
+
+  /* enough gates to grow the table several times */
+  std::vector<compact_mig_network::signal> gates{a, b, c};
+  for ( auto i = 0u; i < 500u; ++i )
+  {
+    gates.push_back( mig.create_maj( gates[i], !gates[i + 1], gates[i + 2] ) );
+  }
+  const auto num_gates = mig.num_gates();
+  CHECK( mig._storage->hash.size() == num_gates );
+  for ( auto i = 0u; i < 500u; ++i )
+  {
+    CHECK( mig.create_maj( gates[i + 2], gates[i], !gates[i + 1] ) == gates[i + 3] );
+  }
+  CHECK( mig.num_gates() == num_gates );
+}
+
+TEST_CASE( "clone a node in a compact MIG", "[compact_mig]" )
+{
+  compact_mig_network mig1, mig2;
+
+  CHECK( has_clone_node_v<compact_mig_network> );
+
+  auto a1 = mig1.create_pi();
+  auto b1 = mig1.create_pi();
+  auto c1 = mig1.create_pi();
+  auto f1 = mig1.create_maj( a1, b1, c1 );
+
+  auto a2 = mig2.create_pi();
+  auto b2 = mig2.create_pi();
+  auto c2 = mig2.create_pi();
+  CHECK( mig2.size() == 4 );
+
+  auto f2 = mig2.clone_node( mig1, mig1.get_node( f1 ), {a2, b2, c2} );
+  CHECK( mig2.size() == 5 );
+
+  mig2.foreach_fanin( mig2.get_node( f2 ), [&]( auto const& s ) {
+    CHECK( !mig2.is_complemented( s ) );
+  } );
+}
+
+TEST_CASE( "structural properties of a compact MIG", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  const auto x1 = mig.create_pi();
+  const auto x2 = mig.create_pi();
+  const auto x3 = mig.create_pi();
+
+  const auto f1 = mig.create_maj( x1, x2, x3 );
+  const auto f2 = mig.create_and( x1, x2 );
+
+  mig.create_po( f1 );
+  mig.create_po( f2 );
+
+  CHECK( mig.size() == 6 );
+  CHECK( mig.num_pis() == 3 );
+  CHECK( mig.num_pos() == 2 );
+  CHECK( mig.num_gates() == 2 );
+  CHECK( mig.fanin_size( mig.get_node( x1 ) ) == 0 );
+  CHECK( mig.fanin_size( mig.get_node( f1 ) ) == 3 );
+  CHECK( mig.fanout_size( mig.get_node( x1 ) ) == 2 );
+  CHECK( mig.fanout_size( mig.get_node( x3 ) ) == 1 );
+  CHECK( mig.fanout_size( mig.get_node( f1 ) ) == 1 );
+  CHECK( mig.is_maj( mig.get_node( f1 ) ) );
+  CHECK( !mig.is_and( mig.get_node( f1 ) ) );
+  CHECK( mig.is_and( mig.get_node( f2 ) ) );
+  CHECK( !mig.is_maj( mig.get_node( x1 ) ) );
+}
+
+TEST_CASE( "compute values in compact MIGs", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  CHECK( has_compute_v<compact_mig_network, bool> );
+  CHECK( has_compute_v<compact_mig_network, kitty::dynamic_truth_table> );
+
+  const auto x1 = mig.create_pi();
+  const auto x2 = mig.create_pi();
+  const auto x3 = mig.create_pi();
+  const auto f1 = mig.create_maj( !x1, x2, x3 );
+  const auto f2 = mig.create_maj( x1, !x2, x3 );
+  mig.create_po( f1 );
+  mig.create_po( f2 );
+
+  std::vector<bool> values{{true, false, true}};
+
+  CHECK( mig.compute( mig.get_node( f1 ), values.begin(), values.end() ) == false );
+  CHECK( mig.compute( mig.get_node( f2 ), values.begin(), values.end() ) == true );
+
+  std::vector<kitty::dynamic_truth_table> xs{3, kitty::dynamic_truth_table( 3 )};
+  kitty::create_nth_var( xs[0], 0 );
+  kitty::create_nth_var( xs[1], 1 );
+  kitty::create_nth_var( xs[2], 2 );
+
+  CHECK( mig.compute( mig.get_node( f1 ), xs.begin(), xs.end() ) == kitty::ternary_majority( ~xs[0], xs[1], xs[2] ) );
+  CHECK( mig.compute( mig.get_node( f2 ), xs.begin(), xs.end() ) == kitty::ternary_majority( xs[0], ~xs[1], xs[2] ) );
+}
+
+TEST_CASE( "custom node values and visited flags in compact MIGs", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  const auto x1 = mig.create_pi();
+  const auto x2 = mig.create_pi();
+  const auto x3 = mig.create_pi();
+  mig.create_po( mig.create_maj( x1, x2, x3 ) );
+  mig.create_po( mig.create_or( x1, x2 ) );
+
+  mig.clear_values();
+  mig.foreach_node( [&]( auto n ) {
+    CHECK( mig.value( n ) == 0 );
+    mig.set_value( n, n );
+    CHECK( mig.value( n ) == n );
+    CHECK( mig.incr_value( n ) == n );
+    CHECK( mig.value( n ) == n + 1 );
+    CHECK( mig.decr_value( n ) == n );
+  } );
+  mig.clear_values();
+  mig.foreach_node( [&]( auto n ) {
+    CHECK( mig.value( n ) == 0 );
+  } );
+
+  mig.clear_visited();
+  mig.foreach_node( [&]( auto n ) {
+    CHECK( mig.visited( n ) == 0 );
+    mig.set_visited( n, static_cast<uint32_t>( n ) );
+    CHECK( mig.visited( n ) == static_cast<uint32_t>( n ) );
+  } );
+  mig.clear_visited();
+  mig.foreach_node( [&]( auto n ) {
+    CHECK( mig.visited( n ) == 0 );
+  } );
+}
+
+TEST_CASE( "node substitution in compact MIGs", "[compact_mig]" )
+{
+  compact_mig_network mig;
+  const auto a = mig.create_pi();
+  const auto b = mig.create_pi();
+  const auto f = mig.create_and( a, b );
+
+  CHECK( mig.size() == 4 );
+
+  mig.foreach_fanin( mig.get_node( f ), [&]( auto const& s ) {
+    CHECK( !mig.is_complemented( s ) );
+  } );
+
+  mig.substitute_node( mig.get_node( mig.get_constant( false ) ), mig.get_constant( true ) );
+
+  CHECK( mig.size() == 4 );
+
+  mig.foreach_fanin( mig.get_node( f ), [&]( auto const& s, auto i ) {
+    switch ( i )
+    {
+    case 0:
+      CHECK( mig.is_complemented( s ) );
+      break;
+    default:
+      CHECK( !mig.is_complemented( s ) );
+      break;
+    }
+  } );
+}
+
+TEST_CASE( "substitute nodes with propagation in compact MIGs", "[compact_mig]" )
+{
+  compact_mig_network mig;
+  const auto x1 = mig.create_pi();
+  const auto x2 = mig.create_pi();
+  const auto x3 = mig.create_pi();
+  const auto x4 = mig.create_pi();
+
+  const auto f1 = mig.create_maj( x1, x2, x4 );
+  const auto f2 = mig.create_maj( x1, x3, x4 );
+  const auto f3 = mig.create_maj( f1, f2, x2 );
+
+  mig.create_po( f3 );
+
+  CHECK( mig.num_gates() == 3u );
+  CHECK( mig._storage->hash.size() == 3u );
+
+  /* f1 becomes f2, and f3 = <f2 f2 x2> collapses to f2 */
+  mig.substitute_node( mig.get_node( x2 ), x3 );
+
+  CHECK( mig.num_gates() == 1u );
+  CHECK( mig._storage->hash.size() == 1u );
+  CHECK( mig.is_dead( mig.get_node( f1 ) ) );
+  CHECK( mig.is_dead( mig.get_node( f3 ) ) );
+  CHECK( !mig.is_dead( mig.get_node( f2 ) ) );
+  CHECK( mig.po_at( 0 ) == f2 );
+  CHECK( mig.fanout_size( mig.get_node( f2 ) ) == 1u );
+  CHECK( mig.create_maj( x4, x3, x1 ) == f2 );
+
+  mig = cleanup_dangling( mig );
+
+  CHECK( mig.num_gates() == 1u );
+}
+
+TEST_CASE( "cut rewriting of a compact MIG preserves its function", "[compact_mig]" )
+{
+  compact_mig_network mig;
+
+  std::vector<compact_mig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return mig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return mig.create_pi(); } );
+  auto carry = mig.create_pi();
+  /* a redundant majority, a0 b3 + a0 c + b3 c */
+  mig.create_po( mig.create_or( mig.create_or( mig.create_and( a[0], b[3] ), mig.create_and( a[0], carry ) ), mig.create_and( b[3], carry ) ) );
+  carry_ripple_adder_inplace( mig, a, b, carry );
+  std::for_each( a.begin(), a.end(), [&]( auto f ) { mig.create_po( f ); } );
+  mig.create_po( carry );
+
+  const auto before = simulate<kitty::static_truth_table<9>>( mig );
+  const auto gates_before = mig.num_gates();
+
+  akers_resynthesis<compact_mig_network> resyn;
+  cut_rewriting( mig, resyn );
+  mig = cleanup_dangling( mig );
+
+  CHECK( mig.num_pis() == 9u );
+  CHECK( mig.num_pos() == 6u );
+  CHECK( mig.num_gates() < gates_before );
+  CHECK( simulate<kitty::static_truth_table<9>>( mig ) == before );
+}
@@ -0,0 +1,253 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/storage.hpp>
+#include <mockturtle/networks/strash_table.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+using and_node = regular_node<2, 2, 1>;
+using maj_node = regular_node<3, 2, 1>;
+
+and_node make_and( uint64_t a, uint64_t b )
+{
+  and_node n;
+  n.children[0] = {a, 0};
+  n.children[1] = {b, 1};
+  return n;
+}
+
+maj_node make_maj( uint64_t a, uint64_t b, uint64_t c )
+{
+  maj_node n;
+  n.children[0] = {a, 0};
+  n.children[1] = {b, 1};
+  n.children[2] = {c, 0};
+  return n;
+}
+
+} // namespace
+
+TEST_CASE( "insert and find in a strash table", "[strash_table]" )
+{
+  strash_table<and_node> table;
+
+  CHECK( table.empty() );
+  CHECK( table.find( make_and( 1, 2 ) ) == table.end() );
+
+  table[make_and( 1, 2 )] = 3;
+  table[make_and( 1, 3 )] = 4;
+
+  CHECK( table.size() == 2u );
+  REQUIRE( table.find( make_and( 1, 2 ) ) != table.end() );
+  CHECK( table.find( make_and( 1, 2 ) )->second == 3u );
+  CHECK( table.find( make_and( 1, 3 ) )->second == 4u );
+
+  /* the complement of a child is part of the key */
+  auto n = make_and( 1, 2 );
+  n.children[0].weight = 1;
+  CHECK( table.find( n ) == table.end() );
+
+  /* operator[] on an existing key does not insert */
+  CHECK( table[make_and( 1, 2 )] == 3u );
+  CHECK( table.size() == 2u );
+
+  strash_table<and_node> const& ctable = table;
+  CHECK( ctable.find( make_and( 1, 3 ) )->second == 4u );
+
+  table.clear();
+  CHECK( table.empty() );
+  CHECK( table.find( make_and( 1, 2 ) ) == table.end() );
+}
+
+TEST_CASE( "insert and find 3-input keys in a strash table", "[strash_table]" )
+{
+  strash_table<maj_node> table;
+
+  table[make_maj( 1, 2, 3 )] = 4;
+  table[make_maj( 1, 2, 4 )] = 5;
+
+  CHECK( table.size() == 2u );
+  CHECK( table.find( make_maj( 1, 2, 3 ) )->second == 4u );
+  CHECK( table.find( make_maj( 1, 2, 4 ) )->second == 5u );
+  CHECK( table.find( make_maj( 1, 3, 2 ) ) == table.end() );
+}
+
+TEST_CASE( "grow a strash table", "[strash_table]" )
+{
+  strash_table<and_node> table;
+
+  const auto initial = table.capacity();
+  for ( auto i = 0u; i < 10000u; ++i )
+  {
+    table[make_and( i, i + 1 )] = i;
+  }
+
+  CHECK( table.size() == 10000u );
+  CHECK( table.capacity() > initial );
+  /* power of two number of slots, at most 87.5% full */
+  CHECK( ( table.capacity() & ( table.capacity() - 1u ) ) == 0u );
+  CHECK( table.size() <= table.capacity() - table.capacity() / 8u );
+
+  for ( auto i = 0u; i < 10000u; ++i )
+  {
+    const auto it = table.find( make_and( i, i + 1 ) );
+    REQUIRE( it != table.end() );
+    CHECK( it->second == i );
+  }
+  CHECK( table.find( make_and( 10000, 10001 ) ) == table.end() );
+}
+
+TEST_CASE( "reserve space in a strash table", "[strash_table]" )
+{
+  strash_table<and_node> table;
+
+  table[make_and( 1, 2 )] = 3;
+  table.reserve( 5000u );
+
+  const auto capacity = table.capacity();
+  CHECK( capacity - capacity / 8u >= 5000u );
+  CHECK( table.find( make_and( 1, 2 ) )->second == 3u );
+
+  for ( auto i = 0u; i < 5000u; ++i )
+  {
+    table[make_and( i + 2, i + 3 )] = i;
+  }
+  CHECK( table.capacity() == capacity );
+
+  /* reserving less than the capacity never shrinks the table */
+  table.reserve( 10u );
+  CHECK( table.capacity() == capacity );
+}
+
+TEST_CASE( "erase from a strash table and reinsert", "[strash_table]" )
+{
+  strash_table<and_node> table;
+
+  CHECK( table.erase( make_and( 1, 2 ) ) == 0u );
+
+  const auto num_keys = 4000u;
+  for ( auto i = 0u; i < num_keys; ++i )
+  {
+    table[make_and( i, i + 1 )] = i;
+  }
+  const auto capacity = table.capacity();
+
+  /* erase every other key, leaving deleted slots in full groups */
+  for ( auto i = 0u; i < num_keys; i += 2u )
+  {
+    CHECK( table.erase( make_and( i, i + 1 ) ) == 1u );
+  }
+  CHECK( table.erase( make_and( 0, 1 ) ) == 0u );
+  CHECK( table.size() == num_keys / 2u );
+
+  /* probes continue past deleted slots */
+  for ( auto i = 0u; i < num_keys; ++i )
+  {
+    const auto it = table.find( make_and( i, i + 1 ) );
+    if ( i % 2u == 0u )
+    {
+      CHECK( it == table.end() );
+    }
+    else
+    {
+      REQUIRE( it != table.end() );
+      CHECK( it->second == i );
+    }
+  }
+
+  /* reinserted keys take new values and are not duplicated */
+  for ( auto i = 0u; i < num_keys; i += 2u )
+  {
+    table[make_and( i, i + 1 )] = i + num_keys;
+  }
+  CHECK( table.size() == num_keys );
+  for ( auto i = 0u; i < num_keys; ++i )
+  {
+    CHECK( table.find( make_and( i, i + 1 ) )->second == ( i % 2u == 0u ? i + num_keys : i ) );
+  }
+
+  /* repeated erase and insert of a stable number of keys reuses deleted
+     slots instead of growing the table */
+  for ( auto round = 0u; round < 20u; ++round )
+  {
+    for ( auto i = 0u; i < num_keys; i += 2u )
+    {
+      table.erase( make_and( i + round * num_keys, i + round * num_keys + 1 ) );
+      table[make_and( i + ( round + 1 ) * num_keys, i + ( round + 1 ) * num_keys + 1 )] = i;
+    }
+  }
+  CHECK( table.size() == num_keys );
+  CHECK( table.capacity() == capacity );
+}
+
+TEST_CASE( "rebuild a strash table from a node array", "[strash_table]" )
+{
+  strash_table<and_node> table;
+  table[make_and( 7, 9 )] = 1;
+
+  std::vector<and_node> nodes;
+  for ( auto i = 0u; i < 3000u; ++i )
+  {
+    nodes.push_back( make_and( i, i + 1 ) );
+  }
+
+  table.rebuild( nodes, []( auto i ) { return i % 3u != 0u; } );
+
+  CHECK( table.size() == 2000u );
+  CHECK( table.find( make_and( 7, 9 ) ) == table.end() );
+  for ( auto i = 0u; i < nodes.size(); ++i )
+  {
+    const auto it = table.find( nodes[i] );
+    if ( i % 3u == 0u )
+    {
+      CHECK( it == table.end() );
+    }
+    else
+    {
+      REQUIRE( it != table.end() );
+      CHECK( it->second == i );
+    }
+  }
+}
+
+TEST_CASE( "rehash gates created without structural hashing", "[strash_table]" )
+{
+  aig_network aig;
+
+  CHECK( has_create_and_unhashed_v<aig_network> );
+
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto c = aig.create_pi();
+
+  const auto f1 = aig.create_and_unhashed( a, b );
+  const auto f2 = aig.create_and_unhashed( !b, c );
+  const auto f3 = aig.create_and_unhashed( f1, f2 );
+  CHECK( aig.create_and_unhashed( a, !a ) == aig.get_constant( false ) );
+
+  CHECK( aig.num_gates() == 3u );
+  CHECK( aig._storage->hash.size() == 0u );
+
+  aig.rehash_gates();
+
+  CHECK( aig._storage->hash.size() == 3u );
+  CHECK( aig.create_and( b, a ) == f1 );
+  CHECK( aig.create_and( c, !b ) == f2 );
+  CHECK( aig.create_and( f2, f1 ) == f3 );
+  CHECK( aig.num_gates() == 3u );
+
+  /* dead gates are left out */
+  aig.create_po( f3 );
+  aig.substitute_node( aig.get_node( f2 ), c );
+  aig.rehash_gates();
+
+  CHECK( aig.is_dead( aig.get_node( f2 ) ) );
+  CHECK( aig._storage->hash.size() == 2u );
+  CHECK( aig.create_and( f1, c ) == aig.po_at( 0 ) );
+}
@@ -0,0 +1,92 @@
+#include <fdeep/fdeep.hpp>
+#include <alice/alice.hpp>
+#include <mockturtle/mockturtle.hpp>
+#include <libkahypar.h>
+#include <gtest/gtest.h>
+
+#include "algorithms/partitioning/partition_view.hpp"
+#include "utility.hpp"
+#include "profiler.hpp"
+#include "resources.hpp"
+#include "algorithms/optimization/aig_script.hpp"
+#include "algorithms/optimization/mig_script.hpp"
+#include "algorithms/optimization/partition_verification.hpp"
+#include "algorithms/optimization/dual_candidate.hpp"
+
+#include <array>
+#include <vector>
+
+namespace
+{
+  /* two levels of majorities over nine inputs, four gates as an MIG */
+  template<class Ntk>
+  Ntk majority_tree(){
+    Ntk ntk;
+    std::vector<typename Ntk::signal> pis;
+    for(auto i = 0; i < 9; i++)
+      pis.push_back(ntk.create_pi());
+    std::array<typename Ntk::signal, 3> level;
+    for(auto i = 0; i < 3; i++)
+      level[i] = ntk.create_maj(pis[3 * i], pis[3 * i + 1], pis[3 * i + 2]);
+    ntk.create_po(ntk.create_maj(level[0], level[1], level[2]));
+    return ntk;
+  }
+
+  constexpr unsigned area = 1u;
+}
+
+TEST(dual_candidate, support_bound_stops_the_aig_of_majority_logic)
+{
+  auto aig = majority_tree<mockturtle::aig_network>();
+  auto mig = majority_tree<mockturtle::mig_network>();
+  oracle::candidate_monitor monitor(area, 0u, oracle::witnessed_support(aig));
+
+  oracle::mig_script migopt;
+  const auto mig_opt = migopt.run(mig);
+  mockturtle::depth_view mig_depth{mig_opt};
+  monitor.finish(false, mig_opt.num_gates(), mig_depth.depth());
+
+  /* 9 inputs need at least 8 AND gates, more than the 4 majorities */
+  int passes = 0;
+  oracle::aig_script aigopt;
+  aigopt.run(aig, [&](auto const&){ passes++; return monitor.keep_going(true); });
+  EXPECT_TRUE(monitor.cancelled(true));
+  EXPECT_EQ(passes, 1);
+}
+
+TEST(dual_candidate, progress_bound_stops_a_converged_candidate)
+{
+  oracle::candidate_monitor monitor(area, 0u, 0u);
+  monitor.finish(true, 100, 10);
+  monitor.start(false, 300, 20, 9);
+
+  /* large gains in the first window keep the MIG going */
+  EXPECT_TRUE(monitor.keep_going(false, 200, 18));
+  EXPECT_TRUE(monitor.keep_going(false, 195, 18));
+  EXPECT_TRUE(monitor.keep_going(false, 194, 18));
+
+  /* 7 gates over the last window, at most 14 in the remaining 5 passes are
+     not enough to get from 193 to 100 gates */
+  EXPECT_FALSE(monitor.keep_going(false, 193, 17));
+  EXPECT_TRUE(monitor.cancelled(false));
+  EXPECT_FALSE(monitor.cancelled(true));
+}
+
+TEST(dual_candidate, progress_bound_keeps_an_improving_candidate)
+{
+  oracle::candidate_monitor monitor(area, 0u, 0u);
+  monitor.finish(true, 100, 10);
+  monitor.start(false, 300, 20, 9);
+
+  for(auto size : {260, 230, 200, 170, 150, 130})
+    EXPECT_TRUE(monitor.keep_going(false, size, 20));
+  EXPECT_FALSE(monitor.cancelled(false));
+}
+
+TEST(dual_candidate, unstarted_candidates_use_the_support_bound_only)
+{
+  oracle::candidate_monitor monitor(area, 0u, 0u);
+  monitor.finish(true, 100, 10);
+  for(auto i = 0; i < 9; i++)
+    EXPECT_TRUE(monitor.keep_going(false, 192, 17));
+}
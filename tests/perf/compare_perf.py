@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Compares two google-benchmark JSON reports of perf_tests and fails if any
+benchmark of the baseline got slower, or allocates more, than allowed."""
+import argparse
+import json
+import sys
+
+parser = argparse.ArgumentParser(prog='compare_perf', description='Regression check for the LSOracle performance suite')
+parser.add_argument('baseline', help='JSON report of the baseline run')
+parser.add_argument('current', help='JSON report of the run to check')
+parser.add_argument('--threshold', '-t', type=float, default=0.10,
+                    help='allowed relative increase of the time per iteration (default 0.10)')
+parser.add_argument('--alloc_threshold', type=float, default=0.05,
+                    help='allowed relative increase of the allocations per iteration (default 0.05)')
+parser.add_argument('--metric', choices=['real_time', 'cpu_time'], default='cpu_time',
+                    help='time measurement to compare (default cpu_time)')
+args = parser.parse_args()
+
+
+def load(filename):
+    with open(filename) as f:
+        report = json.load(f)
+    # Use the median when the suite was run with repetitions
+    results = {}
+    for b in report['benchmarks']:
+        if b.get('run_type') == 'aggregate' and b.get('aggregate_name') != 'median':
+            continue
+        results[b.get('run_name', b['name'])] = b
+    return results
+
+
+baseline = load(args.baseline)
+current = load(args.current)
+
+regressions = []
+print('{:<40} {:>12} {:>12} {:>8} {:>8}'.format('benchmark', 'baseline', 'current', 'time', 'allocs'))
+for name, base in baseline.items():
+    if name not in current:
+        print('{:<40} missing from the current run'.format(name))
+        continue
+    cur = current[name]
+    time_change = cur[args.metric] / base[args.metric] - 1.0 if base[args.metric] > 0 else 0.0
+    alloc_change = 0.0
+    if base.get('allocs', 0) > 0 and 'allocs' in cur:
+        alloc_change = cur['allocs'] / base['allocs'] - 1.0
+    flag = ''
+    if time_change > args.threshold or alloc_change > args.alloc_threshold:
+        flag = ' REGRESSION'
+        regressions.append(name)
+    print('{:<40} {:>10.3f}{:<2} {:>10.3f}{:<2} {:>+7.1%} {:>+7.1%}{}'.format(
+        name, base[args.metric], base['time_unit'], cur[args.metric], cur['time_unit'], time_change, alloc_change, flag))
+
+for name in current:
+    if name not in baseline:
+        print('{:<40} not in the baseline'.format(name))
+
+if regressions:
+    print('{} of {} benchmarks regressed'.format(len(regressions), len(baseline)))
+    sys.exit(1)
+print('No regressions')
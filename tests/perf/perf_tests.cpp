@@ -0,0 +1,383 @@
+/* Performance suite for the LSOracle kernels.
+ *
+ * Every benchmark is registered once per input design. The bundled designs
+ * in tests/end_to_end are always used, more can be given in
+ * LSORACLE_PERF_INPUTS as a colon separated list of .aig, .blif or .v files
+ * or directories containing them.
+ *
+ * Write a baseline with
+ *   perf_tests --benchmark_out=baseline.json --benchmark_out_format=json
+ * and compare a later run against it with tests/perf/compare_perf.py.
+ */
+#include <fdeep/fdeep.hpp>
+#include <alice/alice.hpp>
+#include <mockturtle/mockturtle.hpp>
+#include <libkahypar.h>
+#include <benchmark/benchmark.h>
+
+#include "algorithms/partitioning/partition_view.hpp"
+#include "algorithms/partitioning/hyperg.hpp"
+#include "utility.hpp"
+#include "profiler.hpp"
+#include "resources.hpp"
+#include "algorithms/partitioning/partition_manager.hpp"
+#include "algorithms/partitioning/partition_extract.hpp"
+#include "algorithms/optimization/aig_script.hpp"
+#include "algorithms/optimization/mig_script.hpp"
+#include "algorithms/asic_mapping/techmapping.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using aig_names = mockturtle::names_view<mockturtle::aig_network>;
+using mig_names = mockturtle::names_view<mockturtle::mig_network>;
+
+namespace
+{
+  /* KaHyPar and the partition manager report on stdout, which would be
+     interleaved with the benchmark table */
+  class quiet_scope{
+  public:
+    quiet_scope() : old(std::cout.rdbuf(sink.rdbuf())) {}
+    ~quiet_scope(){ std::cout.rdbuf(old); }
+
+  private:
+    std::ostringstream sink;
+    std::streambuf* old;
+  };
+
+  bool read_network(std::string const& filename, aig_names& ntk){
+    const auto ext = fs::path(filename).extension().string();
+    if(ext == ".aig")
+      return mockturtle::read_aiger_mmap(filename, ntk) == lorina::return_code::success;
+    if(ext == ".blif"){
+      /* as in read, BLIF is read as a k-LUT network and resynthesized */
+      mockturtle::klut_network klut;
+      mockturtle::names_view<mockturtle::klut_network> klut_names{klut};
+      if(lorina::read_blif(filename, mockturtle::blif_reader(klut_names)) != lorina::return_code::success)
+        return false;
+      mockturtle::xag_npn_resynthesis<mockturtle::aig_network> resyn;
+      mockturtle::node_resynthesis(ntk, klut_names, resyn);
+      return true;
+    }
+    if(ext == ".v")
+      return lorina::read_verilog(filename, mockturtle::verilog_reader(ntk)) == lorina::return_code::success;
+    return false;
+  }
+
+  /* One input design with the state shared by its benchmarks, built on
+     first use so that filtered out benchmarks cost nothing */
+  class design{
+  public:
+    explicit design(std::string filename) : filename(std::move(filename)) {}
+
+    std::string name() const { return fs::path(filename).stem().string(); }
+
+    aig_names load() const {
+      aig_names ntk;
+      read_network(filename, ntk);
+      return ntk;
+    }
+
+    aig_names& network(){
+      if(!ntk){
+        ntk = std::make_unique<aig_names>(load());
+        num_parts = std::max(1, (int) std::ceil(ntk->size() / 300.0));
+      }
+      return *ntk;
+    }
+
+    int partition_count(){
+      network();
+      return num_parts;
+    }
+
+    oracle::partition_manager<aig_names>& partitions(){
+      if(!manager){
+        quiet_scope quiet;
+        manager = std::make_unique<oracle::partition_manager<aig_names>>(network(), num_parts);
+      }
+      return *manager;
+    }
+
+    /* Copy of the design in another format, for the reader benchmarks */
+    std::string const& converted(std::string const& ext){
+      auto& file = ext == ".blif" ? blif_file : verilog_file;
+      if(file.empty()){
+        file = fs::path(fs::temp_directory_path() / ("lsoracle_perf_" + name() + ext)).string();
+        if(ext == ".blif")
+          mockturtle::write_blif(network(), file);
+        else
+          mockturtle::write_verilog(network(), file);
+      }
+      return file;
+    }
+
+    ~design(){
+      for(auto const& file : {blif_file, verilog_file})
+        if(!file.empty())
+          std::remove(file.c_str());
+    }
+
+    std::string filename;
+
+  private:
+    std::unique_ptr<aig_names> ntk;
+    std::unique_ptr<oracle::partition_manager<aig_names>> manager;
+    int num_parts{1};
+    std::string blif_file;
+    std::string verilog_file;
+  };
+
+  std::vector<std::string> perf_inputs(){
+    std::vector<std::string> paths{PERF_INPUT_DIR};
+    if(auto const* extra = std::getenv("LSORACLE_PERF_INPUTS")){
+      std::stringstream ss(extra);
+      std::string path;
+      while(std::getline(ss, path, ':'))
+        if(!path.empty())
+          paths.push_back(path);
+    }
+
+    std::vector<std::string> files;
+    auto add = [&](fs::path const& p){
+      const auto ext = p.extension().string();
+      if(ext == ".aig" || ext == ".blif" || ext == ".v")
+        files.push_back(p.string());
+    };
+    for(auto const& path : paths){
+      if(fs::is_directory(path)){
+        std::vector<fs::path> entries;
+        for(auto const& entry : fs::directory_iterator(path))
+          entries.push_back(entry.path());
+        std::sort(entries.begin(), entries.end());
+        for(auto const& entry : entries)
+          add(entry);
+      }
+      else if(fs::exists(path)){
+        add(path);
+      }
+      else{
+        std::cerr << "[w] perf input " << path << " does not exist\n";
+      }
+    }
+    return files;
+  }
+
+  /* Reports the allocations made by the timed region per iteration */
+  class allocation_counter{
+  public:
+    explicit allocation_counter(benchmark::State& state) : state(state), start(oracle::thread_allocations), start_bytes(oracle::thread_allocated_bytes) {}
+
+    ~allocation_counter(){
+      state.counters["allocs"] = benchmark::Counter(oracle::thread_allocations - start, benchmark::Counter::kAvgIterations);
+      state.counters["alloc_bytes"] = benchmark::Counter(oracle::thread_allocated_bytes - start_bytes, benchmark::Counter::kAvgIterations);
+    }
+
+  private:
+    benchmark::State& state;
+    uint64_t start;
+    uint64_t start_bytes;
+  };
+
+  void set_size(benchmark::State& state, aig_names const& ntk){
+    state.counters["gates"] = ntk.num_gates();
+  }
+
+  void bm_read(benchmark::State& state, design* d){
+    set_size(state, d->network());
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      auto ntk = d->load();
+      benchmark::DoNotOptimize(ntk.size());
+    }
+  }
+
+  void bm_read_converted(benchmark::State& state, design* d, std::string ext){
+    set_size(state, d->network());
+    auto const& file = d->converted(ext);
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      aig_names ntk;
+      read_network(file, ntk);
+      benchmark::DoNotOptimize(ntk.size());
+    }
+  }
+
+  void bm_hypergraph(benchmark::State& state, design* d){
+    auto& ntk = d->network();
+    set_size(state, ntk);
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      oracle::hypergraph<aig_names> t(ntk);
+      t.get_hypergraph(ntk);
+      std::vector<uint32_t> connections;
+      t.return_hyperedges(connections);
+      benchmark::DoNotOptimize(connections.data());
+    }
+  }
+
+  void bm_partition(benchmark::State& state, design* d){
+    auto& ntk = d->network();
+    set_size(state, ntk);
+    d->partitions();
+    state.counters["parts"] = d->partition_count();
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      quiet_scope quiet;
+      oracle::partition_manager<aig_names> partitions(ntk, d->partition_count());
+      benchmark::DoNotOptimize(partitions.get_part_num());
+    }
+  }
+
+  void bm_create_part(benchmark::State& state, design* d){
+    auto& ntk = d->network();
+    auto& partitions = d->partitions();
+    set_size(state, ntk);
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      for(int i = 0; i < partitions.get_part_num(); i++){
+        auto part = partitions.create_part(ntk, i);
+        benchmark::DoNotOptimize(part.size());
+      }
+    }
+  }
+
+  template<class Ntk, class Script>
+  void bm_script(benchmark::State& state, design* d){
+    auto& ntk = d->network();
+    auto& partitions = d->partitions();
+    set_size(state, ntk);
+    oracle::partition_extractor<aig_names> extractor(ntk);
+    std::vector<oracle::partition_view<aig_names>> parts;
+    for(int i = 0; i < partitions.get_part_num(); i++)
+      parts.push_back(partitions.create_part(ntk, i));
+
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      for(auto const& part : parts){
+        state.PauseTiming();
+        auto opt = extractor.extract<Ntk>(part);
+        state.ResumeTiming();
+        Script script;
+        opt = script.run(opt);
+        benchmark::DoNotOptimize(opt.size());
+      }
+    }
+  }
+
+  void bm_synchronize_part(benchmark::State& state, design* d){
+    auto& partitions = d->partitions();
+    set_size(state, d->network());
+    oracle::partition_extractor<aig_names> extractor(d->network());
+    std::vector<mockturtle::aig_network> opts;
+    for(int i = 0; i < partitions.get_part_num(); i++){
+      auto opt = extractor.extract<mockturtle::aig_network>(partitions.create_part(d->network(), i));
+      oracle::aig_script script;
+      opts.push_back(script.run(opt));
+    }
+
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      state.PauseTiming();
+      auto ntk = d->load();
+      std::vector<oracle::partition_view<aig_names>> parts;
+      for(int i = 0; i < partitions.get_part_num(); i++)
+        parts.push_back(partitions.create_part(ntk, i));
+      state.ResumeTiming();
+      for(auto i = 0u; i < parts.size(); i++)
+        partitions.synchronize_part(parts[i], opts[i], ntk);
+      benchmark::DoNotOptimize(ntk.size());
+    }
+  }
+
+  void bm_lut_mapping(benchmark::State& state, design* d){
+    auto& ntk = d->network();
+    set_size(state, ntk);
+    mockturtle::lut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 6;
+    ps.cut_enumeration_ps.cut_limit = 8;
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      mockturtle::mapping_view<aig_names, true> mapped{ntk};
+      mockturtle::lut_mapping<mockturtle::mapping_view<aig_names, true>, true>(mapped, ps);
+      benchmark::DoNotOptimize(mapped.num_cells());
+    }
+  }
+
+  void bm_techmap(benchmark::State& state, design* d){
+    /* techmap_mapped_network loads its cell library from this fixed path */
+    if(!fs::exists("../../NPN_complete_noZero.json")){
+      state.SkipWithError("../../NPN_complete_noZero.json not found, run from a build directory two levels below the repository");
+      return;
+    }
+    auto& ntk = d->network();
+    set_size(state, ntk);
+    mockturtle::mapping_view<aig_names, true> mapped{ntk};
+    mockturtle::lut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 4;
+    ps.cut_enumeration_ps.cut_limit = 4;
+    mockturtle::lut_mapping<mockturtle::mapping_view<aig_names, true>, true>(mapped, ps);
+    const auto klut = *mockturtle::collapse_mapped_network<mockturtle::klut_network>(mapped);
+    mockturtle::topo_view klut_topo{klut};
+
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      quiet_scope quiet;
+      auto techmapped = oracle::techmap_mapped_network<mockturtle::klut_network>(klut_topo);
+      benchmark::DoNotOptimize(std::get<0>(techmapped).size());
+    }
+  }
+
+  void bm_write_verilog(benchmark::State& state, design* d){
+    auto& ntk = d->network();
+    set_size(state, ntk);
+    allocation_counter allocs(state);
+    for(auto _ : state){
+      std::ostringstream os;
+      mockturtle::write_verilog(ntk, os);
+      benchmark::DoNotOptimize(os.tellp());
+    }
+  }
+}
+
+int main(int argc, char** argv){
+  benchmark::Initialize(&argc, argv);
+  if(benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  std::vector<std::unique_ptr<design>> designs;
+  for(auto const& file : perf_inputs())
+    designs.push_back(std::make_unique<design>(file));
+
+  for(auto const& d : designs){
+    const auto name = d->name();
+    auto add = [&](std::string const& kernel, auto&& fn, auto... args){
+      benchmark::RegisterBenchmark((kernel + "/" + name).c_str(), fn, d.get(), args...)->Unit(benchmark::kMillisecond);
+    };
+    add("read", bm_read);
+    add("read_blif", bm_read_converted, std::string(".blif"));
+    add("read_verilog", bm_read_converted, std::string(".v"));
+    add("hypergraph", bm_hypergraph);
+    add("partition", bm_partition);
+    add("create_part", bm_create_part);
+    add("aig_script", bm_script<mockturtle::aig_network, oracle::aig_script>);
+    add("mig_script", bm_script<mockturtle::mig_network, oracle::mig_script>);
+    add("synchronize_part", bm_synchronize_part);
+    add("lut_mapping", bm_lut_mapping);
+    add("techmap", bm_techmap);
+    add("write_verilog", bm_write_verilog);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
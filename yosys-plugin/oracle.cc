@@ -46,11 +46,37 @@
 #define LSO_COMMAND_AIG "ps -a; aigscript; ps -a "
 #define LSO_COMMAND_PART_EXCLU_AIG "ps -a; partitioning {P}; optimization -a; ps -a "
 #define LSO_COMMAND_PART_EXCLU_MIG "ps -a; partitioning {P}; optimization -m; ps -m; crit_path_stats; ntk_stats "
-#define LSO_COMMAND_PART_DEEP "ps -a; partitioning {P}; optimization -i {D}; ps -m; crit_path_stats; ntk_stats "
+#define LSO_COMMAND_PART_DEEP "ps -a; partitioning {P}; optimization -n {D}; ps -m; crit_path_stats; ntk_stats "
 #define LSO_COMMAND_PART_HIGH_EFFORT "ps -a; oracle; ps -m; crit_path_stats; ntk_stats "
-#define LSO_COMMAND_PART_DEEP_M "ps -a; partitioning {P}; optimization -i {D} -c; ps -m; crit_path_stats; ntk_stats "
+#define LSO_COMMAND_PART_DEEP_M "ps -a; partitioning {P}; optimization -n {D} -c; ps -m; crit_path_stats; ntk_stats "
 #define LSO_COMMAND_PART_HIGH_EFFORT_M "ps -a; oracle -c; ps -m; crit_path_stats; ntk_stats "
 
+// LSOracle core, linked into the plugin for the in-process flow. Included before
+// the Yosys headers so that their macros do not leak into the core.
+#include <fdeep/fdeep.hpp>
+#include <alice/alice.hpp>
+#include <mockturtle/mockturtle.hpp>
+#include <libkahypar.h>
+#include "algorithms/partitioning/partition_view.hpp"
+#include "algorithms/partitioning/hyperg.hpp"
+#include "utility.hpp"
+#include "profiler.hpp"
+#include "resources.hpp"
+#include "algorithms/partitioning/partition_manager.hpp"
+#include "algorithms/optimization/aig_script.hpp"
+#include "algorithms/optimization/mig_script.hpp"
+#include "algorithms/optimization/partition_verification.hpp"
+#include "algorithms/optimization/dual_candidate.hpp"
+#include "algorithms/optimization/optimization.hpp"
+#include "algorithms/optimization/optimization_test.hpp"
+#include "kahypar_config.hpp"
+#include <alice/server.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "kernel/register.h"
 #include "kernel/sigtools.h"
 #include "kernel/celltypes.h"
@@ -68,6 +94,8 @@
 #ifndef _WIN32
 #  include <unistd.h>
 #  include <dirent.h>
+#  include <sys/socket.h>
+#  include <sys/un.h>
 #endif
 
 #include "frontends/blif/blifparse.h"
@@ -112,437 +140,13 @@ struct gate_t
 	RTLIL::State init;
 };
 
+
 bool map_mux4;
 bool map_mux8;
 bool map_mux16;
 
 bool markgroups;
-int map_autoidx;
-SigMap assign_map;
-RTLIL::Module *module;
-std::vector<gate_t> signal_list;
-std::map<RTLIL::SigBit, int> signal_map;
-std::map<RTLIL::SigBit, RTLIL::State> signal_init;
 pool<std::string> enabled_gates;
-bool recover_init;
-
-bool clk_polarity, en_polarity;
-RTLIL::SigSpec clk_sig, en_sig;
-dict<int, std::string> pi_map, po_map;
-
-int map_signal(RTLIL::SigBit bit, gate_type_t gate_type = G(NONE), int in1 = -1, int in2 = -1, int in3 = -1, int in4 = -1)
-{
-	assign_map.apply(bit);
-
-	if (signal_map.count(bit) == 0) {
-		gate_t gate;
-		gate.id = signal_list.size();
-		gate.type = G(NONE);
-		gate.in1 = -1;
-		gate.in2 = -1;
-		gate.in3 = -1;
-		gate.in4 = -1;
-		gate.is_port = false;
-		gate.bit = bit;
-		if (signal_init.count(bit))
-			gate.init = signal_init.at(bit);
-		else
-			gate.init = State::Sx;
-		signal_list.push_back(gate);
-		signal_map[bit] = gate.id;
-	}
-
-	gate_t &gate = signal_list[signal_map[bit]];
-
-	if (gate_type != G(NONE))
-		gate.type = gate_type;
-	if (in1 >= 0)
-		gate.in1 = in1;
-	if (in2 >= 0)
-		gate.in2 = in2;
-	if (in3 >= 0)
-		gate.in3 = in3;
-	if (in4 >= 0)
-		gate.in4 = in4;
-
-	return gate.id;
-}
-
-void mark_port(RTLIL::SigSpec sig)
-{
-	for (auto &bit : assign_map(sig))
-		if (bit.wire != NULL && signal_map.count(bit) > 0)
-			signal_list[signal_map[bit]].is_port = true;
-}
-
-void extract_cell(RTLIL::Cell *cell, bool keepff)
-{
-	if (cell->type == "$_DFF_N_" || cell->type == "$_DFF_P_")
-	{
-		if (clk_polarity != (cell->type == "$_DFF_P_"))
-			return;
-		if (clk_sig != assign_map(cell->getPort("\\C")))
-			return;
-		if (GetSize(en_sig) != 0)
-			return;
-		goto matching_dff;
-	}
-
-	if (cell->type == "$_DFFE_NN_" || cell->type == "$_DFFE_NP_" || cell->type == "$_DFFE_PN_" || cell->type == "$_DFFE_PP_")
-	{
-		if (clk_polarity != (cell->type == "$_DFFE_PN_" || cell->type == "$_DFFE_PP_"))
-			return;
-		if (en_polarity != (cell->type == "$_DFFE_NP_" || cell->type == "$_DFFE_PP_"))
-			return;
-		if (clk_sig != assign_map(cell->getPort("\\C")))
-			return;
-		if (en_sig != assign_map(cell->getPort("\\E")))
-			return;
-		goto matching_dff;
-	}
-
-	if (0) {
-	matching_dff:
-		RTLIL::SigSpec sig_d = cell->getPort("\\D");
-		RTLIL::SigSpec sig_q = cell->getPort("\\Q");
-
-		if (keepff)
-			for (auto &c : sig_q.chunks())
-				if (c.wire != NULL)
-					c.wire->attributes["\\keep"] = 1;
-
-		assign_map.apply(sig_d);
-		assign_map.apply(sig_q);
-
-		map_signal(sig_q, G(FF), map_signal(sig_d));
-
-		module->remove(cell);
-		return;
-	}
-
-	if (cell->type.in("$_BUF_", "$_NOT_"))
-	{
-		RTLIL::SigSpec sig_a = cell->getPort("\\A");
-		RTLIL::SigSpec sig_y = cell->getPort("\\Y");
-
-		assign_map.apply(sig_a);
-		assign_map.apply(sig_y);
-
-		map_signal(sig_y, cell->type == "$_BUF_" ? G(BUF) : G(NOT), map_signal(sig_a));
-
-		module->remove(cell);
-		return;
-	}
-
-	if (cell->type.in("$_AND_", "$_NAND_", "$_OR_", "$_NOR_", "$_XOR_", "$_XNOR_", "$_ANDNOT_", "$_ORNOT_"))
-	{
-		RTLIL::SigSpec sig_a = cell->getPort("\\A");
-		RTLIL::SigSpec sig_b = cell->getPort("\\B");
-		RTLIL::SigSpec sig_y = cell->getPort("\\Y");
-
-		assign_map.apply(sig_a);
-		assign_map.apply(sig_b);
-		assign_map.apply(sig_y);
-
-		int mapped_a = map_signal(sig_a);
-		int mapped_b = map_signal(sig_b);
-
-		if (cell->type == "$_AND_")
-			map_signal(sig_y, G(AND), mapped_a, mapped_b);
-		else if (cell->type == "$_NAND_")
-			map_signal(sig_y, G(NAND), mapped_a, mapped_b);
-		else if (cell->type == "$_OR_")
-			map_signal(sig_y, G(OR), mapped_a, mapped_b);
-		else if (cell->type == "$_NOR_")
-			map_signal(sig_y, G(NOR), mapped_a, mapped_b);
-		else if (cell->type == "$_XOR_")
-			map_signal(sig_y, G(XOR), mapped_a, mapped_b);
-		else if (cell->type == "$_XNOR_")
-			map_signal(sig_y, G(XNOR), mapped_a, mapped_b);
-		else if (cell->type == "$_ANDNOT_")
-			map_signal(sig_y, G(ANDNOT), mapped_a, mapped_b);
-		else if (cell->type == "$_ORNOT_")
-			map_signal(sig_y, G(ORNOT), mapped_a, mapped_b);
-		else
-			log_abort();
-
-		module->remove(cell);
-		return;
-	}
-
-	if (cell->type == "$_MUX_")
-	{
-		RTLIL::SigSpec sig_a = cell->getPort("\\A");
-		RTLIL::SigSpec sig_b = cell->getPort("\\B");
-		RTLIL::SigSpec sig_s = cell->getPort("\\S");
-		RTLIL::SigSpec sig_y = cell->getPort("\\Y");
-
-		assign_map.apply(sig_a);
-		assign_map.apply(sig_b);
-		assign_map.apply(sig_s);
-		assign_map.apply(sig_y);
-
-		int mapped_a = map_signal(sig_a);
-		int mapped_b = map_signal(sig_b);
-		int mapped_s = map_signal(sig_s);
-
-		map_signal(sig_y, G(MUX), mapped_a, mapped_b, mapped_s);
-
-		module->remove(cell);
-		return;
-	}
-
-	if (cell->type.in("$_AOI3_", "$_OAI3_"))
-	{
-		RTLIL::SigSpec sig_a = cell->getPort("\\A");
-		RTLIL::SigSpec sig_b = cell->getPort("\\B");
-		RTLIL::SigSpec sig_c = cell->getPort("\\C");
-		RTLIL::SigSpec sig_y = cell->getPort("\\Y");
-
-		assign_map.apply(sig_a);
-		assign_map.apply(sig_b);
-		assign_map.apply(sig_c);
-		assign_map.apply(sig_y);
-
-		int mapped_a = map_signal(sig_a);
-		int mapped_b = map_signal(sig_b);
-		int mapped_c = map_signal(sig_c);
-
-		map_signal(sig_y, cell->type == "$_AOI3_" ? G(AOI3) : G(OAI3), mapped_a, mapped_b, mapped_c);
-
-		module->remove(cell);
-		return;
-	}
-
-	if (cell->type.in("$_AOI4_", "$_OAI4_"))
-	{
-		RTLIL::SigSpec sig_a = cell->getPort("\\A");
-		RTLIL::SigSpec sig_b = cell->getPort("\\B");
-		RTLIL::SigSpec sig_c = cell->getPort("\\C");
-		RTLIL::SigSpec sig_d = cell->getPort("\\D");
-		RTLIL::SigSpec sig_y = cell->getPort("\\Y");
-
-		assign_map.apply(sig_a);
-		assign_map.apply(sig_b);
-		assign_map.apply(sig_c);
-		assign_map.apply(sig_d);
-		assign_map.apply(sig_y);
-
-		int mapped_a = map_signal(sig_a);
-		int mapped_b = map_signal(sig_b);
-		int mapped_c = map_signal(sig_c);
-		int mapped_d = map_signal(sig_d);
-
-		map_signal(sig_y, cell->type == "$_AOI4_" ? G(AOI4) : G(OAI4), mapped_a, mapped_b, mapped_c, mapped_d);
-
-		module->remove(cell);
-		return;
-	}
-}
-
-std::string remap_name(RTLIL::IdString abc_name, RTLIL::Wire **orig_wire = nullptr)
-{
-	std::string abc_sname = abc_name.substr(1);
-	bool isnew = false;
-	if (abc_sname.substr(0, 4) == "new_")
-	{
-		abc_sname.erase(0, 4);
-		isnew = true;
-	}
-	if (abc_sname.substr(0, 5) == "ys__n")
-	{
-		abc_sname.erase(0, 5);
-		if (std::isdigit(abc_sname.at(0)))
-		{
-			int sid = std::stoi(abc_sname);
-			size_t postfix_start = abc_sname.find_first_not_of("0123456789");
-			std::string postfix = postfix_start != std::string::npos ? abc_sname.substr(postfix_start) : "";
-
-			if (sid < GetSize(signal_list))
-			{
-				auto sig = signal_list.at(sid);
-				if (sig.bit.wire != nullptr)
-				{
-					std::stringstream sstr;
-					sstr << "$abc$" << map_autoidx << "$" << sig.bit.wire->name.substr(1);
-					if (sig.bit.wire->width != 1)
-						sstr << "[" << sig.bit.offset << "]";
-					if (isnew)
-						sstr << "_new";
-					sstr << postfix;
-					if (orig_wire != nullptr)
-						*orig_wire = sig.bit.wire;
-					return sstr.str();
-				}
-			}
-		}
-	}
-	std::stringstream sstr;
-	sstr << "$abc$" << map_autoidx << "$" << abc_name.substr(1);
-	return sstr.str();
-}
-
-void dump_loop_graph(FILE *f, int &nr, std::map<int, std::set<int>> &edges, std::set<int> &workpool, std::vector<int> &in_counts)
-{
-	if (f == NULL)
-		return;
-
-	log("Dumping loop state graph to slide %d.\n", ++nr);
-
-	fprintf(f, "digraph \"slide%d\" {\n", nr);
-	fprintf(f, "  label=\"slide%d\";\n", nr);
-	fprintf(f, "  rankdir=\"TD\";\n");
-
-	std::set<int> nodes;
-	for (auto &e : edges) {
-		nodes.insert(e.first);
-		for (auto n : e.second)
-			nodes.insert(n);
-	}
-
-	for (auto n : nodes)
-		fprintf(f, "  ys__n%d [label=\"%s\\nid=%d, count=%d\"%s];\n", n, log_signal(signal_list[n].bit),
-				n, in_counts[n], workpool.count(n) ? ", shape=box" : "");
-
-	for (auto &e : edges)
-	for (auto n : e.second)
-		fprintf(f, "  ys__n%d -> ys__n%d;\n", e.first, n);
-
-	fprintf(f, "}\n");
-}
-
-void handle_loops()
-{
-	// http://en.wikipedia.org/wiki/Topological_sorting
-	// (Kahn, Arthur B. (1962), "Topological sorting of large networks")
-
-	std::map<int, std::set<int>> edges;
-	std::vector<int> in_edges_count(signal_list.size());
-	std::set<int> workpool;
-
-	FILE *dot_f = NULL;
-	int dot_nr = 0;
-
-	// uncomment for troubleshooting the loop detection code
-	// dot_f = fopen("test.dot", "w");
-
-	for (auto &g : signal_list) {
-		if (g.type == G(NONE) || g.type == G(FF)) {
-			workpool.insert(g.id);
-		} else {
-			if (g.in1 >= 0) {
-				edges[g.in1].insert(g.id);
-				in_edges_count[g.id]++;
-			}
-			if (g.in2 >= 0 && g.in2 != g.in1) {
-				edges[g.in2].insert(g.id);
-				in_edges_count[g.id]++;
-			}
-			if (g.in3 >= 0 && g.in3 != g.in2 && g.in3 != g.in1) {
-				edges[g.in3].insert(g.id);
-				in_edges_count[g.id]++;
-			}
-			if (g.in4 >= 0 && g.in4 != g.in3 && g.in4 != g.in2 && g.in4 != g.in1) {
-				edges[g.in4].insert(g.id);
-				in_edges_count[g.id]++;
-			}
-		}
-	}
-
-	dump_loop_graph(dot_f, dot_nr, edges, workpool, in_edges_count);
-
-	while (workpool.size() > 0)
-	{
-		int id = *workpool.begin();
-		workpool.erase(id);
-
-		// log("Removing non-loop node %d from graph: %s\n", id, log_signal(signal_list[id].bit));
-
-		for (int id2 : edges[id]) {
-			log_assert(in_edges_count[id2] > 0);
-			if (--in_edges_count[id2] == 0)
-				workpool.insert(id2);
-		}
-		edges.erase(id);
-
-		dump_loop_graph(dot_f, dot_nr, edges, workpool, in_edges_count);
-
-		while (workpool.size() == 0)
-		{
-			if (edges.size() == 0)
-				break;
-
-			int id1 = edges.begin()->first;
-
-			for (auto &edge_it : edges) {
-				int id2 = edge_it.first;
-				RTLIL::Wire *w1 = signal_list[id1].bit.wire;
-				RTLIL::Wire *w2 = signal_list[id2].bit.wire;
-				if (w1 == NULL)
-					id1 = id2;
-				else if (w2 == NULL)
-					continue;
-				else if (w1->name[0] == '$' && w2->name[0] == '\\')
-					id1 = id2;
-				else if (w1->name[0] == '\\' && w2->name[0] == '$')
-					continue;
-				else if (edges[id1].size() < edges[id2].size())
-					id1 = id2;
-				else if (edges[id1].size() > edges[id2].size())
-					continue;
-				else if (w2->name.str() < w1->name.str())
-					id1 = id2;
-			}
-
-			if (edges[id1].size() == 0) {
-				edges.erase(id1);
-				continue;
-			}
-
-			log_assert(signal_list[id1].bit.wire != NULL);
-
-			std::stringstream sstr;
-			sstr << "$abcloop$" << (autoidx++);
-			RTLIL::Wire *wire = module->addWire(sstr.str());
-
-			bool first_line = true;
-			for (int id2 : edges[id1]) {
-				if (first_line)
-					log("Breaking loop using new signal %s: %s -> %s\n", log_signal(RTLIL::SigSpec(wire)),
-							log_signal(signal_list[id1].bit), log_signal(signal_list[id2].bit));
-				else
-					log("                               %*s  %s -> %s\n", int(strlen(log_signal(RTLIL::SigSpec(wire)))), "",
-							log_signal(signal_list[id1].bit), log_signal(signal_list[id2].bit));
-				first_line = false;
-			}
-
-			int id3 = map_signal(RTLIL::SigSpec(wire));
-			signal_list[id1].is_port = true;
-			signal_list[id3].is_port = true;
-			log_assert(id3 == int(in_edges_count.size()));
-			in_edges_count.push_back(0);
-			workpool.insert(id3);
-
-			for (int id2 : edges[id1]) {
-				if (signal_list[id2].in1 == id1)
-					signal_list[id2].in1 = id3;
-				if (signal_list[id2].in2 == id1)
-					signal_list[id2].in2 = id3;
-				if (signal_list[id2].in3 == id1)
-					signal_list[id2].in3 = id3;
-				if (signal_list[id2].in4 == id1)
-					signal_list[id2].in4 = id3;
-			}
-			edges[id1].swap(edges[id3]);
-
-			module->connect(RTLIL::SigSig(signal_list[id3].bit, signal_list[id1].bit));
-			dump_loop_graph(dot_f, dot_nr, edges, workpool, in_edges_count);
-		}
-	}
-
-	if (dot_f != NULL)
-		fclose(dot_f);
-}
 
 std::string add_echos_to_abc_cmd(std::string str)
 {
@@ -617,8 +221,10 @@ struct lso_output_filter
 	std::string linebuf;
 	std::string tempdir_name;
 	bool show_tempdir;
+	const dict<int, std::string> &pi_map, &po_map;
 
-	lso_output_filter(std::string tempdir_name, bool show_tempdir) : tempdir_name(tempdir_name), show_tempdir(show_tempdir)
+	lso_output_filter(std::string tempdir_name, bool show_tempdir, const dict<int, std::string> &pi_map, const dict<int, std::string> &po_map) :
+			tempdir_name(tempdir_name), show_tempdir(show_tempdir), pi_map(pi_map), po_map(po_map)
 	{
 		got_cr = false;
 		escape_seq_state = 0;
@@ -677,7 +283,10 @@ struct abc_output_filter
 	std::string tempdir_name;
 	bool show_tempdir;
 
-	abc_output_filter(std::string tempdir_name, bool show_tempdir) : tempdir_name(tempdir_name), show_tempdir(show_tempdir)
+	const dict<int, std::string> &pi_map, &po_map;
+
+	abc_output_filter(std::string tempdir_name, bool show_tempdir, const dict<int, std::string> &pi_map, const dict<int, std::string> &po_map) :
+			tempdir_name(tempdir_name), show_tempdir(show_tempdir), pi_map(pi_map), po_map(po_map)
 	{
 		got_cr = false;
 		escape_seq_state = 0;
@@ -814,7 +423,6 @@ std::string generate_lso_script(std::string exe_file, std::string input_aig_file
 
 std::string write_lso_script(std::string lso_script, std::string tempdir_name )
 {
-	log("LSOracle script: %s\n", lso_script.c_str());
 	std::string filename = stringf("%s/lso.script", tempdir_name.c_str());
 	FILE *f = fopen(filename.c_str(), "wt");
 	fprintf(f, "%s\n", lso_script.c_str());
@@ -822,291 +430,1113 @@ std::string write_lso_script(std::string lso_script, std::string tempdir_name )
 	return filename;
 }
 
-void lso_module(std::string exe_file, std::string tempdir_name, bool show_tempdir, std::string filename)
+#ifndef _WIN32
+// Runs the script as one job of a server started with `lsoracle --serve --socket <path>`,
+// see lib/alice/include/alice/server.hpp for the protocol.
+int lso_submit(std::string socket_path, std::string filename, std::function<void(const std::string&)> process_line, std::string &error)
 {
-	std::string buffer = stringf("%s -f %s 2>&1", exe_file.c_str(), filename.c_str());
-	log("Running LSOracle command: %s\n", replace_tempdir(buffer, tempdir_name, show_tempdir).c_str());
-	lso_output_filter filt(tempdir_name, show_tempdir);
-	int ret = run_command(buffer, std::bind(&lso_output_filter::next_line, filt, std::placeholders::_1));
+	std::ifstream script_file(filename);
+	std::stringstream script;
+	script << script_file.rdbuf();
+	std::string payload = script.str();
+
+	sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(addr.sun_path)) {
+		error = stringf("LSOracle: server socket path \"%s\" is too long.", socket_path.c_str());
+		return -1;
+	}
+	strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+		error = stringf("LSOracle: cannot connect to server \"%s\": %s", socket_path.c_str(), strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+
+	static std::atomic<int> job_id{0};
+	std::string request = stringf("job %d %zu\n", ++job_id, payload.size()) + payload + "quit\n";
+	for (size_t done = 0; done < request.size();) {
+		ssize_t n = send(fd, request.data() + done, request.size() - done, MSG_NOSIGNAL);
+		if (n <= 0) {
+			error = stringf("LSOracle: sending job to server failed: %s", strerror(errno));
+			close(fd);
+			return -1;
+		}
+		done += n;
+	}
+
+	std::string response;
+	char buffer[4096];
+	ssize_t n;
+	while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+		response.append(buffer, n);
+	close(fd);
+
+	char id[1024];
+	int status;
+	size_t size, header_end = response.find('\n');
+	if (header_end == std::string::npos || sscanf(response.c_str(), "done %1023s %d %zu", id, &status, &size) != 3) {
+		error = stringf("LSOracle: unexpected response from server: %s", response.substr(0, header_end).c_str());
+		return -1;
+	}
+
+	std::stringstream output(response.substr(header_end + 1, size));
+	std::string line;
+	while (std::getline(output, line))
+		process_line(line + "\n");
+	if (status != 0)
+		error = stringf("LSOracle: job failed on server \"%s\".", socket_path.c_str());
+	return status;
+}
+#endif
 
+// Runs the script and returns the exit status of LSOracle, does not log so
+// that modules can be processed concurrently
+int lso_module(std::string exe_file, std::string lso_server, std::string filename, std::function<void(const std::string&)> process_line,
+		std::string &command, std::string &error)
+{
+#ifndef _WIN32
+	if (!lso_server.empty()) {
+		command = stringf("job on server %s", lso_server.c_str());
+		return lso_submit(lso_server, filename, process_line, error);
+	}
+#endif
+	command = stringf("%s -f %s 2>&1", exe_file.c_str(), filename.c_str());
+	int ret = run_command(command, process_line);
 	if (ret != 0)
-		log_error("LSOracle: execution of command \"%s\" failed: return code %d.\n", buffer.c_str(), ret);
+		error = stringf("LSOracle: execution of command \"%s\" failed: return code %d.", command.c_str(), ret);
+	return ret;
 }
 
-void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::string script_file, std::string abcexe_file,std::string lsoexe_file,
-		std::string liberty_file, std::string constr_file, bool cleanup, vector<int> lut_costs, bool dff_mode, std::string clk_str,
-		bool keepff, std::string delay_target, std::string sop_inputs, std::string sop_products, std::string lutin_shared, bool fast_mode,
-		const std::vector<RTLIL::Cell*> &cells, bool show_tempdir, bool sop_mode, bool abc_dress, std::string num_parts, bool partitioned,
-		bool exclu_part, bool mig, bool deep, bool merge, bool test, bool aig, bool lut)
+// In-process flow: the extracted gate graph is built as an AIG, optimized by the
+// linked LSOracle core and written back as RTLIL cells, without temporary files.
+
+typedef mockturtle::names_view<mockturtle::aig_network> lso_aig_t;
+typedef mockturtle::aig_network::signal lso_signal_t;
+
+lso_signal_t lso_create_gate(lso_aig_t &ntk, const gate_t &si, const std::vector<lso_signal_t> &sigs)
 {
-	module = current_module;
-	map_autoidx = autoidx++;
+	lso_signal_t a = si.in1 >= 0 ? sigs[si.in1] : ntk.get_constant(false);
+	lso_signal_t b = si.in2 >= 0 ? sigs[si.in2] : ntk.get_constant(false);
+	lso_signal_t c = si.in3 >= 0 ? sigs[si.in3] : ntk.get_constant(false);
+	lso_signal_t d = si.in4 >= 0 ? sigs[si.in4] : ntk.get_constant(false);
+
+	switch (si.type) {
+	case G(NONE):
+		// constants, and undriven signals which are not ports
+		return ntk.get_constant(si.bit == State::S1);
+	case G(BUF):
+		return a;
+	case G(NOT):
+		return !a;
+	case G(AND):
+		return ntk.create_and(a, b);
+	case G(NAND):
+		return !ntk.create_and(a, b);
+	case G(OR):
+		return ntk.create_or(a, b);
+	case G(NOR):
+		return !ntk.create_or(a, b);
+	case G(XOR):
+		return ntk.create_xor(a, b);
+	case G(XNOR):
+		return !ntk.create_xor(a, b);
+	case G(ANDNOT):
+		return ntk.create_and(a, !b);
+	case G(ORNOT):
+		return ntk.create_or(a, !b);
+	case G(MUX):
+		return ntk.create_ite(c, b, a);
+	case G(AOI3):
+		return !ntk.create_or(ntk.create_and(a, b), c);
+	case G(OAI3):
+		return !ntk.create_and(ntk.create_or(a, b), c);
+	case G(AOI4):
+		return !ntk.create_or(ntk.create_and(a, b), ntk.create_and(c, d));
+	case G(OAI4):
+		return !ntk.create_and(ntk.create_or(a, b), ntk.create_or(c, d));
+	default:
+		log_abort();
+	}
+}
 
-	signal_map.clear();
-	signal_list.clear();
-	pi_map.clear();
-	po_map.clear();
-	recover_init = false;
+// same mapping as the lut_map command
+template<class Ntk>
+mockturtle::klut_network lso_lut_map(const Ntk &ntk)
+{
+	mockturtle::mapping_view<Ntk, true> mapped{ntk};
+	mockturtle::lut_mapping_params ps;
+	ps.cut_enumeration_ps.cut_size = 6;
+	ps.cut_enumeration_ps.cut_limit = 8;
+	mockturtle::lut_mapping<mockturtle::mapping_view<Ntk, true>, true>(mapped, ps);
+	return *mockturtle::collapse_mapped_network<mockturtle::klut_network>(mapped);
+}
+
+// Sends what the core prints on this thread to a buffer while a flow runs,
+// std::cout is routed per thread by lso_run_jobs()
+struct lso_cout_capture
+{
+	std::streambuf *saved;
 
-	if (clk_str != "$")
+	lso_cout_capture(std::stringstream &buffer) : saved(alice::detail::routed_streambuf::target())
 	{
-		clk_polarity = true;
-		clk_sig = RTLIL::SigSpec();
+		alice::detail::routed_streambuf::target() = buffer.rdbuf();
+	}
+	~lso_cout_capture() { alice::detail::routed_streambuf::target() = saved; }
+};
+
+// Options of the pass, shared by all jobs
+struct lso_config_t
+{
+	std::string script_file, abcexe_file, lsoexe_file, lso_server, liberty_file, constr_file, clk_str;
+	std::string delay_target, sop_inputs, sop_products, lutin_shared;
+	bool fast_mode, dff_mode, keepff, cleanup, show_tempdir, sop_mode, abc_dress;
+	vector<int> lut_costs;
+	std::string num_parts;
+	bool partitioned, exclu_part, mig, deep, merge, test, aig, lut, inprocess;
+};
 
-		en_polarity = true;
-		en_sig = RTLIL::SigSpec();
+enum class lso_output_t {
+	HEADER,
+	NOTE,
+	WARNING,
+	ABC,
+	LSO
+};
+
+// One module or clock domain handed to LSOracle. prepare() and integrate() read
+// and modify the design, and are called on the main thread in the order of the
+// modules. run() only works on the extracted netlist and may run concurrently
+// with the run() of other jobs, so it buffers its log output and errors, which
+// integrate() reports.
+struct lso_job_t
+{
+	const lso_config_t &config;
+	RTLIL::Module *module;
+	int map_autoidx;
+	SigMap assign_map;
+	std::vector<gate_t> signal_list;
+	std::map<RTLIL::SigBit, int> signal_map;
+	std::map<RTLIL::SigBit, RTLIL::State> signal_init;
+	bool recover_init;
+
+	bool clk_polarity, en_polarity;
+	RTLIL::SigSpec clk_sig, en_sig;
+	dict<int, std::string> pi_map, po_map;
+
+	bool inprocess;
+	int count_output;
+	std::string tempdir_name, blif_input_file, aiger_temp_file, tmp_script_name, blif_output_file;
+	lso_aig_t ntk;
+	mockturtle::aig_network opt_aig;
+	mockturtle::mig_network opt_mig;
+	mockturtle::klut_network opt_klut;
+	bool is_mig;
+	std::vector<std::pair<lso_output_t, std::string>> output;
+	std::string error;
+
+	lso_job_t(const lso_config_t &config) : config(config), module(nullptr), map_autoidx(0), recover_init(false),
+			clk_polarity(true), en_polarity(true), inprocess(config.inprocess), count_output(0), is_mig(false) { }
+
+	int map_signal(RTLIL::SigBit bit, gate_type_t gate_type = G(NONE), int in1 = -1, int in2 = -1, int in3 = -1, int in4 = -1)
+	{
+		assign_map.apply(bit);
+
+		if (signal_map.count(bit) == 0) {
+			gate_t gate;
+			gate.id = signal_list.size();
+			gate.type = G(NONE);
+			gate.in1 = -1;
+			gate.in2 = -1;
+			gate.in3 = -1;
+			gate.in4 = -1;
+			gate.is_port = false;
+			gate.bit = bit;
+			if (signal_init.count(bit))
+				gate.init = signal_init.at(bit);
+			else
+				gate.init = State::Sx;
+			signal_list.push_back(gate);
+			signal_map[bit] = gate.id;
+		}
+
+		gate_t &gate = signal_list[signal_map[bit]];
+
+		if (gate_type != G(NONE))
+			gate.type = gate_type;
+		if (in1 >= 0)
+			gate.in1 = in1;
+		if (in2 >= 0)
+			gate.in2 = in2;
+		if (in3 >= 0)
+			gate.in3 = in3;
+		if (in4 >= 0)
+			gate.in4 = in4;
+
+		return gate.id;
 	}
 
-	if (!clk_str.empty() && clk_str != "$")
+	void mark_port(RTLIL::SigSpec sig)
 	{
-		if (clk_str.find(',') != std::string::npos) {
-			int pos = clk_str.find(',');
-			std::string en_str = clk_str.substr(pos+1);
-			clk_str = clk_str.substr(0, pos);
-			if (en_str[0] == '!') {
-				en_polarity = false;
-				en_str = en_str.substr(1);
-			}
-			if (module->wires_.count(RTLIL::escape_id(en_str)) != 0)
-				en_sig = assign_map(RTLIL::SigSpec(module->wires_.at(RTLIL::escape_id(en_str)), 0));
+		for (auto &bit : assign_map(sig))
+			if (bit.wire != NULL && signal_map.count(bit) > 0)
+				signal_list[signal_map[bit]].is_port = true;
+	}
+
+	void extract_cell(RTLIL::Cell *cell, bool keepff)
+	{
+		if (cell->type == "$_DFF_N_" || cell->type == "$_DFF_P_")
+		{
+			if (clk_polarity != (cell->type == "$_DFF_P_"))
+				return;
+			if (clk_sig != assign_map(cell->getPort("\\C")))
+				return;
+			if (GetSize(en_sig) != 0)
+				return;
+			goto matching_dff;
 		}
-		if (clk_str[0] == '!') {
-			clk_polarity = false;
-			clk_str = clk_str.substr(1);
+
+		if (cell->type == "$_DFFE_NN_" || cell->type == "$_DFFE_NP_" || cell->type == "$_DFFE_PN_" || cell->type == "$_DFFE_PP_")
+		{
+			if (clk_polarity != (cell->type == "$_DFFE_PN_" || cell->type == "$_DFFE_PP_"))
+				return;
+			if (en_polarity != (cell->type == "$_DFFE_NP_" || cell->type == "$_DFFE_PP_"))
+				return;
+			if (clk_sig != assign_map(cell->getPort("\\C")))
+				return;
+			if (en_sig != assign_map(cell->getPort("\\E")))
+				return;
+			goto matching_dff;
 		}
-		if (module->wires_.count(RTLIL::escape_id(clk_str)) != 0)
-			clk_sig = assign_map(RTLIL::SigSpec(module->wires_.at(RTLIL::escape_id(clk_str)), 0));
-	}
 
-	if (dff_mode && clk_sig.empty())
-		log_cmd_error("Clock domain %s not found.\n", clk_str.c_str());
+		if (0) {
+		matching_dff:
+			RTLIL::SigSpec sig_d = cell->getPort("\\D");
+			RTLIL::SigSpec sig_q = cell->getPort("\\Q");
 
-	std::string tempdir_name = "/tmp/yosys-abc-XXXXXX";
-	if (!cleanup)
-		tempdir_name[0] = tempdir_name[4] = '_';
-	tempdir_name = make_temp_dir(tempdir_name);
+			if (keepff)
+				for (auto &c : sig_q.chunks())
+					if (c.wire != NULL)
+						c.wire->attributes["\\keep"] = 1;
 
-	std::string blif_input_file = tempdir_name + "/input.blif";
-	std::string aiger_temp_file = tempdir_name + "/abc.aig";
-	std::string tmp_script_name = tempdir_name + "/abc.script";
-	std::string blif_output_file = tempdir_name + "/output.blif";
+			assign_map.apply(sig_d);
+			assign_map.apply(sig_q);
 
-	log_header(design, "Extracting gate netlist of module `%s' to `%s/input.blif'..\n",
-			module->name.c_str(), replace_tempdir(tempdir_name, tempdir_name, show_tempdir).c_str());
+			map_signal(sig_q, G(FF), map_signal(sig_d));
 
-	std::string abc_script = stringf("read_blif %s; strash; write %s", blif_input_file.c_str(), aiger_temp_file.c_str());
+			module->remove(cell);
+			return;
+		}
 
-	abc_script = add_echos_to_abc_cmd(abc_script);
+		if (cell->type.in("$_BUF_", "$_NOT_"))
+		{
+			RTLIL::SigSpec sig_a = cell->getPort("\\A");
+			RTLIL::SigSpec sig_y = cell->getPort("\\Y");
 
-	for (size_t i = 0; i+1 < abc_script.size(); i++)
-		if (abc_script[i] == ';' && abc_script[i+1] == ' ')
-			abc_script[i+1] = '\n';
+			assign_map.apply(sig_a);
+			assign_map.apply(sig_y);
 
-	FILE *f = fopen(tmp_script_name.c_str(), "wt");
-	fprintf(f, "%s\n", abc_script.c_str());
-	fclose(f);
+			map_signal(sig_y, cell->type == "$_BUF_" ? G(BUF) : G(NOT), map_signal(sig_a));
 
-	if (dff_mode || !clk_str.empty())
-	{
-		if (clk_sig.size() == 0)
-			log("No%s clock domain found. Not extracting any FF cells.\n", clk_str.empty() ? "" : " matching");
-		else {
-			log("Found%s %s clock domain: %s", clk_str.empty() ? "" : " matching", clk_polarity ? "posedge" : "negedge", log_signal(clk_sig));
-			if (en_sig.size() != 0)
-				log(", enabled by %s%s", en_polarity ? "" : "!", log_signal(en_sig));
-			log("\n");
+			module->remove(cell);
+			return;
+		}
+
+		if (cell->type.in("$_AND_", "$_NAND_", "$_OR_", "$_NOR_", "$_XOR_", "$_XNOR_", "$_ANDNOT_", "$_ORNOT_"))
+		{
+			RTLIL::SigSpec sig_a = cell->getPort("\\A");
+			RTLIL::SigSpec sig_b = cell->getPort("\\B");
+			RTLIL::SigSpec sig_y = cell->getPort("\\Y");
+
+			assign_map.apply(sig_a);
+			assign_map.apply(sig_b);
+			assign_map.apply(sig_y);
+
+			int mapped_a = map_signal(sig_a);
+			int mapped_b = map_signal(sig_b);
+
+			if (cell->type == "$_AND_")
+				map_signal(sig_y, G(AND), mapped_a, mapped_b);
+			else if (cell->type == "$_NAND_")
+				map_signal(sig_y, G(NAND), mapped_a, mapped_b);
+			else if (cell->type == "$_OR_")
+				map_signal(sig_y, G(OR), mapped_a, mapped_b);
+			else if (cell->type == "$_NOR_")
+				map_signal(sig_y, G(NOR), mapped_a, mapped_b);
+			else if (cell->type == "$_XOR_")
+				map_signal(sig_y, G(XOR), mapped_a, mapped_b);
+			else if (cell->type == "$_XNOR_")
+				map_signal(sig_y, G(XNOR), mapped_a, mapped_b);
+			else if (cell->type == "$_ANDNOT_")
+				map_signal(sig_y, G(ANDNOT), mapped_a, mapped_b);
+			else if (cell->type == "$_ORNOT_")
+				map_signal(sig_y, G(ORNOT), mapped_a, mapped_b);
+			else
+				log_abort();
+
+			module->remove(cell);
+			return;
+		}
+
+		if (cell->type == "$_MUX_")
+		{
+			RTLIL::SigSpec sig_a = cell->getPort("\\A");
+			RTLIL::SigSpec sig_b = cell->getPort("\\B");
+			RTLIL::SigSpec sig_s = cell->getPort("\\S");
+			RTLIL::SigSpec sig_y = cell->getPort("\\Y");
+
+			assign_map.apply(sig_a);
+			assign_map.apply(sig_b);
+			assign_map.apply(sig_s);
+			assign_map.apply(sig_y);
+
+			int mapped_a = map_signal(sig_a);
+			int mapped_b = map_signal(sig_b);
+			int mapped_s = map_signal(sig_s);
+
+			map_signal(sig_y, G(MUX), mapped_a, mapped_b, mapped_s);
+
+			module->remove(cell);
+			return;
+		}
+
+		if (cell->type.in("$_AOI3_", "$_OAI3_"))
+		{
+			RTLIL::SigSpec sig_a = cell->getPort("\\A");
+			RTLIL::SigSpec sig_b = cell->getPort("\\B");
+			RTLIL::SigSpec sig_c = cell->getPort("\\C");
+			RTLIL::SigSpec sig_y = cell->getPort("\\Y");
+
+			assign_map.apply(sig_a);
+			assign_map.apply(sig_b);
+			assign_map.apply(sig_c);
+			assign_map.apply(sig_y);
+
+			int mapped_a = map_signal(sig_a);
+			int mapped_b = map_signal(sig_b);
+			int mapped_c = map_signal(sig_c);
+
+			map_signal(sig_y, cell->type == "$_AOI3_" ? G(AOI3) : G(OAI3), mapped_a, mapped_b, mapped_c);
+
+			module->remove(cell);
+			return;
+		}
+
+		if (cell->type.in("$_AOI4_", "$_OAI4_"))
+		{
+			RTLIL::SigSpec sig_a = cell->getPort("\\A");
+			RTLIL::SigSpec sig_b = cell->getPort("\\B");
+			RTLIL::SigSpec sig_c = cell->getPort("\\C");
+			RTLIL::SigSpec sig_d = cell->getPort("\\D");
+			RTLIL::SigSpec sig_y = cell->getPort("\\Y");
+
+			assign_map.apply(sig_a);
+			assign_map.apply(sig_b);
+			assign_map.apply(sig_c);
+			assign_map.apply(sig_d);
+			assign_map.apply(sig_y);
+
+			int mapped_a = map_signal(sig_a);
+			int mapped_b = map_signal(sig_b);
+			int mapped_c = map_signal(sig_c);
+			int mapped_d = map_signal(sig_d);
+
+			map_signal(sig_y, cell->type == "$_AOI4_" ? G(AOI4) : G(OAI4), mapped_a, mapped_b, mapped_c, mapped_d);
+
+			module->remove(cell);
+			return;
 		}
 	}
 
-	for (auto c : cells)
-		extract_cell(c, keepff);
+	std::string remap_name(RTLIL::IdString abc_name, RTLIL::Wire **orig_wire = nullptr)
+	{
+		std::string abc_sname = abc_name.substr(1);
+		bool isnew = false;
+		if (abc_sname.substr(0, 4) == "new_")
+		{
+			abc_sname.erase(0, 4);
+			isnew = true;
+		}
+		if (abc_sname.substr(0, 5) == "ys__n")
+		{
+			abc_sname.erase(0, 5);
+			if (std::isdigit(abc_sname.at(0)))
+			{
+				int sid = std::stoi(abc_sname);
+				size_t postfix_start = abc_sname.find_first_not_of("0123456789");
+				std::string postfix = postfix_start != std::string::npos ? abc_sname.substr(postfix_start) : "";
 
-	for (auto &wire_it : module->wires_) {
-		if (wire_it.second->port_id > 0 || wire_it.second->get_bool_attribute("\\keep"))
-			mark_port(RTLIL::SigSpec(wire_it.second));
+				if (sid < GetSize(signal_list))
+				{
+					auto sig = signal_list.at(sid);
+					if (sig.bit.wire != nullptr)
+					{
+						std::stringstream sstr;
+						sstr << "$abc$" << map_autoidx << "$" << sig.bit.wire->name.substr(1);
+						if (sig.bit.wire->width != 1)
+							sstr << "[" << sig.bit.offset << "]";
+						if (isnew)
+							sstr << "_new";
+						sstr << postfix;
+						if (orig_wire != nullptr)
+							*orig_wire = sig.bit.wire;
+						return sstr.str();
+					}
+				}
+			}
+		}
+		std::stringstream sstr;
+		sstr << "$abc$" << map_autoidx << "$" << abc_name.substr(1);
+		return sstr.str();
 	}
 
-	for (auto &cell_it : module->cells_)
-	for (auto &port_it : cell_it.second->connections())
-		mark_port(port_it.second);
+	void dump_loop_graph(FILE *f, int &nr, std::map<int, std::set<int>> &edges, std::set<int> &workpool, std::vector<int> &in_counts)
+	{
+		if (f == NULL)
+			return;
 
-	if (clk_sig.size() != 0)
-		mark_port(clk_sig);
+		log("Dumping loop state graph to slide %d.\n", ++nr);
 
-	if (en_sig.size() != 0)
-		mark_port(en_sig);
+		fprintf(f, "digraph \"slide%d\" {\n", nr);
+		fprintf(f, "  label=\"slide%d\";\n", nr);
+		fprintf(f, "  rankdir=\"TD\";\n");
 
-	handle_loops();
+		std::set<int> nodes;
+		for (auto &e : edges) {
+			nodes.insert(e.first);
+			for (auto n : e.second)
+				nodes.insert(n);
+		}
 
-	f = fopen(blif_input_file.c_str(), "wt");
-	if (f == NULL)
-		log_error("Opening %s for writing failed: %s\n", blif_input_file.c_str(), strerror(errno));
+		for (auto n : nodes)
+			fprintf(f, "  ys__n%d [label=\"%s\\nid=%d, count=%d\"%s];\n", n, log_signal(signal_list[n].bit),
+					n, in_counts[n], workpool.count(n) ? ", shape=box" : "");
 
-	fprintf(f, ".model netlist\n");
+		for (auto &e : edges)
+		for (auto n : e.second)
+			fprintf(f, "  ys__n%d -> ys__n%d;\n", e.first, n);
 
-	int count_input = 0;
-	fprintf(f, ".inputs");
-	for (auto &si : signal_list) {
-		if (!si.is_port || si.type != G(NONE))
-			continue;
-		fprintf(f, " ys__n%d", si.id);
-		pi_map[count_input++] = log_signal(si.bit);
+		fprintf(f, "}\n");
 	}
-	if (count_input == 0)
-		fprintf(f, " dummy_input\n");
-	fprintf(f, "\n");
-
-	int count_output = 0;
-	fprintf(f, ".outputs");
-	for (auto &si : signal_list) {
-		if (!si.is_port || si.type == G(NONE))
-			continue;
-		fprintf(f, " ys__n%d", si.id);
-		po_map[count_output++] = log_signal(si.bit);
-	}
-	fprintf(f, "\n");
 
-	for (auto &si : signal_list)
-		fprintf(f, "# ys__n%-5d %s\n", si.id, log_signal(si.bit));
+	void handle_loops()
+	{
+		// http://en.wikipedia.org/wiki/Topological_sorting
+		// (Kahn, Arthur B. (1962), "Topological sorting of large networks")
+
+		std::map<int, std::set<int>> edges;
+		std::vector<int> in_edges_count(signal_list.size());
+		std::set<int> workpool;
+
+		FILE *dot_f = NULL;
+		int dot_nr = 0;
+
+		// uncomment for troubleshooting the loop detection code
+		// dot_f = fopen("test.dot", "w");
+
+		for (auto &g : signal_list) {
+			if (g.type == G(NONE) || g.type == G(FF)) {
+				workpool.insert(g.id);
+			} else {
+				if (g.in1 >= 0) {
+					edges[g.in1].insert(g.id);
+					in_edges_count[g.id]++;
+				}
+				if (g.in2 >= 0 && g.in2 != g.in1) {
+					edges[g.in2].insert(g.id);
+					in_edges_count[g.id]++;
+				}
+				if (g.in3 >= 0 && g.in3 != g.in2 && g.in3 != g.in1) {
+					edges[g.in3].insert(g.id);
+					in_edges_count[g.id]++;
+				}
+				if (g.in4 >= 0 && g.in4 != g.in3 && g.in4 != g.in2 && g.in4 != g.in1) {
+					edges[g.in4].insert(g.id);
+					in_edges_count[g.id]++;
+				}
+			}
+		}
+
+		dump_loop_graph(dot_f, dot_nr, edges, workpool, in_edges_count);
+
+		while (workpool.size() > 0)
+		{
+			int id = *workpool.begin();
+			workpool.erase(id);
+
+			// log("Removing non-loop node %d from graph: %s\n", id, log_signal(signal_list[id].bit));
+
+			for (int id2 : edges[id]) {
+				log_assert(in_edges_count[id2] > 0);
+				if (--in_edges_count[id2] == 0)
+					workpool.insert(id2);
+			}
+			edges.erase(id);
 
-	for (auto &si : signal_list) {
-		if (si.bit.wire == NULL) {
-			fprintf(f, ".names ys__n%d\n", si.id);
-			if (si.bit == RTLIL::State::S1)
-				fprintf(f, "1\n");
+			dump_loop_graph(dot_f, dot_nr, edges, workpool, in_edges_count);
+
+			while (workpool.size() == 0)
+			{
+				if (edges.size() == 0)
+					break;
+
+				int id1 = edges.begin()->first;
+
+				for (auto &edge_it : edges) {
+					int id2 = edge_it.first;
+					RTLIL::Wire *w1 = signal_list[id1].bit.wire;
+					RTLIL::Wire *w2 = signal_list[id2].bit.wire;
+					if (w1 == NULL)
+						id1 = id2;
+					else if (w2 == NULL)
+						continue;
+					else if (w1->name[0] == '$' && w2->name[0] == '\\')
+						id1 = id2;
+					else if (w1->name[0] == '\\' && w2->name[0] == '$')
+						continue;
+					else if (edges[id1].size() < edges[id2].size())
+						id1 = id2;
+					else if (edges[id1].size() > edges[id2].size())
+						continue;
+					else if (w2->name.str() < w1->name.str())
+						id1 = id2;
+				}
+
+				if (edges[id1].size() == 0) {
+					edges.erase(id1);
+					continue;
+				}
+
+				log_assert(signal_list[id1].bit.wire != NULL);
+
+				std::stringstream sstr;
+				sstr << "$abcloop$" << (autoidx++);
+				RTLIL::Wire *wire = module->addWire(sstr.str());
+
+				bool first_line = true;
+				for (int id2 : edges[id1]) {
+					if (first_line)
+						log("Breaking loop using new signal %s: %s -> %s\n", log_signal(RTLIL::SigSpec(wire)),
+								log_signal(signal_list[id1].bit), log_signal(signal_list[id2].bit));
+					else
+						log("                               %*s  %s -> %s\n", int(strlen(log_signal(RTLIL::SigSpec(wire)))), "",
+								log_signal(signal_list[id1].bit), log_signal(signal_list[id2].bit));
+					first_line = false;
+				}
+
+				int id3 = map_signal(RTLIL::SigSpec(wire));
+				signal_list[id1].is_port = true;
+				signal_list[id3].is_port = true;
+				log_assert(id3 == int(in_edges_count.size()));
+				in_edges_count.push_back(0);
+				workpool.insert(id3);
+
+				for (int id2 : edges[id1]) {
+					if (signal_list[id2].in1 == id1)
+						signal_list[id2].in1 = id3;
+					if (signal_list[id2].in2 == id1)
+						signal_list[id2].in2 = id3;
+					if (signal_list[id2].in3 == id1)
+						signal_list[id2].in3 = id3;
+					if (signal_list[id2].in4 == id1)
+						signal_list[id2].in4 = id3;
+				}
+				edges[id1].swap(edges[id3]);
+
+				module->connect(RTLIL::SigSig(signal_list[id3].bit, signal_list[id1].bit));
+				dump_loop_graph(dot_f, dot_nr, edges, workpool, in_edges_count);
+			}
 		}
+
+		if (dot_f != NULL)
+			fclose(dot_f);
 	}
 
-	int count_gates = 0;
-	for (auto &si : signal_list) {
-		if (si.type == G(BUF)) {
-			fprintf(f, ".names ys__n%d ys__n%d\n", si.in1, si.id);
-			fprintf(f, "1 1\n");
-		} else if (si.type == G(NOT)) {
-			fprintf(f, ".names ys__n%d ys__n%d\n", si.in1, si.id);
-			fprintf(f, "0 1\n");
-		} else if (si.type == G(AND)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "11 1\n");
-		} else if (si.type == G(NAND)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "0- 1\n");
-			fprintf(f, "-0 1\n");
-		} else if (si.type == G(OR)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "-1 1\n");
-			fprintf(f, "1- 1\n");
-		} else if (si.type == G(NOR)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "00 1\n");
-		} else if (si.type == G(XOR)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "01 1\n");
-			fprintf(f, "10 1\n");
-		} else if (si.type == G(XNOR)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "00 1\n");
-			fprintf(f, "11 1\n");
-		} else if (si.type == G(ANDNOT)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "10 1\n");
-		} else if (si.type == G(ORNOT)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
-			fprintf(f, "1- 1\n");
-			fprintf(f, "-0 1\n");
-		} else if (si.type == G(MUX)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.id);
-			fprintf(f, "1-0 1\n");
-			fprintf(f, "-11 1\n");
-		} else if (si.type == G(AOI3)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.id);
-			fprintf(f, "-00 1\n");
-			fprintf(f, "0-0 1\n");
-		} else if (si.type == G(OAI3)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.id);
-			fprintf(f, "00- 1\n");
-			fprintf(f, "--0 1\n");
-		} else if (si.type == G(AOI4)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.in4, si.id);
-			fprintf(f, "-0-0 1\n");
-			fprintf(f, "-00- 1\n");
-			fprintf(f, "0--0 1\n");
-			fprintf(f, "0-0- 1\n");
-		} else if (si.type == G(OAI4)) {
-			fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.in4, si.id);
-			fprintf(f, "00-- 1\n");
-			fprintf(f, "--00 1\n");
-		} else if (si.type == G(FF)) {
-			if (si.init == State::S0 || si.init == State::S1) {
-				fprintf(f, ".latch ys__n%d ys__n%d %d\n", si.in1, si.id, si.init == State::S1 ? 1 : 0);
-				recover_init = true;
-			} else
-				fprintf(f, ".latch ys__n%d ys__n%d 2\n", si.in1, si.id);
-		} else if (si.type != G(NONE))
-			log_abort();
-		if (si.type != G(NONE))
-			count_gates++;
+	// Builds the network with the same inputs and outputs, in the same order, as the
+	// netlist written for the external flow.
+	void build_aig()
+	{
+		std::vector<lso_signal_t> sigs(signal_list.size());
+		std::vector<bool> built(signal_list.size(), false);
+
+		int count_input = 0;
+		for (auto &si : signal_list) {
+			if (!si.is_port || si.type != G(NONE))
+				continue;
+			sigs[si.id] = ntk.create_pi(stringf("ys__n%d", si.id));
+			built[si.id] = true;
+			pi_map[count_input++] = log_signal(si.bit);
+		}
+
+		// handle_loops() has broken all combinational loops, the fanin cones are DAGs
+		std::vector<int> stack;
+		auto build = [&](int id) {
+			stack.push_back(id);
+			while (!stack.empty()) {
+				const gate_t &si = signal_list[stack.back()];
+				if (built[si.id]) {
+					stack.pop_back();
+					continue;
+				}
+				bool ready = true;
+				for (int in : {si.in1, si.in2, si.in3, si.in4})
+					if (in >= 0 && !built[in]) {
+						stack.push_back(in);
+						ready = false;
+					}
+				if (!ready)
+					continue;
+				stack.pop_back();
+				sigs[si.id] = lso_create_gate(ntk, si, sigs);
+				built[si.id] = true;
+			}
+		};
+
+		for (auto &si : signal_list) {
+			if (!si.is_port || si.type == G(NONE))
+				continue;
+			build(si.id);
+			ntk.create_po(sigs[si.id], stringf("ys__n%d", si.id));
+			po_map[count_output++] = log_signal(si.bit);
+		}
 	}
 
-	fprintf(f, ".end\n");
-	fclose(f);
+	template<class Ntk>
+	void rebuild_module(RTLIL::Design *design, const Ntk &ntk, std::map<std::string, int> &cell_stats)
+	{
+		std::vector<RTLIL::SigBit> pi_bits, po_bits;
+		for (auto &si : signal_list)
+			if (si.is_port)
+				(si.type == G(NONE) ? pi_bits : po_bits).push_back(si.bit);
 
-	log("Extracted %d gates and %d wires to a netlist network with %d inputs and %d outputs.\n",
-			count_gates, GetSize(signal_list), count_input, count_output);
-	log_push();
-	if (count_output > 0)
+		int wire_idx = 0, cell_idx = 0;
+		auto add_wire = [&]() {
+			RTLIL::Wire *wire = module->addWire(remap_name(stringf("\\lso_n%d", wire_idx++)));
+			if (markgroups) wire->attributes["\\abcgroup"] = map_autoidx;
+			design->select(module, wire);
+			return RTLIL::SigBit(wire);
+		};
+		auto add_cell = [&](std::string type) {
+			RTLIL::Cell *cell = module->addCell(remap_name(stringf("\\lso_g%d", cell_idx++)), type);
+			if (markgroups) cell->attributes["\\abcgroup"] = map_autoidx;
+			design->select(module, cell);
+			cell_stats[RTLIL::unescape_id(type)]++;
+			return cell;
+		};
+		auto add_gate = [&](std::string type, RTLIL::SigBit a, RTLIL::SigBit b) {
+			RTLIL::SigBit y = add_wire();
+			RTLIL::Cell *cell = add_cell(type);
+			cell->setPort("\\A", a);
+			cell->setPort("\\B", b);
+			cell->setPort("\\Y", y);
+			return y;
+		};
+
+		std::vector<RTLIL::SigBit> bits(ntk.size());
+		dict<int, RTLIL::SigBit> inverted;
+		auto signal_bit = [&](typename Ntk::signal f) {
+			auto n = ntk.get_node(f);
+			bool complemented = ntk.is_complemented(f);
+			if (ntk.is_constant(n))
+				return RTLIL::SigBit(ntk.constant_value(n) != complemented ? State::S1 : State::S0);
+			int index = ntk.node_to_index(n);
+			if (!complemented)
+				return bits[index];
+			if (!inverted.count(index)) {
+				RTLIL::SigBit y = add_wire();
+				RTLIL::Cell *cell = add_cell("$_NOT_");
+				cell->setPort("\\A", bits[index]);
+				cell->setPort("\\Y", y);
+				inverted[index] = y;
+			}
+			return inverted.at(index);
+		};
+
+		ntk.foreach_pi([&](auto n, auto i) {
+			bits[ntk.node_to_index(n)] = pi_bits[i];
+		});
+
+		mockturtle::topo_view<Ntk> topo{ntk};
+		topo.foreach_gate([&](auto n) {
+			std::vector<RTLIL::SigBit> fanin;
+			std::vector<typename Ntk::signal> signals;
+			ntk.foreach_fanin(n, [&](auto f) {
+				signals.push_back(f);
+				fanin.push_back(signal_bit(f));
+			});
+			RTLIL::SigBit &y = bits[ntk.node_to_index(n)];
+
+			if constexpr (std::is_base_of_v<mockturtle::klut_network, Ntk>) {
+				auto const &tt = ntk.node_function(n);
+				std::vector<RTLIL::State> lut;
+				for (uint64_t i = 0; i < tt.num_bits(); i++)
+					lut.push_back(kitty::get_bit(tt, i) ? State::S1 : State::S0);
+				y = add_wire();
+				RTLIL::Cell *cell = add_cell("$lut");
+				cell->setParam("\\WIDTH", GetSize(fanin));
+				cell->setParam("\\LUT", RTLIL::Const(lut));
+				cell->setPort("\\A", RTLIL::SigSpec(fanin));
+				cell->setPort("\\Y", y);
+			} else if (GetSize(fanin) == 2) {
+				y = add_gate("$_AND_", fanin[0], fanin[1]);
+			} else {
+				// majority gates with a constant fanin are ANDs and ORs
+				log_assert(GetSize(fanin) == 3);
+				for (int i = 0; i < 3; i++)
+					if (ntk.is_constant(ntk.get_node(signals[i]))) {
+						bool one = fanin[i] == State::S1;
+						y = add_gate(one ? "$_OR_" : "$_AND_", fanin[(i + 1) % 3], fanin[(i + 2) % 3]);
+						return;
+					}
+				RTLIL::SigBit ab = add_gate("$_AND_", fanin[0], fanin[1]);
+				RTLIL::SigBit a_or_b = add_gate("$_OR_", fanin[0], fanin[1]);
+				y = add_gate("$_OR_", ab, add_gate("$_AND_", fanin[2], a_or_b));
+			}
+		});
+
+		ntk.foreach_po([&](auto f, auto i) {
+			module->connect(po_bits[i], signal_bit(f));
+		});
+
+		for (auto &it : cell_stats)
+			log("LSOracle RESULTS:   %15s cells: %8d\n", it.first.c_str(), it.second);
+		log("LSOracle RESULTS:        internal signals: %8d\n", int(signal_list.size()) - GetSize(pi_bits) - GetSize(po_bits));
+		log("LSOracle RESULTS:           input signals: %8d\n", GetSize(pi_bits));
+		log("LSOracle RESULTS:          output signals: %8d\n", GetSize(po_bits));
+	}
+
+	void prepare(RTLIL::Design *design, RTLIL::Module *current_module, const std::vector<RTLIL::Cell*> &cells)
 	{
-		log_header(design, "Executing ABC.\n");
+		module = current_module;
+		map_autoidx = autoidx++;
+		assign_map.set(module);
+
+		for (Wire *wire : module->wires())
+			if (wire->attributes.count("\\init")) {
+				SigSpec initsig = assign_map(wire);
+				Const initval = wire->attributes.at("\\init");
+				for (int i = 0; i < GetSize(initsig) && i < GetSize(initval); i++)
+					switch (initval[i]) {
+						case State::S0:
+							signal_init[initsig[i]] = State::S0;
+							break;
+						case State::S1:
+							signal_init[initsig[i]] = State::S1;
+							break;
+						default:
+							break;
+					}
+			}
+
+		std::string clk_str = config.clk_str;
+		if (clk_str != "$")
+		{
+			clk_polarity = true;
+			clk_sig = RTLIL::SigSpec();
+
+			en_polarity = true;
+			en_sig = RTLIL::SigSpec();
+		}
+
+		if (!clk_str.empty() && clk_str != "$")
+		{
+			if (clk_str.find(',') != std::string::npos) {
+				int pos = clk_str.find(',');
+				std::string en_str = clk_str.substr(pos+1);
+				clk_str = clk_str.substr(0, pos);
+				if (en_str[0] == '!') {
+					en_polarity = false;
+					en_str = en_str.substr(1);
+				}
+				if (module->wires_.count(RTLIL::escape_id(en_str)) != 0)
+					en_sig = assign_map(RTLIL::SigSpec(module->wires_.at(RTLIL::escape_id(en_str)), 0));
+			}
+			if (clk_str[0] == '!') {
+				clk_polarity = false;
+				clk_str = clk_str.substr(1);
+			}
+			if (module->wires_.count(RTLIL::escape_id(clk_str)) != 0)
+				clk_sig = assign_map(RTLIL::SigSpec(module->wires_.at(RTLIL::escape_id(clk_str)), 0));
+		}
+
+		if (config.dff_mode && clk_sig.empty())
+			log_cmd_error("Clock domain %s not found.\n", clk_str.c_str());
+
+		if (inprocess && clk_sig.size() != 0) {
+			log("Sequential logic is only supported by the external flow, not running LSOracle in-process.\n");
+			inprocess = false;
+		}
+
+		FILE *f;
+
+		if (inprocess)
+			log_header(design, "Extracting gate netlist of module `%s'..\n", module->name.c_str());
+		else {
+			tempdir_name = "/tmp/yosys-abc-XXXXXX";
+			if (!config.cleanup)
+				tempdir_name[0] = tempdir_name[4] = '_';
+			tempdir_name = make_temp_dir(tempdir_name);
+
+			blif_input_file = tempdir_name + "/input.blif";
+			aiger_temp_file = tempdir_name + "/abc.aig";
+			tmp_script_name = tempdir_name + "/abc.script";
+			blif_output_file = tempdir_name + "/output.blif";
+
+			log_header(design, "Extracting gate netlist of module `%s' to `%s/input.blif'..\n",
+					module->name.c_str(), replace_tempdir(tempdir_name, tempdir_name, config.show_tempdir).c_str());
+
+			std::string abc_script = stringf("read_blif %s; strash; write %s", blif_input_file.c_str(), aiger_temp_file.c_str());
+
+			abc_script = add_echos_to_abc_cmd(abc_script);
+
+			for (size_t i = 0; i+1 < abc_script.size(); i++)
+				if (abc_script[i] == ';' && abc_script[i+1] == ' ')
+					abc_script[i+1] = '\n';
+
+			f = fopen(tmp_script_name.c_str(), "wt");
+			fprintf(f, "%s\n", abc_script.c_str());
+			fclose(f);
+		}
+
+		if (config.dff_mode || !clk_str.empty())
+		{
+			if (clk_sig.size() == 0)
+				log("No%s clock domain found. Not extracting any FF cells.\n", clk_str.empty() ? "" : " matching");
+			else {
+				log("Found%s %s clock domain: %s", clk_str.empty() ? "" : " matching", clk_polarity ? "posedge" : "negedge", log_signal(clk_sig));
+				if (en_sig.size() != 0)
+					log(", enabled by %s%s", en_polarity ? "" : "!", log_signal(en_sig));
+				log("\n");
+			}
+		}
+
+		for (auto c : cells)
+			extract_cell(c, config.keepff);
+
+		for (auto &wire_it : module->wires_) {
+			if (wire_it.second->port_id > 0 || wire_it.second->get_bool_attribute("\\keep"))
+				mark_port(RTLIL::SigSpec(wire_it.second));
+		}
+
+		for (auto &cell_it : module->cells_)
+		for (auto &port_it : cell_it.second->connections())
+			mark_port(port_it.second);
+
+		if (clk_sig.size() != 0)
+			mark_port(clk_sig);
 
-		std::string abc_command = stringf("%s -s -f %s 2>&1", abcexe_file.c_str(), tmp_script_name.c_str());
-		log("Running ABC command: %s\n", replace_tempdir(abc_command, tempdir_name, show_tempdir).c_str());
+		if (en_sig.size() != 0)
+			mark_port(en_sig);
 
+		handle_loops();
+
+		if (inprocess) {
+			build_aig();
+			log("Extracted %d gates and %d wires to an AIG with %d inputs and %d outputs.\n",
+					int(ntk.num_gates()), GetSize(signal_list), int(ntk.num_pis()), count_output);
+			return;
+		}
+
+		f = fopen(blif_input_file.c_str(), "wt");
+		if (f == NULL)
+			log_error("Opening %s for writing failed: %s\n", blif_input_file.c_str(), strerror(errno));
+
+		fprintf(f, ".model netlist\n");
+
+		int count_input = 0;
+		fprintf(f, ".inputs");
+		for (auto &si : signal_list) {
+			if (!si.is_port || si.type != G(NONE))
+				continue;
+			fprintf(f, " ys__n%d", si.id);
+			pi_map[count_input++] = log_signal(si.bit);
+		}
+		if (count_input == 0)
+			fprintf(f, " dummy_input\n");
+		fprintf(f, "\n");
+
+		fprintf(f, ".outputs");
+		for (auto &si : signal_list) {
+			if (!si.is_port || si.type == G(NONE))
+				continue;
+			fprintf(f, " ys__n%d", si.id);
+			po_map[count_output++] = log_signal(si.bit);
+		}
+		fprintf(f, "\n");
+
+		for (auto &si : signal_list)
+			fprintf(f, "# ys__n%-5d %s\n", si.id, log_signal(si.bit));
+
+		for (auto &si : signal_list) {
+			if (si.bit.wire == NULL) {
+				fprintf(f, ".names ys__n%d\n", si.id);
+				if (si.bit == RTLIL::State::S1)
+					fprintf(f, "1\n");
+			}
+		}
+
+		int count_gates = 0;
+		for (auto &si : signal_list) {
+			if (si.type == G(BUF)) {
+				fprintf(f, ".names ys__n%d ys__n%d\n", si.in1, si.id);
+				fprintf(f, "1 1\n");
+			} else if (si.type == G(NOT)) {
+				fprintf(f, ".names ys__n%d ys__n%d\n", si.in1, si.id);
+				fprintf(f, "0 1\n");
+			} else if (si.type == G(AND)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "11 1\n");
+			} else if (si.type == G(NAND)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "0- 1\n");
+				fprintf(f, "-0 1\n");
+			} else if (si.type == G(OR)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "-1 1\n");
+				fprintf(f, "1- 1\n");
+			} else if (si.type == G(NOR)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "00 1\n");
+			} else if (si.type == G(XOR)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "01 1\n");
+				fprintf(f, "10 1\n");
+			} else if (si.type == G(XNOR)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "00 1\n");
+				fprintf(f, "11 1\n");
+			} else if (si.type == G(ANDNOT)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "10 1\n");
+			} else if (si.type == G(ORNOT)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.id);
+				fprintf(f, "1- 1\n");
+				fprintf(f, "-0 1\n");
+			} else if (si.type == G(MUX)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.id);
+				fprintf(f, "1-0 1\n");
+				fprintf(f, "-11 1\n");
+			} else if (si.type == G(AOI3)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.id);
+				fprintf(f, "-00 1\n");
+				fprintf(f, "0-0 1\n");
+			} else if (si.type == G(OAI3)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.id);
+				fprintf(f, "00- 1\n");
+				fprintf(f, "--0 1\n");
+			} else if (si.type == G(AOI4)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.in4, si.id);
+				fprintf(f, "-0-0 1\n");
+				fprintf(f, "-00- 1\n");
+				fprintf(f, "0--0 1\n");
+				fprintf(f, "0-0- 1\n");
+			} else if (si.type == G(OAI4)) {
+				fprintf(f, ".names ys__n%d ys__n%d ys__n%d ys__n%d ys__n%d\n", si.in1, si.in2, si.in3, si.in4, si.id);
+				fprintf(f, "00-- 1\n");
+				fprintf(f, "--00 1\n");
+			} else if (si.type == G(FF)) {
+				if (si.init == State::S0 || si.init == State::S1) {
+					fprintf(f, ".latch ys__n%d ys__n%d %d\n", si.in1, si.id, si.init == State::S1 ? 1 : 0);
+					recover_init = true;
+				} else
+					fprintf(f, ".latch ys__n%d ys__n%d 2\n", si.in1, si.id);
+			} else if (si.type != G(NONE))
+				log_abort();
+			if (si.type != G(NONE))
+				count_gates++;
+		}
+
+		fprintf(f, ".end\n");
+		fclose(f);
+
+		log("Extracted %d gates and %d wires to a netlist network with %d inputs and %d outputs.\n",
+				count_gates, GetSize(signal_list), count_input, count_output);
+	}
+
+	void note(lso_output_t kind, std::string text)
+	{
+		output.emplace_back(kind, text);
+	}
+
+	int run_abc(std::string script_name, std::string &command)
+	{
+		command = stringf("%s -s -f %s 2>&1", config.abcexe_file.c_str(), script_name.c_str());
+		note(lso_output_t::NOTE, stringf("Running ABC command: %s\n", command.c_str()));
 #ifndef YOSYS_LINK_ABC
-		abc_output_filter filt(tempdir_name, show_tempdir);
-		int ret = run_command(abc_command, std::bind(&abc_output_filter::next_line, filt, std::placeholders::_1));
+		return run_command(command, [&](const std::string &line) { output.emplace_back(lso_output_t::ABC, line); });
 #else
+		// ABC keeps global state, run one instance at a time
+		static std::mutex abc_mutex;
+		std::lock_guard<std::mutex> lock(abc_mutex);
+
 		// These needs to be mutable, supposedly due to getopt
 		char *abc_argv[5];
 
-		abc_argv[0] = strdup(abcexe_file.c_str());
+		abc_argv[0] = strdup(config.abcexe_file.c_str());
 		abc_argv[1] = strdup("-s");
 		abc_argv[2] = strdup("-f");
-		abc_argv[3] = strdup(tmp_script_name.c_str());
+		abc_argv[3] = strdup(script_name.c_str());
 		abc_argv[4] = 0;
 		int ret = Abc_RealMain(4, abc_argv);
 		free(abc_argv[0]);
 		free(abc_argv[1]);
 		free(abc_argv[2]);
 		free(abc_argv[3]);
+		return ret;
 #endif
-		if (ret != 0)
-			log_error("ABC: execution of command \"%s\" failed: return code %d.\n", abc_command.c_str(), ret);
+	}
+
+	void run_external()
+	{
+		note(lso_output_t::HEADER, "Executing ABC.\n");
+
+		std::string abc_command;
+		int ret = run_abc(tmp_script_name, abc_command);
+		if (ret != 0) {
+			error = stringf("ABC: execution of command \"%s\" failed: return code %d.", abc_command.c_str(), ret);
+			return;
+		}
 
 		std::ifstream ifs;
 		ifs.open(aiger_temp_file);
-		if (ifs.fail())
-			log_error("Can't open ABC output file `%s'.\n", aiger_temp_file.c_str());
+		if (ifs.fail()) {
+			error = stringf("Can't open ABC output file `%s'.", aiger_temp_file.c_str());
+			return;
+		}
 
 		std::string lso_script;
-		if (script_file == "") {
+		if (config.script_file == "") {
 		// TODO pass temp filenames
-			lso_script = generate_lso_script(lsoexe_file, aiger_temp_file, blif_output_file, num_parts,
-							partitioned, exclu_part, mig, deep, merge, test, aig, lut);
+			lso_script = generate_lso_script(config.lsoexe_file, aiger_temp_file, blif_output_file, config.num_parts,
+							config.partitioned, config.exclu_part, config.mig, config.deep, config.merge, config.test, config.aig, config.lut);
 
 		} else {
-			lso_script = prepend_script_file(script_file, aiger_temp_file, blif_output_file);
+			lso_script = prepend_script_file(config.script_file, aiger_temp_file, blif_output_file);
 		}
+		note(lso_output_t::NOTE, stringf("LSOracle script: %s\n", lso_script.c_str()));
 		std::string script = write_lso_script(lso_script, tempdir_name);
 
-		lso_module(lsoexe_file, tempdir_name, show_tempdir, script);
+		std::string lso_command;
+		if (config.lso_server.empty())
+			note(lso_output_t::NOTE, stringf("Running LSOracle command: %s -f %s 2>&1\n", config.lsoexe_file.c_str(), script.c_str()));
+		else
+			note(lso_output_t::NOTE, stringf("Submitting LSOracle script to server %s\n", config.lso_server.c_str()));
+		ret = lso_module(config.lsoexe_file, config.lso_server, script, [&](const std::string &line) { output.emplace_back(lso_output_t::LSO, line); },
+				lso_command, error);
+		if (ret != 0)
+			return;
 
-		printf("%s\n", blif_output_file.c_str());
 		std::ifstream ifs_lso;
 		ifs_lso.open(blif_output_file);
-		if (ifs_lso.fail())
-			log_error("Can't open LSOracle output file `%s'.\n", blif_output_file.c_str());
+		if (ifs_lso.fail()) {
+			error = stringf("Can't open LSOracle output file `%s'.", blif_output_file.c_str());
+			return;
+		}
 
-		printf("Finished LSO\n");
+		note(lso_output_t::NOTE, "Finished LSO\n");
 
 		std::string cec_script = stringf("cec %s %s", aiger_temp_file.c_str(), blif_output_file.c_str());
 		cec_script = add_echos_to_abc_cmd(cec_script);
@@ -1115,39 +1545,160 @@ void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::strin
 			if (cec_script[i] == ';' && cec_script[i+1] == ' ')
 				cec_script[i+1] = '\n';
 
-		FILE *cec = fopen(stringf("%s/cec.script", tempdir_name.c_str()).c_str(), "wt");
+		std::string cec_script_name = stringf("%s/cec.script", tempdir_name.c_str());
+		FILE *cec = fopen(cec_script_name.c_str(), "wt");
 		fprintf(cec, "%s\n", cec_script.c_str());
 		fclose(cec);
 
-		std::string cec_buffer = stringf("%s -s -f %s/cec.script 2>&1", abcexe_file.c_str(), tempdir_name.c_str());
-
-		printf("Verifying LSOracle result is equivalent to original file\n");
-
-		#ifndef YOSYS_LINK_ABC
-				ret = run_command(cec_buffer, std::bind(&abc_output_filter::next_line, filt, std::placeholders::_1));
-		#else
-				// These needs to be mutable, supposedly due to getopt
-				char *abc_argv[5];
-				string tmp_script_name = stringf("%s/cec.script", tempdir_name.c_str());
-				abc_argv[0] = strdup(abcexe_file.c_str());
-				abc_argv[1] = strdup("-s");
-				abc_argv[2] = strdup("-f");
-				abc_argv[3] = strdup(tmp_script_name.c_str());
-				abc_argv[4] = 0;
-				ret = Abc_RealMain(4, abc_argv);
-				free(abc_argv[0]);
-				free(abc_argv[1]);
-				free(abc_argv[2]);
-				free(abc_argv[3]);
-		#endif
-				if (ret != 0)
-					log_error("ABC: execution of command \"%s\" failed: return code %d.\n", cec_buffer.c_str(), ret);
-
-		printf("Verification complete\n");
-
-		bool builtin_lib = liberty_file.empty();
+		note(lso_output_t::NOTE, "Verifying LSOracle result is equivalent to original file\n");
+
+		std::string cec_command;
+		ret = run_abc(cec_script_name, cec_command);
+		if (ret != 0) {
+			error = stringf("ABC: execution of command \"%s\" failed: return code %d.", cec_command.c_str(), ret);
+			return;
+		}
+
+		note(lso_output_t::NOTE, "Verification complete\n");
+	}
+
+	// Runs the flow that generate_lso_script() would write for these options
+	void run_inprocess()
+	{
+		note(lso_output_t::HEADER, "Executing LSOracle in-process.\n");
+
+		int parts = config.partitioned ? atoi(config.num_parts.c_str()) : ceil(ntk.size() / 300.0);
+		size_t exe_pos = config.lsoexe_file.rfind("lsoracle");
+		std::string config_direc = exe_pos == std::string::npos ? "" : config.lsoexe_file.substr(0, exe_pos);
+		std::string nn_model = config.deep ? config_direc + "../../deep_learn_model.json" : "";
+		std::string kahypar_config = config_direc.empty() ? "" : config_direc + "../../core/test.ini";
+
+		mockturtle::aig_network spec = mockturtle::cleanup_dangling<mockturtle::aig_network>(ntk);
+		std::stringstream lso_output;
+		{
+			lso_cout_capture capture(lso_output);
+			if (config.test) {
+				opt_aig = ntk;
+			} else if (!config.partitioned && config.mig) {
+				auto ntk_mig = *oracle::aig_to_mig(ntk, 0);
+				oracle::mig_script migopt;
+				opt_mig = migopt.run(ntk_mig);
+				is_mig = true;
+			} else if (!config.partitioned && config.aig) {
+				oracle::aig_script aigopt;
+				opt_aig = aigopt.run(ntk);
+			} else if (config.partitioned && (config.exclu_part || config.deep)) {
+				// partitioning {P}; optimization -a|-m|-n {D} [-c], see LSO_COMMAND_PART_*
+				oracle::partition_manager<lso_aig_t> partitions(ntk, parts, kahypar_config);
+				std::string model = config.exclu_part ? "" : nn_model;
+				opt_mig = oracle::optimization(ntk, partitions, 0, 0, model, model.empty(),
+						config.exclu_part && !config.mig, config.exclu_part && config.mig, !config.exclu_part && config.merge,
+						{}, {}, {}, {}, {});
+				is_mig = true;
+			} else {
+				// oracle [-c], see LSO_COMMAND_PART_HIGH_EFFORT
+				oracle::partition_manager<lso_aig_t> partitions(ntk, parts);
+				opt_mig = oracle::optimization_test(ntk, partitions, 0, "", true, false, false, config.merge);
+				is_mig = true;
+			}
+		}
+		std::string line;
+		while (std::getline(lso_output, line))
+			output.emplace_back(lso_output_t::LSO, line + "\n");
+
+		note(lso_output_t::NOTE, "Verifying LSOracle result is equivalent to the extracted netlist.\n");
+		std::optional<bool> equivalent = is_mig ? mockturtle::sweeping_equivalence_checking(spec, opt_mig) :
+				mockturtle::sweeping_equivalence_checking(spec, opt_aig);
+		if (!equivalent)
+			note(lso_output_t::WARNING, "LSOracle: equivalence of the result could not be decided.\n");
+		else if (!*equivalent) {
+			error = "LSOracle: the optimized network is not equivalent to the extracted netlist.";
+			return;
+		}
+
+		if (config.lut)
+			opt_klut = is_mig ? lso_lut_map(opt_mig) : lso_lut_map(opt_aig);
+	}
+
+	void run()
+	{
+		if (count_output == 0)
+			return;
+		try {
+			if (inprocess)
+				run_inprocess();
+			else
+				run_external();
+		} catch (std::exception &e) {
+			error = stringf("LSOracle: %s", e.what());
+		}
+	}
+
+	void integrate(RTLIL::Design *design)
+	{
+		log_push();
+		if (count_output > 0)
+		{
+			abc_output_filter abc_filt(tempdir_name, config.show_tempdir, pi_map, po_map);
+			lso_output_filter lso_filt(tempdir_name, config.show_tempdir || inprocess, pi_map, po_map);
+			for (auto &it : output) {
+				std::string text = inprocess ? it.second : replace_tempdir(it.second, tempdir_name, config.show_tempdir);
+				switch (it.first) {
+				case lso_output_t::HEADER:
+					log_header(design, "%s", text.c_str());
+					break;
+				case lso_output_t::NOTE:
+					log("%s", text.c_str());
+					break;
+				case lso_output_t::WARNING:
+					log_warning("%s", text.c_str());
+					break;
+				case lso_output_t::ABC:
+					abc_filt.next_line(it.second);
+					break;
+				case lso_output_t::LSO:
+					lso_filt.next_line(it.second);
+					break;
+				}
+			}
+			if (!error.empty())
+				log_error("%s\n", error.c_str());
+
+			if (inprocess) {
+				log_header(design, "Re-integrating LSOracle results.\n");
+				std::map<std::string, int> cell_stats;
+				if (config.lut)
+					rebuild_module(design, opt_klut, cell_stats);
+				else if (is_mig)
+					rebuild_module(design, opt_mig, cell_stats);
+				else
+					rebuild_module(design, opt_aig, cell_stats);
+			} else
+				integrate_external(design);
+		}
+		else
+		{
+			log("Don't call LSOracle as there is nothing to map.\n");
+		}
+
+		if (!inprocess && config.cleanup)
+		{
+			log("Removing temp directory.\n");
+			remove_directory(tempdir_name);
+		}
+		log_pop();
+	}
+
+	void integrate_external(RTLIL::Design *design)
+	{
+		std::ifstream ifs_lso;
+		ifs_lso.open(blif_output_file);
+		if (ifs_lso.fail())
+			log_error("Can't open LSOracle output file `%s'.\n", blif_output_file.c_str());
+
+		bool builtin_lib = config.liberty_file.empty();
 		RTLIL::Design *mapped_design = new RTLIL::Design;
-		parse_blif(mapped_design, ifs_lso, builtin_lib ? "\\DFF" : "\\_dff_", false, sop_mode);
+		parse_blif(mapped_design, ifs_lso, builtin_lib ? "\\DFF" : "\\_dff_", false, config.sop_mode);
 
 		ifs_lso.close();
 
@@ -1404,18 +1955,34 @@ void abc_module(RTLIL::Design *design, RTLIL::Module *current_module, std::strin
 
 		delete mapped_design;
 	}
-	else
-	{
-		log("Don't call LSOracle as there is nothing to map.\n");
-	}
+};
 
-	if (cleanup)
-	{
-		log("Removing temp directory.\n");
-		remove_directory(tempdir_name);
+
+// Runs the jobs on up to num_threads threads, each thread takes the next job
+// that has not been started yet
+void lso_run_jobs(std::vector<std::unique_ptr<lso_job_t>> &jobs, int num_threads)
+{
+	alice::detail::routed_streambuf out_buf(std::cout.rdbuf());
+	std::streambuf *old_out = std::cout.rdbuf(&out_buf);
+
+	std::atomic<size_t> next_job{0};
+	auto work = [&]() {
+		for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+			jobs[i]->run();
+	};
+
+	num_threads = std::max(1, std::min(num_threads, GetSize(jobs)));
+	if (num_threads == 1)
+		work();
+	else {
+		std::vector<std::thread> threads;
+		for (int i = 0; i < num_threads; i++)
+			threads.emplace_back(work);
+		for (auto &t : threads)
+			t.join();
 	}
-	log_pop();
 
+	std::cout.rdbuf(old_out);
 }
 
 struct ORACLEPass : public Pass {
@@ -1438,6 +2005,19 @@ struct ORACLEPass : public Pass {
 		log("    -lso_exe <command>\n");
 		log("        specify where the LSOracle executable is. If not specified, \"lsoracle\" from the current PATH will be used.\n");
 		log("\n");
+		log("    -j <number of jobs>\n");
+		log("        run LSOracle on up to this many modules concurrently (default 1). the modules\n");
+		log("        are still extracted and merged back into the design one after the other.\n");
+		log("\n");
+		log("    -external\n");
+		log("        run ABC and LSOracle as separate processes that exchange the netlist through\n");
+		log("        temporary files, instead of running the LSOracle core linked into the plugin.\n");
+		log("        this is implied by -script and -lso_server, and used for sequential logic.\n");
+		log("\n");
+		log("    -lso_server <socket>\n");
+		log("        submit the modules to a running LSOracle server (lsoracle --serve --socket <socket>)\n");
+		log("        instead of starting a new LSOracle process for each module.\n");
+		log("\n");
 		log("    -partition <number of partitions>\n");
 		log("        use k-way hypergraph partitioning to partition circuit for optimization of partitions independently.\n");
 		log("\n");
@@ -1473,13 +2053,6 @@ struct ORACLEPass : public Pass {
 		log_header(design, "Executing LSOracle pass (MIG optimization using LSOracle).\n");
 		log_push();
 
-		assign_map.clear();
-		signal_list.clear();
-		signal_map.clear();
-		signal_init.clear();
-		pi_map.clear();
-		po_map.clear();
-
 #ifdef ABCEXTERNAL
 		std::string abcexe_file = ABCEXTERNAL;
 #else
@@ -1500,6 +2073,8 @@ struct ORACLEPass : public Pass {
 
 		std::string num_parts;
 		bool partitioned = false, exclu_part = false, mig = false, aig = false, lut = false, deep = false, merge = false, test = false;
+		bool external = false;
+		int num_jobs = 1;
 
 #ifdef _WIN32
 #ifndef ABCEXTERNAL
@@ -1509,6 +2084,7 @@ struct ORACLEPass : public Pass {
 #endif
 
 		std::string lsoexe_file = "lsoracle";
+		std::string lso_server;
 		size_t argidx;
 		char pwd [PATH_MAX];
 		if (!getcwd(pwd, sizeof(pwd))) {
@@ -1524,6 +2100,20 @@ struct ORACLEPass : public Pass {
 					lsoexe_file = args[++argidx];
 					continue;
 				}
+				if (arg == "-lso_server" && argidx+1 < args.size()) {
+					lso_server = args[++argidx];
+					continue;
+				}
+				if (arg == "-j" && argidx+1 < args.size()) {
+					num_jobs = atoi(args[++argidx].c_str());
+					if (num_jobs < 1)
+						log_cmd_error("Invalid number of jobs `%s'.\n", args[argidx].c_str());
+					continue;
+				}
+				if (arg == "-external") {
+					external = true;
+					continue;
+				}
 				if (arg == "-abc_exe" && argidx+1 < args.size()) {
 					abcexe_file = args[++argidx];
 					continue;
@@ -1582,6 +2172,44 @@ struct ORACLEPass : public Pass {
 			}
 			extra_args(args, argidx, design);
 
+			if (partitioned && atoi(num_parts.c_str()) <= 0)
+				log_cmd_error("Invalid number of partitions `%s'.\n", num_parts.c_str());
+
+			lso_config_t config;
+			config.script_file = script_file;
+			config.abcexe_file = abcexe_file;
+			config.lsoexe_file = lsoexe_file;
+			config.lso_server = lso_server;
+			config.liberty_file = liberty_file;
+			config.constr_file = constr_file;
+			config.clk_str = clk_str;
+			config.delay_target = delay_target;
+			config.sop_inputs = sop_inputs;
+			config.sop_products = sop_products;
+			config.lutin_shared = lutin_shared;
+			config.fast_mode = fast_mode;
+			config.dff_mode = dff_mode;
+			config.keepff = keepff;
+			config.cleanup = cleanup;
+			config.show_tempdir = show_tempdir;
+			config.sop_mode = sop_mode;
+			config.abc_dress = abc_dress;
+			config.lut_costs = lut_costs;
+			config.num_parts = num_parts;
+			config.partitioned = partitioned;
+			config.exclu_part = exclu_part;
+			config.mig = mig;
+			config.deep = deep;
+			config.merge = merge;
+			config.test = test;
+			config.aig = aig;
+			config.lut = lut;
+			config.inprocess = !external && script_file.empty() && lso_server.empty();
+
+			// Modules are extracted and re-integrated one after the other in the order of
+			// the selection, only running LSOracle on them happens concurrently, so the
+			// result does not depend on -j.
+			std::vector<std::unique_ptr<lso_job_t>> jobs;
 			for (auto mod : design->selected_modules())
 			{
 				if (mod->processes.size() > 0) {
@@ -1589,35 +2217,18 @@ struct ORACLEPass : public Pass {
 					continue;
 				}
 
-				assign_map.set(mod);
-				signal_init.clear();
-
-				for (Wire *wire : mod->wires())
-					if (wire->attributes.count("\\init")) {
-						SigSpec initsig = assign_map(wire);
-						Const initval = wire->attributes.at("\\init");
-						for (int i = 0; i < GetSize(initsig) && i < GetSize(initval); i++)
-							switch (initval[i]) {
-								case State::S0:
-									signal_init[initsig[i]] = State::S0;
-									break;
-								case State::S1:
-									signal_init[initsig[i]] = State::S1;
-									break;
-								default:
-									break;
-							}
-					}
-
-				std::cout << "lsoexe_file = " << lsoexe_file << "\n";
 				if (!dff_mode || !clk_str.empty()) {
-					abc_module(design, mod, script_file, abcexe_file, lsoexe_file, liberty_file, constr_file, cleanup, lut_costs, dff_mode, clk_str, keepff,
-							delay_target, sop_inputs, sop_products, lutin_shared, fast_mode, mod->selected_cells(), show_tempdir, sop_mode, abc_dress,
-							num_parts, partitioned, exclu_part, mig, deep, merge, test, aig, lut);
-					continue;
+					jobs.emplace_back(new lso_job_t(config));
+					jobs.back()->prepare(design, mod, mod->selected_cells());
 				}
 			}
 
+			if (num_jobs > 1 && GetSize(jobs) > 1)
+				log("Running LSOracle on %d modules with %d jobs.\n", GetSize(jobs), std::min(num_jobs, GetSize(jobs)));
+			lso_run_jobs(jobs, num_jobs);
+
+			for (auto &job : jobs)
+				job->integrate(design);
 		}
 		else{
 			log("Invalid number of arguments\n");